@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_EXAMPLE_COMMON_BROADCAST_HUB_HPP
+#define BOOST_BEAST_EXAMPLE_COMMON_BROADCAST_HUB_HPP
+
+#include <boost/asio/post.hpp>
+#include <boost/assert.hpp>
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/smart_ptr/weak_ptr.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*  A registry of sessions which delivers messages to all of them.
+
+    Sessions are spread over shards. Each shard holds an immutable
+    list of its sessions, which is replaced when a session joins or
+    leaves, so a broadcast neither takes a lock nor copies the list.
+    A broadcast posts one handler per shard to the executor, and
+    the shards are delivered concurrently by the threads running it.
+
+    `Session` must provide a member function callable concurrently
+    from any thread, which queues the message without blocking:
+
+        void deliver(Message const&);
+*/
+template<class Session, class Message>
+class broadcast_hub
+{
+    struct entry
+    {
+        Session* session;
+        boost::weak_ptr<Session> wp;
+    };
+
+    using list_type = std::vector<entry>;
+
+    struct shard
+    {
+        // Only serializes joining and leaving
+        std::mutex mutex;
+        std::shared_ptr<list_type const> list =
+            std::make_shared<list_type const>();
+    };
+
+    std::unique_ptr<shard[]> shards_;
+    std::size_t const size_;
+    std::atomic<std::size_t> next_{0};
+
+public:
+    /// The type of token returned by join
+    using token_type = std::size_t;
+
+    /** Constructor
+
+        @param shards The number of shards. Zero uses one shard
+        for each hardware thread.
+    */
+    explicit
+    broadcast_hub(std::size_t shards = 0)
+        : size_(shards > 0 ? shards :
+            (std::max)(1u, std::thread::hardware_concurrency()))
+    {
+        shards_.reset(new shard[size_]);
+    }
+
+    /// Returns the number of shards
+    std::size_t
+    shards() const noexcept
+    {
+        return size_;
+    }
+
+    /** Add a session.
+
+        The session stays registered until @ref leave is
+        called with the returned token.
+    */
+    token_type
+    join(boost::shared_ptr<Session> const& sp)
+    {
+        auto const i = next_++ % size_;
+        auto& s = shards_[i];
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto list = std::make_shared<list_type>(*s.list);
+        list->push_back(entry{sp.get(), sp});
+        std::atomic_store(&s.list,
+            std::shared_ptr<list_type const>(std::move(list)));
+        return i;
+    }
+
+    /// Remove a session
+    void
+    leave(Session* session, token_type token)
+    {
+        BOOST_ASSERT(token < size_);
+        auto& s = shards_[token];
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto list = std::make_shared<list_type>();
+        list->reserve(s.list->size());
+        for(auto const& e : *s.list)
+            if(e.session != session)
+                list->push_back(e);
+        std::atomic_store(&s.list,
+            std::shared_ptr<list_type const>(std::move(list)));
+    }
+
+    /** Deliver a message to every session.
+
+        One handler per shard is posted to `ex`, which calls
+        `deliver` on each session in the shard still alive.
+    */
+    template<class Executor>
+    void
+    broadcast(Executor const& ex, Message const& msg)
+    {
+        for(std::size_t i = 0; i < size_; ++i)
+        {
+            auto list = std::atomic_load(&shards_[i].list);
+            if(list->empty())
+                continue;
+            boost::asio::post(ex,
+                [list, msg]
+                {
+                    for(auto const& e : *list)
+                        if(auto sp = e.wp.lock())
+                            sp->deliver(msg);
+                });
+        }
+    }
+};
+
+#endif
@@ -34,8 +34,9 @@ void
 shared_state::
 send(std::string message)
 {
-    auto const ss = std::make_shared<std::string const>(std::move(message));
+    // Frame the message once, so we can re-use it for each client
+    websocket::prepared_message const msg(true, net::buffer(message));
 
     for(auto session : sessions_)
-        session->send(ss);
+        session->send(msg);
 }
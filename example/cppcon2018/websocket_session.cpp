@@ -85,18 +85,28 @@ on_read(beast::error_code ec, std::size_t)
 
 void
 websocket_session::
-send(std::shared_ptr<std::string const> const& ss)
+send(websocket::prepared_message const& msg)
 {
-    // Always add to queue
-    queue_.push_back(ss);
+    // Always add to queue, which drops the
+    // oldest messages for a slow client
+    queue_.push(msg);
 
     // Are we already writing?
-    if(queue_.size() > 1)
+    if(queue_.busy())
         return;
 
     // We are not currently writing, so send this immediately
-    ws_.async_write(
-        net::buffer(*queue_.front()),
+    do_write();
+}
+
+void
+websocket_session::
+do_write()
+{
+    // Small messages waiting in the queue
+    // are sent together in one write.
+    ws_.async_write_prepared(
+        queue_,
         std::bind(
             &websocket_session::on_write,
             shared_from_this(),
@@ -112,16 +122,7 @@ on_write(beast::error_code ec, std::size_t)
     if(ec)
         return fail(ec, "write");
 
-    // Remove the string from the queue
-    queue_.erase(queue_.begin());
-
-    // Send the next message if any
+    // Send the next messages if any
     if(! queue_.empty())
-        ws_.async_write(
-            net::buffer(*queue_.front()),
-            std::bind(
-                &websocket_session::on_write,
-                shared_from_this(),
-                std::placeholders::_1,
-                std::placeholders::_2));
+        do_write();
 }
@@ -29,12 +29,13 @@ class websocket_session : public std::enable_shared_from_this<websocket_session>
     beast::flat_buffer buffer_;
     websocket::stream<tcp::socket> ws_;
     std::shared_ptr<shared_state> state_;
-    std::vector<std::shared_ptr<std::string const>> queue_;
+    websocket::send_queue queue_;
 
     void fail(beast::error_code ec, char const* what);
     void on_accept(beast::error_code ec);
     void on_read(beast::error_code ec, std::size_t bytes_transferred);
     void on_write(beast::error_code ec, std::size_t bytes_transferred);
+    void do_write();
 
 public:
     websocket_session(
@@ -49,7 +50,7 @@ public:
 
     // Send a message
     void
-    send(std::shared_ptr<std::string const> const& ss);
+    send(websocket::prepared_message const& msg);
 };
 
 template<class Body, class Allocator>
@@ -50,7 +50,7 @@ main(int argc, char* argv[])
     boost::make_shared<listener>(
         ioc,
         tcp::endpoint{address, port},
-        boost::make_shared<shared_state>(doc_root))->run();
+        boost::make_shared<shared_state>(ioc, doc_root))->run();
 
     // Capture SIGINT and SIGTERM to perform a clean shutdown
     net::signal_set signals(ioc, SIGINT, SIGTERM);
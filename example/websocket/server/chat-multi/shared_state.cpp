@@ -9,27 +9,31 @@
 
 #include "shared_state.hpp"
 #include "websocket_session.hpp"
+#include "net.hpp"
 
 shared_state::
-shared_state(std::string doc_root)
+shared_state(
+    net::io_context& ioc,
+    std::string doc_root)
     : doc_root_(std::move(doc_root))
+    , ex_(ioc.get_executor())
 {
+    pmd_.server_enable = true;
 }
 
-void
+auto
 shared_state::
-join(websocket_session* session)
+join(boost::shared_ptr<websocket_session> const& session) ->
+    hub_type::token_type
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    sessions_.insert(session);
+    return hub_.join(session);
 }
 
 void
 shared_state::
-leave(websocket_session* session)
+leave(websocket_session* session, hub_type::token_type token)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    sessions_.erase(session);
+    hub_.leave(session, token);
 }
 
 // Broadcast a message to all websocket client sessions
@@ -37,23 +41,12 @@ void
 shared_state::
 send(std::string message)
 {
-    // Put the message in a shared pointer so we can re-use it for each client
-    auto const ss = boost::make_shared<std::string const>(std::move(message));
-
-    // Make a local list of all the weak pointers representing
-    // the sessions, so we can do the actual sending without
-    // holding the mutex:
-    std::vector<boost::weak_ptr<websocket_session>> v;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        v.reserve(sessions_.size());
-        for(auto p : sessions_)
-            v.emplace_back(p->weak_from_this());
-    }
+    // Frame and compress the message once, so we can re-use it for
+    // each client. Copies of a prepared message share the same bytes.
+    websocket::prepared_message const msg(
+        true, net::buffer(message), pmd_);
 
-    // For each session in our local list, try to acquire a strong
-    // pointer. If successful, then send the message on that session.
-    for(auto const& wp : v)
-        if(auto sp = wp.lock())
-            sp->send(ss);
+    // Each shard of the sessions is delivered by one handler,
+    // without taking a lock or copying the list of sessions.
+    hub_.broadcast(ex_, msg);
 }
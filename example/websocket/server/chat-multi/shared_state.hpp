@@ -10,11 +10,12 @@
 #ifndef BOOST_BEAST_EXAMPLE_WEBSOCKET_CHAT_MULTI_SHARED_STATE_HPP
 #define BOOST_BEAST_EXAMPLE_WEBSOCKET_CHAT_MULTI_SHARED_STATE_HPP
 
+#include "beast.hpp"
+#include "net.hpp"
+#include "example/common/broadcast_hub.hpp"
 #include <boost/smart_ptr.hpp>
 #include <memory>
-#include <mutex>
 #include <string>
-#include <unordered_set>
 
 // Forward declaration
 class websocket_session;
@@ -22,17 +23,26 @@ class websocket_session;
 // Represents the shared server state
 class shared_state
 {
+public:
+    using hub_type = broadcast_hub<
+        websocket_session, websocket::prepared_message>;
+
+private:
     std::string const doc_root_;
 
-    // This mutex synchronizes all access to sessions_
-    std::mutex mutex_;
+    // Compression settings for sessions and broadcast messages
+    websocket::permessage_deflate pmd_;
+
+    // Runs the handlers which deliver broadcast messages
+    net::io_context::executor_type ex_;
 
     // Keep a list of all the connected clients
-    std::unordered_set<websocket_session*> sessions_;
+    hub_type hub_;
 
 public:
-    explicit
-    shared_state(std::string doc_root);
+    shared_state(
+        net::io_context& ioc,
+        std::string doc_root);
 
     std::string const&
     doc_root() const noexcept
@@ -40,8 +50,16 @@ public:
         return doc_root_;
     }
 
-    void join  (websocket_session* session);
-    void leave (websocket_session* session);
+    websocket::permessage_deflate const&
+    pmd() const noexcept
+    {
+        return pmd_;
+    }
+
+    hub_type::token_type
+    join(boost::shared_ptr<websocket_session> const& session);
+
+    void leave (websocket_session* session, hub_type::token_type token);
     void send  (std::string message);
 };
 
@@ -18,13 +18,15 @@ websocket_session(
     , state_(state)
     , strand_(ws_.get_executor())
 {
+    ws_.set_option(state_->pmd());
 }
 
 websocket_session::
 ~websocket_session()
 {
     // Remove this session from the list of active sessions
-    state_->leave(this);
+    if(joined_)
+        state_->leave(this, token_);
 }
 
 void
@@ -48,7 +50,8 @@ on_accept(beast::error_code ec)
         return fail(ec, "accept");
 
     // Add this session to the list of active sessions
-    state_->join(this);
+    token_ = state_->join(shared_from_this());
+    joined_ = true;
 
     // Read a message
     ws_.async_read(
@@ -88,29 +91,58 @@ on_read(beast::error_code ec, std::size_t)
 
 void
 websocket_session::
-send(boost::shared_ptr<std::string const> const& ss)
+deliver(websocket::prepared_message const& msg)
 {
-    // Get on the strand if we aren't already,
-    // otherwise we will concurrently access
-    // objects which are not thread-safe.
-    if(! strand_.running_in_this_thread())
-        return net::post(
-            net::bind_executor(strand_,
-                std::bind(
-                    &websocket_session::send,
-                    shared_from_this(),
-                    ss)));
-
-    // Always add to queue
-    queue_.push_back(ss);
+    // Called concurrently by the broadcast handlers, so only
+    // the inbox is touched here. Messages arriving while the
+    // inbox is non-empty ride along with the pending handler.
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inbox_.push_back(msg);
+        if(inbox_.size() > 1)
+            return;
+    }
+
+    // Get on the strand, otherwise we will concurrently
+    // access objects which are not thread-safe.
+    net::post(
+        net::bind_executor(strand_,
+            std::bind(
+                &websocket_session::on_deliver,
+                shared_from_this())));
+}
+
+void
+websocket_session::
+on_deliver()
+{
+    std::vector<websocket::prepared_message> inbox;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inbox.swap(inbox_);
+    }
+
+    // The queue drops the oldest messages if the
+    // client can't keep up, but never those being sent.
+    for(auto const& msg : inbox)
+        queue_.push(msg);
 
     // Are we already writing?
-    if(queue_.size() > 1)
+    if(queue_.busy())
         return;
 
     // We are not currently writing, so send this immediately
-    ws_.async_write(
-        net::buffer(*queue_.front()),
+    do_write();
+}
+
+void
+websocket_session::
+do_write()
+{
+    // Small messages waiting in the queue
+    // are sent together in one write.
+    ws_.async_write_prepared(
+        queue_,
         net::bind_executor(strand_,
             std::bind(
                 &websocket_session::on_write,
@@ -127,17 +159,7 @@ on_write(beast::error_code ec, std::size_t)
     if(ec)
         return fail(ec, "write");
 
-    // Remove the string from the queue
-    queue_.erase(queue_.begin());
-
-    // Send the next message if any
+    // Send the next messages if any
     if(! queue_.empty())
-        ws_.async_write(
-            net::buffer(*queue_.front()),
-            net::bind_executor(strand_,
-                std::bind(
-                    &websocket_session::on_write,
-                    shared_from_this(),
-                    std::placeholders::_1,
-                    std::placeholders::_2)));
+        do_write();
 }
@@ -16,6 +16,7 @@
 
 #include <cstdlib>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -29,13 +30,21 @@ class websocket_session : public boost::enable_shared_from_this<websocket_sessio
     beast::flat_buffer buffer_;
     websocket::stream<tcp::socket> ws_;
     boost::shared_ptr<shared_state> state_;
-    std::vector<boost::shared_ptr<std::string const>> queue_;
+    websocket::send_queue queue_;
     net::strand<net::io_context::executor_type> strand_;
+    shared_state::hub_type::token_type token_ = 0;
+    bool joined_ = false;
+
+    // Messages delivered from other threads, waiting to be queued
+    std::mutex mutex_;
+    std::vector<websocket::prepared_message> inbox_;
 
     void fail(beast::error_code ec, char const* what);
     void on_accept(beast::error_code ec);
     void on_read(beast::error_code ec, std::size_t bytes_transferred);
     void on_write(beast::error_code ec, std::size_t bytes_transferred);
+    void on_deliver();
+    void do_write();
 
 public:
     websocket_session(
@@ -48,9 +57,9 @@ public:
     void
     run(http::request<Body, http::basic_fields<Allocator>> req);
 
-    // Send a message
+    // Send a message, may be called from any thread
     void
-    send(boost::shared_ptr<std::string const> const& ss);
+    deliver(websocket::prepared_message const& msg);
 };
 
 template<class Body, class Allocator>
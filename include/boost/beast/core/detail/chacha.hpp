@@ -44,13 +44,17 @@ namespace detail {
 template<std::size_t R>
 class chacha
 {
-    void generate_block();
-    void chacha_core();
+    // Blocks generated together. The rounds operate on
+    // each word of all the blocks at once, which compilers
+    // turn into vector instructions.
+    static constexpr int batch = 4;
 
-    alignas(16) std::uint32_t block_[16];
+    void generate_blocks();
+
+    alignas(16) std::uint32_t block_[16 * batch];
     std::uint32_t keysetup_[8];
     std::uint64_t ctr_ = 0;
-    int idx_ = 16;
+    int idx_ = 16 * batch;
 
 public:
     static constexpr std::size_t state_size = sizeof(chacha::keysetup_);
@@ -106,11 +110,10 @@ std::uint32_t
 chacha<R>::
 operator()()
 {
-    if(idx_ == 16)
+    if(idx_ == 16 * batch)
     {
         idx_ = 0;
-        ++ctr_;
-        generate_block();
+        generate_blocks();
     }
     return block_[idx_++];
 }
@@ -118,52 +121,57 @@ operator()()
 template<std::size_t R>
 void
 chacha<R>::
-generate_block()
+generate_blocks()
 {
     std::uint32_t constexpr constants[4] = {
         0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
-    std::uint32_t input[16];
-    for (int i = 0; i < 4; ++i)
-        input[i] = constants[i];
-    for (int i = 0; i < 8; ++i)
-        input[4 + i] = keysetup_[i];
-    input[12] = (ctr_ / 16) & 0xffffffffu;
-    input[13] = (ctr_ / 16) >> 32;
-    input[14] = input[15] = 0xdeadbeef; // Could use 128-bit counter.
-    for (int i = 0; i < 16; ++i)
-        block_[i] = input[i];
-    chacha_core();
-    for (int i = 0; i < 16; ++i)
-        block_[i] += input[i];
-}
 
-template<std::size_t R>
-void
-chacha<R>::
-chacha_core()
-{
+    // x[i][j] is word i of block j
+    std::uint32_t input[16][batch];
+    std::uint32_t x[16][batch];
+    for(int j = 0; j < batch; ++j)
+    {
+        for(int i = 0; i < 4; ++i)
+            input[i][j] = constants[i];
+        for(int i = 0; i < 8; ++i)
+            input[4 + i][j] = keysetup_[i];
+        input[12][j] = (ctr_ + j) & 0xffffffffu;
+        input[13][j] = (ctr_ + j) >> 32;
+        input[14][j] = input[15][j] = 0xdeadbeef; // Could use 128-bit counter.
+    }
+    ctr_ += batch;
+    for(int i = 0; i < 16; ++i)
+        for(int j = 0; j < batch; ++j)
+            x[i][j] = input[i][j];
+
     #define BOOST_BEAST_CHACHA_ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
 
     #define BOOST_BEAST_CHACHA_QUARTERROUND(x, a, b, c, d) \
-        x[a] = x[a] + x[b]; x[d] ^= x[a]; x[d] = BOOST_BEAST_CHACHA_ROTL32(x[d], 16); \
-        x[c] = x[c] + x[d]; x[b] ^= x[c]; x[b] = BOOST_BEAST_CHACHA_ROTL32(x[b], 12); \
-        x[a] = x[a] + x[b]; x[d] ^= x[a]; x[d] = BOOST_BEAST_CHACHA_ROTL32(x[d],  8); \
-        x[c] = x[c] + x[d]; x[b] ^= x[c]; x[b] = BOOST_BEAST_CHACHA_ROTL32(x[b],  7)
+        for(int j = 0; j < batch; ++j) { \
+        x[a][j] = x[a][j] + x[b][j]; x[d][j] ^= x[a][j]; x[d][j] = BOOST_BEAST_CHACHA_ROTL32(x[d][j], 16); \
+        x[c][j] = x[c][j] + x[d][j]; x[b][j] ^= x[c][j]; x[b][j] = BOOST_BEAST_CHACHA_ROTL32(x[b][j], 12); \
+        x[a][j] = x[a][j] + x[b][j]; x[d][j] ^= x[a][j]; x[d][j] = BOOST_BEAST_CHACHA_ROTL32(x[d][j],  8); \
+        x[c][j] = x[c][j] + x[d][j]; x[b][j] ^= x[c][j]; x[b][j] = BOOST_BEAST_CHACHA_ROTL32(x[b][j],  7); }
 
     for (unsigned i = 0; i < R; i += 2)
     {
-        BOOST_BEAST_CHACHA_QUARTERROUND(block_, 0, 4, 8, 12);
-        BOOST_BEAST_CHACHA_QUARTERROUND(block_, 1, 5, 9, 13);
-        BOOST_BEAST_CHACHA_QUARTERROUND(block_, 2, 6, 10, 14);
-        BOOST_BEAST_CHACHA_QUARTERROUND(block_, 3, 7, 11, 15);
-        BOOST_BEAST_CHACHA_QUARTERROUND(block_, 0, 5, 10, 15);
-        BOOST_BEAST_CHACHA_QUARTERROUND(block_, 1, 6, 11, 12);
-        BOOST_BEAST_CHACHA_QUARTERROUND(block_, 2, 7, 8, 13);
-        BOOST_BEAST_CHACHA_QUARTERROUND(block_, 3, 4, 9, 14);
+        BOOST_BEAST_CHACHA_QUARTERROUND(x, 0, 4, 8, 12)
+        BOOST_BEAST_CHACHA_QUARTERROUND(x, 1, 5, 9, 13)
+        BOOST_BEAST_CHACHA_QUARTERROUND(x, 2, 6, 10, 14)
+        BOOST_BEAST_CHACHA_QUARTERROUND(x, 3, 7, 11, 15)
+        BOOST_BEAST_CHACHA_QUARTERROUND(x, 0, 5, 10, 15)
+        BOOST_BEAST_CHACHA_QUARTERROUND(x, 1, 6, 11, 12)
+        BOOST_BEAST_CHACHA_QUARTERROUND(x, 2, 7, 8, 13)
+        BOOST_BEAST_CHACHA_QUARTERROUND(x, 3, 4, 9, 14)
     }
 
     #undef BOOST_BEAST_CHACHA_QUARTERROUND
     #undef BOOST_BEAST_CHACHA_ROTL32
+
+    // Output the blocks in counter order
+    for(int j = 0; j < batch; ++j)
+        for(int i = 0; i < 16; ++i)
+            block_[16 * j + i] = x[i][j] + input[i][j];
 }
 
 //#endif
@@ -11,6 +11,7 @@
 #define BOOST_BEAST_DETAIL_CPU_INFO_HPP
 
 #include <boost/config.hpp>
+#include <cstdint>
 
 #ifndef BOOST_BEAST_NO_INTRINSICS
 # if defined(BOOST_MSVC) || ((defined(BOOST_GCC) || defined(BOOST_CLANG)) && defined(__SSE4_2__))
@@ -28,6 +29,16 @@
 #include <cpuid.h>  // __get_cpuid
 #endif
 
+/*  Marks a function which uses instructions beyond those the
+    translation unit is compiled for. The function must only be
+    called after checking `cpu_info` for the instructions.
+*/
+#ifdef BOOST_MSVC
+# define BOOST_BEAST_TARGET(features)
+#else
+# define BOOST_BEAST_TARGET(features) __attribute__((target(features)))
+#endif
+
 namespace boost {
 namespace beast {
 namespace detail {
@@ -56,9 +67,48 @@ cpuid(
 #endif
 }
 
+template<class = void>
+void
+cpuid_count(
+    std::uint32_t id,
+    std::uint32_t sub,
+    std::uint32_t& eax,
+    std::uint32_t& ebx,
+    std::uint32_t& ecx,
+    std::uint32_t& edx)
+{
+#ifdef BOOST_MSVC
+    int regs[4];
+    __cpuidex(regs, id, sub);
+    eax = regs[0];
+    ebx = regs[1];
+    ecx = regs[2];
+    edx = regs[3];
+#else
+    __cpuid_count(id, sub, eax, ebx, ecx, edx);
+#endif
+}
+
+// Returns the register state enabled by the operating system
+template<class = void>
+std::uint64_t
+xgetbv()
+{
+#ifdef BOOST_MSVC
+    return _xgetbv(0);
+#else
+    std::uint32_t eax;
+    std::uint32_t edx;
+    __asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (std::uint64_t(edx) << 32) | eax;
+#endif
+}
+
 struct cpu_info
 {
     bool sse42 = false;
+    bool avx2 = false;
+    bool avx512 = false;    // AVX-512 Foundation
 
     cpu_info();
 };
@@ -68,6 +118,13 @@ cpu_info::
 cpu_info()
 {
     constexpr std::uint32_t SSE42 = 1 << 20;
+    constexpr std::uint32_t OSXSAVE = 1 << 27;
+    constexpr std::uint32_t AVX2 = 1 << 5;
+    constexpr std::uint32_t AVX512F = 1 << 16;
+
+    // XMM and YMM state, then opmask and ZMM state
+    constexpr std::uint64_t YMM = 0x06;
+    constexpr std::uint64_t ZMM = 0xe6;
 
     std::uint32_t eax = 0;
     std::uint32_t ebx = 0;
@@ -75,10 +132,23 @@ cpu_info()
     std::uint32_t edx = 0;
 
     cpuid(0, eax, ebx, ecx, edx);
-    if(eax >= 1)
+    auto const max_id = eax;
+    if(max_id >= 1)
     {
         cpuid(1, eax, ebx, ecx, edx);
         sse42 = (ecx & SSE42) != 0;
+
+        // The wide registers may only be used
+        // when the operating system saves them.
+        if(max_id >= 7 && (ecx & OSXSAVE) != 0)
+        {
+            auto const xcr0 = xgetbv();
+            cpuid_count(7, 0, eax, ebx, ecx, edx);
+            avx2 = (ebx & AVX2) != 0 &&
+                (xcr0 & YMM) == YMM;
+            avx512 = (ebx & AVX512F) != 0 &&
+                (xcr0 & ZMM) == ZMM;
+        }
     }
 }
 
@@ -76,10 +76,7 @@ public:
         {
             max_size = cond_(ec, total_, b_);
             max_prepare = std::min<std::size_t>(
-                std::max<std::size_t>(
-                    512, b_.capacity() - b_.size()),
-                std::min<std::size_t>(
-                    max_size, b_.max_size() - b_.size()));
+                max_size, b_.max_size() - b_.size());
             while(max_prepare > 0)
             {
                 BOOST_ASIO_CORO_YIELD
@@ -89,10 +86,7 @@ public:
                 total_ += bytes_transferred;
                 max_size = cond_(ec, total_, b_);
                 max_prepare = std::min<std::size_t>(
-                    std::max<std::size_t>(
-                        512, b_.capacity() - b_.size()),
-                    std::min<std::size_t>(
-                        max_size, b_.max_size() - b_.size()));
+                    max_size, b_.max_size() - b_.size());
             }
             if(! cont)
             {
@@ -191,9 +185,7 @@ public:
                     n = detail::min<std::size_t>(
                         limit_,
                         s_.available(),
-                        b_.max_size() - b_.size(),
-                        std::max<std::size_t>(
-                            512, b_.capacity() - b_.size()));
+                        b_.max_size() - b_.size());
                     BOOST_ASSERT(n > 0);
                     bytes_transferred = s_.read_some(
                         b_.prepare(n), ec);
@@ -361,10 +353,7 @@ read(
     std::size_t max_prepare;
     max_size = cond(ec, total, buffer);
     max_prepare = std::min<std::size_t>(
-        std::max<std::size_t>(
-            512, buffer.capacity() - buffer.size()),
-        std::min<std::size_t>(
-            max_size, buffer.max_size() - buffer.size()));
+        max_size, buffer.max_size() - buffer.size());
     while(max_prepare > 0)
     {
         std::size_t const bytes_transferred =
@@ -373,10 +362,7 @@ read(
         total += bytes_transferred;
         max_size = cond(ec, total, buffer);
         max_prepare = std::min<std::size_t>(
-            std::max<std::size_t>(
-                512, buffer.capacity() - buffer.size()),
-            std::min<std::size_t>(
-                max_size, buffer.max_size() - buffer.size()));
+            max_size, buffer.max_size() - buffer.size());
     }
     return total;
 }
@@ -449,9 +435,7 @@ read(
             n = detail::min<std::size_t>(
                 limit,
                 socket.available(),
-                buffer.max_size() - buffer.size(),
-                std::max<std::size_t>(
-                    512, buffer.capacity() - buffer.size()));
+                buffer.max_size() - buffer.size());
             BOOST_ASSERT(n > 0);
             bytes_transferred = socket.read_some(
                 buffer.prepare(n), ec);
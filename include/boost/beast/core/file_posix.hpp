@@ -30,6 +30,7 @@
 
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/file_base.hpp>
+#include <boost/asio/buffer.hpp>
 #include <cstdint>
 
 namespace boost {
@@ -41,6 +42,9 @@ namespace beast {
 */
 class file_posix
 {
+    // Maximum number of buffers in one gather write
+    static std::size_t constexpr max_iov = 16;
+
     int fd_ = -1;
 
     BOOST_BEAST_DECL
@@ -179,6 +183,44 @@ public:
     BOOST_BEAST_DECL
     std::size_t
     write(void const* buffer, std::size_t n, error_code& ec);
+
+    /** Write a buffer sequence to the open file
+
+        The buffers are written in order at the current position
+        using gather writes, so that a sequence with several
+        buffers is usually written with a single system call.
+
+        @param buffers The buffers holding the data to write
+
+        @param ec Set to the error, if any occurred
+
+        @return The number of bytes written
+    */
+    template<class ConstBufferSequence>
+    std::size_t
+    write(ConstBufferSequence const& buffers, error_code& ec);
+
+    /** Reserve storage for data which will be written to the file
+
+        This is a hint which lets the file system allocate the
+        storage for the data in one step, reducing fragmentation.
+        The size of the file is not changed. If the file system
+        does not support the operation, no error is reported.
+
+        @param n The number of bytes to reserve, starting at the
+        beginning of the file
+
+        @param ec Set to the error, if any occurred
+    */
+    BOOST_BEAST_DECL
+    void
+    preallocate(std::uint64_t n, error_code& ec);
+
+private:
+    BOOST_BEAST_DECL
+    std::size_t
+    write_some(net::const_buffer const* buffers,
+        std::size_t count, error_code& ec);
 };
 
 } // beast
@@ -24,7 +24,9 @@
 # endif
 #endif
 
+#include <boost/assert.hpp>
 #include <boost/core/exchange.hpp>
+#include <boost/core/ignore_unused.hpp>
 #include <limits>
 #include <fcntl.h>
 #include <sys/types.h>
@@ -308,6 +310,119 @@ write(void const* buffer, std::size_t n, error_code& ec)
     return nwritten;
 }
 
+template<class ConstBufferSequence>
+std::size_t
+file_posix::
+write(ConstBufferSequence const& buffers, error_code& ec)
+{
+    static_assert(net::is_const_buffer_sequence<
+        ConstBufferSequence>::value,
+            "ConstBufferSequence requirements not met");
+    ec = {};
+    net::const_buffer v[max_iov];
+    std::size_t count = 0;
+    std::size_t nwritten = 0;
+    for(auto it = net::buffer_sequence_begin(buffers);
+        it != net::buffer_sequence_end(buffers); ++it)
+    {
+        net::const_buffer const b = *it;
+        if(b.size() == 0)
+            continue;
+        v[count++] = b;
+        if(count < max_iov)
+            continue;
+        nwritten += write_some(v, count, ec);
+        if(ec)
+            return nwritten;
+        count = 0;
+    }
+    if(count > 0)
+        nwritten += write_some(v, count, ec);
+    return nwritten;
+}
+
+std::size_t
+file_posix::
+write_some(net::const_buffer const* buffers,
+    std::size_t count, error_code& ec)
+{
+    if(fd_ == -1)
+    {
+        ec = make_error_code(errc::bad_file_descriptor);
+        return 0;
+    }
+    BOOST_ASSERT(count <= max_iov);
+    ::iovec iov[max_iov];
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        iov[i].iov_base = const_cast<void*>(buffers[i].data());
+        iov[i].iov_len = buffers[i].size();
+    }
+    auto p = iov;
+    auto const last = iov + count;
+    std::size_t nwritten = 0;
+    while(p != last)
+    {
+        auto const result = ::writev(
+            fd_, p, static_cast<int>(last - p));
+        if(result == -1)
+        {
+            auto const ev = errno;
+            if(ev == EINTR)
+                continue;
+            ec.assign(ev, system_category());
+            return nwritten;
+        }
+        nwritten += result;
+        // skip what was written, resuming in the
+        // middle of a buffer after a short write
+        auto n = static_cast<std::size_t>(result);
+        while(p != last && n >= p->iov_len)
+        {
+            n -= p->iov_len;
+            ++p;
+        }
+        if(p != last)
+        {
+            p->iov_base = static_cast<char*>(p->iov_base) + n;
+            p->iov_len -= n;
+        }
+    }
+    return nwritten;
+}
+
+void
+file_posix::
+preallocate(std::uint64_t n, error_code& ec)
+{
+    if(fd_ == -1)
+    {
+        ec = make_error_code(errc::bad_file_descriptor);
+        return;
+    }
+    ec = {};
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+    if(n == 0)
+        return;
+    for(;;)
+    {
+        if(::fallocate(fd_, FALLOC_FL_KEEP_SIZE,
+                0, static_cast<off_t>(n)) == 0)
+            return;
+        auto const ev = errno;
+        if(ev == EINTR)
+            continue;
+        // not supported by this file system
+        if(ev == EOPNOTSUPP || ev == ENOSYS)
+            return;
+        ec.assign(ev, system_category());
+        return;
+    }
+#else
+    boost::ignore_unused(n);
+#endif
+}
+
 } // beast
 } // boost
 
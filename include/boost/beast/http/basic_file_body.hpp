@@ -15,6 +15,7 @@
 #include <boost/beast/core/file_base.hpp>
 #include <boost/beast/core/type_traits.hpp>
 #include <boost/beast/http/message.hpp>
+#include <boost/beast/http/detail/type_traits.hpp>
 #include <boost/assert.hpp>
 #include <boost/optional.hpp>
 #include <algorithm>
@@ -96,6 +97,9 @@ class basic_file_body<File>::value_type
     // The cached file size
     std::uint64_t file_size_ = 0;
 
+    // Reserve storage from the Content-Length when parsing
+    bool preallocate_ = false;
+
 public:
     /** Destructor.
 
@@ -126,6 +130,22 @@ public:
         return file_size_;
     }
 
+    /** Set whether storage is reserved for an incoming body.
+
+        When this option is set and the message being parsed has
+        a Content-Length, the reader asks the file system to
+        reserve storage for the whole body before writing to the
+        file, if the File type supports it. This reduces the
+        fragmentation of large uploads. The default is `false`.
+
+        @param v `true` to reserve storage or `false` to disable it.
+    */
+    void
+    preallocate(bool v)
+    {
+        preallocate_ = v;
+    }
+
     /// Close the file if open
     void
     close();
@@ -394,6 +414,22 @@ class basic_file_body<File>::reader
 {
     value_type& body_;  // The body we are writing to
 
+    void
+    preallocate(std::uint64_t n, error_code& ec, std::true_type);
+
+    void
+    preallocate(std::uint64_t n, error_code& ec, std::false_type);
+
+    template<class ConstBufferSequence>
+    std::size_t
+    put(ConstBufferSequence const& buffers,
+        error_code& ec, std::true_type);
+
+    template<class ConstBufferSequence>
+    std::size_t
+    put(ConstBufferSequence const& buffers,
+        error_code& ec, std::false_type);
+
 public:
     // Constructor.
     //
@@ -464,17 +500,34 @@ init(
     // The file must already be open for writing
     BOOST_ASSERT(body_.file_.is_open());
 
-    // We don't do anything with this but a sophisticated
-    // application might check available space on the device
-    // to see if there is enough room to store the body.
-    boost::ignore_unused(content_length);
-
     // The error_code specification requires that we
     // either set the error to some value, or set it
     // to indicate no error.
-    //
-    // We don't do anything fancy so set "no error"
     ec = {};
+
+    // If requested, and the size of the body is known, let
+    // the file system reserve the storage up front. This is
+    // only a hint, so a File without the ability is fine.
+    if(body_.preallocate_ && content_length)
+        preallocate(*content_length, ec, std::integral_constant<bool,
+            detail::has_file_preallocate<File>::value>{});
+}
+
+template<class File>
+void
+basic_file_body<File>::
+reader::
+preallocate(std::uint64_t n, error_code& ec, std::true_type)
+{
+    body_.file_.preallocate(n, ec);
+}
+
+template<class File>
+void
+basic_file_body<File>::
+reader::
+preallocate(std::uint64_t, error_code&, std::false_type)
+{
 }
 
 // This will get called one or more times with body buffers
@@ -485,6 +538,34 @@ std::size_t
 basic_file_body<File>::
 reader::
 put(ConstBufferSequence const& buffers, error_code& ec)
+{
+    return put(buffers, ec, std::integral_constant<bool,
+        detail::has_file_write_buffers<File, ConstBufferSequence>::value>{});
+}
+
+// The File can write the whole sequence at once, for example
+// with a gather write. The parser presents the body octets
+// still held in the caller's dynamic buffer, so they go to
+// the file without an intermediate copy.
+//
+template<class File>
+template<class ConstBufferSequence>
+std::size_t
+basic_file_body<File>::
+reader::
+put(ConstBufferSequence const& buffers,
+    error_code& ec, std::true_type)
+{
+    return body_.file_.write(buffers, ec);
+}
+
+template<class File>
+template<class ConstBufferSequence>
+std::size_t
+basic_file_body<File>::
+reader::
+put(ConstBufferSequence const& buffers,
+    error_code& ec, std::false_type)
 {
     // This function must return the total number of
     // bytes transferred from the input buffers.
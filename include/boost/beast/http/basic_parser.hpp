@@ -176,6 +176,9 @@ class basic_parser
     template<bool OtherIsRequest, class OtherDerived, class OtherProtocol>
     friend class basic_parser;
 
+    static_assert(is_protocol<Protocol>::value,
+        "Protocol requirements not met");
+
     // limit on the size of the stack flat buffer
     static std::size_t constexpr max_stack_buffer = 8192;
 
@@ -235,6 +238,31 @@ protected:
     template<class OtherDerived>
     basic_parser(basic_parser<isRequest, OtherDerived, Protocol>&&);
 
+    /** Prepare to receive body octets without calling @ref put.
+
+        This is used by derived classes which store body octets
+        read by the caller directly into the body. If the header
+        is complete, the body has a Content-Length, and octets of
+        the body remain, the body is initialized if needed and the
+        number of octets remaining is returned. Otherwise, zero is
+        returned and the octets must be presented with @ref put.
+
+        @param ec Set to the error, if any occurred.
+    */
+    std::uint64_t
+    direct_body_remaining(error_code& ec);
+
+    /** Account for body octets received without calling @ref put.
+
+        @param n The number of octets of the body received, which
+        may not exceed the value returned by the previous call to
+        @ref direct_body_remaining.
+
+        @param ec Set to the error, if any occurred.
+    */
+    void
+    direct_body_commit(std::size_t n, error_code& ec);
+
 public:
     /// `true` if this parser parses requests, `false` for responses.
     using is_request =
@@ -347,6 +375,18 @@ public:
     boost::optional<std::uint64_t>
     content_length() const;
 
+    /** Returns the number of body octets not yet parsed, if known.
+
+        When the message has a Content-Length, this is the number
+        of octets of the body which remain to be presented to the
+        parser. Otherwise, `boost::none` is returned.
+
+        @note The return value is undefined unless
+        @ref is_header_done would return `true`.
+    */
+    boost::optional<std::uint64_t>
+    content_length_remaining() const;
+
     /** Returns `true` if the message semantics require an end of file.
 
         Depending on the contents of the header, the parser may
@@ -497,7 +537,9 @@ public:
         message data. If the length of this buffer sequence is
         one, the implementation will not allocate additional memory.
         The class @ref beast::flat_buffer is provided as one way to
-        meet this requirement
+        meet this requirement. When the body is not chunked, body
+        octets in a longer buffer sequence are presented to the
+        derived class without being copied.
 
         @param ec Set to the error, if any occurred.
 
@@ -548,6 +590,21 @@ private:
         ConstBufferSequence const& buffers,
             error_code& ec);
 
+    template<class ConstBufferSequence>
+    std::size_t
+    put_body(ConstBufferSequence const& buffers,
+        error_code& ec);
+
+    // Called with a buffer sequence holding a portion of the
+    // body when there is no chunked transfer coding. A derived
+    // class may hide this to receive the buffers without the
+    // parser first copying them into contiguous storage.
+    template<class ConstBufferSequence>
+    std::size_t
+    on_body_buffers_impl(
+        ConstBufferSequence const& buffers,
+        error_code& ec);
+
     void
     maybe_need_more(
         char const* p, std::size_t n,
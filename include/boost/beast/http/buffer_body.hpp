@@ -14,7 +14,10 @@
 #include <boost/beast/http/error.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/type_traits.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/assert.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
 #include <type_traits>
 #include <utility>
 
@@ -141,6 +144,29 @@ struct buffer_body
             return bytes_transferred;
         }
 
+        net::mutable_buffer
+        prepare(std::size_t n, error_code& ec)
+        {
+            if(! body_.data || body_.size == 0)
+            {
+                ec = error::need_buffer;
+                return {};
+            }
+            ec = {};
+            return net::mutable_buffer(body_.data,
+                (std::min)(n, body_.size));
+        }
+
+        void
+        commit(std::size_t n, error_code& ec)
+        {
+            BOOST_ASSERT(n <= body_.size);
+            body_.data = static_cast<char*>(
+                body_.data) + n;
+            body_.size -= n;
+            ec = {};
+        }
+
         void
         finish(error_code& ec)
         {
@@ -0,0 +1,261 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_DEFLATE_BODY_HPP
+#define BOOST_BEAST_HTTP_DEFLATE_BODY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/type_traits.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A @b Body which applies a deflate based content coding to another body.
+
+    This body adapts another @b Body, compressing the octets
+    produced by its writer when serializing, and decompressing
+    the received octets before passing them to its reader when
+    parsing. The message body container is the same as that of
+    the adapted body.
+
+    When `isGzip` is `true` the "gzip" content coding of
+    rfc7230 section 4.2.3 is used: the compressed data is
+    preceded by a gzip member header and followed by the
+    CRC-32 and length trailer of rfc1952. Otherwise the
+    "deflate" content coding of rfc7230 section 4.2.2 is used,
+    which is the zlib format of rfc1950 with an Adler-32
+    trailer.
+
+    The size of the compressed payload is not known in advance,
+    so this body does not provide a `size` function, and
+    @ref message::prepare_payload will select the chunked
+    Transfer-Encoding for HTTP/1.1 messages. The caller is
+    responsible for setting the Content-Encoding field.
+
+    When parsing, the reader of the adapted body is initialized
+    without a content length, and is expected to accept all of
+    the decompressed octets presented to it.
+
+    @tparam Body The body type to adapt.
+
+    @tparam isGzip `true` for the gzip coding, `false` for deflate.
+*/
+template<class Body, bool isGzip>
+struct basic_deflate_body
+{
+    static_assert(is_body<Body>::value,
+        "Body requirements not met");
+
+    /// The adapted body type
+    using body_type = Body;
+
+    /** The type of container used for the body
+
+        This determines the type of @ref message::body
+        when this body type is used with a message container.
+    */
+    using value_type = typename Body::value_type;
+
+    /** The algorithm for parsing the body
+
+        Meets the requirements of @b BodyReader.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using reader = __implementation_defined__;
+#else
+    class reader;
+#endif
+
+    /** The algorithm for serializing the body
+
+        Meets the requirements of @b BodyWriter.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using writer = __implementation_defined__;
+#else
+    class writer;
+#endif
+};
+
+#if ! BOOST_BEAST_DOXYGEN
+
+template<class Body, bool isGzip>
+class basic_deflate_body<Body, isGzip>::writer
+{
+    enum class state
+    {
+        header,
+        body,
+        finish,
+        trailer,
+        done
+    };
+
+    using inner_buffers_type =
+        typename Body::writer::const_buffers_type;
+
+    typename Body::writer wr_;
+    zlib::deflate_stream ds_;
+    boost::optional<buffers_suffix<inner_buffers_type>> in_;
+    error_code ec_;             // deferred error from wr_
+    std::uint32_t check_;       // CRC-32 or Adler-32 of the input
+    std::uint32_t size_ = 0;    // input size modulo 2^32
+    int level_ = 6;
+    state s_ = state::header;
+    bool more_ = true;          // wr_ may produce more buffers
+    char buf_[4096];            // compressed output
+
+    template<bool isRequest, class Fields>
+    using is_const_constructible = std::is_constructible<
+        typename Body::writer,
+        header<isRequest, Fields> const&,
+        value_type const&>;
+
+    std::size_t
+    write_header(char* p);
+
+    std::size_t
+    write_trailer(char* p);
+
+public:
+    using const_buffers_type =
+        net::const_buffer;
+
+    template<bool isRequest, class Fields,
+        class = typename std::enable_if<
+            is_const_constructible<isRequest, Fields>::value>::type>
+    writer(header<isRequest, Fields> const& h, value_type const& b)
+        : wr_(h, b)
+    {
+    }
+
+    template<bool isRequest, class Fields,
+        class = typename std::enable_if<
+            ! is_const_constructible<isRequest, Fields>::value>::type>
+    writer(header<isRequest, Fields>& h, value_type& b)
+        : wr_(h, b)
+    {
+    }
+
+    /** Set the compression level.
+
+        This must be called before serialization begins.
+
+        @param level A value from 0 (no compression)
+        to 9 (best compression). The default is 6.
+    */
+    void
+    level(int level)
+    {
+        level_ = level;
+    }
+
+    void
+    init(error_code& ec);
+
+    boost::optional<std::pair<const_buffers_type, bool>>
+    get(error_code& ec);
+};
+
+template<class Body, bool isGzip>
+class basic_deflate_body<Body, isGzip>::reader
+{
+    enum class state
+    {
+        header,
+        extra_length,
+        extra,
+        name,
+        comment,
+        header_crc,
+        body,
+        trailer,
+        done
+    };
+
+    typename Body::reader rd_;
+    zlib::inflate_stream is_;
+    std::uint32_t check_;       // CRC-32 or Adler-32 of the output
+    std::uint32_t size_ = 0;    // output size modulo 2^32
+    std::uint32_t value_ = 0;   // field being accumulated
+    std::size_t need_ = 0;      // octets left in the current state
+    unsigned char flags_ = 0;   // gzip FLG
+    state s_ = state::header;
+    char buf_[4096];            // decompressed output
+
+    std::size_t
+    put_header(unsigned char const* p, std::size_t n, error_code& ec);
+
+    std::size_t
+    put_body(unsigned char const* p, std::size_t n, error_code& ec);
+
+    std::size_t
+    put_trailer(unsigned char const* p, std::size_t n, error_code& ec);
+
+    void
+    start(state s, std::size_t need)
+    {
+        s_ = s;
+        need_ = need;
+        value_ = 0;
+    }
+
+public:
+    template<bool isRequest, class Fields>
+    explicit
+    reader(header<isRequest, Fields>& h, value_type& b)
+        : rd_(h, b)
+    {
+    }
+
+    void
+    init(boost::optional<std::uint64_t> const&, error_code& ec);
+
+    template<class ConstBufferSequence>
+    std::size_t
+    put(ConstBufferSequence const& buffers, error_code& ec);
+
+    void
+    finish(error_code& ec);
+};
+
+#endif
+
+/** A @b Body which applies the "deflate" content coding to another body.
+
+    @see basic_deflate_body
+*/
+template<class Body>
+using deflate_body = basic_deflate_body<Body, false>;
+
+/** A @b Body which applies the "gzip" content coding to another body.
+
+    @see basic_deflate_body
+*/
+template<class Body>
+using gzip_body = basic_deflate_body<Body, true>;
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/deflate_body.ipp>
+
+#endif
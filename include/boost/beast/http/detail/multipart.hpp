@@ -0,0 +1,84 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_DETAIL_MULTIPART_HPP
+#define BOOST_BEAST_HTTP_DETAIL_MULTIPART_HPP
+
+#include <boost/beast/core/detail/cpu_info.hpp>
+#include <cstddef>
+#include <cstring>
+
+#if ! BOOST_BEAST_NO_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+namespace boost {
+namespace beast {
+namespace http {
+namespace detail {
+
+/*  Return a pointer to the first position in [first, last)
+    which could begin a multipart delimiter, or `last`.
+
+    Every delimiter inside a body starts with "\r\n--", so
+    a candidate is a CR whose third following octet is '-'
+    when that octet is present. Candidates near the end of
+    the range, where the following octets are not all
+    present, are always returned.
+*/
+inline
+char const*
+find_multipart_delimiter(char const* first, char const* last)
+{
+#if ! BOOST_BEAST_NO_INTRINSICS
+    // Test 16 positions at a time, matching CR at
+    // each position and '-' three octets later.
+    __m128i const cr = _mm_set1_epi8('\r');
+    __m128i const dash = _mm_set1_epi8('-');
+    while(last - first >= 16 + 3)
+    {
+        auto const m0 = _mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<
+                __m128i const*>(first)), cr));
+        auto const m3 = _mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<
+                __m128i const*>(first + 3)), dash));
+        auto mask = static_cast<unsigned>(m0 & m3);
+        if(mask != 0)
+        {
+            while((mask & 1) == 0)
+            {
+                mask >>= 1;
+                ++first;
+            }
+            return first;
+        }
+        first += 16;
+    }
+#endif
+    for(;;)
+    {
+        if(first == last)
+            return last;
+        auto const p = static_cast<char const*>(
+            std::memchr(first, '\r', last - first));
+        if(! p)
+            return last;
+        if(last - p < 4 || p[3] == '-')
+            return p;
+        first = p + 1;
+    }
+}
+
+} // detail
+} // http
+} // beast
+} // boost
+
+#endif
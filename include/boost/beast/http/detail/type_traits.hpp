@@ -10,7 +10,9 @@
 #ifndef BOOST_BEAST_HTTP_DETAIL_TYPE_TRAITS_HPP
 #define BOOST_BEAST_HTTP_DETAIL_TYPE_TRAITS_HPP
 
+#include <boost/beast/core/error.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
+#include <boost/asio/buffer.hpp>
 #include <boost/optional.hpp>
 #include <cstdint>
 
@@ -96,6 +98,60 @@ struct is_body_sized<T, beast::detail::void_t<
         T::size(std::declval<typename T::value_type const&>())
     )>> : std::true_type {};
 
+/** Determine if a File can write a buffer sequence in one call.
+
+    This metafunction is equivalent to `std::true_type` if File
+    has a member function `write` accepting a buffer sequence
+    and an error code, such as a gather write.
+*/
+template<class File, class ConstBufferSequence, class = void>
+struct has_file_write_buffers : std::false_type {};
+
+template<class File, class ConstBufferSequence>
+struct has_file_write_buffers<File, ConstBufferSequence,
+    beast::detail::void_t<decltype(
+    std::declval<std::size_t&>() =
+        std::declval<File&>().write(
+            std::declval<ConstBufferSequence const&>(),
+            std::declval<error_code&>())
+    )>> : std::true_type {};
+
+/** Determine if a File can reserve storage ahead of writing.
+
+    This metafunction is equivalent to `std::true_type` if File
+    has a member function `preallocate` accepting a size and an
+    error code.
+*/
+template<class File, class = void>
+struct has_file_preallocate : std::false_type {};
+
+template<class File>
+struct has_file_preallocate<File, beast::detail::void_t<decltype(
+    std::declval<File&>().preallocate(
+        std::declval<std::uint64_t>(),
+        std::declval<error_code&>())
+    )>> : std::true_type {};
+
+/** Determine if a BodyReader can store octets read directly.
+
+    This metafunction is equivalent to `std::true_type` if the
+    reader has the optional member functions `prepare`, returning
+    storage in the body, and `commit`.
+*/
+template<class Reader, class = void>
+struct has_direct_reader : std::false_type {};
+
+template<class Reader>
+struct has_direct_reader<Reader, beast::detail::void_t<decltype(
+    std::declval<net::mutable_buffer&>() =
+        std::declval<Reader&>().prepare(
+            std::declval<std::size_t>(),
+            std::declval<error_code&>()),
+    std::declval<Reader&>().commit(
+        std::declval<std::size_t>(),
+        std::declval<error_code&>())
+    )>> : std::true_type {};
+
 template<class T>
 struct is_fields_helper : T
 {
@@ -144,7 +144,13 @@ enum class error
     bad_chunk_extension,
 
     /// An obs-fold exceeded an internal limit.
-    bad_obs_fold
+    bad_obs_fold,
+
+    /// The content coding framing or checksum is invalid.
+    bad_content_coding,
+
+    /// The multipart body framing is invalid.
+    bad_multipart
 };
 
 } // http
@@ -397,6 +397,20 @@ to_string(field f);
 field
 default_string_to_field(string_view s);
 
+/** Attempt to convert a string to a field enum.
+
+    The string comparison is case-insensitive.
+
+    @return The corresponding field, or @ref field::unknown
+    if no known field matches.
+*/
+inline
+field
+string_to_field(string_view s)
+{
+    return default_string_to_field(s);
+}
+
 /// Write the text for a field name to an output stream.
 inline
 std::ostream&
@@ -15,7 +15,7 @@
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/core/detail/allocator.hpp>
 #include <boost/beast/http/field.hpp>
-#include "boost/beast/http/protocol.hpp"
+#include <boost/beast/http/protocol.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/core/empty_value.hpp>
 #include <boost/intrusive/list.hpp>
@@ -62,6 +62,9 @@ class basic_fields
         std::allocator_traits<Allocator>::pointer>::value,
         "Allocator must use regular pointers");
 
+    static_assert(is_protocol<Protocol>::value,
+        "Protocol requirements not met");
+
     friend class fields_test; // for `header`
 
     static std::size_t constexpr max_static_buffer = 4096;
@@ -550,10 +553,10 @@ public:
     swap(basic_fields& other);
 
     /// Swap two field containers
-    template<class Alloc>
+    template<class Alloc, class Proto>
     friend
     void
-    swap(basic_fields<Alloc>& lhs, basic_fields<Alloc>& rhs);
+    swap(basic_fields<Alloc, Proto>& lhs, basic_fields<Alloc, Proto>& rhs);
 
     //--------------------------------------------------------------------------
     //
@@ -10,6 +10,7 @@
 #ifndef BOOST_BEAST_HTTP_IMPL_BASIC_PARSER_IPP
 #define BOOST_BEAST_HTTP_IMPL_BASIC_PARSER_IPP
 
+#include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/beast/core/static_string.hpp>
 #include <boost/beast/core/type_traits.hpp>
 #include <boost/beast/core/detail/clamp.hpp>
@@ -76,6 +77,52 @@ content_length() const
     return len_;
 }
 
+template<bool isRequest, class Derived, class Protocol>
+std::uint64_t
+basic_parser<isRequest, Derived, Protocol>::
+direct_body_remaining(error_code& ec)
+{
+    ec = {};
+    if(state_ == state::body0)
+    {
+        impl().on_body_init_impl(content_length(), ec);
+        if(ec)
+            return 0;
+        state_ = state::body;
+    }
+    if(state_ != state::body)
+        return 0;
+    return len_;
+}
+
+template<bool isRequest, class Derived, class Protocol>
+void
+basic_parser<isRequest, Derived, Protocol>::
+direct_body_commit(std::size_t n, error_code& ec)
+{
+    BOOST_ASSERT(state_ == state::body);
+    BOOST_ASSERT(n <= len_);
+    ec = {};
+    len_ -= n;
+    if(len_ > 0)
+        return;
+    impl().on_finish_impl(ec);
+    if(ec)
+        return;
+    state_ = state::complete;
+}
+
+template<bool isRequest, class Derived, class Protocol>
+boost::optional<std::uint64_t>
+basic_parser<isRequest, Derived, Protocol>::
+content_length_remaining() const
+{
+    BOOST_ASSERT(is_header_done());
+    if(! (f_ & flagContentLength))
+        return boost::none;
+    return len_;
+}
+
 template<bool isRequest, class Derived, class Protocol>
 void
 basic_parser<isRequest, Derived, Protocol>::
@@ -112,6 +159,9 @@ put(ConstBufferSequence const& buffers,
         // single buffer
         return put(net::const_buffer(*p), ec);
     }
+    if( state_ == state::body0 || state_ == state::body ||
+        state_ == state::body_to_eof0 || state_ == state::body_to_eof)
+        return put_body(buffers, ec);
     auto const size = buffer_size(buffers);
     if(size <= max_stack_buffer)
         return put_from_stack(size, buffers, ec);
@@ -315,6 +365,68 @@ put_from_stack(std::size_t size,
         buf, size}, ec);
 }
 
+template<bool isRequest, class Derived, class Protocol>
+template<class ConstBufferSequence>
+std::size_t
+basic_parser<isRequest, Derived, Protocol>::
+put_body(ConstBufferSequence const& buffers,
+    error_code& ec)
+{
+    ec = {};
+    if(state_ == state::body0 || state_ == state::body_to_eof0)
+    {
+        impl().on_body_init_impl(content_length(), ec);
+        if(ec)
+            return 0;
+        state_ = state_ == state::body0 ?
+            state::body : state::body_to_eof;
+    }
+    std::size_t n;
+    if(state_ == state::body)
+    {
+        n = impl().on_body_buffers_impl(buffers_prefix(
+            beast::detail::clamp(len_), buffers), ec);
+        len_ -= n;
+        if(ec || len_ > 0)
+            return n;
+        impl().on_finish_impl(ec);
+        if(ec)
+            return n;
+        state_ = state::complete;
+        return n;
+    }
+    auto const size = net::buffer_size(buffers);
+    if(size > body_limit_)
+    {
+        ec = error::body_limit;
+        return 0;
+    }
+    body_limit_ = body_limit_ - size;
+    return impl().on_body_buffers_impl(buffers, ec);
+}
+
+template<bool isRequest, class Derived, class Protocol>
+template<class ConstBufferSequence>
+std::size_t
+basic_parser<isRequest, Derived, Protocol>::
+on_body_buffers_impl(
+    ConstBufferSequence const& buffers,
+    error_code& ec)
+{
+    std::size_t total = 0;
+    for(auto it = net::buffer_sequence_begin(buffers);
+        it != net::buffer_sequence_end(buffers); ++it)
+    {
+        net::const_buffer b = *it;
+        auto const n = impl().on_body_impl(string_view{
+            static_cast<char const*>(b.data()), b.size()}, ec);
+        total += n;
+        if(ec || n < b.size())
+            break;
+    }
+    return total;
+}
+
 template<bool isRequest, class Derived, class Protocol>
 inline
 void
@@ -542,6 +654,12 @@ finish_header(error_code& ec, std::true_type)
         f_ |= flagHasBody;
         state_ = state::chunk_header0;
     }
+    else if(Protocol::request_body_to_eof())
+    {
+        f_ |= flagHasBody;
+        f_ |= flagNeedEOF;
+        state_ = state::body_to_eof0;
+    }
     else
     {
         len_ = 0;
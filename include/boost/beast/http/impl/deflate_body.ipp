@@ -0,0 +1,546 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_DEFLATE_BODY_IPP
+#define BOOST_BEAST_HTTP_IMPL_DEFLATE_BODY_IPP
+
+#include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/zlib/detail/checksum.hpp>
+#include <boost/assert.hpp>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+namespace detail {
+
+// gzip uses CRC-32, the zlib format uses Adler-32
+
+inline
+std::uint32_t
+deflate_body_check(std::true_type)
+{
+    return 0;
+}
+
+inline
+std::uint32_t
+deflate_body_check(std::false_type)
+{
+    return 1;
+}
+
+inline
+std::uint32_t
+deflate_body_check(std::true_type,
+    std::uint32_t check, void const* p, std::size_t n)
+{
+    return zlib::detail::crc32(check, p, n);
+}
+
+inline
+std::uint32_t
+deflate_body_check(std::false_type,
+    std::uint32_t check, void const* p, std::size_t n)
+{
+    return zlib::detail::adler32(check, p, n);
+}
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+template<class Body, bool isGzip>
+std::size_t
+basic_deflate_body<Body, isGzip>::
+writer::
+write_header(char* p)
+{
+    if(isGzip)
+    {
+        // rfc1952 section 2.3, no optional fields
+        p[0] = static_cast<char>(0x1f);             // ID1
+        p[1] = static_cast<char>(0x8b);             // ID2
+        p[2] = 8;                                   // CM = deflate
+        p[3] = 0;                                   // FLG
+        p[4] = 0; p[5] = 0; p[6] = 0; p[7] = 0;     // MTIME
+        p[8] = static_cast<char>(                   // XFL
+            level_ >= 9 ? 2 : (level_ == 1 ? 4 : 0));
+        p[9] = static_cast<char>(0xff);             // OS = unknown
+        return 10;
+    }
+    // rfc1950 section 2.2, 32K window, no dictionary
+    unsigned const cmf = 0x78;
+    unsigned const flevel =
+        level_ < 2 ? 0 : level_ < 6 ? 1 : level_ == 6 ? 2 : 3;
+    unsigned flg = flevel << 6;
+    flg += 31 - ((cmf << 8) + flg) % 31;
+    p[0] = static_cast<char>(cmf);
+    p[1] = static_cast<char>(flg);
+    return 2;
+}
+
+template<class Body, bool isGzip>
+std::size_t
+basic_deflate_body<Body, isGzip>::
+writer::
+write_trailer(char* p)
+{
+    if(isGzip)
+    {
+        // CRC32 and ISIZE, least significant byte first
+        for(int i = 0; i < 4; ++i)
+            p[i] = static_cast<char>(check_ >> (8 * i));
+        for(int i = 0; i < 4; ++i)
+            p[4 + i] = static_cast<char>(size_ >> (8 * i));
+        return 8;
+    }
+    // ADLER32, most significant byte first
+    for(int i = 0; i < 4; ++i)
+        p[i] = static_cast<char>(check_ >> (24 - 8 * i));
+    return 4;
+}
+
+template<class Body, bool isGzip>
+void
+basic_deflate_body<Body, isGzip>::
+writer::
+init(error_code& ec)
+{
+    wr_.init(ec);
+    if(ec)
+        return;
+    ds_.reset(level_, 15, 8, zlib::Strategy::normal);
+    check_ = detail::deflate_body_check(
+        std::integral_constant<bool, isGzip>{});
+    size_ = 0;
+    s_ = state::header;
+    more_ = true;
+    in_ = boost::none;
+    ec_ = {};
+}
+
+template<class Body, bool isGzip>
+auto
+basic_deflate_body<Body, isGzip>::
+writer::
+get(error_code& ec) ->
+    boost::optional<std::pair<const_buffers_type, bool>>
+{
+    if(ec_)
+    {
+        // report the error held back from the previous call
+        ec = ec_;
+        ec_ = {};
+        return boost::none;
+    }
+    if(s_ == state::done)
+    {
+        ec = {};
+        return boost::none;
+    }
+    zlib::z_params zs;
+    zs.next_in = nullptr;
+    zs.avail_in = 0;
+    zs.next_out = buf_;
+    zs.avail_out = sizeof(buf_);
+    auto const produced =
+        [&]
+        {
+            return sizeof(buf_) - zs.avail_out;
+        };
+    auto const advance =
+        [&](std::size_t n)
+        {
+            zs.next_out = static_cast<char*>(zs.next_out) + n;
+            zs.avail_out -= n;
+            zs.total_out += n;
+        };
+    while(zs.avail_out > 0 && s_ != state::done)
+    {
+        switch(s_)
+        {
+        case state::header:
+            advance(write_header(buf_));
+            s_ = state::body;
+            break;
+
+        case state::body:
+        {
+            if(! in_)
+            {
+                if(! more_)
+                {
+                    s_ = state::finish;
+                    break;
+                }
+                auto result = wr_.get(ec);
+                if(ec)
+                {
+                    if(produced() == 0 || (
+                        ec != error::need_buffer &&
+                        ec != error::need_more))
+                        return boost::none;
+                    // deliver what we have first
+                    ec_ = ec;
+                    ec = {};
+                    return {{const_buffers_type{
+                        buf_, produced()}, true}};
+                }
+                if(! result)
+                {
+                    more_ = false;
+                    s_ = state::finish;
+                    break;
+                }
+                more_ = result->second;
+                in_.emplace(result->first);
+            }
+            if(net::buffer_size(*in_) == 0)
+            {
+                in_ = boost::none;
+                break;
+            }
+            net::const_buffer b;
+            for(auto const cb : beast::buffers_range(*in_))
+            {
+                if(cb.size() > 0)
+                {
+                    b = cb;
+                    break;
+                }
+            }
+            zs.next_in = b.data();
+            zs.avail_in = b.size();
+            ds_.write(zs, zlib::Flush::none, ec);
+            if(ec && ec != zlib::error::need_buffers)
+                return boost::none;
+            ec = {};
+            auto const n = b.size() - zs.avail_in;
+            check_ = detail::deflate_body_check(
+                std::integral_constant<bool, isGzip>{},
+                    check_, b.data(), n);
+            size_ += static_cast<std::uint32_t>(n);
+            in_->consume(n);
+            break;
+        }
+
+        case state::finish:
+            zs.next_in = nullptr;
+            zs.avail_in = 0;
+            ds_.write(zs, zlib::Flush::finish, ec);
+            if(ec == zlib::error::end_of_stream)
+            {
+                s_ = state::trailer;
+            }
+            else if(ec && ec != zlib::error::need_buffers)
+            {
+                return boost::none;
+            }
+            ec = {};
+            break;
+
+        case state::trailer:
+            if(zs.avail_out < 8)
+                goto out;
+            advance(write_trailer(
+                static_cast<char*>(zs.next_out)));
+            s_ = state::done;
+            break;
+
+        default:
+            break;
+        }
+    }
+out:
+    BOOST_ASSERT(produced() > 0);
+    ec = {};
+    return {{const_buffers_type{buf_, produced()},
+        s_ != state::done}};
+}
+
+//------------------------------------------------------------------------------
+
+template<class Body, bool isGzip>
+void
+basic_deflate_body<Body, isGzip>::
+reader::
+init(boost::optional<std::uint64_t> const&, error_code& ec)
+{
+    // The decompressed length is not known
+    rd_.init(boost::none, ec);
+    if(ec)
+        return;
+    is_.reset(15);
+    check_ = detail::deflate_body_check(
+        std::integral_constant<bool, isGzip>{});
+    size_ = 0;
+    flags_ = 0;
+    start(state::header, isGzip ? 10 : 2);
+}
+
+template<class Body, bool isGzip>
+std::size_t
+basic_deflate_body<Body, isGzip>::
+reader::
+put_header(
+    unsigned char const* p, std::size_t n, error_code& ec)
+{
+    auto const next =
+        [&]
+        {
+            // select the next optional gzip header field
+            if(flags_ & 0x04)
+            {
+                flags_ &= ~0x04;
+                start(state::extra_length, 2);
+            }
+            else if(flags_ & 0x08)
+            {
+                flags_ &= ~0x08;
+                start(state::name, 0);
+            }
+            else if(flags_ & 0x10)
+            {
+                flags_ &= ~0x10;
+                start(state::comment, 0);
+            }
+            else if(flags_ & 0x02)
+            {
+                flags_ &= ~0x02;
+                start(state::header_crc, 2);
+            }
+            else
+            {
+                start(state::body, 0);
+            }
+        };
+    std::size_t i = 0;
+    while(i < n && s_ != state::body)
+    {
+        auto const c = p[i++];
+        switch(s_)
+        {
+        case state::header:
+        {
+            if(! isGzip)
+            {
+                value_ = (value_ << 8) | c;
+                if(--need_ > 0)
+                    break;
+                // rfc1950 section 2.2
+                if((value_ & 0x0f00) != 0x0800 ||
+                    (value_ >> 12) > 7 ||
+                    (value_ & 0x20) != 0 ||
+                    value_ % 31 != 0)
+                {
+                    ec = error::bad_content_coding;
+                    return i;
+                }
+                start(state::body, 0);
+                break;
+            }
+            // rfc1952 section 2.3
+            auto const pos = 10 - need_;
+            if( (pos == 0 && c != 0x1f) ||
+                (pos == 1 && c != 0x8b) ||
+                (pos == 2 && c != 8) ||
+                (pos == 3 && (c & 0xe0) != 0))
+            {
+                ec = error::bad_content_coding;
+                return i;
+            }
+            if(pos == 3)
+                flags_ = c;
+            if(--need_ == 0)
+                next();
+            break;
+        }
+
+        case state::extra_length:
+            value_ |= static_cast<std::uint32_t>(c) << (8 * (2 - need_));
+            if(--need_ > 0)
+                break;
+            if(value_ == 0)
+                next();
+            else
+                start(state::extra, value_);
+            break;
+
+        case state::extra:
+        case state::header_crc:
+            if(--need_ == 0)
+                next();
+            break;
+
+        case state::name:
+        case state::comment:
+            if(c == 0)
+                next();
+            break;
+
+        default:
+            BOOST_ASSERT(false);
+            break;
+        }
+    }
+    return i;
+}
+
+template<class Body, bool isGzip>
+std::size_t
+basic_deflate_body<Body, isGzip>::
+reader::
+put_body(
+    unsigned char const* p, std::size_t n, error_code& ec)
+{
+    zlib::z_params zs;
+    zs.next_in = p;
+    zs.avail_in = n;
+    for(;;)
+    {
+        auto const avail_in = zs.avail_in;
+        zs.next_out = buf_;
+        zs.avail_out = sizeof(buf_);
+        is_.write(zs, zlib::Flush::none, ec);
+        auto const eos = ec == zlib::error::end_of_stream;
+        if(ec && ! eos && ec != zlib::error::need_buffers)
+            return n - zs.avail_in;
+        ec = {};
+        auto const produced = sizeof(buf_) - zs.avail_out;
+        if(produced > 0)
+        {
+            check_ = detail::deflate_body_check(
+                std::integral_constant<bool, isGzip>{},
+                    check_, buf_, produced);
+            size_ += static_cast<std::uint32_t>(produced);
+            rd_.put(net::const_buffer{buf_, produced}, ec);
+            if(ec)
+                return n - zs.avail_in;
+        }
+        if(eos)
+        {
+            start(state::trailer, isGzip ? 8 : 4);
+            break;
+        }
+        if(zs.avail_out > 0 && (zs.avail_in == 0 || (
+            produced == 0 && zs.avail_in == avail_in)))
+            break;
+    }
+    return n - zs.avail_in;
+}
+
+template<class Body, bool isGzip>
+std::size_t
+basic_deflate_body<Body, isGzip>::
+reader::
+put_trailer(
+    unsigned char const* p, std::size_t n, error_code& ec)
+{
+    std::size_t i = 0;
+    while(i < n && need_ > 0)
+    {
+        auto const c = static_cast<std::uint32_t>(p[i++]);
+        --need_;
+        if(isGzip)
+        {
+            // CRC32 then ISIZE, least significant byte first
+            auto const pos = 7 - need_;
+            value_ |= c << (8 * (pos % 4));
+            if(pos == 3)
+            {
+                if(value_ != check_)
+                {
+                    ec = error::bad_content_coding;
+                    return i;
+                }
+                value_ = 0;
+            }
+            else if(pos == 7 && value_ != size_)
+            {
+                ec = error::bad_content_coding;
+                return i;
+            }
+        }
+        else
+        {
+            // ADLER32, most significant byte first
+            value_ = (value_ << 8) | c;
+            if(need_ == 0 && value_ != check_)
+            {
+                ec = error::bad_content_coding;
+                return i;
+            }
+        }
+    }
+    if(need_ == 0)
+        s_ = state::done;
+    return i;
+}
+
+template<class Body, bool isGzip>
+template<class ConstBufferSequence>
+std::size_t
+basic_deflate_body<Body, isGzip>::
+reader::
+put(ConstBufferSequence const& buffers, error_code& ec)
+{
+    ec = {};
+    std::size_t total = 0;
+    for(auto const b : beast::buffers_range(buffers))
+    {
+        auto p = static_cast<unsigned char const*>(b.data());
+        auto n = b.size();
+        while(n > 0 && s_ != state::done)
+        {
+            std::size_t used;
+            switch(s_)
+            {
+            case state::body:
+                used = put_body(p, n, ec);
+                break;
+            case state::trailer:
+                used = put_trailer(p, n, ec);
+                break;
+            default:
+                used = put_header(p, n, ec);
+                break;
+            }
+            total += used;
+            p += used;
+            n -= used;
+            if(ec)
+                return total;
+        }
+        // octets following the coded content are discarded
+        total += n;
+    }
+    return total;
+}
+
+template<class Body, bool isGzip>
+void
+basic_deflate_body<Body, isGzip>::
+reader::
+finish(error_code& ec)
+{
+    if(s_ != state::done)
+    {
+        ec = error::partial_message;
+        return;
+    }
+    rd_.finish(ec);
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -63,6 +63,8 @@ public:
         case error::bad_chunk: return "bad chunk";
         case error::bad_chunk_extension: return "bad chunk extension";
         case error::bad_obs_fold: return "bad obs-fold";
+        case error::bad_content_coding: return "bad content coding";
+        case error::bad_multipart: return "bad multipart";
 
         default:
             return "beast.http error";
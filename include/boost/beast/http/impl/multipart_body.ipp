@@ -0,0 +1,346 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_MULTIPART_BODY_IPP
+#define BOOST_BEAST_HTTP_IMPL_MULTIPART_BODY_IPP
+
+#include <boost/beast/http/detail/multipart.hpp>
+#include <boost/beast/http/rfc7230.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+inline
+string_view
+multipart_body::
+reader::
+get_boundary(string_view content_type)
+{
+    // media-type = type "/" subtype *( OWS ";" OWS parameter )
+    auto const semi = content_type.find(';');
+    if(semi == string_view::npos)
+        return {};
+    auto type = content_type.substr(0, semi);
+    while(! type.empty() && (type.back() == ' ' || type.back() == '\t'))
+        type.remove_suffix(1);
+    if(type.size() <= 10 || ! iequals(type.substr(0, 10), "multipart/"))
+        return {};
+    for(auto const& param : param_list{content_type.substr(semi)})
+    {
+        if(! iequals(param.first, "boundary"))
+            continue;
+        auto v = param.second;
+        if(v.size() >= 2 && v.front() == '"')
+        {
+            // the boundary characters of rfc2046
+            // do not include quoted-pair
+            v.remove_prefix(1);
+            v.remove_suffix(1);
+        }
+        if(v.size() > 70)
+            return {};
+        return v;
+    }
+    return {};
+}
+
+inline
+void
+multipart_body::
+reader::
+init(boost::optional<std::uint64_t> const&, error_code& ec)
+{
+    auto const boundary = get_boundary(content_type_(h_));
+    if(boundary.empty())
+    {
+        ec = error::bad_multipart;
+        return;
+    }
+    delim_.reserve(4 + boundary.size());
+    delim_.assign("\r\n--", 4);
+    delim_.append(boundary.data(), boundary.size());
+    // The first delimiter may appear at the very beginning
+    // of the payload, without the preceding CRLF. Act as if
+    // the CRLF was already matched, the preamble is discarded.
+    match_ = 2;
+    s_ = state::preamble;
+    ec = {};
+}
+
+inline
+void
+multipart_body::
+reader::
+put_data(char const* p, std::size_t n, error_code& ec)
+{
+    if(n == 0 || s_ != state::body || ! body_.cb_b_)
+        return;
+    body_.cb_b_(string_view{p, n}, ec);
+}
+
+inline
+void
+multipart_body::
+reader::
+end_part(error_code& ec)
+{
+    if(s_ == state::body)
+    {
+        ++body_.parts_;
+        if(body_.cb_e_)
+            body_.cb_e_(ec);
+    }
+    s_ = state::delimiter;
+}
+
+inline
+std::size_t
+multipart_body::
+reader::
+put_header(char const* p, std::size_t n, error_code& ec)
+{
+    auto const size0 = hdr_.size();
+    auto const limit = body_.header_limit_;
+    auto const m = (std::min)(n,
+        limit > size0 ? limit - size0 : 0);
+    hdr_.append(p, m);
+    std::size_t end = 0;
+    if(hdr_.size() >= 2 && hdr_[0] == '\r' && hdr_[1] == '\n')
+    {
+        // no fields
+        end = 2;
+    }
+    else
+    {
+        auto const pos = hdr_.find("\r\n\r\n",
+            size0 > 3 ? size0 - 3 : 0, 4);
+        if(pos != std::string::npos)
+            end = pos + 4;
+    }
+    if(end == 0)
+    {
+        if(hdr_.size() >= limit)
+            ec = error::header_limit;
+        return m;
+    }
+    hdr_.resize(end);
+    parse_header(ec);
+    hdr_.clear();
+    s_ = state::body;
+    return end - size0;
+}
+
+inline
+void
+multipart_body::
+reader::
+parse_header(error_code& ec)
+{
+    part_.clear();
+    detail::basic_parser_base base;
+    auto p = hdr_.data();
+    auto const last = p + hdr_.size();
+    while(p[0] != '\r' || p[1] != '\n')
+    {
+        string_view name;
+        string_view value;
+        base.parse_field(p, last, name, value, fold_, ec);
+        if(ec)
+        {
+            if(ec == error::need_more)
+                ec = error::bad_multipart;
+            return;
+        }
+        part_.insert(name, value);
+    }
+    if(body_.cb_h_)
+        body_.cb_h_(part_, ec);
+}
+
+inline
+std::size_t
+multipart_body::
+reader::
+put_body(char const* p, std::size_t n, error_code& ec)
+{
+    auto const last = p + n;
+    auto it = p;
+    if(match_ > 0)
+    {
+        // Continue a delimiter which began in a previous
+        // buffer. Its octets are known, so none were kept.
+        while(match_ < delim_.size() && it != last &&
+                *it == delim_[match_])
+        {
+            ++match_;
+            ++it;
+        }
+        if(match_ == delim_.size())
+        {
+            match_ = 0;
+            end_part(ec);
+            return it - p;
+        }
+        if(it == last)
+            return n;
+        // Not a delimiter, the matched octets are data
+        auto const m = match_;
+        match_ = 0;
+        put_data(delim_.data(), m, ec);
+        if(ec)
+            return it - p;
+    }
+    auto first = it;
+    for(;;)
+    {
+        it = detail::find_multipart_delimiter(it, last);
+        if(it == last)
+            break;
+        auto const m = (std::min)(delim_.size(),
+            static_cast<std::size_t>(last - it));
+        if(std::memcmp(it, delim_.data(), m) != 0)
+        {
+            ++it;
+            continue;
+        }
+        put_data(first, it - first, ec);
+        if(ec)
+            return it - p;
+        if(m < delim_.size())
+        {
+            // The buffer ends with part of a delimiter
+            match_ = m;
+            return n;
+        }
+        it += m;
+        end_part(ec);
+        return it - p;
+    }
+    put_data(first, last - first, ec);
+    return n;
+}
+
+inline
+std::size_t
+multipart_body::
+reader::
+put(char const* p, std::size_t n, error_code& ec)
+{
+    std::size_t i = 0;
+    while(i < n)
+    {
+        switch(s_)
+        {
+        case state::preamble:
+        case state::body:
+            i += put_body(p + i, n - i, ec);
+            break;
+
+        case state::delimiter:
+            if(p[i] == '-')
+            {
+                ++i;
+                s_ = state::close;
+                break;
+            }
+            s_ = state::padding;
+            BOOST_FALLTHROUGH;
+
+        case state::padding:
+            if(p[i] == ' ' || p[i] == '\t')
+            {
+                ++i;
+                break;
+            }
+            if(p[i] != '\r')
+            {
+                ec = error::bad_multipart;
+                return i;
+            }
+            ++i;
+            s_ = state::eol;
+            break;
+
+        case state::eol:
+            if(p[i] != '\n')
+            {
+                ec = error::bad_multipart;
+                return i;
+            }
+            ++i;
+            s_ = state::header;
+            break;
+
+        case state::close:
+            if(p[i] != '-')
+            {
+                ec = error::bad_multipart;
+                return i;
+            }
+            ++i;
+            s_ = state::epilogue;
+            break;
+
+        case state::header:
+            i += put_header(p + i, n - i, ec);
+            break;
+
+        case state::epilogue:
+            // discarded
+            i = n;
+            break;
+        }
+        if(ec)
+            return i;
+    }
+    return i;
+}
+
+template<class ConstBufferSequence>
+std::size_t
+multipart_body::
+reader::
+put(ConstBufferSequence const& buffers, error_code& ec)
+{
+    ec = {};
+    std::size_t total = 0;
+    for(auto it = net::buffer_sequence_begin(buffers);
+        it != net::buffer_sequence_end(buffers); ++it)
+    {
+        net::const_buffer b = *it;
+        total += put(static_cast<char const*>(
+            b.data()), b.size(), ec);
+        if(ec)
+            break;
+    }
+    return total;
+}
+
+inline
+void
+multipart_body::
+reader::
+finish(error_code& ec)
+{
+    if(s_ != state::epilogue)
+    {
+        ec = error::partial_message;
+        return;
+    }
+    ec = {};
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
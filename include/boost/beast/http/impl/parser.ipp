@@ -40,7 +40,7 @@ template<bool isRequest, class Body, class Allocator, class Protocol>
 template<class OtherBody, class... Args, class>
 parser<isRequest, Body, Allocator, Protocol>::
 parser(
-    parser<isRequest, OtherBody, Allocator>&& other,
+    parser<isRequest, OtherBody, Allocator, Protocol>&& other,
     Args&&... args)
     : base_type(std::move(other))
     , m_(other.release(), std::forward<Args>(args)...)
@@ -0,0 +1,343 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_PRECOMPRESSED_STORE_IPP
+#define BOOST_BEAST_HTTP_IMPL_PRECOMPRESSED_STORE_IPP
+
+#include <boost/beast/http/deflate_body.hpp>
+#include <boost/beast/http/rfc7230.hpp>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+namespace detail {
+
+// Parse a qvalue, rfc7231 section 5.3.1, returning
+// the weight in thousandths or -1 if the value is invalid.
+//
+//  qvalue = ( "0" [ "." 0*3DIGIT ] ) / ( "1" [ "." 0*3("0") ] )
+//
+inline
+int
+parse_qvalue(string_view s)
+{
+    if(s.empty() || (s[0] != '0' && s[0] != '1'))
+        return -1;
+    int v = (s[0] - '0') * 1000;
+    if(s.size() == 1)
+        return v;
+    if(s[1] != '.' || s.size() > 5)
+        return -1;
+    int scale = 100;
+    for(std::size_t i = 2; i < s.size(); ++i)
+    {
+        if(s[i] < '0' || s[i] > '9')
+            return -1;
+        v += (s[i] - '0') * scale;
+        scale /= 10;
+    }
+    if(v > 1000)
+        return -1;
+    return v;
+}
+
+} // detail
+
+inline
+string_view
+to_string(content_coding c)
+{
+    switch(c)
+    {
+    case content_coding::deflate:   return "deflate";
+    case content_coding::gzip:      return "gzip";
+    case content_coding::identity:
+    default:
+        break;
+    }
+    return "identity";
+}
+
+inline
+content_coding
+negotiate_content_coding(string_view accept_encoding)
+{
+    int gzip = -1;
+    int deflate = -1;
+    int identity = -1;
+    int any = -1;
+    for(auto const& e : ext_list{accept_encoding})
+    {
+        int q = 1000;
+        for(auto const& p : e.second)
+            if(iequals(p.first, "q"))
+                q = detail::parse_qvalue(p.second);
+        if(q < 0)
+            continue;
+        if(iequals(e.first, "gzip") || iequals(e.first, "x-gzip"))
+            gzip = q;
+        else if(iequals(e.first, "deflate"))
+            deflate = q;
+        else if(iequals(e.first, "identity"))
+            identity = q;
+        else if(e.first == "*")
+            any = q;
+    }
+    if(gzip < 0)
+        gzip = any;
+    if(deflate < 0)
+        deflate = any;
+    if(identity < 0)
+        identity = any < 0 ? 1 : any;
+    if(gzip > 0 && gzip >= deflate && gzip >= identity)
+        return content_coding::gzip;
+    if(deflate > 0 && deflate >= identity)
+        return content_coding::deflate;
+    return content_coding::identity;
+}
+
+//------------------------------------------------------------------------------
+
+template<class File>
+basic_precompressed_store<File>::
+basic_precompressed_store(std::size_t capacity)
+{
+    stats_.capacity = capacity;
+}
+
+template<class File>
+auto
+basic_precompressed_store<File>::
+stats() const ->
+    stats_type
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return stats_;
+}
+
+template<class File>
+std::string
+basic_precompressed_store<File>::
+make_key(string_view path, content_coding c)
+{
+    std::string key;
+    key.reserve(path.size() + 2);
+    key.append(path.data(), path.size());
+    key.push_back('\0');
+    key.push_back(static_cast<char>('0' + static_cast<int>(c)));
+    return key;
+}
+
+template<class File>
+template<bool isGzip>
+std::shared_ptr<std::string const>
+basic_precompressed_store<File>::
+compress(std::string const& path,
+    std::uint64_t& file_size, error_code& ec)
+{
+    typename basic_file_body<File>::value_type body;
+    body.open(path.c_str(), file_mode::scan, ec);
+    if(ec)
+        return nullptr;
+    file_size = body.size();
+    header<false> h;
+    typename basic_deflate_body<
+        basic_file_body<File>, isGzip>::writer wr{h, body};
+    wr.level(9);
+    wr.init(ec);
+    if(ec)
+        return nullptr;
+    auto data = std::make_shared<std::string>();
+    for(;;)
+    {
+        auto const result = wr.get(ec);
+        if(ec)
+            return nullptr;
+        if(! result)
+            break;
+        data->append(
+            static_cast<char const*>(result->first.data()),
+            result->first.size());
+        if(! result->second)
+            break;
+    }
+    data->shrink_to_fit();
+    return data;
+}
+
+template<class File>
+std::shared_ptr<std::string const>
+basic_precompressed_store<File>::
+compress(std::string const& path, content_coding c,
+    std::uint64_t& file_size, error_code& ec)
+{
+    if(c == content_coding::gzip)
+        return compress<true>(path, file_size, ec);
+    BOOST_ASSERT(c == content_coding::deflate);
+    return compress<false>(path, file_size, ec);
+}
+
+template<class File>
+auto
+basic_precompressed_store<File>::
+find(std::string const& key) ->
+    entry const*
+{
+    auto const it = map_.find(key);
+    if(it == map_.end())
+        return nullptr;
+    list_.splice(list_.begin(), list_, it->second);
+    return &*it->second;
+}
+
+template<class File>
+void
+basic_precompressed_store<File>::
+insert(entry e)
+{
+    auto const n = e.data ? e.data->size() : 0;
+    auto const it = map_.find(e.key);
+    if(it != map_.end())
+    {
+        if(it->second->data)
+            stats_.size -= it->second->data->size();
+        list_.erase(it->second);
+        map_.erase(it);
+    }
+    if(n > stats_.capacity)
+        return;
+    while(stats_.size + n > stats_.capacity)
+    {
+        BOOST_ASSERT(! list_.empty());
+        auto& back = list_.back();
+        if(back.data)
+            stats_.size -= back.data->size();
+        map_.erase(back.key);
+        list_.pop_back();
+        ++stats_.evictions;
+    }
+    list_.emplace_front(std::move(e));
+    map_.emplace(list_.front().key, list_.begin());
+    stats_.size += n;
+    stats_.entries = map_.size();
+}
+
+template<class File>
+void
+basic_precompressed_store<File>::
+load(string_view path, error_code& ec)
+{
+    std::string const s(path.data(), path.size());
+    for(auto c : {content_coding::gzip, content_coding::deflate})
+    {
+        entry e;
+        e.key = make_key(path, c);
+        e.data = compress(s, c, e.file_size, ec);
+        if(ec)
+            return;
+        if(e.data->size() >= e.file_size)
+            e.data = nullptr;
+        std::lock_guard<std::mutex> lock(m_);
+        insert(std::move(e));
+    }
+}
+
+template<class File>
+content_coding
+basic_precompressed_store<File>::
+open(
+    string_view path,
+    string_view accept_encoding,
+    typename body_type::value_type& body,
+    error_code& ec)
+{
+    body.close();
+    std::string const s(path.data(), path.size());
+    auto const c = negotiate_content_coding(accept_encoding);
+    if(c != content_coding::identity)
+    {
+        auto const key = make_key(path, c);
+        std::shared_ptr<std::string const> data;
+        std::uint64_t file_size = 0;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            if(auto const p = find(key))
+            {
+                found = true;
+                data = p->data;
+                file_size = p->file_size;
+                ++stats_.hits;
+                if(data)
+                    stats_.bytes_saved += file_size - data->size();
+            }
+        }
+        if(! found)
+        {
+            // Compress outside the lock, a concurrent
+            // miss on the same key replaces the entry.
+            data = compress(s, c, file_size, ec);
+            if(ec)
+                return content_coding::identity;
+            if(data->size() >= file_size)
+                data = nullptr;
+            std::lock_guard<std::mutex> lock(m_);
+            ++stats_.misses;
+            if(data)
+                stats_.bytes_saved += file_size - data->size();
+            insert({key, data, file_size});
+        }
+        if(data)
+        {
+            body.data_ = std::move(data);
+            ec = {};
+            return c;
+        }
+    }
+    body.file_.open(s.c_str(), file_mode::scan, ec);
+    return content_coding::identity;
+}
+
+template<class File>
+void
+basic_precompressed_store<File>::
+erase(string_view path)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    for(auto c : {content_coding::gzip, content_coding::deflate})
+    {
+        auto const it = map_.find(make_key(path, c));
+        if(it == map_.end())
+            continue;
+        if(it->second->data)
+            stats_.size -= it->second->data->size();
+        list_.erase(it->second);
+        map_.erase(it);
+    }
+    stats_.entries = map_.size();
+}
+
+template<class File>
+void
+basic_precompressed_store<File>::
+clear()
+{
+    std::lock_guard<std::mutex> lock(m_);
+    map_.clear();
+    list_.clear();
+    stats_.size = 0;
+    stats_.entries = 0;
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
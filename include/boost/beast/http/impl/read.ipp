@@ -15,9 +15,15 @@
 #include <boost/beast/http/parser.hpp>
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/core/async_op_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/detail/clamp.hpp>
 #include <boost/beast/core/detail/get_executor_type.hpp>
 #include <boost/beast/core/detail/read.hpp>
+#include <boost/asio/coroutine.hpp>
 #include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+#include <algorithm>
+#include <type_traits>
 
 namespace boost {
 namespace beast {
@@ -25,19 +31,56 @@ namespace http {
 
 namespace detail {
 
-// The default maximum number of bytes to transfer in a single operation.
-std::size_t constexpr default_max_transfer_size = 65536;
+// The size of the first read of a header.
+std::size_t constexpr default_header_read_size = 1024;
+
+// The maximum size of a read while the header is incomplete.
+std::size_t constexpr default_max_header_read_size = 65536;
+
+// The size of the first read of a body of unknown length.
+std::size_t constexpr default_body_read_size = 4096;
+
+// The maximum size of a read of the body.
+std::size_t constexpr default_max_body_read_size = 1024 * 1024;
+
+} // detail
+
+template<bool isRequest, class Derived, class Protocol>
+std::size_t
+read_size_hint(
+    basic_parser<isRequest, Derived, Protocol> const& parser,
+    std::size_t previous)
+{
+    if(! parser.is_header_done())
+    {
+        if(previous == 0)
+            return detail::default_header_read_size;
+        return (std::min)(2 * previous,
+            detail::default_max_header_read_size);
+    }
+    auto const remain = parser.content_length_remaining();
+    if(remain)
+        return (std::max<std::size_t>)(1, beast::detail::clamp(
+            *remain, detail::default_max_body_read_size));
+    if(previous < detail::default_body_read_size)
+        return detail::default_body_read_size;
+    return (std::min)(2 * previous,
+        detail::default_max_body_read_size);
+}
+
+namespace detail {
 
 template<
     class DynamicBuffer,
-    bool isRequest, class Derived,
+    bool isRequest, class Derived, class Protocol,
     class Condition>
 std::size_t
 parse_until(
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     error_code& ec,
-    Condition cond)
+    Condition cond,
+    std::size_t& hint)
 {
     if(ec == net::error::eof)
     {
@@ -78,14 +121,19 @@ parse_until(
             return 0;
         }
     }
-    return default_max_transfer_size;
+    // Call unqualified, with the derived type, so that an
+    // overload for the derived parser can be found.
+    hint = read_size_hint(
+        static_cast<Derived const&>(parser), hint);
+    return hint;
 }
 
 // predicate is true on any forward parser progress
-template<bool isRequest, class Derived>
+template<bool isRequest, class Derived, class Protocol>
 struct read_some_condition
 {
-    basic_parser<isRequest, Derived>& parser;
+    basic_parser<isRequest, Derived, Protocol>& parser;
+    std::size_t hint;   // previous read size, initially zero
 
     template<class DynamicBuffer>
     std::size_t
@@ -97,15 +145,16 @@ struct read_some_condition
             []
             {
                 return true;
-            });
+            }, hint);
     }
 };
 
 // predicate is true when parser header is complete
-template<bool isRequest, class Derived>
+template<bool isRequest, class Derived, class Protocol>
 struct read_header_condition
 {
-    basic_parser<isRequest, Derived>& parser;
+    basic_parser<isRequest, Derived, Protocol>& parser;
+    std::size_t hint;   // previous read size, initially zero
 
     template<class DynamicBuffer>
     std::size_t
@@ -117,15 +166,16 @@ struct read_header_condition
             [this]
             {
                 return parser.is_header_done();
-            });
+            }, hint);
     }
 };
 
 // predicate is true when parser message is complete
-template<bool isRequest, class Derived>
+template<bool isRequest, class Derived, class Protocol>
 struct read_all_condition
 {
-    basic_parser<isRequest, Derived>& parser;
+    basic_parser<isRequest, Derived, Protocol>& parser;
+    std::size_t hint;   // previous read size, initially zero
 
     template<class DynamicBuffer>
     std::size_t
@@ -137,7 +187,7 @@ struct read_all_condition
             [this]
             {
                 return parser.is_done();
-            });
+            }, hint);
     }
 };
 
@@ -145,7 +195,7 @@ struct read_all_condition
 
 template<
     class Stream, class DynamicBuffer,
-    bool isRequest, class Body, class Allocator,
+    bool isRequest, class Body, class Allocator, class Protocol,
     class Handler>
 class read_msg_op
     : public beast::stable_async_op_base<
@@ -153,7 +203,7 @@ class read_msg_op
     , public net::coroutine
 {
     using parser_type =
-        parser<isRequest, Body, Allocator>;
+        parser<isRequest, Body, Allocator, Protocol>;
 
     using message_type =
         typename parser_type::value_type;
@@ -203,6 +253,222 @@ public:
     }
 };
 
+//------------------------------------------------------------------------------
+
+/*  Reading a message with a parser whose body reader supports
+    direct reads: after the header, octets of a body with a
+    Content-Length are read straight into the body instead of
+    being copied out of the dynamic buffer by the parser.
+*/
+template<
+    class Stream, class DynamicBuffer,
+    bool isRequest, class Derived, class Protocol,
+    class Handler>
+class read_direct_op
+    : public beast::async_op_base<
+        Handler, beast::detail::get_executor_type<Stream>>
+    , public net::coroutine
+{
+    Stream& s_;
+    DynamicBuffer& b_;
+    Derived& p_;
+    net::mutable_buffer mb_;
+    std::size_t hint_ = 0;
+    std::size_t bytes_transferred_ = 0;
+
+public:
+    template<class Handler_>
+    read_direct_op(
+        Stream& s,
+        DynamicBuffer& b,
+        Derived& p,
+        Handler_&& h)
+        : async_op_base<
+            Handler, beast::detail::get_executor_type<Stream>>(
+                std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+        , b_(b)
+        , p_(p)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred,
+        bool cont = true)
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            if(! p_.is_header_done())
+            {
+                BOOST_ASIO_CORO_YIELD
+                beast::detail::async_read(s_, b_,
+                    read_header_condition<
+                        isRequest, Derived, Protocol>{p_, 0}, std::move(*this));
+                bytes_transferred_ += bytes_transferred;
+                if(ec)
+                    goto upcall;
+            }
+            while(! p_.is_done() && b_.size() == 0)
+            {
+                hint_ = read_size_hint(
+                    static_cast<Derived const&>(p_), hint_);
+                mb_ = p_.prepare_body(hint_, ec);
+                if(ec || mb_.size() == 0)
+                    break;
+                BOOST_ASIO_CORO_YIELD
+                s_.async_read_some(mb_, std::move(*this));
+                bytes_transferred_ += bytes_transferred;
+                {
+                    error_code ec2;
+                    p_.commit_body(bytes_transferred, ec2);
+                    if(ec == net::error::eof)
+                    {
+                        ec = {};
+                        p_.put_eof(ec);
+                    }
+                    if(! ec)
+                        ec = ec2;
+                }
+                if(ec)
+                    goto upcall;
+            }
+            if(ec || p_.is_done())
+                goto upcall;
+            BOOST_ASIO_CORO_YIELD
+            beast::detail::async_read(s_, b_,
+                read_all_condition<
+                    isRequest, Derived, Protocol>{p_, 0}, std::move(*this));
+            bytes_transferred_ += bytes_transferred;
+        upcall:
+            if(! cont)
+            {
+                BOOST_ASIO_CORO_YIELD
+                net::post(
+                    s_.get_executor(),
+                    beast::bind_front_handler(
+                        std::move(*this), ec, bytes_transferred_));
+            }
+            this->invoke(ec, bytes_transferred_);
+        }
+    }
+};
+
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived, class Protocol>
+std::size_t
+read_direct(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived, Protocol>& parser,
+    error_code& ec,
+    std::false_type)
+{
+    return beast::detail::read(stream, buffer,
+        detail::read_all_condition<
+            isRequest, Derived, Protocol>{parser, 0}, ec);
+}
+
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived, class Protocol>
+std::size_t
+read_direct(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived, Protocol>& parser,
+    error_code& ec,
+    std::true_type)
+{
+    auto& p = static_cast<Derived&>(parser);
+    std::size_t bytes_transferred = 0;
+    if(! parser.is_header_done())
+    {
+        bytes_transferred = beast::detail::read(stream, buffer,
+            detail::read_header_condition<
+                isRequest, Derived, Protocol>{parser, 0}, ec);
+        if(ec)
+            return bytes_transferred;
+    }
+    // Octets following the header which are already in the
+    // buffer were presented to the eager parser. When none
+    // remain, the rest of the body is read into its storage.
+    std::size_t hint = 0;
+    while(! parser.is_done() && buffer.size() == 0)
+    {
+        hint = read_size_hint(
+            static_cast<Derived const&>(parser), hint);
+        auto const mb = p.prepare_body(hint, ec);
+        if(ec)
+            return bytes_transferred;
+        if(mb.size() == 0)
+            break;
+        auto const n = stream.read_some(mb, ec);
+        bytes_transferred += n;
+        error_code ec2;
+        p.commit_body(n, ec2);
+        if(ec == net::error::eof)
+        {
+            ec = {};
+            parser.put_eof(ec);
+        }
+        if(! ec)
+            ec = ec2;
+        if(ec)
+            return bytes_transferred;
+    }
+    if(parser.is_done())
+        return bytes_transferred;
+    return bytes_transferred + beast::detail::read(stream, buffer,
+        detail::read_all_condition<
+            isRequest, Derived, Protocol>{parser, 0}, ec);
+}
+
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived, class Protocol,
+    class ReadHandler>
+void
+async_read_direct(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived, Protocol>& parser,
+    ReadHandler&& handler,
+    std::false_type)
+{
+    beast::detail::async_read(stream, buffer,
+        detail::read_all_condition<
+            isRequest, Derived, Protocol>{parser, 0},
+                std::forward<ReadHandler>(handler));
+}
+
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived, class Protocol,
+    class ReadHandler>
+void
+async_read_direct(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived, Protocol>& parser,
+    ReadHandler&& handler,
+    std::true_type)
+{
+    read_direct_op<
+        AsyncReadStream, DynamicBuffer,
+        isRequest, Derived, Protocol,
+        typename std::decay<ReadHandler>::type>(
+            stream, buffer, static_cast<Derived&>(parser),
+                std::forward<ReadHandler>(handler));
+}
+
 } // detail
 
 //------------------------------------------------------------------------------
@@ -210,12 +476,12 @@ public:
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read_some(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser)
+    basic_parser<isRequest, Derived, Protocol>& parser)
 {
     static_assert(
         is_sync_read_stream<SyncReadStream>::value,
@@ -234,12 +500,12 @@ read_some(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read_some(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     error_code& ec)
 {
     static_assert(
@@ -250,20 +516,20 @@ read_some(
         "DynamicBuffer requirements not met");
     return beast::detail::read(stream, buffer,
         detail::read_some_condition<
-            isRequest, Derived>{parser}, ec);
+            isRequest, Derived, Protocol>{parser, 0}, ec);
 }
 
 template<
     class AsyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived,
+    bool isRequest, class Derived, class Protocol,
     class ReadHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(
     ReadHandler, void(error_code, std::size_t))
 async_read_some(
     AsyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     ReadHandler&& handler)
 {
     static_assert(
@@ -276,7 +542,7 @@ async_read_some(
         ReadHandler, void(error_code, std::size_t));
     beast::detail::async_read(stream, buffer,
         detail::read_some_condition<
-            isRequest, Derived>{parser}, std::move(
+            isRequest, Derived, Protocol>{parser, 0}, std::move(
                 init.completion_handler));
     return init.result.get();
 }
@@ -286,12 +552,12 @@ async_read_some(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read_header(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser)
+    basic_parser<isRequest, Derived, Protocol>& parser)
 {
     static_assert(
         is_sync_read_stream<SyncReadStream>::value,
@@ -310,12 +576,12 @@ read_header(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read_header(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     error_code& ec)
 {
     static_assert(
@@ -327,20 +593,20 @@ read_header(
     parser.eager(false);
     return beast::detail::read(stream, buffer,
         detail::read_header_condition<
-            isRequest, Derived>{parser}, ec);
+            isRequest, Derived, Protocol>{parser, 0}, ec);
 }
 
 template<
     class AsyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived,
+    bool isRequest, class Derived, class Protocol,
     class ReadHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(
     ReadHandler, void(error_code, std::size_t))
 async_read_header(
     AsyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     ReadHandler&& handler)
 {
     static_assert(
@@ -354,7 +620,7 @@ async_read_header(
     parser.eager(false);
     beast::detail::async_read(stream, buffer,
         detail::read_header_condition<
-            isRequest, Derived>{parser}, std::move(
+            isRequest, Derived, Protocol>{parser, 0}, std::move(
                 init.completion_handler));
     return init.result.get();
 }
@@ -364,12 +630,12 @@ async_read_header(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser)
+    basic_parser<isRequest, Derived, Protocol>& parser)
 {
     static_assert(
         is_sync_read_stream<SyncReadStream>::value,
@@ -388,12 +654,12 @@ read(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     error_code& ec)
 {
     static_assert(
@@ -403,22 +669,21 @@ read(
         net::is_dynamic_buffer<DynamicBuffer>::value,
         "DynamicBuffer requirements not met");
     parser.eager(true);
-    return beast::detail::read(stream, buffer,
-        detail::read_all_condition<
-            isRequest, Derived>{parser}, ec);
+    return detail::read_direct(stream, buffer, parser, ec,
+        detail::is_parser<Derived>{});
 }
 
 template<
     class AsyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived,
+    bool isRequest, class Derived, class Protocol,
     class ReadHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(
     ReadHandler, void(error_code, std::size_t))
 async_read(
     AsyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     ReadHandler&& handler)
 {
     static_assert(
@@ -430,10 +695,9 @@ async_read(
     BOOST_BEAST_HANDLER_INIT(
         ReadHandler, void(error_code, std::size_t));
     parser.eager(true);
-    beast::detail::async_read(stream, buffer,
-        detail::read_all_condition<
-            isRequest, Derived>{parser}, std::move(
-                init.completion_handler));
+    detail::async_read_direct(stream, buffer, parser,
+        std::move(init.completion_handler),
+            detail::is_parser<Derived>{});
     return init.result.get();
 }
 
@@ -442,12 +706,12 @@ async_read(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Body, class Allocator>
+    bool isRequest, class Body, class Allocator, class Protocol>
 std::size_t
 read(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    message<isRequest, Body, basic_fields<Allocator>>& msg)
+    message<isRequest, Body, basic_fields<Allocator, Protocol>>& msg)
 {
     static_assert(
         is_sync_read_stream<SyncReadStream>::value,
@@ -470,12 +734,12 @@ read(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Body, class Allocator>
+    bool isRequest, class Body, class Allocator, class Protocol>
 std::size_t
 read(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    message<isRequest, Body, basic_fields<Allocator>>& msg,
+    message<isRequest, Body, basic_fields<Allocator, Protocol>>& msg,
     error_code& ec)
 {
     static_assert(
@@ -488,7 +752,7 @@ read(
         "Body requirements not met");
     static_assert(is_body_reader<Body>::value,
         "BodyReader requirements not met");
-    parser<isRequest, Body, Allocator> p(std::move(msg));
+    parser<isRequest, Body, Allocator, Protocol> p(std::move(msg));
     p.eager(true);
     auto const bytes_transferred =
         read(stream, buffer, p.base(), ec);
@@ -501,14 +765,14 @@ read(
 template<
     class AsyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Body, class Allocator,
+    bool isRequest, class Body, class Allocator, class Protocol,
     class ReadHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(
     ReadHandler, void(error_code, std::size_t))
 async_read(
     AsyncReadStream& stream,
     DynamicBuffer& buffer,
-    message<isRequest, Body, basic_fields<Allocator>>& msg,
+    message<isRequest, Body, basic_fields<Allocator, Protocol>>& msg,
     ReadHandler&& handler)
 {
     static_assert(
@@ -526,7 +790,7 @@ async_read(
     detail::read_msg_op<
         AsyncReadStream,
         DynamicBuffer,
-        isRequest, Body, Allocator,
+        isRequest, Body, Allocator, Protocol,
         BOOST_ASIO_HANDLER_TYPE(
             ReadHandler, void(error_code, std::size_t))>(
                 stream, buffer, msg, std::move(
@@ -149,7 +149,7 @@ next(error_code& ec, Visit&& visit)
         wr_.init(ec);
         if(ec)
             return;
-        if(split_)
+        if(split_ || coalesce_ > 0)
             goto go_header_only_c;
         auto result = wr_.get(ec);
         if(ec == error::need_more)
@@ -206,6 +206,8 @@ next(error_code& ec, Visit&& visit)
 
     case do_body_c + 1:
     {
+        if(coalesce_ > 0)
+            goto go_body_cc;
         auto result = wr_.get(ec);
         if(ec)
             return;
@@ -272,6 +274,79 @@ next(error_code& ec, Visit&& visit)
 
     //----------------------------------------------------------------------
 
+    go_body_cc:
+        more_ = true;
+        s_ = do_body_cc;
+        BOOST_FALLTHROUGH;
+    case do_body_cc:
+    {
+        // accumulate body octets until the threshold is
+        // reached, the body is complete, or a flush is requested.
+        while(more_ && cb_.size() < coalesce_ &&
+            ! (flush_ && cb_.size() > 0))
+        {
+            auto result = wr_.get(ec);
+            if(ec == error::need_more ||
+                ec == error::need_buffer)
+            {
+                if(! flush_ || cb_.size() == 0)
+                    return;
+                ec = {};
+                break;
+            }
+            if(ec)
+                return;
+            if(! result)
+            {
+                more_ = false;
+                break;
+            }
+            more_ = result->second;
+            cb_.commit(net::buffer_copy(
+                cb_.prepare(buffer_size(result->first)),
+                result->first));
+        }
+        flush_ = false;
+        if(! more_)
+        {
+            if(cb_.size() == 0)
+                goto go_final_c;
+            v_.template emplace<10>(
+                boost::in_place_init,
+                cb_.size(),
+                net::const_buffer{nullptr, 0},
+                chunk_crlf{},
+                cb_.data(),
+                chunk_crlf{},
+                detail::chunk_last(),
+                net::const_buffer{nullptr, 0},
+                chunk_crlf{});
+            goto go_body_final_cc;
+        }
+        v_.template emplace<9>(
+            boost::in_place_init,
+            cb_.size(),
+            net::const_buffer{nullptr, 0},
+            chunk_crlf{},
+            cb_.data(),
+            chunk_crlf{});
+        s_ = do_body_cc + 1;
+        BOOST_FALLTHROUGH;
+    }
+
+    case do_body_cc + 1:
+        do_visit<9>(ec, visit);
+        break;
+
+    go_body_final_cc:
+        s_ = do_body_cc + 2;
+        BOOST_FALLTHROUGH;
+    case do_body_cc + 2:
+        do_visit<10>(ec, visit);
+        break;
+
+    //----------------------------------------------------------------------
+
     default:
     case do_complete:
         BOOST_ASSERT(false);
@@ -357,7 +432,7 @@ consume(std::size_t n)
             break;
         fwr_ = boost::none;
         header_done_ = true;
-        if(! split_)
+        if(! split_ && coalesce_ == 0)
         {
             s_ = do_final_c;
             break;
@@ -414,6 +489,29 @@ consume(std::size_t n)
 
     //----------------------------------------------------------------------
 
+    case do_body_cc + 1:
+        BOOST_ASSERT(
+            n <= buffer_size(v_.template get<9>()));
+        v_.template get<9>().consume(n);
+        if(buffer_size(v_.template get<9>()) > 0)
+            break;
+        v_.reset();
+        cb_.consume(cb_.size());
+        s_ = do_body_cc;
+        break;
+
+    case do_body_cc + 2:
+        BOOST_ASSERT(
+            n <= buffer_size(v_.template get<10>()));
+        v_.template get<10>().consume(n);
+        if(buffer_size(v_.template get<10>()) > 0)
+            break;
+        v_.reset();
+        cb_.consume(cb_.size());
+        goto go_complete;
+
+    //----------------------------------------------------------------------
+
     default:
         BOOST_ASSERT(false);
     case do_complete:
@@ -0,0 +1,298 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_MULTIPART_BODY_HPP
+#define BOOST_BEAST_HTTP_MULTIPART_BODY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/static_string.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/detail/basic_parser.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A @b Body which splits a multipart payload into its parts.
+
+    This body is used with a @ref parser to receive a message
+    whose Content-Type is a multipart media type, such as
+    "multipart/form-data" described in rfc7578. The boundary
+    is taken from the Content-Type field of the message.
+
+    Rather than storing the payload, the body reader delivers
+    each part to callbacks set on the body container before
+    parsing: the fields of each part are parsed into a
+    @ref fields object and presented to the part header
+    callback, followed by zero or more calls to the part body
+    callback with the octets of the part, followed by a call
+    to the part end callback. The callbacks decide where the
+    data of each part goes, for example into a file opened in
+    the part header callback.
+
+    The memory used by the reader is bounded by the limit on
+    the size of the fields of a part, regardless of the size
+    of the payload. The preamble and epilogue are discarded.
+
+    @par Example
+    @code
+    request_parser<multipart_body> p;
+    file f;
+    auto on_header =
+        [&](fields& part, error_code& ec)
+        {
+            f.open(make_path(part[field::content_disposition]).c_str(),
+                file_mode::write, ec);
+        };
+    auto on_body =
+        [&](string_view data, error_code& ec)
+        {
+            f.write(data.data(), data.size(), ec);
+        };
+    auto on_end =
+        [&](error_code& ec)
+        {
+            f.close(ec);
+        };
+    p.get().body().on_part_header(on_header);
+    p.get().body().on_part_body(on_body);
+    p.get().body().on_part_end(on_end);
+    read(sock, buffer, p);
+    @endcode
+*/
+struct multipart_body
+{
+    /// The type of the @ref message::body member.
+    class value_type;
+
+    /** The algorithm for parsing the body
+
+        Meets the requirements of @b BodyReader.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using reader = __implementation_defined__;
+#else
+    class reader;
+#endif
+};
+
+/** The type of the @ref message::body member.
+
+    This container holds the callbacks which receive the
+    parts of the payload, and the number of parts seen.
+*/
+class multipart_body::value_type
+{
+    friend class reader;
+
+    std::function<void(
+        fields&,
+        error_code&)> cb_h_;
+
+    std::function<void(
+        string_view,
+        error_code&)> cb_b_;
+
+    std::function<void(
+        error_code&)> cb_e_;
+
+    std::size_t header_limit_ = 8 * 1024;
+    std::size_t parts_ = 0;
+
+public:
+    /// Constructor
+    value_type() = default;
+
+    /// Returns the number of parts received
+    std::size_t
+    parts() const
+    {
+        return parts_;
+    }
+
+    /** Set the limit on the size of the fields of each part.
+
+        The reader buffers the fields of one part at a time,
+        so this bounds the memory used by the reader.
+        The default limit is 8KB.
+    */
+    void
+    header_limit(std::size_t v)
+    {
+        header_limit_ = v;
+    }
+
+    /** Set a callback to be invoked with the fields of each part
+
+        The implementation type-erases the callback without requiring
+        a dynamic allocation. For this reason, the callback object is
+        passed by a non-constant reference.
+
+        @param cb The function to set, which must be invocable with
+        this equivalent signature:
+        @code
+        void
+        on_part_header(
+            fields& part,               // The fields of the part
+            error_code& ec);            // May be set by the callback to indicate an error
+        @endcode
+    */
+    template<class Callback>
+    void
+    on_part_header(Callback& cb)
+    {
+        // Callback may not be constant, caller is responsible for
+        // managing the lifetime of the callback. Copies are not made.
+        BOOST_STATIC_ASSERT(! std::is_const<Callback>::value);
+
+        cb_h_ = std::ref(cb);
+    }
+
+    /** Set a callback to be invoked with the data of each part
+
+        The callback is invoked zero or more times per part, in
+        order, with consecutive octets of the part body.
+
+        @param cb The function to set, which must be invocable with
+        this equivalent signature:
+        @code
+        void
+        on_part_body(
+            string_view data,           // Some of the octets of the part body
+            error_code& ec);            // May be set by the callback to indicate an error
+        @endcode
+    */
+    template<class Callback>
+    void
+    on_part_body(Callback& cb)
+    {
+        BOOST_STATIC_ASSERT(! std::is_const<Callback>::value);
+
+        cb_b_ = std::ref(cb);
+    }
+
+    /** Set a callback to be invoked at the end of each part
+
+        @param cb The function to set, which must be invocable with
+        this equivalent signature:
+        @code
+        void
+        on_part_end(
+            error_code& ec);            // May be set by the callback to indicate an error
+        @endcode
+    */
+    template<class Callback>
+    void
+    on_part_end(Callback& cb)
+    {
+        BOOST_STATIC_ASSERT(! std::is_const<Callback>::value);
+
+        cb_e_ = std::ref(cb);
+    }
+};
+
+#if ! BOOST_BEAST_DOXYGEN
+
+class multipart_body::reader
+{
+    enum class state
+    {
+        preamble,
+        delimiter,      // after a delimiter, before its CRLF
+        close,          // after a delimiter and one '-'
+        padding,        // transport padding before the CRLF
+        eol,            // after the CR of the delimiter line
+        header,
+        body,
+        epilogue
+    };
+
+    value_type& body_;
+    void const* h_;
+    string_view (*content_type_)(void const*);
+    std::string delim_;         // CRLF "--" boundary
+    std::string hdr_;           // fields of the current part
+    fields part_;
+    static_string<
+        detail::basic_parser_base::max_obs_fold> fold_;
+    std::size_t match_ = 0;     // delimiter octets matched
+    state s_ = state::preamble;
+
+    template<class Header>
+    static
+    string_view
+    content_type(void const* h)
+    {
+        return (*static_cast<Header const*>(h))[field::content_type];
+    }
+
+    static
+    string_view
+    get_boundary(string_view content_type);
+
+    void
+    put_data(char const* p, std::size_t n, error_code& ec);
+
+    void
+    end_part(error_code& ec);
+
+    std::size_t
+    put_header(char const* p, std::size_t n, error_code& ec);
+
+    void
+    parse_header(error_code& ec);
+
+    std::size_t
+    put_body(char const* p, std::size_t n, error_code& ec);
+
+    std::size_t
+    put(char const* p, std::size_t n, error_code& ec);
+
+public:
+    // The reader is constructed before the header is
+    // received, so the Content-Type is inspected in init.
+    template<bool isRequest, class Fields>
+    explicit
+    reader(header<isRequest, Fields>& h, value_type& b)
+        : body_(b)
+        , h_(&h)
+        , content_type_(&content_type<header<isRequest, Fields>>)
+    {
+    }
+
+    void
+    init(boost::optional<std::uint64_t> const&, error_code& ec);
+
+    template<class ConstBufferSequence>
+    std::size_t
+    put(ConstBufferSequence const& buffers, error_code& ec);
+
+    void
+    finish(error_code& ec);
+};
+
+#endif
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/multipart_body.ipp>
+
+#endif
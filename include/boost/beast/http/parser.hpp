@@ -11,9 +11,12 @@
 #define BOOST_BEAST_HTTP_PARSER_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/detail/clamp.hpp>
 #include <boost/beast/http/basic_parser.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/type_traits.hpp>
+#include <boost/assert.hpp>
+#include <boost/core/ignore_unused.hpp>
 #include <boost/optional.hpp>
 #include <boost/throw_exception.hpp>
 #include <functional>
@@ -161,7 +164,7 @@ public:
 #endif
     explicit
     parser(parser<isRequest, OtherBody,
-        Allocator>&& parser, Args&&... args);
+        Allocator, Protocol>&& parser, Args&&... args);
 
     /** Returns the parsed message.
 
@@ -299,9 +302,82 @@ public:
         cb_b_ = std::ref(cb);
     }
 
+    /** Return storage in the body for receiving octets directly.
+
+        When the header is complete, the body has a Content-Length,
+        and the body reader supports direct reads, this function
+        returns a buffer in the body for up to `n` of the remaining
+        octets of the body. The caller reads octets of the body into
+        the buffer and then calls @ref commit_body. This avoids
+        copying body octets from an intermediate buffer.
+
+        Otherwise, an empty buffer is returned and the octets of the
+        body must be presented with @ref put.
+
+        @note All octets which precede the body in the stream must
+        have been presented with @ref put first.
+
+        @param n The largest number of octets to prepare.
+
+        @param ec Set to the error, if any occurred.
+    */
+    net::mutable_buffer
+    prepare_body(std::size_t n, error_code& ec)
+    {
+        return prepare_body(n, ec, std::integral_constant<bool,
+            detail::has_direct_reader<typename Body::reader>::value>{});
+    }
+
+    /** Commit octets received into the buffer from @ref prepare_body.
+
+        @param n The number of octets written to the buffer returned
+        by the last call to @ref prepare_body. This may be zero.
+
+        @param ec Set to the error, if any occurred.
+    */
+    void
+    commit_body(std::size_t n, error_code& ec)
+    {
+        commit_body(n, ec, std::integral_constant<bool,
+            detail::has_direct_reader<typename Body::reader>::value>{});
+    }
+
 private:
     friend class basic_parser<isRequest, parser, Protocol>;
 
+    net::mutable_buffer
+    prepare_body(std::size_t n, error_code& ec, std::true_type)
+    {
+        auto const remain = this->direct_body_remaining(ec);
+        if(ec || remain == 0)
+            return {};
+        return rd_.prepare(beast::detail::clamp(remain, n), ec);
+    }
+
+    net::mutable_buffer
+    prepare_body(std::size_t, error_code& ec, std::false_type)
+    {
+        ec = {};
+        return {};
+    }
+
+    void
+    commit_body(std::size_t n, error_code& ec, std::true_type)
+    {
+        rd_.commit(n, ec);
+        if(ec || n == 0)
+            return;
+        this->direct_body_commit(n, ec);
+    }
+
+    void
+    commit_body(std::size_t n, error_code& ec, std::false_type)
+    {
+        BOOST_ASSERT(n == 0);
+        boost::ignore_unused(n);
+        ec = {};
+    }
+
     parser(std::true_type);
     parser(std::false_type);
 
@@ -310,7 +386,7 @@ private:
             ! std::is_same<Body, OtherBody>::value>::type>
     parser(
         std::true_type,
-        parser<isRequest, OtherBody, Allocator>&& parser,
+        parser<isRequest, OtherBody, Allocator, Protocol>&& parser,
         Args&&... args);
 
     template<class OtherBody, class... Args,
@@ -318,7 +394,7 @@ private:
             ! std::is_same<Body, OtherBody>::value>::type>
     parser(
         std::false_type,
-        parser<isRequest, OtherBody, Allocator>&& parser,
+        parser<isRequest, OtherBody, Allocator, Protocol>&& parser,
         Args&&... args);
 
     template<class Arg1, class... ArgN,
@@ -421,6 +497,15 @@ private:
             body.data(), body.size()), ec);
     }
 
+    template<class ConstBufferSequence>
+    std::size_t
+    on_body_buffers_impl(
+        ConstBufferSequence const& buffers,
+        error_code& ec)
+    {
+        return rd_.put(buffers, ec);
+    }
+
     void
     on_chunk_header_impl(
         std::uint64_t size,
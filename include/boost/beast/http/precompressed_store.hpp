@@ -0,0 +1,391 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_PRECOMPRESSED_STORE_HPP
+#define BOOST_BEAST_HTTP_PRECOMPRESSED_STORE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/file.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/basic_file_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/// The content codings known to @ref basic_precompressed_store
+enum class content_coding
+{
+    /// No transformation, the representation is sent as-is
+    identity,
+
+    /// The "deflate" content coding, rfc7230 section 4.2.2
+    deflate,
+
+    /// The "gzip" content coding, rfc7230 section 4.2.3
+    gzip
+};
+
+/// Returns the content coding name used in the Content-Encoding field
+string_view
+to_string(content_coding c);
+
+/** Select a content coding from the value of an Accept-Encoding field.
+
+    The field value is parsed as an @ref ext_list, where each
+    element is a coding optionally followed by a "q" parameter
+    holding its weight, as described in rfc7231 section 5.3.4.
+    The acceptable coding with the highest weight is returned.
+    When weights are equal "gzip" is preferred over "deflate",
+    and both are preferred over "identity".
+
+    An empty value selects @ref content_coding::identity.
+
+    @param accept_encoding The value of the Accept-Encoding field.
+*/
+content_coding
+negotiate_content_coding(string_view accept_encoding);
+
+/** A @b Body holding either a file or a precompressed variant of it.
+
+    Objects of this body type are filled in by
+    @ref basic_precompressed_store::open. When a precompressed
+    variant was selected the body refers to a shared, immutable
+    buffer held by the store, and serializing it costs nothing
+    beyond writing the octets. Otherwise the body holds the open
+    file, which is read as with @ref basic_file_body.
+
+    @tparam File The implementation to use for accessing files.
+    This type must meet the requirements of @b File.
+*/
+template<class File>
+struct basic_precompressed_body
+{
+    /// The type of File this body uses
+    using file_type = File;
+
+    /// The type of the @ref message::body member.
+    class value_type;
+
+    /** Algorithm for retrieving buffers when serializing.
+
+        Meets the requirements of @b BodyWriter.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using writer = __implementation_defined__;
+#else
+    class writer;
+#endif
+
+    /// Returns the size of the body
+    static
+    std::uint64_t
+    size(value_type const& body);
+};
+
+template<class File>
+class basic_precompressed_body<File>::value_type
+{
+    template<class>
+    friend class basic_precompressed_store;
+
+    friend class writer;
+    friend struct basic_precompressed_body;
+
+    typename basic_file_body<File>::value_type file_;
+    std::shared_ptr<std::string const> data_;
+
+public:
+    /// Constructor
+    value_type() = default;
+
+    /// Constructor
+    value_type(value_type&& other) = default;
+
+    /// Move assignment
+    value_type& operator=(value_type&& other) = default;
+
+    /// Returns `true` if the body refers to a precompressed variant
+    bool
+    is_precompressed() const
+    {
+        return data_ != nullptr;
+    }
+
+    /// Returns `true` if the body holds a file or a variant
+    bool
+    is_open() const
+    {
+        return data_ || file_.is_open();
+    }
+
+    /// Returns the size of the representation to be sent
+    std::uint64_t
+    size() const
+    {
+        return data_ ? data_->size() : file_.size();
+    }
+
+    /// Release the file or variant held by the body
+    void
+    close()
+    {
+        data_.reset();
+        file_.close();
+    }
+};
+
+#if ! BOOST_BEAST_DOXYGEN
+
+template<class File>
+class basic_precompressed_body<File>::writer
+{
+    value_type& body_;
+    boost::optional<typename
+        basic_file_body<File>::writer> wr_;
+    bool done_ = false;
+
+public:
+    using const_buffers_type =
+        net::const_buffer;
+
+    template<bool isRequest, class Fields>
+    writer(header<isRequest, Fields>& h, value_type& b)
+        : body_(b)
+    {
+        BOOST_ASSERT(body_.is_open());
+        if(! body_.data_)
+            wr_.emplace(h, body_.file_);
+    }
+
+    void
+    init(error_code& ec)
+    {
+        if(wr_)
+            return wr_->init(ec);
+        ec = {};
+    }
+
+    boost::optional<std::pair<const_buffers_type, bool>>
+    get(error_code& ec)
+    {
+        if(wr_)
+            return wr_->get(ec);
+        ec = {};
+        if(done_ || body_.data_->empty())
+            return boost::none;
+        done_ = true;
+        return {{const_buffers_type{
+            body_.data_->data(), body_.data_->size()}, false}};
+    }
+};
+
+#endif
+
+template<class File>
+std::uint64_t
+basic_precompressed_body<File>::
+size(value_type const& body)
+{
+    return body.size();
+}
+
+//------------------------------------------------------------------------------
+
+/** A cache of compressed variants of static files.
+
+    This container holds "gzip" and "deflate" coded variants
+    of files, compressed once at compression level 9, either
+    ahead of time by calling @ref load or on the first request
+    for the file. Responses are then served from the cached
+    variant with no compression work per request.
+
+    The total size of the cached variants is bounded by the
+    capacity given on construction. When inserting a variant
+    would exceed the capacity, the least recently used variants
+    are evicted. A variant which is not smaller than the file it
+    was produced from is not served; the file is sent with the
+    identity coding instead.
+
+    The store does not observe changes to files on disk. Call
+    @ref erase or @ref clear after modifying a cached file.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Safe.
+
+    @tparam File The implementation to use for accessing files.
+    This type must meet the requirements of @b File.
+*/
+template<class File>
+class basic_precompressed_store
+{
+public:
+    /// The body type filled in by @ref open
+    using body_type = basic_precompressed_body<File>;
+
+    /// Statistics reported by @ref stats
+    struct stats_type
+    {
+        /// The maximum number of octets in cached variants
+        std::size_t capacity = 0;
+
+        /// The number of octets in cached variants
+        std::size_t size = 0;
+
+        /// The number of cached variants
+        std::size_t entries = 0;
+
+        /// The number of variants served from the cache
+        std::uint64_t hits = 0;
+
+        /// The number of variants which had to be produced
+        std::uint64_t misses = 0;
+
+        /// The number of variants evicted to stay within capacity
+        std::uint64_t evictions = 0;
+
+        /// The number of octets not sent because a variant was served
+        std::uint64_t bytes_saved = 0;
+    };
+
+private:
+    struct entry
+    {
+        std::string key;
+        std::shared_ptr<std::string const> data;
+        std::uint64_t file_size;
+    };
+
+    using list_type = std::list<entry>;
+
+    mutable std::mutex m_;
+    list_type list_;    // most recently used first
+    std::unordered_map<std::string,
+        typename list_type::iterator> map_;
+    stats_type stats_;
+
+    static
+    std::string
+    make_key(string_view path, content_coding c);
+
+    template<bool isGzip>
+    static
+    std::shared_ptr<std::string const>
+    compress(std::string const& path,
+        std::uint64_t& file_size, error_code& ec);
+
+    static
+    std::shared_ptr<std::string const>
+    compress(std::string const& path, content_coding c,
+        std::uint64_t& file_size, error_code& ec);
+
+    entry const*
+    find(std::string const& key);
+
+    void
+    insert(entry e);
+
+public:
+    /** Constructor
+
+        @param capacity The maximum total size in octets
+        of the cached variants.
+    */
+    explicit
+    basic_precompressed_store(std::size_t capacity);
+
+    /// Returns the maximum total size of the cached variants
+    std::size_t
+    capacity() const
+    {
+        return stats_.capacity;
+    }
+
+    /// Returns a snapshot of the statistics
+    stats_type
+    stats() const;
+
+    /** Produce the compressed variants of a file.
+
+        This compresses the file with each supported coding
+        and inserts the variants into the cache, so that
+        requests for the file do not pay for compression.
+
+        @param path The utf-8 encoded path to the file.
+
+        @param ec Set to the error, if any occurred.
+    */
+    void
+    load(string_view path, error_code& ec);
+
+    /** Open the representation of a file to send.
+
+        The content coding is chosen from the Accept-Encoding
+        field value using @ref negotiate_content_coding. If a
+        compressed coding is chosen, the variant is taken from
+        the cache, or produced and inserted if not present.
+        Otherwise, the file itself is opened for reading.
+
+        The caller is responsible for setting the
+        Content-Encoding field when the returned coding is not
+        @ref content_coding::identity, and should add
+        "Accept-Encoding" to the Vary field.
+
+        @param path The utf-8 encoded path to the file.
+
+        @param accept_encoding The value of the Accept-Encoding
+        field of the request.
+
+        @param body The body to fill in.
+
+        @param ec Set to the error, if any occurred.
+
+        @return The content coding of the representation
+        held in `body`.
+    */
+    content_coding
+    open(
+        string_view path,
+        string_view accept_encoding,
+        typename body_type::value_type& body,
+        error_code& ec);
+
+    /// Remove the cached variants of a file
+    void
+    erase(string_view path);
+
+    /// Remove all cached variants
+    void
+    clear();
+};
+
+/// A precompressed body using the default file for the platform
+using precompressed_body = basic_precompressed_body<file>;
+
+/// A precompressed store using the default file for the platform
+using precompressed_store = basic_precompressed_store<file>;
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/precompressed_store.ipp>
+
+#endif
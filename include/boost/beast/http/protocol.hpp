@@ -4,12 +4,23 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/string.hpp>
+#include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/beast/http/field.hpp>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 
 namespace boost {
 namespace beast {
 namespace http {
 
+/** The protocol policy for HTTP.
+
+    This class meets the requirements of @b Protocol, which
+    @ref basic_parser and @ref basic_fields use to adapt the
+    message syntax to HTTP or to another protocol using the
+    same framing, such as SIP. See @ref is_protocol.
+*/
 class protocol
 {
 public:
@@ -23,17 +34,17 @@ public:
 	return name().size();
     }
 
-    static bool check_version(int v)
+    static bool constexpr check_version(int v)
     {
 	return v >= 10 && v <= 11;
     }
 
-    static bool use_http11_keepalive(int v)
+    static bool constexpr use_http11_keepalive(int v)
     {
 	return v >= 11;
     }
 
-    static int default_version()
+    static constexpr int default_version()
     {
 	return 11;
     }
@@ -48,6 +59,21 @@ public:
 	return to_string(name);
     }
 
+    static field string_to_field(string_view name)
+    {
+	return default_string_to_field(name);
+    }
+
+    static string_view field_to_compact(field name)
+    {
+	return to_string(name);
+    }
+
+    static string_view name_to_compact(string_view name)
+    {
+	return name;
+    }
+
     static bool constexpr allow_chunked(int version)
     {
 	return version >= 11;
@@ -55,7 +81,7 @@ public:
 
     static bool constexpr accept_chunked()
     {
-	return false;
+	return true;
     }
 
     static bool constexpr content_length_required()
@@ -68,6 +94,14 @@ public:
 	return false;
     }
 
+    static bool constexpr request_body_to_eof()
+    {
+	// RFC 7230 section 3.3.3: a request without Content-Length
+	// or Transfer-Encoding has no body.
+
+	return false;
+    }
+
     static constexpr
     std::uint64_t
     default_body_limit(std::true_type)
@@ -85,6 +119,86 @@ public:
     }
 };
 
+/** Determine if `T` meets the requirements of @b Protocol.
+
+    A @b Protocol is a class with only static member functions,
+    which supply the decisions that differ between HTTP and
+    protocols derived from it. The parser and the fields container
+    call them for every message, so the functions which decide how
+    a message is framed must be `constexpr`; each instantiation of
+    @ref basic_parser then contains only the branches its protocol
+    can take. This metafunction is equivalent to `std::true_type`
+    if all of the following are valid, with `v` an `int`, `f` a
+    @ref field and `s` a @ref string_view:
+
+    @li `T::name()` returns the name used in the version, such
+    as "HTTP", convertible to @ref string_view.
+
+    @li `T::check_version(v)`, `T::use_http11_keepalive(v)` and
+    `T::allow_chunked(v)` are constant expressions of type `bool`.
+
+    @li `T::accept_chunked()`, `T::content_length_required()`,
+    `T::override_content_length()` and `T::request_body_to_eof()`
+    are constant expressions of type `bool`.
+
+    @li `T::default_version()` is a constant expression of type `int`.
+
+    @li `T::default_body_limit(std::true_type{})` and
+    `T::default_body_limit(std::false_type{})` are constant
+    expressions of type `std::uint64_t`, the limits for requests
+    and responses.
+
+    @li `T::string_to_field(s)` returns a @ref field.
+
+    @li `T::field_to_compact(f)` and `T::name_to_compact(s)` return
+    the name under which a field is stored in @ref basic_fields,
+    convertible to @ref string_view.
+
+    @par Example
+    @code
+    template<class Protocol>
+    void check_protocol()
+    {
+        static_assert(is_protocol<Protocol>::value,
+            "Protocol requirements not met");
+    }
+    @endcode
+*/
+#if BOOST_BEAST_DOXYGEN
+template<class T>
+struct is_protocol : std::integral_constant<bool, ...> {};
+#else
+template<class T, class = void>
+struct is_protocol : std::false_type {};
+
+template<class T>
+struct is_protocol<T, beast::detail::void_t<
+    std::integral_constant<bool, T::check_version(0)>,
+    std::integral_constant<bool, T::use_http11_keepalive(0)>,
+    std::integral_constant<bool, T::allow_chunked(0)>,
+    std::integral_constant<bool, T::accept_chunked()>,
+    std::integral_constant<bool, T::content_length_required()>,
+    std::integral_constant<bool, T::override_content_length()>,
+    std::integral_constant<bool, T::request_body_to_eof()>,
+    std::integral_constant<int, T::default_version()>,
+    std::integral_constant<std::uint64_t,
+        T::default_body_limit(std::true_type{})>,
+    std::integral_constant<std::uint64_t,
+        T::default_body_limit(std::false_type{})>
+    >> : std::integral_constant<bool,
+    std::is_convertible<decltype(
+        T::name()), string_view>::value &&
+    std::is_same<decltype(T::string_to_field(
+        std::declval<string_view>())), field>::value &&
+    std::is_convertible<decltype(T::field_to_compact(
+        std::declval<field>())), string_view>::value &&
+    std::is_convertible<decltype(T::name_to_compact(
+        std::declval<string_view>())), string_view>::value
+    >
+{
+};
+#endif
+
 } // http
 } // beast
 } // boost
@@ -20,6 +20,42 @@ namespace boost {
 namespace beast {
 namespace http {
 
+/** Return the number of bytes to request in the next read of a message.
+
+    The stream algorithms which read into a parser call this function
+    before each read, to decide the most number of bytes to request
+    from the stream. The default policy adapts to the state of the
+    parser:
+
+    @li While reading the header, a small read is requested first,
+        doubling on each further read while the header is incomplete.
+
+    @li When the body has a Content-Length, the number of body octets
+        remaining is requested, up to a limit.
+
+    @li For a chunked body, or a body which ends at end of file, the
+        size ramps up exponentially from the size of the previous read,
+        up to a limit.
+
+    This is a customization point. The algorithms call the function
+    unqualified, with the derived parser type, so an overload found
+    through argument dependent lookup for a derived parser, or for a
+    @ref parser instantiated with a user-defined body type, replaces
+    the default policy.
+
+    @param parser The parser which will receive the bytes read.
+
+    @param previous The value returned by the previous call while
+    reading the same message, or zero for the first read.
+
+    @return The number of bytes to request, which must be non-zero.
+*/
+template<bool isRequest, class Derived, class Protocol>
+std::size_t
+read_size_hint(
+    basic_parser<isRequest, Derived, Protocol> const& parser,
+    std::size_t previous);
+
 //------------------------------------------------------------------------------
 
 /** Read part of a message from a stream using a parser.
@@ -72,12 +108,12 @@ namespace http {
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read_some(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser);
+    basic_parser<isRequest, Derived, Protocol>& parser);
 
 /** Read part of a message from a stream using a parser.
 
@@ -129,12 +165,12 @@ read_some(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read_some(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     error_code& ec);
 
 /** Read part of a message asynchronously from a stream using a parser.
@@ -202,14 +238,14 @@ read_some(
 template<
     class AsyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived,
+    bool isRequest, class Derived, class Protocol,
     class ReadHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(
     ReadHandler, void(error_code, std::size_t))
 async_read_some(
     AsyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     ReadHandler&& handler);
 
 //------------------------------------------------------------------------------
@@ -264,12 +300,12 @@ async_read_some(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read_header(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser);
+    basic_parser<isRequest, Derived, Protocol>& parser);
 
 /** Read a complete message header from a stream using a parser.
 
@@ -321,12 +357,12 @@ read_header(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read_header(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     error_code& ec);
 
 /** Read a complete message header asynchronously from a stream using a parser.
@@ -395,14 +431,14 @@ read_header(
 template<
     class AsyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived,
+    bool isRequest, class Derived, class Protocol,
     class ReadHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(
     ReadHandler, void(error_code, std::size_t))
 async_read_header(
     AsyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     ReadHandler&& handler);
 
 //------------------------------------------------------------------------------
@@ -457,12 +493,12 @@ async_read_header(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser);
+    basic_parser<isRequest, Derived, Protocol>& parser);
 
 /** Read a complete message from a stream using a parser.
 
@@ -514,12 +550,12 @@ read(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived>
+    bool isRequest, class Derived, class Protocol>
 std::size_t
 read(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     error_code& ec);
 
 /** Read a complete message asynchronously from a stream using a parser.
@@ -588,14 +624,14 @@ read(
 template<
     class AsyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Derived,
+    bool isRequest, class Derived, class Protocol,
     class ReadHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(
     ReadHandler, void(error_code, std::size_t))
 async_read(
     AsyncReadStream& stream,
     DynamicBuffer& buffer,
-    basic_parser<isRequest, Derived>& parser,
+    basic_parser<isRequest, Derived, Protocol>& parser,
     ReadHandler&& handler);
 
 //------------------------------------------------------------------------------
@@ -653,12 +689,12 @@ async_read(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Body, class Allocator>
+    bool isRequest, class Body, class Allocator, class Protocol>
 std::size_t
 read(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    message<isRequest, Body, basic_fields<Allocator>>& msg);
+    message<isRequest, Body, basic_fields<Allocator, Protocol>>& msg);
 
 /** Read a complete message from a stream.
 
@@ -713,12 +749,12 @@ read(
 template<
     class SyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Body, class Allocator>
+    bool isRequest, class Body, class Allocator, class Protocol>
 std::size_t
 read(
     SyncReadStream& stream,
     DynamicBuffer& buffer,
-    message<isRequest, Body, basic_fields<Allocator>>& msg,
+    message<isRequest, Body, basic_fields<Allocator, Protocol>>& msg,
     error_code& ec);
 
 /** Read a complete message asynchronously from a stream.
@@ -790,14 +826,14 @@ read(
 template<
     class AsyncReadStream,
     class DynamicBuffer,
-    bool isRequest, class Body, class Allocator,
+    bool isRequest, class Body, class Allocator, class Protocol,
     class ReadHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(
     ReadHandler, void(error_code, std::size_t))
 async_read(
     AsyncReadStream& stream,
     DynamicBuffer& buffer,
-    message<isRequest, Body, basic_fields<Allocator>>& msg,
+    message<isRequest, Body, basic_fields<Allocator, Protocol>>& msg,
     ReadHandler&& handler);
 
 } // http
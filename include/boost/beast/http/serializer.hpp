@@ -14,6 +14,7 @@
 #include <boost/beast/core/buffers_cat.hpp>
 #include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/core/type_traits.hpp>
 #include <boost/beast/core/detail/variant.hpp>
@@ -44,6 +45,13 @@ namespace http {
     the chunk buffer sequence types @ref chunk_body, @ref chunk_crlf,
     @ref chunk_header, and @ref chunk_last.
 
+    By default each buffer returned by the body writer becomes one
+    chunk. When the body is produced in many small pieces, for example
+    with @ref buffer_body, the framing overhead may be reduced by
+    setting a coalescing threshold with @ref coalesce. Body octets
+    are then accumulated into an internal buffer until the threshold
+    is reached, the body is complete, or @ref flush is called.
+
     @tparam isRequest `true` if the message is a request.
 
     @tparam Body The body type of the message.
@@ -101,8 +109,9 @@ private:
         do_body_final_c     = 100,
         do_all_c            = 110,
     #endif
+        do_body_cc          = 120,
 
-        do_complete         = 120
+        do_complete         = 130
     };
 
     void fwrinit(std::true_type);
@@ -173,19 +182,43 @@ private:
         chunk_crlf>>;                               // crlf
     using pcb8_t = buffers_prefix_view<cb8_t const&>;
 
+    using cb9_t = buffers_suffix<buffers_cat_view<
+        detail::chunk_size,                         // chunk-header
+        net::const_buffer,                          // chunk-ext
+        chunk_crlf,                                 // crlf
+        net::const_buffer,                          // coalesced body
+        chunk_crlf>>;                               // crlf
+    using pcb9_t = buffers_prefix_view<cb9_t const&>;
+
+    using cb10_t = buffers_suffix<buffers_cat_view<
+        detail::chunk_size,                         // chunk-header
+        net::const_buffer,                          // chunk-ext
+        chunk_crlf,                                 // crlf
+        net::const_buffer,                          // coalesced body
+        chunk_crlf,                                 // crlf
+        net::const_buffer,                          // chunk-final
+        net::const_buffer,                          // trailers
+        chunk_crlf>>;                               // crlf
+    using pcb10_t = buffers_prefix_view<cb10_t const&>;
+
     value_type& m_;
     writer wr_;
     boost::optional<typename Fields::writer> fwr_;
     beast::detail::variant<
         cb1_t, cb2_t, cb3_t, cb4_t,
-        cb5_t ,cb6_t, cb7_t, cb8_t> v_;
+        cb5_t ,cb6_t, cb7_t, cb8_t,
+        cb9_t, cb10_t> v_;
     beast::detail::variant<
         pcb1_t, pcb2_t, pcb3_t, pcb4_t,
-        pcb5_t ,pcb6_t, pcb7_t, pcb8_t> pv_;
+        pcb5_t ,pcb6_t, pcb7_t, pcb8_t,
+        pcb9_t, pcb10_t> pv_;
+    flat_buffer cb_;
     std::size_t limit_ =
         (std::numeric_limits<std::size_t>::max)();
+    std::size_t coalesce_ = 0;
     int s_ = do_construct;
     bool split_ = false;
+    bool flush_ = false;
     bool header_done_ = false;
     bool more_;
 
@@ -248,6 +281,58 @@ public:
             (std::numeric_limits<std::size_t>::max)();
     }
 
+    /// Returns the chunk coalescing threshold
+    std::size_t
+    coalesce()
+    {
+        return coalesce_;
+    }
+
+    /** Set the chunk coalescing threshold
+
+        This function sets the minimum number of body octets
+        which are accumulated before a chunk is produced, when
+        the message is serialized using the chunked encoding.
+        Buffers returned by the body writer are copied into an
+        internal buffer until at least this many octets are
+        available, the body is complete, or @ref flush is called.
+        The new threshold takes effect in the following call
+        to @ref next.
+
+        If the body writer indicates that it has no more octets
+        available right now, the error is reported from @ref next
+        and the octets already received are retained for the
+        next chunk.
+
+        The default is zero, which emits one chunk for each
+        buffer returned by the body writer. This setting has no
+        effect on messages which are not chunked.
+
+        @param n The new threshold, in octets.
+    */
+    void
+    coalesce(std::size_t n)
+    {
+        coalesce_ = n;
+    }
+
+    /** Emit coalesced body octets at the next opportunity.
+
+        When a coalescing threshold is set, this function causes
+        the following call to @ref next to produce a chunk
+        containing any retained body octets, even if the threshold
+        has not been reached. This is intended for latency
+        sensitive streams, such as server-sent events, where
+        each piece of the body should be delivered promptly.
+
+        The request is cleared once a chunk is produced.
+    */
+    void
+    flush()
+    {
+        flush_ = true;
+    }
+
     /** Returns `true` if we will pause after writing the complete header.
     */
     bool
@@ -14,6 +14,8 @@
 #include <boost/beast/core/span.hpp>
 #include <boost/beast/http/error.hpp>
 #include <boost/beast/http/message.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/assert.hpp>
 #include <boost/optional.hpp>
 
 namespace boost {
@@ -112,6 +114,27 @@ public:
             return n;
         }
 
+        net::mutable_buffer
+        prepare(std::size_t n, error_code& ec)
+        {
+            if(n > body_.size())
+            {
+                ec = error::buffer_overflow;
+                return {};
+            }
+            ec = {};
+            return net::mutable_buffer(body_.data(), n);
+        }
+
+        void
+        commit(std::size_t n, error_code& ec)
+        {
+            BOOST_ASSERT(n <= body_.size());
+            body_ = value_type{
+                body_.data() + n, body_.size() - n};
+            ec = {};
+        }
+
         void
         finish(error_code& ec)
         {
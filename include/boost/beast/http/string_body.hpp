@@ -16,6 +16,7 @@
 #include <boost/beast/core/buffers_range.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/asio/buffer.hpp>
+#include <boost/assert.hpp>
 #include <boost/optional.hpp>
 #include <cstdint>
 #include <limits>
@@ -78,6 +79,7 @@ public:
     class reader
     {
         value_type& body_;
+        std::size_t prepared_ = 0;
 
     public:
         template<bool isRequest, class Fields>
@@ -141,6 +143,33 @@ public:
             return extra;
         }
 
+        net::mutable_buffer
+        prepare(std::size_t n, error_code& ec)
+        {
+            auto const size = body_.size();
+            try
+            {
+                body_.resize(size + n);
+            }
+            catch(std::exception const&)
+            {
+                ec = error::buffer_overflow;
+                return {};
+            }
+            ec = {};
+            prepared_ = n;
+            return net::mutable_buffer(&body_[0] + size, n);
+        }
+
+        void
+        commit(std::size_t n, error_code& ec)
+        {
+            BOOST_ASSERT(n <= prepared_);
+            body_.resize(body_.size() - (prepared_ - n));
+            prepared_ = 0;
+            ec = {};
+        }
+
         void
         finish(error_code& ec)
         {
@@ -15,6 +15,7 @@
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/asio/buffer.hpp>
+#include <boost/assert.hpp>
 #include <boost/optional.hpp>
 #include <cstdint>
 #include <limits>
@@ -72,6 +73,7 @@ public:
     class reader
     {
         value_type& body_;
+        std::size_t prepared_ = 0;
 
     public:
         template<bool isRequest, class Fields>
@@ -129,6 +131,33 @@ public:
                 &body_[0] + len, n), buffers);
         }
 
+        net::mutable_buffer
+        prepare(std::size_t n, error_code& ec)
+        {
+            auto const size = body_.size();
+            try
+            {
+                body_.resize(size + n);
+            }
+            catch(std::exception const&)
+            {
+                ec = error::buffer_overflow;
+                return {};
+            }
+            ec = {};
+            prepared_ = n;
+            return net::mutable_buffer(&body_[0] + size, n);
+        }
+
+        void
+        commit(std::size_t n, error_code& ec)
+        {
+            BOOST_ASSERT(n <= prepared_);
+            body_.resize(body_.size() - (prepared_ - n));
+            prepared_ = 0;
+            ec = {};
+        }
+
         void
         finish(error_code& ec)
         {
@@ -2,8 +2,14 @@
 #define BOOST_BEAST_SIP_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/sip/batch.hpp>
+#include <boost/beast/sip/connection.hpp>
+#include <boost/beast/sip/datagram.hpp>
+#include <boost/beast/sip/editor.hpp>
 #include <boost/beast/sip/fields.hpp>
 #include <boost/beast/sip/message.hpp>
 #include <boost/beast/sip/parser.hpp>
+#include <boost/beast/sip/rfc3261.hpp>
+#include <boost/beast/sip/transaction.hpp>
 
 #endif
@@ -0,0 +1,441 @@
+#ifndef BOOST_BEAST_SIP_BATCH_HPP
+#define BOOST_BEAST_SIP_BATCH_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/sip/datagram.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+namespace detail {
+struct batch_access;
+} // detail
+
+/** Storage for a batch of datagrams.
+
+    This container holds up to a fixed number of datagrams, each
+    in its own fixed-size buffer carved from a single allocation,
+    together with the endpoint each datagram came from or is
+    going to. It is used by @ref receive_batch to receive many
+    datagrams with one system call, and by @ref send_batch to
+    send many datagrams with one system call.
+
+    The storage is allocated once on construction and reused by
+    every operation which is given the batch. A received datagram
+    which does not fit in its buffer is truncated, and where the
+    platform reports it, this is indicated by @ref truncated.
+
+    @tparam Endpoint The type of endpoint, which must provide
+    `data`, `size`, `capacity` and `resize` with the same
+    semantics as `net::ip::udp::endpoint`.
+*/
+template<class Endpoint>
+class basic_datagram_batch
+{
+    friend struct detail::batch_access;
+
+    struct entry
+    {
+        Endpoint endpoint;
+        std::size_t size = 0;
+        bool truncated = false;
+    };
+
+    std::unique_ptr<char[]> p_;
+    std::unique_ptr<entry[]> v_;
+    std::size_t capacity_;
+    std::size_t buffer_size_;
+    std::size_t n_ = 0;
+
+    char*
+    buffer(std::size_t i) const noexcept
+    {
+        return p_.get() + i * buffer_size_;
+    }
+
+public:
+    /// The type of endpoint
+    using endpoint_type = Endpoint;
+
+    /** The default size of the buffer for each datagram.
+
+        This comfortably holds a SIP message which is sent over
+        UDP without fragmentation; see rfc3261 section 18.1.1.
+    */
+    static std::size_t constexpr default_buffer_size = 4096;
+
+    /** Constructor
+
+        @param capacity The largest number of datagrams in the batch.
+
+        @param buffer_size The number of octets of storage for each
+        datagram. To receive any datagram without truncation, use
+        @ref datagram_buffer::max_size.
+    */
+    explicit
+    basic_datagram_batch(
+        std::size_t capacity,
+        std::size_t buffer_size = default_buffer_size)
+        : p_(new char[capacity * buffer_size])
+        , v_(new entry[capacity])
+        , capacity_(capacity)
+        , buffer_size_(buffer_size)
+    {
+        BOOST_ASSERT(capacity > 0);
+        BOOST_ASSERT(buffer_size > 0);
+        BOOST_ASSERT(buffer_size <= datagram_buffer::max_size);
+    }
+
+    /// Returns the largest number of datagrams in the batch
+    std::size_t
+    capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    /// Returns the number of octets of storage for each datagram
+    std::size_t
+    buffer_size() const noexcept
+    {
+        return buffer_size_;
+    }
+
+    /// Returns the number of datagrams in the batch
+    std::size_t
+    size() const noexcept
+    {
+        return n_;
+    }
+
+    /// Returns `true` if the batch holds no datagrams
+    bool
+    empty() const noexcept
+    {
+        return n_ == 0;
+    }
+
+    /// Returns `true` if no more datagrams can be added
+    bool
+    full() const noexcept
+    {
+        return n_ == capacity_;
+    }
+
+    /// Remove all datagrams from the batch
+    void
+    clear() noexcept
+    {
+        n_ = 0;
+    }
+
+    /// Returns the octets of the datagram at index `i`
+    net::const_buffer
+    data(std::size_t i) const noexcept
+    {
+        BOOST_ASSERT(i < n_);
+        return {buffer(i), v_[i].size};
+    }
+
+    /** Returns the endpoint of the datagram at index `i`
+
+        For a received datagram this is the sender, and for a
+        datagram to be sent this is the destination.
+    */
+    Endpoint const&
+    endpoint(std::size_t i) const noexcept
+    {
+        BOOST_ASSERT(i < n_);
+        return v_[i].endpoint;
+    }
+
+    /** Returns `true` if the received datagram at index `i` was truncated
+
+        Truncation is detected when datagrams are received with
+        `recvmmsg`, or when `receive_from` reports it as the error
+        `net::error::message_size`.
+    */
+    bool
+    truncated(std::size_t i) const noexcept
+    {
+        BOOST_ASSERT(i < n_);
+        return v_[i].truncated;
+    }
+
+    /** Returns the storage for the next datagram to be sent
+
+        The returned buffer is valid until @ref commit or
+        @ref clear is called.
+    */
+    net::mutable_buffer
+    prepare() noexcept
+    {
+        BOOST_ASSERT(! full());
+        return {buffer(n_), buffer_size_};
+    }
+
+    /** Add the datagram in the storage returned by @ref prepare
+
+        @param n The number of octets in the datagram.
+
+        @param destination The endpoint to send the datagram to.
+    */
+    void
+    commit(std::size_t n, Endpoint const& destination)
+    {
+        BOOST_ASSERT(! full());
+        BOOST_ASSERT(n <= buffer_size_);
+        auto& e = v_[n_++];
+        e.endpoint = destination;
+        e.size = n;
+        e.truncated = false;
+    }
+};
+
+/// A batch of UDP datagrams
+using datagram_batch =
+    basic_datagram_batch<net::ip::udp::endpoint>;
+
+/** Serialize a message and add it to a batch of datagrams.
+
+    The entire message is written into the storage for the next
+    datagram of the batch, as with @ref serialize_datagram.
+
+    @param batch The batch to add the datagram to, which must
+    not be full.
+
+    @param msg The message to serialize.
+
+    @param destination The endpoint to send the datagram to.
+
+    @param ec Set to the error, if any occurred. The error
+    @ref http::error::buffer_overflow is returned when the
+    message does not fit in the buffer for one datagram, in
+    which case the batch is unchanged.
+*/
+template<
+    class Endpoint,
+    bool isRequest, class Body, class Fields>
+void
+serialize_datagram(
+    basic_datagram_batch<Endpoint>& batch,
+    http::message<isRequest, Body, Fields> const& msg,
+    Endpoint const& destination,
+    error_code& ec);
+
+//------------------------------------------------------------------------------
+
+/** Receive a batch of datagrams on a socket.
+
+    This function is used to receive as many datagrams as are
+    available on the socket, up to the capacity of the batch.
+    The call will block until at least one datagram is received
+    or an error occurs. Datagrams which arrive after the first
+    are not waited for.
+
+    On Linux the datagrams are received with `recvmmsg`, up to
+    64 for each system call; elsewhere each is received with
+    `receive_from`.
+    The batch is cleared before receiving. Each datagram may be
+    parsed with @ref parse_datagram, for example:
+
+    @code
+    boost::optional<udp_parser<true, http::string_body>> p;
+    auto const n = receive_batch(socket, batch);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        if(batch.truncated(i))
+            continue;
+        error_code ec;
+        p.emplace();
+        parse_datagram(*p, batch.data(i), ec);
+        ...
+    }
+    @endcode
+
+    @param socket The socket to receive from. The type must
+    provide `native_handle`, `non_blocking`, `wait`, `available`
+    and `receive_from` with the same semantics as
+    `net::ip::udp::socket`.
+
+    @param batch The batch to receive into.
+
+    @param ec Set to the error, if any occurred.
+
+    @return The number of datagrams received.
+*/
+template<class DatagramSocket>
+std::size_t
+receive_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type>& batch,
+    error_code& ec);
+
+/** Receive a batch of datagrams on a socket.
+
+    This function is used to receive as many datagrams as are
+    available on the socket, up to the capacity of the batch.
+    The call will block until at least one datagram is received
+    or an error occurs.
+
+    @param socket The socket to receive from.
+
+    @param batch The batch to receive into.
+
+    @return The number of datagrams received.
+
+    @throws system_error Thrown on failure.
+*/
+template<class DatagramSocket>
+std::size_t
+receive_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type>& batch);
+
+/** Receive a batch of datagrams on a socket asynchronously.
+
+    This function is used to asynchronously receive as many
+    datagrams as are available on the socket, up to the capacity
+    of the batch. The operation completes when at least one
+    datagram is received or an error occurs. The function call
+    always returns immediately.
+
+    The socket is waited on for readability with `async_wait`,
+    and the datagrams which are then available are received
+    without blocking, as with @ref receive_batch.
+
+    @param socket The socket to receive from. The type must
+    provide `async_wait` in addition to the requirements of
+    @ref receive_batch.
+
+    @param batch The batch to receive into. The object must
+    remain valid until the handler is called.
+
+    @param handler The completion handler to invoke when the
+    operation completes. The equivalent function signature of
+    the handler must be:
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t count               // the number of datagrams received
+    );
+    @endcode
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::io_context::post`.
+*/
+template<class DatagramSocket, class ReceiveHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReceiveHandler, void(error_code, std::size_t))
+async_receive_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type>& batch,
+    ReceiveHandler&& handler);
+
+//------------------------------------------------------------------------------
+
+/** Send a batch of datagrams on a socket.
+
+    This function is used to send every datagram in the batch
+    to its destination. The call will block until all of the
+    datagrams are sent or an error occurs.
+
+    On Linux the datagrams are sent with as few calls to
+    `sendmmsg` as the system allows; elsewhere each is sent
+    with `send_to`. The batch is not modified.
+
+    @param socket The socket to send on. The type must provide
+    `native_handle`, `non_blocking`, `wait` and `send_to` with
+    the same semantics as `net::ip::udp::socket`.
+
+    @param batch The datagrams to send.
+
+    @param ec Set to the error, if any occurred.
+
+    @return The number of datagrams sent. When an error occurs,
+    this is the index of the datagram which failed.
+*/
+template<class DatagramSocket>
+std::size_t
+send_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type> const& batch,
+    error_code& ec);
+
+/** Send a batch of datagrams on a socket.
+
+    This function is used to send every datagram in the batch
+    to its destination. The call will block until all of the
+    datagrams are sent or an error occurs.
+
+    @param socket The socket to send on.
+
+    @param batch The datagrams to send.
+
+    @return The number of datagrams sent.
+
+    @throws system_error Thrown on failure.
+*/
+template<class DatagramSocket>
+std::size_t
+send_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type> const& batch);
+
+/** Send a batch of datagrams on a socket asynchronously.
+
+    This function is used to asynchronously send every datagram
+    in the batch to its destination. The function call always
+    returns immediately.
+
+    @param socket The socket to send on. The type must provide
+    `async_wait` in addition to the requirements of
+    @ref send_batch.
+
+    @param batch The datagrams to send. The object must remain
+    valid until the handler is called.
+
+    @param handler The completion handler to invoke when the
+    operation completes. The equivalent function signature of
+    the handler must be:
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t count               // the number of datagrams sent
+    );
+    @endcode
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::io_context::post`.
+*/
+template<class DatagramSocket, class SendHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    SendHandler, void(error_code, std::size_t))
+async_send_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type> const& batch,
+    SendHandler&& handler);
+
+} // sip
+} // beast
+} // boost
+
+#include <boost/beast/sip/impl/batch.ipp>
+
+#endif
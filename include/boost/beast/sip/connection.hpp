@@ -0,0 +1,447 @@
+#ifndef BOOST_BEAST_SIP_CONNECTION_HPP
+#define BOOST_BEAST_SIP_CONNECTION_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/sip/message.hpp>
+#include <boost/beast/sip/parser.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+/** A histogram of latencies.
+
+    Each recorded latency is counted in one of a fixed number of
+    buckets whose widths double, so that the histogram covers
+    latencies from a microsecond to many minutes in constant space
+    and records each sample in constant time. Bucket 0 counts the
+    latencies under one microsecond, and bucket `i` counts those
+    of at least `upper_bound(i - 1)` and under `upper_bound(i)`.
+    The last bucket also counts every longer latency.
+*/
+class latency_histogram
+{
+public:
+    /// The type of latency
+    using duration = std::chrono::microseconds;
+
+    /// The number of buckets
+    static std::size_t constexpr bucket_count = 32;
+
+private:
+    std::uint64_t v_[bucket_count] = {};
+    std::uint64_t n_ = 0;
+
+public:
+    /// Record a latency
+    void
+    record(duration d) noexcept;
+
+    /// Returns the number of latencies recorded
+    std::uint64_t
+    count() const noexcept
+    {
+        return n_;
+    }
+
+    /// Returns the number of latencies in bucket `i`
+    std::uint64_t
+    bucket(std::size_t i) const noexcept
+    {
+        BOOST_ASSERT(i < bucket_count);
+        return v_[i];
+    }
+
+    /// Returns the smallest latency above those in bucket `i`
+    static
+    duration
+    upper_bound(std::size_t i) noexcept
+    {
+        BOOST_ASSERT(i < bucket_count);
+        return duration(std::int64_t(1) << i);
+    }
+
+    /** Returns an upper bound on a percentile of the latencies.
+
+        @param p The percentile, from 0 to 100.
+
+        @return The upper bound of the bucket holding the latency
+        at percentile `p`, or zero if no latencies are recorded.
+    */
+    duration
+    percentile(double p) const noexcept;
+
+    /// Forget every recorded latency
+    void
+    clear() noexcept;
+};
+
+//------------------------------------------------------------------------------
+
+/** A persistent connection carrying SIP messages over a stream.
+
+    Over a stream transport such as TCP or TLS, a SIP element
+    keeps one connection to each next hop and sends every
+    transaction with that hop over it; see rfc3261 section 18.
+    This object owns the stream of such a connection, frames the
+    inbound octets into messages, and queues outbound messages.
+
+    Inbound messages are framed by their Content-Length using a
+    @ref tcp_parser constructed in storage which is reused by
+    each message, and read through a single buffer, so that
+    several messages arriving in one segment are delivered one
+    at a time without further reads. Empty lines between
+    messages, such as the keep-alives of rfc5626 section 3.5.1,
+    are discarded. Responses are matched to their transactions
+    by the caller, for example with @ref transaction_table.
+
+    Outbound messages are serialized into a queue as they are
+    sent. While a write is in progress, every message sent is
+    appended to the next write, so that a burst of messages is
+    written with one call to the stream instead of one call per
+    message. The time each message spends queued and written is
+    recorded in a @ref latency_histogram.
+
+    Opening the stream, including connecting and performing any
+    TLS handshake, is the responsibility of the caller. The
+    connection is created by `std::make_shared`, as its writes
+    extend its lifetime.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe. The application must also ensure
+    that all asynchronous operations are performed within the same
+    implicit or explicit strand as the stream.
+
+    @tparam NextLayer The type of stream, such as
+    `net::ip::tcp::socket` or `net::ssl::stream<net::ip::tcp::socket>`.
+
+    @tparam Body The type of body of the inbound messages.
+*/
+template<class NextLayer, class Body = http::string_body>
+class basic_connection
+    : public std::enable_shared_from_this<
+        basic_connection<NextLayer, Body>>
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Serialized messages and the time each was sent
+    struct queue
+    {
+        std::string s;
+        std::vector<clock_type::time_point> t;
+    };
+
+    NextLayer stream_;
+    flat_buffer buffer_;
+    boost::optional<tcp_parser<true, Body>> req_;
+    boost::optional<tcp_parser<false, Body>> res_;
+    bool is_request_ = false;
+    bool writing_ = false;
+    queue q_[2];
+    error_code ec_;
+    std::atomic<bool> open_{true};
+    latency_histogram latency_;
+
+    template<class Handler>
+    class read_op;
+
+    void fail(error_code ec);
+    void do_write();
+    void on_write(error_code ec);
+
+public:
+    /// The type of the next layer
+    using next_layer_type = NextLayer;
+
+    /// The type of inbound request
+    using request_type = tcp_request<Body>;
+
+    /// The type of inbound response
+    using response_type = tcp_response<Body>;
+
+    /** Constructor
+
+        @param args Arguments forwarded to the constructor of
+        the stream.
+    */
+    template<class... Args>
+    explicit
+    basic_connection(Args&&... args)
+        : stream_(std::forward<Args>(args)...)
+    {
+    }
+
+    /// Returns the stream
+    NextLayer&
+    next_layer() noexcept
+    {
+        return stream_;
+    }
+
+    /// Returns the stream
+    NextLayer const&
+    next_layer() const noexcept
+    {
+        return stream_;
+    }
+
+    /** Returns `true` if the connection may be used.
+
+        A connection fails when a read or write on its stream
+        fails, or when the inbound octets cannot be framed. The
+        messages queued are then discarded. This function may
+        be called from any thread.
+    */
+    bool
+    is_open() const noexcept
+    {
+        return open_;
+    }
+
+    /// Returns the error which failed the connection, if any
+    error_code const&
+    error() const noexcept
+    {
+        return ec_;
+    }
+
+    /** Read the next message.
+
+        This function is used to asynchronously read the next
+        complete message from the stream. When the operation
+        completes successfully, @ref is_request indicates the
+        kind of message, which is returned by @ref request or
+        @ref response.
+
+        @param handler The completion handler to invoke when the
+        operation completes. The equivalent function signature of
+        the handler must be:
+        @code
+        void handler(
+            error_code const& error,        // result of operation
+            std::size_t bytes_transferred   // the number of octets read from the stream
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::io_context::post`.
+    */
+    template<class ReadHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(
+        ReadHandler, void(error_code, std::size_t))
+    async_read(ReadHandler&& handler);
+
+    /// Returns `true` if the message read last is a request
+    bool
+    is_request() const noexcept
+    {
+        return is_request_;
+    }
+
+    /** Returns the request read last.
+
+        The request remains valid until the next read.
+
+        @par Preconditions
+        `is_request() == true`
+    */
+    request_type&
+    request()
+    {
+        BOOST_ASSERT(is_request_ && req_);
+        return req_->get();
+    }
+
+    /** Returns the response read last.
+
+        The response remains valid until the next read.
+
+        @par Preconditions
+        `is_request() == false`
+    */
+    response_type&
+    response()
+    {
+        BOOST_ASSERT(! is_request_ && res_);
+        return res_->get();
+    }
+
+    /** Send a message.
+
+        The message is serialized into the queue of the connection
+        and written later, together with every other message queued
+        before the write begins. The message may be destroyed when
+        this function returns.
+
+        @param msg The message to send.
+
+        @param ec Set to the error, if any occurred. When the
+        connection has failed, this is the error which failed it.
+    */
+    template<bool isRequest, class OtherBody, class Fields>
+    void
+    send(
+        http::message<isRequest, OtherBody, Fields> const& msg,
+        error_code& ec);
+
+    /** Send a message.
+
+        @param msg The message to send.
+
+        @throws system_error Thrown on failure.
+    */
+    template<bool isRequest, class OtherBody, class Fields>
+    void
+    send(http::message<isRequest, OtherBody, Fields> const& msg);
+
+    /// Returns the number of messages queued or being written
+    std::size_t
+    queue_depth() const noexcept
+    {
+        return q_[0].t.size() + q_[1].t.size();
+    }
+
+    /// Returns the number of octets queued or being written
+    std::size_t
+    queue_size() const noexcept
+    {
+        return q_[0].s.size() + q_[1].s.size();
+    }
+
+    /** Returns the latencies of the messages sent.
+
+        The latency of a message is the time from the call to
+        @ref send until its last octet is written to the stream.
+    */
+    latency_histogram const&
+    latency() const noexcept
+    {
+        return latency_;
+    }
+
+    /// Forget the recorded latencies
+    void
+    clear_latency() noexcept
+    {
+        latency_.clear();
+    }
+};
+
+/// A connection carrying SIP messages over TCP
+using connection = basic_connection<net::ip::tcp::socket>;
+
+//------------------------------------------------------------------------------
+
+/** A pool of persistent connections, one for each next hop.
+
+    A SIP element which forwards over stream transports looks up
+    the connection to the next hop of each message, and opens one
+    only when none exists or the previous one has failed. This
+    pool maps each next hop to its connection.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Safe. Each connection must still be used
+    within the strand of its stream.
+
+    @tparam Connection The type of connection, such as
+    @ref basic_connection.
+
+    @tparam Key The type identifying the next hop. To share one
+    connection between the transactions to a host, including the
+    server name checked by TLS, the key should identify the host
+    as well as the endpoint.
+*/
+template<
+    class Connection,
+    class Key = net::ip::tcp::endpoint>
+class connection_pool
+{
+    std::mutex mutable m_;
+    std::map<Key, std::shared_ptr<Connection>> map_;
+
+public:
+    /// The type of connection
+    using connection_type = Connection;
+
+    /// The type identifying the next hop
+    using key_type = Key;
+
+    /** Returns the open connection to a next hop.
+
+        A failed connection to the next hop is removed.
+
+        @return The connection, or null if there is no open
+        connection to the next hop.
+    */
+    std::shared_ptr<Connection>
+    find(Key const& key);
+
+    /** Add a connection to a next hop.
+
+        The connection is constructed from the arguments, which
+        are forwarded to the constructor of its stream, and
+        replaces any connection to the next hop. The stream must
+        be opened by the caller.
+
+        @return The new connection.
+    */
+    template<class... Args>
+    std::shared_ptr<Connection>
+    emplace(Key const& key, Args&&... args);
+
+    /** Remove the connection to a next hop.
+
+        The connection is destroyed once no asynchronous
+        operation or other owner refers to it.
+
+        @return `true` if a connection was removed.
+    */
+    bool
+    erase(Key const& key);
+
+    /// Returns the number of connections in the pool
+    std::size_t
+    size() const;
+
+    /** Call a function with each connection in the pool.
+
+        The function is called while the pool is locked, with
+        the equivalent signature:
+        @code
+        void f(Key const& key, std::shared_ptr<Connection> const& c);
+        @endcode
+        It may be used to gather the queue depth and latencies
+        of each connection, but it must not use the pool.
+    */
+    template<class Function>
+    void
+    for_each(Function&& f) const;
+};
+
+} // sip
+} // beast
+} // boost
+
+#include <boost/beast/sip/impl/connection.ipp>
+
+#endif
@@ -0,0 +1,341 @@
+#ifndef BOOST_BEAST_SIP_DATAGRAM_HPP
+#define BOOST_BEAST_SIP_DATAGRAM_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/http/basic_parser.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+/** Storage for one datagram.
+
+    This buffer holds a received datagram while it is parsed, or
+    a message serialized for sending. The storage is allocated
+    once, large enough for any datagram, and is reused by every
+    operation which is given the buffer, so that receiving or
+    sending a message does not allocate memory for the octets
+    on the wire. A program typically keeps one buffer for each
+    outstanding operation on a socket.
+*/
+class datagram_buffer
+{
+    std::unique_ptr<char[]> p_;
+    std::size_t size_ = 0;
+
+public:
+    /// The largest number of octets in a datagram
+    static std::size_t constexpr max_size = 65535;
+
+    /// Constructor
+    datagram_buffer()
+        : p_(new char[max_size])
+    {
+    }
+
+    /// Returns the octets of the last datagram stored in the buffer
+    net::const_buffer
+    data() const noexcept
+    {
+        return {p_.get(), size_};
+    }
+
+    /// Returns the storage for the next datagram
+    net::mutable_buffer
+    prepare() noexcept
+    {
+        size_ = 0;
+        return {p_.get(), max_size};
+    }
+
+    /// Set the number of octets of the datagram in the storage
+    void
+    commit(std::size_t n) noexcept
+    {
+        BOOST_ASSERT(n <= max_size);
+        size_ = n;
+    }
+};
+
+/** Parse a received datagram using a parser.
+
+    The octets of the datagram are presented to the parser,
+    which must not have received any octets. Following the
+    rules for message-oriented transports in rfc3261 section
+    18.3, when the header has a Content-Length, octets beyond
+    the end of the body are discarded, and when it has none,
+    the body ends at the end of the datagram.
+
+    @param parser The parser to use.
+
+    @param buffer The octets of the datagram.
+
+    @param ec Set to the error, if any occurred. The error
+    @ref http::error::partial_message is returned when the
+    datagram ends before the message is complete.
+*/
+template<bool isRequest, class Derived, class Protocol>
+void
+parse_datagram(
+    http::basic_parser<isRequest, Derived, Protocol>& parser,
+    net::const_buffer buffer,
+    error_code& ec);
+
+/** Serialize a message into a datagram.
+
+    The entire message is written into the buffer, which is
+    sent as a single datagram. Field names are written as
+    stored in the container; the @ref udp_fields container
+    stores the compact form of names which have one.
+
+    @param buffer The buffer to store the datagram in.
+
+    @param msg The message to serialize.
+
+    @param ec Set to the error, if any occurred. The error
+    @ref http::error::buffer_overflow is returned when the
+    message does not fit in a datagram.
+*/
+template<bool isRequest, class Body, class Fields>
+void
+serialize_datagram(
+    datagram_buffer& buffer,
+    http::message<isRequest, Body, Fields> const& msg,
+    error_code& ec);
+
+//------------------------------------------------------------------------------
+
+/** Receive a message on a datagram socket using a parser.
+
+    This function is used to receive one datagram from a socket
+    and parse it as a complete message. The call will block
+    until a datagram is received or an error occurs.
+
+    The datagram is received into the buffer and parsed in place
+    with @ref parse_datagram. The parser enforces its body limit,
+    which for the datagram protocol defaults to 65335 octets.
+
+    @param socket The socket to receive from. The type must
+    provide a member function `receive_from` with the same
+    semantics as `net::ip::udp::socket`.
+
+    @param buffer Storage for the received datagram.
+
+    @param parser The parser to use, which must not have
+    received any octets.
+
+    @param sender Set to the endpoint the datagram came from.
+
+    @param ec Set to the error, if any occurred.
+
+    @return The number of octets in the datagram.
+*/
+template<
+    class DatagramSocket,
+    bool isRequest, class Derived, class Protocol>
+std::size_t
+receive_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::basic_parser<isRequest, Derived, Protocol>& parser,
+    typename DatagramSocket::endpoint_type& sender,
+    error_code& ec);
+
+/** Receive a message on a datagram socket using a parser.
+
+    This function is used to receive one datagram from a socket
+    and parse it as a complete message. The call will block
+    until a datagram is received or an error occurs.
+
+    @param socket The socket to receive from.
+
+    @param buffer Storage for the received datagram.
+
+    @param parser The parser to use, which must not have
+    received any octets.
+
+    @param sender Set to the endpoint the datagram came from.
+
+    @return The number of octets in the datagram.
+
+    @throws system_error Thrown on failure.
+*/
+template<
+    class DatagramSocket,
+    bool isRequest, class Derived, class Protocol>
+std::size_t
+receive_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::basic_parser<isRequest, Derived, Protocol>& parser,
+    typename DatagramSocket::endpoint_type& sender);
+
+/** Receive a message on a datagram socket asynchronously.
+
+    This function is used to asynchronously receive one datagram
+    from a socket and parse it as a complete message. The function
+    call always returns immediately.
+
+    @param socket The socket to receive from. The type must
+    provide a member function `async_receive_from` with the same
+    semantics as `net::ip::udp::socket`.
+
+    @param buffer Storage for the received datagram. The object
+    must remain valid until the handler is called.
+
+    @param parser The parser to use, which must not have received
+    any octets. The object must remain valid until the handler is
+    called.
+
+    @param sender Set to the endpoint the datagram came from. The
+    object must remain valid until the handler is called.
+
+    @param handler The completion handler to invoke when the
+    operation completes. The equivalent function signature of
+    the handler must be:
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t bytes_transferred   // the number of octets in the datagram
+    );
+    @endcode
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::io_context::post`.
+*/
+template<
+    class DatagramSocket,
+    bool isRequest, class Derived, class Protocol,
+    class ReceiveHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReceiveHandler, void(error_code, std::size_t))
+async_receive_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::basic_parser<isRequest, Derived, Protocol>& parser,
+    typename DatagramSocket::endpoint_type& sender,
+    ReceiveHandler&& handler);
+
+//------------------------------------------------------------------------------
+
+/** Send a message on a datagram socket.
+
+    This function serializes the message into the buffer with
+    @ref serialize_datagram and sends it as one datagram. The
+    call will block until the datagram is sent or an error
+    occurs.
+
+    @param socket The socket to send on. The type must provide
+    a member function `send_to` with the same semantics as
+    `net::ip::udp::socket`.
+
+    @param buffer Storage for the serialized message.
+
+    @param msg The message to send.
+
+    @param destination The endpoint to send the datagram to.
+
+    @param ec Set to the error, if any occurred.
+
+    @return The number of octets in the datagram.
+*/
+template<
+    class DatagramSocket,
+    bool isRequest, class Body, class Fields>
+std::size_t
+send_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::message<isRequest, Body, Fields> const& msg,
+    typename DatagramSocket::endpoint_type const& destination,
+    error_code& ec);
+
+/** Send a message on a datagram socket.
+
+    This function serializes the message into the buffer and
+    sends it as one datagram. The call will block until the
+    datagram is sent or an error occurs.
+
+    @param socket The socket to send on.
+
+    @param buffer Storage for the serialized message.
+
+    @param msg The message to send.
+
+    @param destination The endpoint to send the datagram to.
+
+    @return The number of octets in the datagram.
+
+    @throws system_error Thrown on failure.
+*/
+template<
+    class DatagramSocket,
+    bool isRequest, class Body, class Fields>
+std::size_t
+send_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::message<isRequest, Body, Fields> const& msg,
+    typename DatagramSocket::endpoint_type const& destination);
+
+/** Send a message on a datagram socket asynchronously.
+
+    This function serializes the message into the buffer and
+    asynchronously sends it as one datagram. The function call
+    always returns immediately. The message is serialized before
+    the function returns, so only the buffer must remain valid
+    until the handler is called.
+
+    @param socket The socket to send on. The type must provide
+    a member function `async_send_to` with the same semantics as
+    `net::ip::udp::socket`.
+
+    @param buffer Storage for the serialized message. The object
+    must remain valid until the handler is called.
+
+    @param msg The message to send.
+
+    @param destination The endpoint to send the datagram to.
+
+    @param handler The completion handler to invoke when the
+    operation completes. The equivalent function signature of
+    the handler must be:
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t bytes_transferred   // the number of octets in the datagram
+    );
+    @endcode
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::io_context::post`.
+*/
+template<
+    class DatagramSocket,
+    bool isRequest, class Body, class Fields,
+    class SendHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    SendHandler, void(error_code, std::size_t))
+async_send_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::message<isRequest, Body, Fields> const& msg,
+    typename DatagramSocket::endpoint_type const& destination,
+    SendHandler&& handler);
+
+} // sip
+} // beast
+} // boost
+
+#include <boost/beast/sip/impl/datagram.ipp>
+
+#endif
@@ -0,0 +1,276 @@
+#ifndef BOOST_BEAST_SIP_DETAIL_RFC3261_HPP
+#define BOOST_BEAST_SIP_DETAIL_RFC3261_HPP
+
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/detail/rfc7230.hpp>
+#include <cstdint>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+struct via_parm;
+struct name_addr;
+
+namespace detail {
+
+inline
+bool
+is_ws(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+inline
+string_view
+trim_ws(string_view s)
+{
+    while(! s.empty() && is_ws(s.front()))
+        s.remove_prefix(1);
+    while(! s.empty() && is_ws(s.back()))
+        s.remove_suffix(1);
+    return s;
+}
+
+inline
+void
+skip_ws(char const*& it, char const* last)
+{
+    while(it != last && is_ws(*it))
+        ++it;
+}
+
+inline
+bool
+is_alnum(char c)
+{
+    return
+        http::detail::is_alpha(c) ||
+        http::detail::is_digit(c);
+}
+
+// Characters of a hostname or IPv4address
+inline
+bool
+is_host_char(char c)
+{
+    return is_alnum(c) || c == '-' || c == '.';
+}
+
+// Characters of a gen-value which is a token or host
+inline
+bool
+is_gen_value_char(char c)
+{
+    return
+        http::detail::is_token_char(c) ||
+        c == '[' || c == ']' || c == ':';
+}
+
+inline
+string_view
+make_view(char const* first, char const* last)
+{
+    return {first, static_cast<std::size_t>(last - first)};
+}
+
+/*  Parse a quoted-string starting at `it`, which points to
+    the opening quote. On success `it` points past the
+    closing quote.
+*/
+inline
+bool
+parse_quoted(char const*& it, char const* last)
+{
+    ++it;
+    for(;;)
+    {
+        if(it == last)
+            return false;
+        auto c = *it++;
+        if(c == '"')
+            return true;
+        if(http::detail::is_qdchar(c))
+            continue;
+        if(c != '\\' || it == last)
+            return false;
+        c = *it++;
+        if(! http::detail::is_qpchar(c))
+            return false;
+    }
+}
+
+enum class param_result
+{
+    param,
+    none,
+    error
+};
+
+/*  Parse one generic-param preceded by a semicolon.
+    Returns `none` with `it` unchanged when the next
+    character other than whitespace is not a semicolon.
+*/
+inline
+param_result
+parse_param(
+    char const*& it,
+    char const* last,
+    std::pair<string_view, string_view>& v)
+{
+    auto p = it;
+    skip_ws(p, last);
+    if(p == last || *p != ';')
+        return param_result::none;
+    ++p;
+    skip_ws(p, last);
+    if(p == last || ! http::detail::is_token_char(*p))
+        return param_result::error;
+    auto const p0 = p;
+    http::detail::skip_token(++p, last);
+    v.first = make_view(p0, p);
+    v.second = {};
+    it = p;
+    skip_ws(p, last);
+    if(p == last || *p != '=')
+        return param_result::param;
+    ++p;
+    skip_ws(p, last);
+    if(p == last)
+        return param_result::error;
+    auto const p1 = p;
+    if(*p == '"')
+    {
+        if(! parse_quoted(p, last))
+            return param_result::error;
+    }
+    else
+    {
+        while(p != last && is_gen_value_char(*p))
+            ++p;
+        if(p == p1)
+            return param_result::error;
+    }
+    v.second = make_view(p1, p);
+    it = p;
+    return param_result::param;
+}
+
+/*  Parse the parameters following `it`, returning them in
+    `params` and calling `f` with each one.
+*/
+template<class F>
+bool
+parse_params(
+    char const*& it,
+    char const* last,
+    string_view& params,
+    F const& f)
+{
+    auto const first = it;
+    std::pair<string_view, string_view> v;
+    for(;;)
+    {
+        auto const r = parse_param(it, last, v);
+        if(r == param_result::error)
+            return false;
+        if(r == param_result::none)
+            break;
+        f(v);
+    }
+    params = make_view(first, it);
+    return true;
+}
+
+/*  After an element of a comma separated list, skip
+    the separating comma. Returns `false` if anything
+    other than whitespace or a comma follows.
+*/
+inline
+bool
+skip_separator(char const*& it, char const* last)
+{
+    skip_ws(it, last);
+    if(it == last)
+        return true;
+    if(*it != ',')
+        return false;
+    ++it;
+    return true;
+}
+
+/*  Advance to the next element of a comma separated list.
+    Returns `false` when there are no more elements, after
+    setting `it` to null to indicate the end of the list.
+*/
+inline
+bool
+next_element(char const*& it, string_view s)
+{
+    auto const last = s.data() + s.size();
+    for(;;)
+    {
+        skip_ws(it, last);
+        if(it == last)
+        {
+            it = nullptr;
+            return false;
+        }
+        if(*it != ',')
+            return true;
+        ++it;
+    }
+}
+
+struct param_list_policy
+{
+    using value_type =
+        std::pair<string_view, string_view>;
+
+    bool
+    operator()(value_type& v,
+        char const*& it, string_view s) const
+    {
+        auto const last = s.data() + s.size();
+        v = {};
+        auto const r = parse_param(it, last, v);
+        if(r == param_result::error)
+            return false;
+        if(r == param_result::param)
+            return true;
+        skip_ws(it, last);
+        if(it != last)
+            return false;
+        it = nullptr;
+        return true;
+    }
+};
+
+struct via_list_policy
+{
+    using value_type = via_parm;
+
+    inline
+    bool
+    operator()(value_type& v,
+        char const*& it, string_view s) const;
+};
+
+struct contact_list_policy
+{
+    using value_type = name_addr;
+
+    inline
+    bool
+    operator()(value_type& v,
+        char const*& it, string_view s) const;
+};
+
+} // detail
+
+} // sip
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,228 @@
+#ifndef BOOST_BEAST_SIP_EDITOR_HPP
+#define BOOST_BEAST_SIP_EDITOR_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffers_cat.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/sip/rfc3261.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+/** An editor which rewrites a serialized message in place.
+
+    A proxy forwards a message after adding a Via, decrementing
+    Max-Forwards and perhaps replacing the Request-URI, and removes
+    its Via from each response. Parsing the message into a container,
+    modifying the fields and serializing it again costs time in
+    proportion to the size of the message. This editor instead
+    locates the few fields a proxy changes in the received octets,
+    and presents the edited message as a buffer sequence made of
+    slices of the original octets around the changed bytes. The
+    cost of forwarding is proportional to the number of edits.
+
+    Each edit refers to the original message: popping the top Via
+    removes the Via which was received, whether or not a Via has
+    been pushed, and making the same edit twice replaces the first.
+    The octets of the message are not copied, and must remain valid
+    and unchanged while the editor is used.
+
+    The editor keeps the bytes it inserts in storage which is
+    reused by each message, so that a program which keeps one
+    editor for each socket does not allocate memory once the
+    storage has grown to the size of its edits.
+
+    @par Example
+    @code
+    error_code ec;
+    editor.reset(buffer.data(), ec);
+    if(! ec && editor.decrement_max_forwards())
+    {
+        editor.push_via("SIP/2.0/UDP proxy.example.com;branch=z9hG4bK4b43c2ff8.1");
+        socket.send_to(editor.buffers(), next_hop);
+    }
+    @endcode
+*/
+class message_editor
+{
+public:
+    /** The type of buffer sequence holding the edited message.
+
+        The sequence holds the slices of the original message
+        between the edits, and the bytes of the edits.
+    */
+    using const_buffers_type = buffers_cat_view<
+        net::const_buffer, net::const_buffer, net::const_buffer,
+        net::const_buffer, net::const_buffer, net::const_buffer,
+        net::const_buffer, net::const_buffer, net::const_buffer>;
+
+private:
+    static std::size_t constexpr npos = std::size_t(-1);
+
+    enum
+    {
+        target_slot,
+        push_slot,
+        pop_slot,
+        max_forwards_slot,
+        slot_count
+    };
+
+    struct edit
+    {
+        std::size_t pos;        // offset in the message
+        std::size_t erase;      // octets of the message replaced
+        std::size_t first;      // offset in the storage
+        std::size_t size;       // octets inserted
+    };
+
+    char const* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool is_request_ = false;
+
+    // Offsets in the message, or npos
+    std::size_t target_ = npos;
+    std::size_t target_end_ = npos;
+    std::size_t fields_ = npos;
+    std::size_t end_ = npos;
+    std::size_t via_line_ = npos;
+    std::size_t via_ = npos;
+    std::size_t via_end_ = npos;
+    std::size_t via_next_ = npos;
+    std::size_t max_forwards_ = npos;
+    std::size_t max_forwards_end_ = npos;
+
+    std::string s_;
+    edit edits_[slot_count] = {};
+
+    void
+    set(int slot,
+        std::size_t pos,
+        std::size_t erase,
+        string_view s);
+
+public:
+    /// Constructor
+    message_editor() = default;
+
+    /** Begin editing a message.
+
+        The start line and the fields of the message are scanned
+        to locate the Request-URI, the top Via and Max-Forwards,
+        and any previous edits are discarded. The body is not
+        examined, and its length is not changed by the edits.
+
+        @param message The octets of a complete request or
+        response, such as a received datagram. The octets must
+        remain valid and unchanged while the editor is used.
+
+        @param ec Set to the error, if any occurred. The error
+        @ref http::error::partial_message is returned when the
+        message ends before the empty line which ends the fields.
+    */
+    void
+    reset(net::const_buffer message, error_code& ec);
+
+    /// Returns `true` if the message is a request
+    bool
+    is_request() const noexcept
+    {
+        return is_request_;
+    }
+
+    /// Returns the Request-URI of the original message
+    string_view
+    target() const noexcept
+    {
+        if(target_ == npos)
+            return {};
+        return {data_ + target_, target_end_ - target_};
+    }
+
+    /** Replace the Request-URI.
+
+        @param target The new Request-URI, which is copied.
+
+        @par Preconditions
+        The message is a request.
+    */
+    void
+    set_target(string_view target);
+
+    /** Add a Via to the top of the message.
+
+        A Via field holding the value is inserted before the
+        other fields.
+
+        @param value The via-parm to add, which is copied.
+    */
+    void
+    push_via(string_view value);
+
+    /** Remove the top Via from the message.
+
+        When the first Via field holds more than one via-parm,
+        only the first is removed from the value; otherwise the
+        field is removed.
+
+        @param v Set to the removed via-parm. Its strings refer
+        to the octets of the message.
+
+        @return `true` if the top Via was removed, or `false` if
+        the message has no Via or its value could not be parsed.
+    */
+    bool
+    pop_via(via_parm& v);
+
+    /** Remove the top Via from the message.
+
+        @return `true` if the top Via was removed.
+    */
+    bool
+    pop_via()
+    {
+        via_parm v;
+        return pop_via(v);
+    }
+
+    /** Decrement the value of Max-Forwards.
+
+        As a proxy must do before forwarding a request, the value
+        of the Max-Forwards field is replaced by one less, or the
+        field is added with the value 70 when the message has none.
+        See rfc3261 section 16.6.
+
+        @return `true` on success, or `false` if the value is zero
+        or is not a number, in which case the message is unchanged
+        and must not be forwarded. A proxy responds to such a
+        request with 483 (Too Many Hops).
+    */
+    bool
+    decrement_max_forwards();
+
+    /// Returns the number of octets in the edited message
+    std::size_t
+    size() const noexcept;
+
+    /** Returns the edited message.
+
+        The returned buffer sequence refers to the original
+        octets and to storage owned by the editor, and remains
+        valid until the next edit or call to @ref reset.
+    */
+    const_buffers_type
+    buffers() const;
+};
+
+} // sip
+} // beast
+} // boost
+
+#include <boost/beast/sip/impl/editor.ipp>
+
+#endif
@@ -0,0 +1,500 @@
+#ifndef BOOST_BEAST_SIP_IMPL_BATCH_IPP
+#define BOOST_BEAST_SIP_IMPL_BATCH_IPP
+
+#include <boost/beast/core/async_op_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/detail/get_executor_type.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/socket_base.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+
+#ifndef BOOST_BEAST_SIP_USE_MMSG
+# if defined(__linux__)
+#  define BOOST_BEAST_SIP_USE_MMSG 1
+# else
+#  define BOOST_BEAST_SIP_USE_MMSG 0
+# endif
+#endif
+
+#if BOOST_BEAST_SIP_USE_MMSG
+# include <cerrno>
+# include <sys/socket.h>
+#endif
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+namespace detail {
+
+struct batch_access
+{
+    template<class Endpoint>
+    static
+    char*
+    buffer(basic_datagram_batch<Endpoint> const& b, std::size_t i)
+    {
+        return b.buffer(i);
+    }
+
+    template<class Endpoint>
+    static
+    typename basic_datagram_batch<Endpoint>::entry&
+    entry(basic_datagram_batch<Endpoint> const& b, std::size_t i)
+    {
+        return b.v_[i];
+    }
+
+    template<class Endpoint>
+    static
+    void
+    resize(basic_datagram_batch<Endpoint>& b, std::size_t n)
+    {
+        b.n_ = n;
+    }
+};
+
+#if BOOST_BEAST_SIP_USE_MMSG
+
+// The largest number of messages passed to one
+// system call, bounding the headers on the stack.
+static std::size_t constexpr mmsg_chunk = 64;
+
+/*  Receive datagrams with recvmmsg into the batch, replacing its
+    contents. When `block` is true the call may block until the
+    first datagram arrives; later datagrams are never waited for.
+*/
+template<class DatagramSocket, class Endpoint>
+std::size_t
+receive_some(
+    DatagramSocket& socket,
+    basic_datagram_batch<Endpoint>& b,
+    bool block,
+    error_code& ec)
+{
+    ::mmsghdr hdrs[mmsg_chunk];
+    ::iovec iovs[mmsg_chunk];
+    std::size_t n = 0;
+    ec = {};
+    batch_access::resize(b, 0);
+    while(n < b.capacity())
+    {
+        auto const k = (std::min)(b.capacity() - n, mmsg_chunk);
+        for(std::size_t j = 0; j < k; ++j)
+        {
+            auto& e = batch_access::entry(b, n + j);
+            iovs[j].iov_base = batch_access::buffer(b, n + j);
+            iovs[j].iov_len = b.buffer_size();
+            auto& h = hdrs[j].msg_hdr;
+            h = {};
+            h.msg_name = e.endpoint.data();
+            h.msg_namelen = static_cast<
+                ::socklen_t>(e.endpoint.capacity());
+            h.msg_iov = &iovs[j];
+            h.msg_iovlen = 1;
+            hdrs[j].msg_len = 0;
+        }
+        int const flags = (block && n == 0) ?
+            MSG_WAITFORONE : MSG_DONTWAIT;
+        auto const r = ::recvmmsg(socket.native_handle(),
+            hdrs, static_cast<unsigned>(k), flags, nullptr);
+        if(r < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            // Datagrams already received are delivered,
+            // and the error is left for the next call.
+            if(n == 0)
+                ec.assign(errno, system_category());
+            break;
+        }
+        auto const m = static_cast<std::size_t>(r);
+        for(std::size_t j = 0; j < m; ++j)
+        {
+            auto& e = batch_access::entry(b, n + j);
+            e.endpoint.resize(hdrs[j].msg_hdr.msg_namelen);
+            e.size = hdrs[j].msg_len;
+            e.truncated =
+                (hdrs[j].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        }
+        n += m;
+        batch_access::resize(b, n);
+        if(m < k)
+            break;
+    }
+    return n;
+}
+
+// Send datagrams starting at index `i` with one call to sendmmsg.
+template<class DatagramSocket, class Endpoint>
+std::size_t
+send_some(
+    DatagramSocket& socket,
+    basic_datagram_batch<Endpoint> const& b,
+    std::size_t i,
+    bool block,
+    error_code& ec)
+{
+    ::mmsghdr hdrs[mmsg_chunk];
+    ::iovec iovs[mmsg_chunk];
+    auto const k = (std::min)(b.size() - i, mmsg_chunk);
+    for(std::size_t j = 0; j < k; ++j)
+    {
+        auto& e = batch_access::entry(b, i + j);
+        iovs[j].iov_base = batch_access::buffer(b, i + j);
+        iovs[j].iov_len = e.size;
+        auto& h = hdrs[j].msg_hdr;
+        h = {};
+        h.msg_name = const_cast<void*>(
+            static_cast<void const*>(e.endpoint.data()));
+        h.msg_namelen = static_cast<
+            ::socklen_t>(e.endpoint.size());
+        h.msg_iov = &iovs[j];
+        h.msg_iovlen = 1;
+        hdrs[j].msg_len = 0;
+    }
+    ec = {};
+    for(;;)
+    {
+        auto const r = ::sendmmsg(socket.native_handle(),
+            hdrs, static_cast<unsigned>(k),
+                block ? 0 : MSG_DONTWAIT);
+        if(r >= 0)
+            return static_cast<std::size_t>(r);
+        if(errno != EINTR)
+            break;
+    }
+    ec.assign(errno, system_category());
+    return 0;
+}
+
+#else
+
+template<class DatagramSocket, class Endpoint>
+std::size_t
+receive_some(
+    DatagramSocket& socket,
+    basic_datagram_batch<Endpoint>& b,
+    bool block,
+    error_code& ec)
+{
+    std::size_t n = 0;
+    ec = {};
+    batch_access::resize(b, 0);
+    while(n < b.capacity())
+    {
+        if(n > 0 || ! block)
+        {
+            // Only receive datagrams which are already queued
+            error_code ec2;
+            auto const avail = socket.available(ec2);
+            if(ec2 || avail == 0)
+            {
+                if(n == 0)
+                    ec = ec2 ? ec2 : error_code(
+                        net::error::would_block);
+                break;
+            }
+        }
+        auto& e = batch_access::entry(b, n);
+        error_code ec2;
+        e.size = socket.receive_from(net::mutable_buffer(
+            batch_access::buffer(b, n), b.buffer_size()),
+                e.endpoint, 0, ec2);
+        e.truncated = false;
+        if(ec2 == net::error::message_size)
+        {
+            e.size = b.buffer_size();
+            e.truncated = true;
+            ec2 = {};
+        }
+        if(ec2)
+        {
+            if(n == 0)
+                ec = ec2;
+            break;
+        }
+        batch_access::resize(b, ++n);
+    }
+    return n;
+}
+
+template<class DatagramSocket, class Endpoint>
+std::size_t
+send_some(
+    DatagramSocket& socket,
+    basic_datagram_batch<Endpoint> const& b,
+    std::size_t i,
+    bool,
+    error_code& ec)
+{
+    socket.send_to(b.data(i), b.endpoint(i), 0, ec);
+    return ec ? 0 : 1;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+
+template<class DatagramSocket, class Endpoint, class Handler>
+class receive_batch_op
+    : public beast::async_op_base<
+        Handler, beast::detail::get_executor_type<DatagramSocket>>
+    , public net::coroutine
+{
+    DatagramSocket& s_;
+    basic_datagram_batch<Endpoint>& b_;
+    std::size_t n_ = 0;
+
+public:
+    template<class Handler_>
+    receive_batch_op(
+        Handler_&& h,
+        DatagramSocket& s,
+        basic_datagram_batch<Endpoint>& b)
+        : async_op_base<
+            Handler, beast::detail::get_executor_type<DatagramSocket>>(
+                std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+        , b_(b)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t = 0,
+        bool cont = true)
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            for(;;)
+            {
+                n_ = detail::receive_some(s_, b_, false, ec);
+                if(ec != net::error::would_block)
+                    break;
+                BOOST_ASIO_CORO_YIELD
+                s_.async_wait(
+                    net::socket_base::wait_read, std::move(*this));
+                if(ec)
+                    break;
+            }
+            if(! cont)
+            {
+                BOOST_ASIO_CORO_YIELD
+                net::post(
+                    s_.get_executor(),
+                    beast::bind_front_handler(
+                        std::move(*this), ec, n_));
+            }
+            this->invoke(ec, n_);
+        }
+    }
+};
+
+template<class DatagramSocket, class Endpoint, class Handler>
+class send_batch_op
+    : public beast::async_op_base<
+        Handler, beast::detail::get_executor_type<DatagramSocket>>
+    , public net::coroutine
+{
+    DatagramSocket& s_;
+    basic_datagram_batch<Endpoint> const& b_;
+    std::size_t n_ = 0;
+
+public:
+    template<class Handler_>
+    send_batch_op(
+        Handler_&& h,
+        DatagramSocket& s,
+        basic_datagram_batch<Endpoint> const& b)
+        : async_op_base<
+            Handler, beast::detail::get_executor_type<DatagramSocket>>(
+                std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+        , b_(b)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t = 0,
+        bool cont = true)
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            while(n_ < b_.size())
+            {
+                n_ += detail::send_some(s_, b_, n_, false, ec);
+                if(ec == net::error::would_block)
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    s_.async_wait(
+                        net::socket_base::wait_write, std::move(*this));
+                }
+                if(ec)
+                    break;
+            }
+            if(! cont)
+            {
+                BOOST_ASIO_CORO_YIELD
+                net::post(
+                    s_.get_executor(),
+                    beast::bind_front_handler(
+                        std::move(*this), ec, n_));
+            }
+            this->invoke(ec, n_);
+        }
+    }
+};
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+template<
+    class Endpoint,
+    bool isRequest, class Body, class Fields>
+void
+serialize_datagram(
+    basic_datagram_batch<Endpoint>& batch,
+    http::message<isRequest, Body, Fields> const& msg,
+    Endpoint const& destination,
+    error_code& ec)
+{
+    auto const n = detail::serialize_datagram(
+        batch.prepare(), msg, ec);
+    if(ec)
+        return;
+    batch.commit(n, destination);
+}
+
+//------------------------------------------------------------------------------
+
+template<class DatagramSocket>
+std::size_t
+receive_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type>& batch,
+    error_code& ec)
+{
+    for(;;)
+    {
+        auto const n = detail::receive_some(
+            socket, batch, true, ec);
+        // The descriptor is non-blocking once an asynchronous
+        // operation has been started on the socket, so wait
+        // for a datagram as a blocking receive would.
+        if(ec != net::error::would_block || socket.non_blocking())
+            return n;
+        socket.wait(net::socket_base::wait_read, ec);
+        if(ec)
+            return 0;
+    }
+}
+
+template<class DatagramSocket>
+std::size_t
+receive_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type>& batch)
+{
+    error_code ec;
+    auto const n = receive_batch(socket, batch, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return n;
+}
+
+template<class DatagramSocket, class ReceiveHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReceiveHandler, void(error_code, std::size_t))
+async_receive_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type>& batch,
+    ReceiveHandler&& handler)
+{
+    BOOST_BEAST_HANDLER_INIT(
+        ReceiveHandler, void(error_code, std::size_t));
+    detail::receive_batch_op<
+        DatagramSocket,
+        typename DatagramSocket::endpoint_type,
+        BOOST_ASIO_HANDLER_TYPE(
+            ReceiveHandler, void(error_code, std::size_t))>(
+                std::move(init.completion_handler),
+                socket, batch);
+    return init.result.get();
+}
+
+//------------------------------------------------------------------------------
+
+template<class DatagramSocket>
+std::size_t
+send_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type> const& batch,
+    error_code& ec)
+{
+    std::size_t n = 0;
+    ec = {};
+    while(n < batch.size())
+    {
+        n += detail::send_some(socket, batch, n, true, ec);
+        if(ec == net::error::would_block && ! socket.non_blocking())
+            socket.wait(net::socket_base::wait_write, ec);
+        if(ec)
+            break;
+    }
+    return n;
+}
+
+template<class DatagramSocket>
+std::size_t
+send_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type> const& batch)
+{
+    error_code ec;
+    auto const n = send_batch(socket, batch, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return n;
+}
+
+template<class DatagramSocket, class SendHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    SendHandler, void(error_code, std::size_t))
+async_send_batch(
+    DatagramSocket& socket,
+    basic_datagram_batch<
+        typename DatagramSocket::endpoint_type> const& batch,
+    SendHandler&& handler)
+{
+    BOOST_BEAST_HANDLER_INIT(
+        SendHandler, void(error_code, std::size_t));
+    detail::send_batch_op<
+        DatagramSocket,
+        typename DatagramSocket::endpoint_type,
+        BOOST_ASIO_HANDLER_TYPE(
+            SendHandler, void(error_code, std::size_t))>(
+                std::move(init.completion_handler),
+                socket, batch);
+    return init.result.get();
+}
+
+} // sip
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,402 @@
+#ifndef BOOST_BEAST_SIP_IMPL_CONNECTION_IPP
+#define BOOST_BEAST_SIP_IMPL_CONNECTION_IPP
+
+#include <boost/beast/core/async_op_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/read_size.hpp>
+#include <boost/beast/core/detail/get_executor_type.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/throw_exception.hpp>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+inline
+void
+latency_histogram::
+record(duration d) noexcept
+{
+    std::size_t i = 0;
+    if(d.count() > 0)
+    {
+        auto v = static_cast<std::uint64_t>(d.count());
+        while(v && i < bucket_count - 1)
+        {
+            v >>= 1;
+            ++i;
+        }
+    }
+    ++v_[i];
+    ++n_;
+}
+
+inline
+auto
+latency_histogram::
+percentile(double p) const noexcept ->
+    duration
+{
+    if(n_ == 0)
+        return duration(0);
+    auto rank = static_cast<std::uint64_t>(
+        std::ceil(p / 100 * static_cast<double>(n_)));
+    if(rank < 1)
+        rank = 1;
+    std::uint64_t n = 0;
+    for(std::size_t i = 0; i < bucket_count; ++i)
+    {
+        n += v_[i];
+        if(n >= rank)
+            return upper_bound(i);
+    }
+    return upper_bound(bucket_count - 1);
+}
+
+inline
+void
+latency_histogram::
+clear() noexcept
+{
+    for(auto& v : v_)
+        v = 0;
+    n_ = 0;
+}
+
+//------------------------------------------------------------------------------
+
+namespace detail {
+
+// Appends each buffer sequence
+// produced by the serializer to a string.
+class string_writer
+{
+    std::string& s_;
+    std::size_t n_ = 0;
+
+public:
+    explicit
+    string_writer(std::string& s)
+        : s_(s)
+    {
+    }
+
+    std::size_t
+    size() const
+    {
+        return n_;
+    }
+
+    template<class ConstBufferSequence>
+    void
+    operator()(error_code& ec,
+        ConstBufferSequence const& buffers)
+    {
+        ec = {};
+        auto const pos = s_.size();
+        n_ = net::buffer_size(buffers);
+        s_.resize(pos + n_);
+        net::buffer_copy(
+            net::mutable_buffer(&s_[pos], n_), buffers);
+    }
+};
+
+// Discards the empty lines before a message
+inline
+void
+skip_empty_lines(flat_buffer& b)
+{
+    auto const p = static_cast<char const*>(b.data().data());
+    std::size_t n = 0;
+    while(n < b.size() && (p[n] == '\r' || p[n] == '\n'))
+        ++n;
+    b.consume(n);
+}
+
+} // detail
+
+template<class NextLayer, class Body>
+template<class Handler>
+class basic_connection<NextLayer, Body>::read_op
+    : public beast::async_op_base<
+        Handler, beast::detail::get_executor_type<NextLayer>>
+    , public net::coroutine
+{
+    basic_connection& c_;
+    std::size_t bytes_transferred_ = 0;
+
+public:
+    template<class Handler_>
+    read_op(
+        Handler_&& h,
+        basic_connection& c)
+        : async_op_base<
+            Handler, beast::detail::get_executor_type<NextLayer>>(
+                std::forward<Handler_>(h), c.stream_.get_executor())
+        , c_(c)
+    {
+        (*this)({}, 0);
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred)
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            // Every path suspends before the upcall,
+            // so the handler is never invoked from
+            // the initiating function.
+            for(;;)
+            {
+                detail::skip_empty_lines(c_.buffer_);
+                if(c_.buffer_.size() >= 4)
+                    break;
+                BOOST_ASIO_CORO_YIELD
+                c_.stream_.async_read_some(
+                    c_.buffer_.prepare(read_size(c_.buffer_, 65536)),
+                    std::move(*this));
+                c_.buffer_.commit(bytes_transferred);
+                bytes_transferred_ += bytes_transferred;
+                if(ec == net::error::eof)
+                {
+                    detail::skip_empty_lines(c_.buffer_);
+                    if(c_.buffer_.size() == 0)
+                        ec = http::error::end_of_stream;
+                    else
+                        ec = http::error::partial_message;
+                }
+                if(ec)
+                    goto upcall;
+            }
+            c_.is_request_ = std::memcmp(
+                c_.buffer_.data().data(), "SIP/", 4) != 0;
+            if(c_.is_request_)
+            {
+                c_.req_.emplace();
+                BOOST_ASIO_CORO_YIELD
+                http::async_read(c_.stream_,
+                    c_.buffer_, *c_.req_, std::move(*this));
+            }
+            else
+            {
+                c_.res_.emplace();
+                BOOST_ASIO_CORO_YIELD
+                http::async_read(c_.stream_,
+                    c_.buffer_, *c_.res_, std::move(*this));
+            }
+            bytes_transferred_ += bytes_transferred;
+        upcall:
+            if(ec)
+                c_.fail(ec);
+            this->invoke(ec, bytes_transferred_);
+        }
+    }
+};
+
+template<class NextLayer, class Body>
+void
+basic_connection<NextLayer, Body>::
+fail(error_code ec)
+{
+    if(! ec_)
+    {
+        ec_ = ec;
+        open_ = false;
+    }
+    // The messages being written are kept until the write completes
+    q_[1].s.clear();
+    q_[1].t.clear();
+    if(! writing_)
+    {
+        q_[0].s.clear();
+        q_[0].t.clear();
+    }
+}
+
+template<class NextLayer, class Body>
+void
+basic_connection<NextLayer, Body>::
+do_write()
+{
+    // q_[0] is written while q_[1] receives the messages sent
+    BOOST_ASSERT(writing_);
+    BOOST_ASSERT(q_[0].t.empty());
+    if(ec_ || q_[1].t.empty())
+    {
+        writing_ = false;
+        return;
+    }
+    std::swap(q_[0], q_[1]);
+    auto self = this->shared_from_this();
+    net::async_write(stream_, net::buffer(q_[0].s),
+        [self](error_code ec, std::size_t)
+        {
+            self->on_write(ec);
+        });
+}
+
+template<class NextLayer, class Body>
+void
+basic_connection<NextLayer, Body>::
+on_write(error_code ec)
+{
+    if(ec)
+    {
+        writing_ = false;
+        fail(ec);
+        return;
+    }
+    auto const now = clock_type::now();
+    for(auto const& t : q_[0].t)
+        latency_.record(std::chrono::duration_cast<
+            latency_histogram::duration>(now - t));
+    q_[0].s.clear();
+    q_[0].t.clear();
+    do_write();
+}
+
+template<class NextLayer, class Body>
+template<class ReadHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReadHandler, void(error_code, std::size_t))
+basic_connection<NextLayer, Body>::
+async_read(ReadHandler&& handler)
+{
+    BOOST_BEAST_HANDLER_INIT(
+        ReadHandler, void(error_code, std::size_t));
+    read_op<BOOST_ASIO_HANDLER_TYPE(
+        ReadHandler, void(error_code, std::size_t))>(
+            std::move(init.completion_handler), *this);
+    return init.result.get();
+}
+
+template<class NextLayer, class Body>
+template<bool isRequest, class OtherBody, class Fields>
+void
+basic_connection<NextLayer, Body>::
+send(
+    http::message<isRequest, OtherBody, Fields> const& msg,
+    error_code& ec)
+{
+    if(ec_)
+    {
+        ec = ec_;
+        return;
+    }
+    auto& q = q_[1];
+    auto const size = q.s.size();
+    http::serializer<isRequest, OtherBody, Fields> sr{msg};
+    while(! sr.is_done())
+    {
+        detail::string_writer w{q.s};
+        sr.next(ec, w);
+        if(ec)
+        {
+            q.s.resize(size);
+            return;
+        }
+        sr.consume(w.size());
+    }
+    q.t.push_back(clock_type::now());
+    if(! writing_)
+    {
+        // Defer the write, so that it
+        // includes the messages sent next.
+        writing_ = true;
+        auto self = this->shared_from_this();
+        net::post(stream_.get_executor(),
+            [self]
+            {
+                self->do_write();
+            });
+    }
+}
+
+template<class NextLayer, class Body>
+template<bool isRequest, class OtherBody, class Fields>
+void
+basic_connection<NextLayer, Body>::
+send(http::message<isRequest, OtherBody, Fields> const& msg)
+{
+    error_code ec;
+    send(msg, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+}
+
+//------------------------------------------------------------------------------
+
+template<class Connection, class Key>
+std::shared_ptr<Connection>
+connection_pool<Connection, Key>::
+find(Key const& key)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    auto const it = map_.find(key);
+    if(it == map_.end())
+        return nullptr;
+    if(! it->second->is_open())
+    {
+        map_.erase(it);
+        return nullptr;
+    }
+    return it->second;
+}
+
+template<class Connection, class Key>
+template<class... Args>
+std::shared_ptr<Connection>
+connection_pool<Connection, Key>::
+emplace(Key const& key, Args&&... args)
+{
+    auto c = std::make_shared<Connection>(
+        std::forward<Args>(args)...);
+    std::lock_guard<std::mutex> lock(m_);
+    map_[key] = c;
+    return c;
+}
+
+template<class Connection, class Key>
+bool
+connection_pool<Connection, Key>::
+erase(Key const& key)
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return map_.erase(key) != 0;
+}
+
+template<class Connection, class Key>
+std::size_t
+connection_pool<Connection, Key>::
+size() const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    return map_.size();
+}
+
+template<class Connection, class Key>
+template<class Function>
+void
+connection_pool<Connection, Key>::
+for_each(Function&& f) const
+{
+    std::lock_guard<std::mutex> lock(m_);
+    for(auto const& e : map_)
+        f(e.first, e.second);
+}
+
+} // sip
+} // beast
+} // boost
+
+#endif
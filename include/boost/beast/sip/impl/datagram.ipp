@@ -0,0 +1,344 @@
+#ifndef BOOST_BEAST_SIP_IMPL_DATAGRAM_IPP
+#define BOOST_BEAST_SIP_IMPL_DATAGRAM_IPP
+
+#include <boost/beast/core/async_op_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/detail/get_executor_type.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/throw_exception.hpp>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+namespace detail {
+
+// Appends each buffer sequence produced
+// by the serializer to a datagram buffer.
+class datagram_writer
+{
+    char* p_;
+    std::size_t size_;
+    std::size_t n_ = 0;
+
+public:
+    datagram_writer(char* p, std::size_t size)
+        : p_(p)
+        , size_(size)
+    {
+    }
+
+    std::size_t
+    size() const
+    {
+        return n_;
+    }
+
+    template<class ConstBufferSequence>
+    void
+    operator()(error_code& ec,
+        ConstBufferSequence const& buffers)
+    {
+        n_ = 0;
+        if(net::buffer_size(buffers) > size_)
+        {
+            ec = http::error::buffer_overflow;
+            return;
+        }
+        ec = {};
+        n_ = net::buffer_copy(
+            net::mutable_buffer(p_, size_), buffers);
+    }
+};
+
+// Serializes the entire message into the
+// buffer, returning the number of octets.
+template<bool isRequest, class Body, class Fields>
+std::size_t
+serialize_datagram(
+    net::mutable_buffer b,
+    http::message<isRequest, Body, Fields> const& msg,
+    error_code& ec)
+{
+    auto const p = static_cast<char*>(b.data());
+    std::size_t n = 0;
+    http::serializer<isRequest, Body, Fields> sr{msg};
+    while(! sr.is_done())
+    {
+        datagram_writer w{p + n, b.size() - n};
+        sr.next(ec, w);
+        if(ec)
+            return 0;
+        sr.consume(w.size());
+        n += w.size();
+    }
+    return n;
+}
+
+template<
+    class DatagramSocket, class Handler,
+    bool isRequest, class Derived, class Protocol>
+class receive_message_op
+    : public beast::async_op_base<
+        Handler, beast::detail::get_executor_type<DatagramSocket>>
+{
+    datagram_buffer& b_;
+    http::basic_parser<isRequest, Derived, Protocol>& p_;
+
+public:
+    template<class Handler_>
+    receive_message_op(
+        Handler_&& h,
+        DatagramSocket& s,
+        datagram_buffer& b,
+        http::basic_parser<isRequest, Derived, Protocol>& p,
+        typename DatagramSocket::endpoint_type& sender)
+        : async_op_base<
+            Handler, beast::detail::get_executor_type<DatagramSocket>>(
+                std::forward<Handler_>(h), s.get_executor())
+        , b_(b)
+        , p_(p)
+    {
+        s.async_receive_from(b_.prepare(), sender, std::move(*this));
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred)
+    {
+        if(! ec)
+        {
+            b_.commit(bytes_transferred);
+            parse_datagram(p_, b_.data(), ec);
+        }
+        this->invoke(ec, bytes_transferred);
+    }
+};
+
+template<class DatagramSocket, class Handler>
+class send_message_op
+    : public beast::async_op_base<
+        Handler, beast::detail::get_executor_type<DatagramSocket>>
+{
+public:
+    template<class Handler_>
+    send_message_op(
+        Handler_&& h,
+        DatagramSocket& s,
+        datagram_buffer& b,
+        error_code ec,
+        typename DatagramSocket::endpoint_type const& destination)
+        : async_op_base<
+            Handler, beast::detail::get_executor_type<DatagramSocket>>(
+                std::forward<Handler_>(h), s.get_executor())
+    {
+        if(ec)
+        {
+            net::post(
+                s.get_executor(),
+                beast::bind_front_handler(
+                    std::move(*this), ec, 0));
+            return;
+        }
+        s.async_send_to(b.data(), destination, std::move(*this));
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred)
+    {
+        this->invoke(ec, bytes_transferred);
+    }
+};
+
+} // detail
+
+//------------------------------------------------------------------------------
+
+template<bool isRequest, class Derived, class Protocol>
+void
+parse_datagram(
+    http::basic_parser<isRequest, Derived, Protocol>& parser,
+    net::const_buffer buffer,
+    error_code& ec)
+{
+    BOOST_ASSERT(! parser.got_some());
+    if(buffer.size() == 0)
+    {
+        ec = http::error::partial_message;
+        return;
+    }
+    parser.eager(true);
+    while(buffer.size() > 0)
+    {
+        auto const n = parser.put(buffer, ec);
+        if(ec == http::error::need_more)
+        {
+            // the datagram ends within the header
+            ec = {};
+            break;
+        }
+        if(ec)
+            return;
+        // Octets beyond the end of a body
+        // with a Content-Length are discarded.
+        if(parser.is_done())
+            return;
+        if(n == 0)
+            break;
+        buffer += n;
+    }
+    parser.put_eof(ec);
+}
+
+template<bool isRequest, class Body, class Fields>
+void
+serialize_datagram(
+    datagram_buffer& buffer,
+    http::message<isRequest, Body, Fields> const& msg,
+    error_code& ec)
+{
+    auto const n = detail::serialize_datagram(
+        buffer.prepare(), msg, ec);
+    if(ec)
+        return;
+    buffer.commit(n);
+}
+
+//------------------------------------------------------------------------------
+
+template<
+    class DatagramSocket,
+    bool isRequest, class Derived, class Protocol>
+std::size_t
+receive_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::basic_parser<isRequest, Derived, Protocol>& parser,
+    typename DatagramSocket::endpoint_type& sender,
+    error_code& ec)
+{
+    auto const n = socket.receive_from(
+        buffer.prepare(), sender, 0, ec);
+    if(ec)
+        return n;
+    buffer.commit(n);
+    parse_datagram(parser, buffer.data(), ec);
+    return n;
+}
+
+template<
+    class DatagramSocket,
+    bool isRequest, class Derived, class Protocol>
+std::size_t
+receive_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::basic_parser<isRequest, Derived, Protocol>& parser,
+    typename DatagramSocket::endpoint_type& sender)
+{
+    error_code ec;
+    auto const n = receive_message(
+        socket, buffer, parser, sender, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return n;
+}
+
+template<
+    class DatagramSocket,
+    bool isRequest, class Derived, class Protocol,
+    class ReceiveHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReceiveHandler, void(error_code, std::size_t))
+async_receive_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::basic_parser<isRequest, Derived, Protocol>& parser,
+    typename DatagramSocket::endpoint_type& sender,
+    ReceiveHandler&& handler)
+{
+    BOOST_BEAST_HANDLER_INIT(
+        ReceiveHandler, void(error_code, std::size_t));
+    detail::receive_message_op<
+        DatagramSocket,
+        BOOST_ASIO_HANDLER_TYPE(
+            ReceiveHandler, void(error_code, std::size_t)),
+        isRequest, Derived, Protocol>(
+            std::move(init.completion_handler),
+            socket, buffer, parser, sender);
+    return init.result.get();
+}
+
+//------------------------------------------------------------------------------
+
+template<
+    class DatagramSocket,
+    bool isRequest, class Body, class Fields>
+std::size_t
+send_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::message<isRequest, Body, Fields> const& msg,
+    typename DatagramSocket::endpoint_type const& destination,
+    error_code& ec)
+{
+    serialize_datagram(buffer, msg, ec);
+    if(ec)
+        return 0;
+    return socket.send_to(buffer.data(), destination, 0, ec);
+}
+
+template<
+    class DatagramSocket,
+    bool isRequest, class Body, class Fields>
+std::size_t
+send_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::message<isRequest, Body, Fields> const& msg,
+    typename DatagramSocket::endpoint_type const& destination)
+{
+    error_code ec;
+    auto const n = send_message(
+        socket, buffer, msg, destination, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return n;
+}
+
+template<
+    class DatagramSocket,
+    bool isRequest, class Body, class Fields,
+    class SendHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    SendHandler, void(error_code, std::size_t))
+async_send_message(
+    DatagramSocket& socket,
+    datagram_buffer& buffer,
+    http::message<isRequest, Body, Fields> const& msg,
+    typename DatagramSocket::endpoint_type const& destination,
+    SendHandler&& handler)
+{
+    BOOST_BEAST_HANDLER_INIT(
+        SendHandler, void(error_code, std::size_t));
+    error_code ec;
+    serialize_datagram(buffer, msg, ec);
+    detail::send_message_op<
+        DatagramSocket,
+        BOOST_ASIO_HANDLER_TYPE(
+            SendHandler, void(error_code, std::size_t))>(
+                std::move(init.completion_handler),
+                socket, buffer, ec, destination);
+    return init.result.get();
+}
+
+} // sip
+} // beast
+} // boost
+
+#endif
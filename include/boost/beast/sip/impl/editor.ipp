@@ -0,0 +1,307 @@
+#ifndef BOOST_BEAST_SIP_IMPL_EDITOR_IPP
+#define BOOST_BEAST_SIP_IMPL_EDITOR_IPP
+
+#include <boost/beast/http/error.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+namespace detail {
+
+// Returns the offset of the CRLF ending the line at `pos`, or npos
+inline
+std::size_t
+find_crlf(char const* p, std::size_t size, std::size_t pos)
+{
+    while(pos + 1 < size)
+    {
+        auto const q = static_cast<char const*>(
+            std::memchr(p + pos, '\r', size - pos - 1));
+        if(! q)
+            break;
+        pos = static_cast<std::size_t>(q - p);
+        if(p[pos + 1] == '\n')
+            return pos;
+        ++pos;
+    }
+    return std::size_t(-1);
+}
+
+} // detail
+
+inline
+void
+message_editor::
+set(int slot,
+    std::size_t pos,
+    std::size_t erase,
+    string_view s)
+{
+    auto& e = edits_[slot];
+    e.pos = pos;
+    e.erase = erase;
+    e.first = s_.size();
+    e.size = s.size();
+    s_.append(s.data(), s.size());
+}
+
+inline
+void
+message_editor::
+reset(net::const_buffer message, error_code& ec)
+{
+    data_ = static_cast<char const*>(message.data());
+    size_ = message.size();
+    is_request_ = false;
+    target_ = npos;
+    target_end_ = npos;
+    fields_ = npos;
+    end_ = npos;
+    via_line_ = npos;
+    via_ = npos;
+    via_end_ = npos;
+    via_next_ = npos;
+    max_forwards_ = npos;
+    max_forwards_end_ = npos;
+    s_.clear();
+    for(auto& e : edits_)
+        e = {size_, 0, 0, 0};
+
+    auto const p = data_;
+    auto eol = detail::find_crlf(p, size_, 0);
+    if(eol == npos)
+    {
+        ec = http::error::partial_message;
+        return;
+    }
+    string_view const line(p, eol);
+    if(line.substr(0, 4) != "SIP/")
+    {
+        // Request-Line = Method SP Request-URI SP SIP-Version
+        auto const sp0 = line.find(' ');
+        auto const sp1 = sp0 == string_view::npos ?
+            sp0 : line.find(' ', sp0 + 1);
+        if(sp0 == 0 || sp1 == string_view::npos || sp1 == sp0 + 1)
+        {
+            ec = http::error::bad_target;
+            return;
+        }
+        is_request_ = true;
+        target_ = sp0 + 1;
+        target_end_ = sp1;
+    }
+    fields_ = eol + 2;
+
+    // the field which a continuation line extends
+    std::size_t* extend = nullptr;
+    auto pos = fields_;
+    for(;;)
+    {
+        eol = detail::find_crlf(p, size_, pos);
+        if(eol == npos)
+        {
+            ec = http::error::partial_message;
+            return;
+        }
+        if(eol == pos)
+        {
+            end_ = pos;
+            break;
+        }
+        if(detail::is_ws(p[pos]))
+        {
+            // obs-fold
+            if(pos == fields_)
+            {
+                ec = http::error::bad_field;
+                return;
+            }
+            if(extend)
+            {
+                *extend = eol;
+                if(extend == &via_end_)
+                    via_next_ = eol + 2;
+            }
+            pos = eol + 2;
+            continue;
+        }
+        auto it = p + pos;
+        auto const last = p + eol;
+        http::detail::skip_token(it, last);
+        auto const name = detail::make_view(p + pos, it);
+        detail::skip_ws(it, last);
+        if(name.empty() || it == last || *it != ':')
+        {
+            ec = http::error::bad_field;
+            return;
+        }
+        detail::skip_ws(++it, last);
+        auto const value = static_cast<std::size_t>(it - p);
+        extend = nullptr;
+        if(via_line_ == npos && (
+            iequals(name, "Via") || iequals(name, "v")))
+        {
+            via_line_ = pos;
+            via_ = value;
+            via_end_ = eol;
+            via_next_ = eol + 2;
+            extend = &via_end_;
+        }
+        else if(max_forwards_ == npos &&
+            iequals(name, "Max-Forwards"))
+        {
+            max_forwards_ = value;
+            max_forwards_end_ = eol;
+            extend = &max_forwards_end_;
+        }
+        pos = eol + 2;
+    }
+    ec = {};
+}
+
+inline
+void
+message_editor::
+set_target(string_view target)
+{
+    BOOST_ASSERT(is_request_);
+    set(target_slot, target_,
+        target_end_ - target_, target);
+}
+
+inline
+void
+message_editor::
+push_via(string_view value)
+{
+    BOOST_ASSERT(fields_ != npos);
+    auto& e = edits_[push_slot];
+    e.pos = fields_;
+    e.erase = 0;
+    e.first = s_.size();
+    s_.append("Via: ", 5);
+    s_.append(value.data(), value.size());
+    s_.append("\r\n", 2);
+    e.size = s_.size() - e.first;
+}
+
+inline
+bool
+message_editor::
+pop_via(via_parm& v)
+{
+    if(via_ == npos)
+        return false;
+    auto const last = data_ + via_end_;
+    auto it = data_ + via_;
+    if(! detail::next_element(it, detail::make_view(it, last)))
+        return false;
+    auto const first = it;
+    if(! detail::parse_via_parm(it, last, v) ||
+        ! detail::skip_separator(it, last))
+        return false;
+    auto next = it;
+    if(detail::next_element(next, detail::make_view(it, last)))
+    {
+        // remove the first via-parm from the value
+        set(pop_slot,
+            static_cast<std::size_t>(first - data_),
+            static_cast<std::size_t>(next - first), {});
+    }
+    else
+    {
+        // remove the field
+        set(pop_slot, via_line_, via_next_ - via_line_, {});
+    }
+    return true;
+}
+
+inline
+bool
+message_editor::
+decrement_max_forwards()
+{
+    BOOST_ASSERT(end_ != npos);
+    if(max_forwards_ == npos)
+    {
+        set(max_forwards_slot, end_, 0, "Max-Forwards: 70\r\n");
+        return true;
+    }
+    auto const value = detail::trim_ws(string_view(
+        data_ + max_forwards_, max_forwards_end_ - max_forwards_));
+    if(value.empty() || value.size() > 9)
+        return false;
+    std::uint32_t n = 0;
+    for(auto c : value)
+    {
+        if(! http::detail::is_digit(c))
+            return false;
+        n = 10 * n + static_cast<unsigned>(c - '0');
+    }
+    if(n == 0)
+        return false;
+    --n;
+    char buf[10];
+    auto p = buf + sizeof(buf);
+    do
+    {
+        *--p = static_cast<char>('0' + n % 10);
+        n /= 10;
+    }
+    while(n);
+    set(max_forwards_slot,
+        static_cast<std::size_t>(value.data() - data_), value.size(),
+        detail::make_view(p, buf + sizeof(buf)));
+    return true;
+}
+
+inline
+std::size_t
+message_editor::
+size() const noexcept
+{
+    auto n = size_;
+    for(auto const& e : edits_)
+        n = n - e.erase + e.size;
+    return n;
+}
+
+inline
+auto
+message_editor::
+buffers() const ->
+    const_buffers_type
+{
+    edit const* e[slot_count];
+    for(int i = 0; i < slot_count; ++i)
+        e[i] = &edits_[i];
+    // stable, so that insertions at one offset keep the slot order
+    std::stable_sort(e, e + slot_count,
+        [](edit const* lhs, edit const* rhs)
+        {
+            return lhs->pos < rhs->pos;
+        });
+    net::const_buffer b[2 * slot_count + 1];
+    std::size_t pos = 0;
+    for(int i = 0; i < slot_count; ++i)
+    {
+        // an insertion may share the offset of an earlier removal
+        auto const first = (std::max)(pos, e[i]->pos);
+        b[2 * i] = {data_ + pos, first - pos};
+        b[2 * i + 1] = {s_.data() + e[i]->first, e[i]->size};
+        pos = first + e[i]->erase;
+    }
+    b[2 * slot_count] = {data_ + pos, size_ - pos};
+    return buffers_cat(
+        b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7], b[8]);
+}
+
+} // sip
+} // beast
+} // boost
+
+#endif
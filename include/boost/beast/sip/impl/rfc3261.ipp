@@ -0,0 +1,331 @@
+#ifndef BOOST_BEAST_SIP_IMPL_RFC3261_IPP
+#define BOOST_BEAST_SIP_IMPL_RFC3261_IPP
+
+#include <boost/beast/http/field.hpp>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+namespace detail {
+
+// port = 1*DIGIT
+inline
+bool
+parse_port(
+    char const*& it,
+    char const* last,
+    std::uint16_t& port)
+{
+    std::uint32_t v = 0;
+    auto const first = it;
+    while(it != last && http::detail::is_digit(*it))
+    {
+        v = 10 * v + static_cast<unsigned>(*it - '0');
+        if(v > 65535)
+            return false;
+        ++it;
+    }
+    if(it == first)
+        return false;
+    port = static_cast<std::uint16_t>(v);
+    return true;
+}
+
+// IPv6reference = "[" IPv6address "]"
+inline
+bool
+parse_ipv6_reference(
+    char const*& it,
+    char const* last)
+{
+    auto const first = ++it;
+    while(it != last && (
+        http::detail::unhex(*it) != -1 ||
+        *it == ':' || *it == '.'))
+        ++it;
+    if(it == last || *it != ']' || it == first)
+        return false;
+    ++it;
+    return true;
+}
+
+inline
+bool
+parse_via_parm(
+    char const*& it,
+    char const* last,
+    via_parm& v)
+{
+    v = via_parm{};
+    auto const token =
+        [&](string_view& t)
+        {
+            skip_ws(it, last);
+            if(it == last || ! http::detail::is_token_char(*it))
+                return false;
+            auto const p0 = it;
+            http::detail::skip_token(++it, last);
+            t = make_view(p0, it);
+            return true;
+        };
+    auto const slash =
+        [&]
+        {
+            skip_ws(it, last);
+            if(it == last || *it != '/')
+                return false;
+            ++it;
+            return true;
+        };
+    if(! token(v.protocol_name) || ! slash() ||
+        ! token(v.protocol_version) || ! slash() ||
+        ! token(v.transport))
+        return false;
+    if(it == last || ! is_ws(*it))
+        return false;
+    skip_ws(it, last);
+    if(it == last)
+        return false;
+    auto const h0 = it;
+    if(*it == '[')
+    {
+        if(! parse_ipv6_reference(it, last))
+            return false;
+    }
+    else
+    {
+        while(it != last && is_host_char(*it))
+            ++it;
+        if(it == h0)
+            return false;
+    }
+    v.host = make_view(h0, it);
+    auto p = it;
+    skip_ws(p, last);
+    if(p != last && *p == ':')
+    {
+        skip_ws(++p, last);
+        if(! parse_port(p, last, v.port))
+            return false;
+        it = p;
+    }
+    string_view params;
+    if(! parse_params(it, last, params,
+        [&v](std::pair<string_view, string_view> const& param)
+        {
+            if(iequals(param.first, "branch"))
+            {
+                v.branch = param.second;
+            }
+            else if(iequals(param.first, "received"))
+            {
+                v.received = param.second;
+            }
+            else if(iequals(param.first, "rport"))
+            {
+                v.rport = param.second;
+                v.has_rport = true;
+            }
+        }))
+        return false;
+    v.params = param_list{params};
+    return true;
+}
+
+inline
+bool
+parse_name_addr(
+    char const*& it,
+    char const* last,
+    name_addr& v)
+{
+    v = name_addr{};
+    skip_ws(it, last);
+    if(it == last)
+        return false;
+    auto p = it;
+    bool bracketed = true;
+    if(*p == '"')
+    {
+        if(! parse_quoted(p, last))
+            return false;
+        v.display_name = make_view(it, p);
+        skip_ws(p, last);
+        if(p == last || *p != '<')
+            return false;
+    }
+    else if(*p != '<')
+    {
+        // Either a display name of tokens
+        // followed by "<", or an addr-spec.
+        auto q = p;
+        while(q != last && (
+            http::detail::is_token_char(*q) || is_ws(*q)))
+            ++q;
+        if(q != last && *q == '<')
+        {
+            v.display_name = trim_ws(make_view(p, q));
+            p = q;
+        }
+        else
+        {
+            bracketed = false;
+        }
+    }
+    if(bracketed)
+    {
+        auto const u0 = ++p;
+        while(p != last && *p != '>' && *p != '<')
+            ++p;
+        if(p == last || *p != '>' || p == u0)
+            return false;
+        v.uri = make_view(u0, p);
+        ++p;
+    }
+    else
+    {
+        // The addr-spec ends at the first semicolon, comma
+        // or whitespace, which must be in angle brackets
+        // to be part of the URI; see rfc3261 section 20.
+        auto const u0 = p;
+        while(p != last && *p != ';' && *p != ',' && ! is_ws(*p))
+            ++p;
+        if(p == u0)
+            return false;
+        v.uri = make_view(u0, p);
+    }
+    string_view params;
+    if(! parse_params(p, last, params,
+        [&v](std::pair<string_view, string_view> const& param)
+        {
+            if(iequals(param.first, "tag"))
+                v.tag = param.second;
+        }))
+        return false;
+    v.params = param_list{params};
+    it = p;
+    return true;
+}
+
+inline
+bool
+via_list_policy::
+operator()(value_type& v,
+    char const*& it, string_view s) const
+{
+    if(! next_element(it, s))
+        return true;
+    auto const last = s.data() + s.size();
+    if(! parse_via_parm(it, last, v))
+        return false;
+    return skip_separator(it, last);
+}
+
+inline
+bool
+contact_list_policy::
+operator()(value_type& v,
+    char const*& it, string_view s) const
+{
+    if(! next_element(it, s))
+        return true;
+    auto const last = s.data() + s.size();
+    if(! parse_name_addr(it, last, v))
+        return false;
+    return skip_separator(it, last);
+}
+
+} // detail
+
+inline
+bool
+find_param(
+    param_list const& params,
+    string_view name,
+    string_view& value)
+{
+    for(auto const& param : params)
+    {
+        if(iequals(param.first, name))
+        {
+            value = param.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline
+bool
+parse_name_addr(string_view s, name_addr& v)
+{
+    auto it = s.data();
+    auto const last = s.data() + s.size();
+    if(! detail::parse_name_addr(it, last, v))
+        return false;
+    detail::skip_ws(it, last);
+    return it == last;
+}
+
+inline
+bool
+parse_cseq(
+    string_view s,
+    std::uint32_t& number,
+    string_view& method)
+{
+    s = detail::trim_ws(s);
+    auto it = s.data();
+    auto const last = s.data() + s.size();
+    if(it == last || ! http::detail::is_digit(*it))
+        return false;
+    std::uint64_t v = 0;
+    do
+    {
+        v = 10 * v + static_cast<unsigned>(*it - '0');
+        if(v > 0xffffffff)
+            return false;
+        ++it;
+    }
+    while(it != last && http::detail::is_digit(*it));
+    if(it == last || ! detail::is_ws(*it))
+        return false;
+    detail::skip_ws(it, last);
+    auto const first = it;
+    http::detail::skip_token(it, last);
+    if(it == first || it != last)
+        return false;
+    number = static_cast<std::uint32_t>(v);
+    method = detail::make_view(first, it);
+    return true;
+}
+
+template<class Allocator, class Protocol>
+bool
+parsed_header::
+parse(http::basic_fields<Allocator, Protocol> const& fields)
+{
+    auto const it = fields.find(http::field::via);
+    if(it == fields.end())
+        return false;
+    via_list const vias{it->value()};
+    auto const top = vias.begin();
+    if(top == vias.end())
+        return false;
+    via = *top;
+    if(! parse_name_addr(fields[http::field::from], from))
+        return false;
+    if(! parse_name_addr(fields[http::field::to], to))
+        return false;
+    call_id = detail::trim_ws(fields[http::field::call_id]);
+    if(call_id.empty())
+        return false;
+    return parse_cseq(fields[http::field::cseq], cseq, method);
+}
+
+} // sip
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,377 @@
+#ifndef BOOST_BEAST_SIP_IMPL_TRANSACTION_IPP
+#define BOOST_BEAST_SIP_IMPL_TRANSACTION_IPP
+
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+namespace detail {
+
+// FNV-1a
+inline
+void
+hash_append(std::size_t& h, string_view s)
+{
+    for(auto c : s)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= sizeof(std::size_t) == 8 ?
+            static_cast<std::size_t>(1099511628211ULL) : 16777619U;
+    }
+    // separate the strings
+    h ^= 0xff;
+    h *= sizeof(std::size_t) == 8 ?
+        static_cast<std::size_t>(1099511628211ULL) : 16777619U;
+}
+
+} // detail
+
+template<class Allocator, class Protocol>
+bool
+make_transaction_key(
+    transaction_key& key,
+    http::basic_fields<Allocator, Protocol> const& fields)
+{
+    auto const call_id = detail::trim_ws(
+        fields[http::field::call_id]);
+    if(call_id.empty())
+        return false;
+    std::uint32_t cseq;
+    string_view method;
+    if(! parse_cseq(fields[http::field::cseq], cseq, method))
+        return false;
+    auto const via = fields.find(http::field::via);
+    if(via == fields.end())
+        return false;
+    via_list const vias{via->value()};
+    auto const top = vias.begin();
+    if(top == vias.end() || (*top).branch.empty())
+        return false;
+    key.branch = (*top).branch;
+    key.call_id = call_id;
+    key.cseq = cseq;
+    key.method = method == "ACK" ? string_view("INVITE") : method;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+auto
+transaction_timers::
+interval(
+    transaction_timer t,
+    bool reliable,
+    unsigned retransmits) const ->
+        duration
+{
+    auto const backoff =
+        [&]
+        {
+            // bounded so the shift cannot overflow
+            return t1 * (1 << (std::min)(retransmits, 16u));
+        };
+    switch(t)
+    {
+    case transaction_timer::a:
+        return reliable ? duration::zero() : backoff();
+
+    case transaction_timer::e:
+    case transaction_timer::g:
+        return reliable ? duration::zero() : (std::min)(backoff(), t2);
+
+    case transaction_timer::b:
+    case transaction_timer::f:
+    case transaction_timer::h:
+        return 64 * t1;
+
+    case transaction_timer::c:
+        // "> 3min"
+        return std::chrono::seconds(181);
+
+    case transaction_timer::d:
+        // ">= 32s for UDP"
+        return reliable ? duration::zero() : std::chrono::seconds(32);
+
+    case transaction_timer::j:
+        return reliable ? duration::zero() : 64 * t1;
+
+    case transaction_timer::i:
+    case transaction_timer::k:
+        return reliable ? duration::zero() : t4;
+    }
+    return duration::zero();
+}
+
+//------------------------------------------------------------------------------
+
+template<class T, class Clock>
+template<class... Args>
+transaction_table<T, Clock>::
+node::
+node(
+    transaction_key const& k,
+    std::uint64_t id_,
+    Args&&... args)
+    : id(id_)
+    , value(std::forward<Args>(args)...)
+{
+    s.reserve(k.branch.size() + k.call_id.size() + k.method.size());
+    s.append(k.branch.data(), k.branch.size());
+    s.append(k.call_id.data(), k.call_id.size());
+    s.append(k.method.data(), k.method.size());
+    auto p = s.data();
+    key.branch = string_view(p, k.branch.size());
+    p += k.branch.size();
+    key.call_id = string_view(p, k.call_id.size());
+    p += k.call_id.size();
+    key.method = string_view(p, k.method.size());
+    key.cseq = k.cseq;
+}
+
+template<class T, class Clock>
+std::size_t
+transaction_table<T, Clock>::
+hash(transaction_key const& key)
+{
+    std::size_t h = sizeof(std::size_t) == 8 ?
+        static_cast<std::size_t>(14695981039346656037ULL) : 2166136261U;
+    detail::hash_append(h, key.branch);
+    detail::hash_append(h, key.call_id);
+    detail::hash_append(h, key.method);
+    h ^= key.cseq;
+    return h;
+}
+
+template<class T, class Clock>
+auto
+transaction_table<T, Clock>::
+find(
+    shard& s,
+    std::size_t h,
+    transaction_key const& key) ->
+        node*
+{
+    auto const range = s.map.equal_range(h);
+    for(auto it = range.first; it != range.second; ++it)
+        if(it->second->key == key)
+            return it->second.get();
+    return nullptr;
+}
+
+template<class T, class Clock>
+std::uint64_t
+transaction_table<T, Clock>::
+to_tick(time_point when) const
+{
+    if(when <= start_)
+        return 0;
+    // round up, so that a timer never expires early
+    return static_cast<std::uint64_t>(
+        (when - start_ + tick_ - duration(1)) / tick_);
+}
+
+template<class T, class Clock>
+transaction_table<T, Clock>::
+transaction_table(
+    std::size_t shards,
+    duration tick,
+    std::size_t slots)
+    : shards_(new shard[shards])
+    , shard_count_(shards)
+    , tick_(tick)
+    , start_(Clock::now())
+{
+    BOOST_ASSERT(shards > 0);
+    BOOST_ASSERT(tick > duration::zero());
+    BOOST_ASSERT(slots > 0);
+    for(std::size_t i = 0; i < shards; ++i)
+        shards_[i].wheel.resize(slots);
+}
+
+template<class T, class Clock>
+std::size_t
+transaction_table<T, Clock>::
+size() const
+{
+    std::size_t n = 0;
+    for(std::size_t i = 0; i < shard_count_; ++i)
+    {
+        std::lock_guard<std::mutex> lock(shards_[i].m);
+        n += shards_[i].map.size();
+    }
+    return n;
+}
+
+template<class T, class Clock>
+template<class... Args>
+bool
+transaction_table<T, Clock>::
+emplace(transaction_key const& key, Args&&... args)
+{
+    auto const h = hash(key);
+    auto& s = shard_for(h);
+    std::lock_guard<std::mutex> lock(s.m);
+    if(find(s, h, key))
+        return false;
+    s.map.emplace(h, std::unique_ptr<node>(new node(
+        key, s.next_id++, std::forward<Args>(args)...)));
+    return true;
+}
+
+template<class T, class Clock>
+bool
+transaction_table<T, Clock>::
+erase(transaction_key const& key)
+{
+    auto const h = hash(key);
+    auto& s = shard_for(h);
+    std::lock_guard<std::mutex> lock(s.m);
+    auto const range = s.map.equal_range(h);
+    for(auto it = range.first; it != range.second; ++it)
+    {
+        if(it->second->key == key)
+        {
+            // entries left in the wheel are discarded when visited
+            s.map.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+template<class T, class Clock>
+bool
+transaction_table<T, Clock>::
+contains(transaction_key const& key) const
+{
+    auto const h = hash(key);
+    auto& s = shard_for(h);
+    std::lock_guard<std::mutex> lock(s.m);
+    return find(s, h, key) != nullptr;
+}
+
+template<class T, class Clock>
+template<class F>
+bool
+transaction_table<T, Clock>::
+visit(transaction_key const& key, F&& f)
+{
+    auto const h = hash(key);
+    auto& s = shard_for(h);
+    std::lock_guard<std::mutex> lock(s.m);
+    auto const n = find(s, h, key);
+    if(! n)
+        return false;
+    f(n->value);
+    return true;
+}
+
+template<class T, class Clock>
+bool
+transaction_table<T, Clock>::
+start_timer(
+    transaction_key const& key,
+    transaction_timer t,
+    time_point expiry)
+{
+    auto const h = hash(key);
+    auto& s = shard_for(h);
+    std::lock_guard<std::mutex> lock(s.m);
+    auto const n = find(s, h, key);
+    if(! n)
+        return false;
+    auto const i = static_cast<std::size_t>(t);
+    // invalidates the entry of a running timer
+    ++n->gen[i];
+    n->armed |= 1u << i;
+    auto const tick = (std::max)(to_tick(expiry), s.tick + 1);
+    s.wheel[tick % s.wheel.size()].push_back(
+        timer_entry{h, n->id, tick, n->gen[i], t});
+    return true;
+}
+
+template<class T, class Clock>
+bool
+transaction_table<T, Clock>::
+cancel_timer(
+    transaction_key const& key,
+    transaction_timer t)
+{
+    auto const h = hash(key);
+    auto& s = shard_for(h);
+    std::lock_guard<std::mutex> lock(s.m);
+    auto const n = find(s, h, key);
+    if(! n)
+        return false;
+    auto const bit = 1u << static_cast<std::size_t>(t);
+    if(! (n->armed & bit))
+        return false;
+    n->armed &= ~bit;
+    return true;
+}
+
+template<class T, class Clock>
+template<class F>
+std::size_t
+transaction_table<T, Clock>::
+expire(time_point now, F&& f)
+{
+    std::uint64_t const target = now <= start_ ? 0 :
+        static_cast<std::uint64_t>((now - start_) / tick_);
+    std::size_t count = 0;
+    for(std::size_t k = 0; k < shard_count_; ++k)
+    {
+        auto& s = shards_[k];
+        std::lock_guard<std::mutex> lock(s.m);
+        if(target <= s.tick)
+            continue;
+        auto const slots = s.wheel.size();
+        // visit each slot at most once
+        auto const first = target - s.tick > slots ?
+            target - slots + 1 : s.tick + 1;
+        for(auto tick = first; tick <= target; ++tick)
+        {
+            auto& v = s.wheel[tick % slots];
+            for(std::size_t j = 0; j < v.size();)
+            {
+                auto const e = v[j];
+                if(e.tick > target)
+                {
+                    ++j;
+                    continue;
+                }
+                v[j] = v.back();
+                v.pop_back();
+                auto const range = s.map.equal_range(e.hash);
+                auto it = range.first;
+                while(it != range.second && it->second->id != e.id)
+                    ++it;
+                if(it == range.second)
+                    continue;
+                auto& n = *it->second;
+                auto const i = static_cast<std::size_t>(e.t);
+                auto const bit = 1u << i;
+                if(! (n.armed & bit) || n.gen[i] != e.gen)
+                    continue;
+                n.armed &= ~bit;
+                ++count;
+                if(f(static_cast<transaction_key const&>(n.key),
+                        n.value, e.t))
+                    s.map.erase(it);
+            }
+        }
+        s.tick = target;
+    }
+    return count;
+}
+
+} // sip
+} // beast
+} // boost
+
+#endif
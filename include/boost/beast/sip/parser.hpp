@@ -2,7 +2,7 @@
 #define BOOST_BEAST_SIP_PARSER_HPP
 
 #include <boost/beast/core/detail/config.hpp>
-#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/parser.hpp>
 #include <boost/beast/sip/protocol.hpp>
 
 namespace boost {
@@ -3,6 +3,10 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/string.hpp>
+#include <boost/beast/http/field.hpp>
+#include <boost/core/ignore_unused.hpp>
+#include <cstdint>
+#include <type_traits>
 
 namespace boost {
 namespace beast {
@@ -21,7 +25,7 @@ public:
 	if (name.size() == 1)
 	{
 	    // Compact forms from RFC 3261, section 20.
-	    switch (detail::ascii_tolower(name[0])) {
+	    switch (beast::detail::ascii_tolower(name[0])) {
 		case 'i': return http::field::call_id;
 		case 'm': return http::field::contact;
 		case 'e': return http::field::content_encoding;
@@ -38,15 +42,13 @@ public:
 	return http::default_string_to_field(name);
     }
 
-    static bool constexpr allow_chunked(int version)
+    static bool constexpr allow_chunked(int /*version*/)
     {
 	// From RFC 3261, section 7.4.2:
 	//
 	// The "chunked" transfer encoding of HTTP/1.1 MUST NOT
 	// be used for SIP.
 
-	boost::ignore_unused(version);
-
 	return false;
     }
 
@@ -55,7 +57,7 @@ public:
 	return false;
     }
 
-    static bool check_version(int v)
+    static bool constexpr check_version(int v)
     {
 	return v == 20;
     }
@@ -64,6 +66,46 @@ public:
     {
 	return 20;
     }
+
+protected:
+    // Returns the compact form of a full field name from RFC 3261,
+    // section 20, or an empty string if it has none. This is used
+    // instead of string_to_field, which hashes the name, because
+    // only ten names have a compact form.
+    static string_view compact_form(string_view name)
+    {
+	switch (name.size()) {
+	    case 2:
+		if (iequals(name, "To")) return "t";
+		break;
+	    case 3:
+		if (iequals(name, "Via")) return "v";
+		break;
+	    case 4:
+		if (iequals(name, "From")) return "f";
+		break;
+	    case 7:
+		if (iequals(name, "Call-ID")) return "i";
+		if (iequals(name, "Contact")) return "m";
+		if (iequals(name, "Subject")) return "s";
+		break;
+	    case 9:
+		if (iequals(name, "Supported")) return "k";
+		break;
+	    case 12:
+		if (iequals(name, "Content-Type")) return "c";
+		break;
+	    case 14:
+		if (iequals(name, "Content-Length")) return "l";
+		break;
+	    case 16:
+		if (iequals(name, "Content-Encoding")) return "e";
+		break;
+	    default:
+		break;
+	}
+	return {};
+    }
 };
 
 class stream_protocol : public protocol_base
@@ -74,6 +116,16 @@ public:
 	return to_string(name);
     }
 
+    static string_view name_to_compact(string_view sname)
+    {
+	// Full names are stored, and names are compared without
+	// regard to case, so only a compact form must be replaced.
+	if (sname.size() != 1)
+	    return sname;
+	auto name = string_to_field(sname);
+	return name == http::field::unknown ? sname : field_to_compact(name);
+    }
+
     static constexpr
     std::uint64_t
     default_body_limit(std::false_type)
@@ -107,6 +159,11 @@ public:
 	return false;
     }
 
+    static bool constexpr request_body_to_eof()
+    {
+	return false;
+    }
+
     static bool constexpr use_http11_keepalive(int)
     {
 	return true;
@@ -139,8 +196,12 @@ public:
 
     static string_view name_to_compact(string_view sname)
     {
-	auto name = string_to_field(sname);
-	return name == http::field::unknown ? sname : field_to_compact(name);
+	// A compact form, or a single letter which is not one,
+	// is stored as given.
+	if (sname.size() == 1)
+	    return sname;
+	auto compact = compact_form(sname);
+	return compact.empty() ? sname : compact;
     }
 
     // Body size details
@@ -209,6 +270,14 @@ public:
 	return false;
     }
 
+    static bool constexpr request_body_to_eof()
+    {
+	// The body of a request without Content-Length ends at
+	// the end of the transport packet, as for a response.
+
+	return true;
+    }
+
     static bool constexpr use_http11_keepalive(int)
     {
 	return false;
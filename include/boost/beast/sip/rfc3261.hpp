@@ -0,0 +1,276 @@
+#ifndef BOOST_BEAST_SIP_RFC3261_HPP
+#define BOOST_BEAST_SIP_RFC3261_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/detail/basic_parsed_list.hpp>
+#include <boost/beast/sip/detail/rfc3261.hpp>
+#include <cstdint>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+/** A list of parameters in a SIP field value.
+
+    This container allows iteration of the generic parameters which
+    follow a Via, a name-addr in To, From or Contact, and other SIP
+    field values. Unlike @ref http::param_list, no memory is allocated:
+    a quoted-string value is presented as it appears, including the
+    quotes, and may be unquoted by the caller when needed.
+
+    If a parsing error is encountered while iterating the string,
+    the iterator reports it with `error()` and becomes equal to
+    the end iterator. Use @ref http::validate_list to check a list.
+
+    @par BNF
+    @code
+        params          = *( SEMI generic-param )
+        generic-param   = token [ EQUAL gen-value ]
+        gen-value       = token / host / quoted-string
+    @endcode
+
+    @par Example
+    @code
+    for(auto const& param : param_list{";branch=z9hG4bK776;rport"})
+        std::cout << param.first << "=" << param.second << "\n";
+    @endcode
+*/
+using param_list =
+    http::detail::basic_parsed_list<
+        detail::param_list_policy>;
+
+/** Return the value of the first parameter with a name.
+
+    @param params The parameter list to search.
+
+    @param name The name of the parameter. A case-insensitive
+    comparison is used.
+
+    @param value Set to the value of the parameter, which is
+    empty if the parameter has no value.
+
+    @return `true` if the parameter was found.
+*/
+inline
+bool
+find_param(
+    param_list const& params,
+    string_view name,
+    string_view& value);
+
+//------------------------------------------------------------------------------
+
+/** A via-parm in the value of a Via field.
+
+    The strings refer to the field value which was parsed.
+*/
+struct via_parm
+{
+    /// The protocol name of the sent-protocol, such as "SIP"
+    string_view protocol_name;
+
+    /// The protocol version of the sent-protocol, such as "2.0"
+    string_view protocol_version;
+
+    /// The transport of the sent-protocol, such as "UDP"
+    string_view transport;
+
+    /// The host of the sent-by, with the brackets of an IPv6 reference
+    string_view host;
+
+    /// The port of the sent-by, or zero if it has none
+    std::uint16_t port = 0;
+
+    /// All of the via-params
+    param_list params{string_view{}};
+
+    /// The value of the branch parameter
+    string_view branch;
+
+    /// The value of the received parameter
+    string_view received;
+
+    /// The value of the rport parameter, which may be empty when present
+    string_view rport;
+
+    /// `true` if the rport parameter is present
+    bool has_rport = false;
+};
+
+/** A list of via-parms in the value of a Via field.
+
+    This container allows iteration of each via-parm in the value
+    of a Via field, which may hold several separated by commas.
+    The first element is the top Via of a message whose value has
+    been placed in the first Via field. No memory is allocated.
+
+    @par BNF
+    @code
+        via-parm        = sent-protocol LWS sent-by *( SEMI via-params )
+        sent-protocol   = protocol-name SLASH protocol-version SLASH transport
+        sent-by         = host [ COLON port ]
+        host            = hostname / IPv4address / IPv6reference
+    @endcode
+
+    @par Example
+    @code
+    for(auto const& via : via_list{"SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776"})
+        std::cout << via.host << " " << via.branch << "\n";
+    @endcode
+*/
+using via_list =
+    http::detail::basic_parsed_list<
+        detail::via_list_policy>;
+
+//------------------------------------------------------------------------------
+
+/** A name-addr or addr-spec with parameters.
+
+    This is the value of a To or From field, or an element of
+    a Contact field. The strings refer to the field value which
+    was parsed.
+*/
+struct name_addr
+{
+    /** The display name, which may be empty.
+
+        A quoted display name is presented with its quotes.
+    */
+    string_view display_name;
+
+    /** The URI, without enclosing angle brackets.
+
+        For the wildcard Contact this is "*".
+    */
+    string_view uri;
+
+    /** The header parameters following the URI.
+
+        When the URI is not enclosed in angle brackets, every
+        parameter following it is a header parameter.
+    */
+    param_list params{string_view{}};
+
+    /// The value of the tag parameter
+    string_view tag;
+};
+
+/** Parse the value of a To or From field.
+
+    No memory is allocated; the strings of the result refer
+    to the field value.
+
+    @par BNF
+    @code
+        from-spec       = ( name-addr / addr-spec ) *( SEMI from-param )
+        name-addr       = [ display-name ] LAQUOT addr-spec RAQUOT
+        display-name    = *( token LWS ) / quoted-string
+    @endcode
+
+    @param s The field value.
+
+    @param v Set to the parsed value.
+
+    @return `true` if the entire value was parsed.
+*/
+inline
+bool
+parse_name_addr(string_view s, name_addr& v);
+
+/** A list of contacts in the value of a Contact field.
+
+    This container allows iteration of each contact in the value
+    of a Contact field, which may hold several separated by commas.
+    No memory is allocated.
+
+    @par BNF
+    @code
+        Contact         = ( "Contact" / "m" ) HCOLON
+                          ( STAR / ( contact-param *( COMMA contact-param ) ) )
+        contact-param   = ( name-addr / addr-spec ) *( SEMI contact-params )
+    @endcode
+*/
+using contact_list =
+    http::detail::basic_parsed_list<
+        detail::contact_list_policy>;
+
+//------------------------------------------------------------------------------
+
+/** Parse the value of a CSeq field.
+
+    @par BNF
+    @code
+        CSeq            = "CSeq" HCOLON 1*DIGIT LWS Method
+    @endcode
+
+    @param s The field value.
+
+    @param number Set to the sequence number.
+
+    @param method Set to the method, which refers to the
+    field value.
+
+    @return `true` if the value was parsed. The sequence number
+    must be less than 2**32.
+*/
+inline
+bool
+parse_cseq(
+    string_view s,
+    std::uint32_t& number,
+    string_view& method);
+
+//------------------------------------------------------------------------------
+
+/** The parsed values of the fields which identify a SIP message.
+
+    Every SIP element inspects the top Via, From, To, Call-ID and
+    CSeq of each message. This object parses them once, so that
+    the values may be used repeatedly without parsing the fields
+    again. A program typically keeps one alongside each message.
+
+    The strings refer to the field values in the container which
+    was parsed, and are only valid while those fields are
+    unchanged. After modifying the fields, call @ref parse again.
+*/
+struct parsed_header
+{
+    /// The top Via
+    via_parm via;
+
+    /// The From field
+    name_addr from;
+
+    /// The To field
+    name_addr to;
+
+    /// The Call-ID field
+    string_view call_id;
+
+    /// The sequence number of the CSeq field
+    std::uint32_t cseq = 0;
+
+    /// The method of the CSeq field
+    string_view method;
+
+    /** Parse the fields of a message.
+
+        Full and compact field names are both recognized.
+
+        @return `true` if the fields were present and parsed.
+    */
+    template<class Allocator, class Protocol>
+    bool
+    parse(http::basic_fields<Allocator, Protocol> const& fields);
+};
+
+} // sip
+} // beast
+} // boost
+
+#include <boost/beast/sip/impl/rfc3261.ipp>
+
+#endif
@@ -0,0 +1,383 @@
+#ifndef BOOST_BEAST_SIP_TRANSACTION_HPP
+#define BOOST_BEAST_SIP_TRANSACTION_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/fields.hpp>
+#include <boost/beast/sip/rfc3261.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+/** The key which identifies a SIP transaction.
+
+    The key is formed from the branch parameter of the top Via,
+    the Call-ID, and the sequence number and method of the CSeq.
+    As in rfc3261 section 17.2.3, the method of an ACK is taken
+    to be INVITE so that an ACK matches the INVITE transaction
+    it acknowledges, while a CANCEL forms its own transaction.
+
+    The strings refer to the fields of a message, and are only
+    valid while the message is unchanged.
+*/
+struct transaction_key
+{
+    /// The branch parameter of the top Via
+    string_view branch;
+
+    /// The value of the Call-ID field
+    string_view call_id;
+
+    /// The sequence number of the CSeq field
+    std::uint32_t cseq = 0;
+
+    /// The method of the CSeq field, with ACK replaced by INVITE
+    string_view method;
+};
+
+/// Returns `true` if two transaction keys are equal
+inline
+bool
+operator==(transaction_key const& lhs, transaction_key const& rhs)
+{
+    return
+        lhs.cseq == rhs.cseq &&
+        lhs.branch == rhs.branch &&
+        lhs.call_id == rhs.call_id &&
+        lhs.method == rhs.method;
+}
+
+/// Returns `true` if two transaction keys are not equal
+inline
+bool
+operator!=(transaction_key const& lhs, transaction_key const& rhs)
+{
+    return ! (lhs == rhs);
+}
+
+/** Extract the transaction key from the fields of a message.
+
+    The Call-ID, CSeq and the top Via are located in the fields,
+    using either the full or the compact form of their names.
+    No memory is allocated; the strings in the key refer to the
+    values stored in the container.
+
+    @param key The key to set.
+
+    @param fields The fields of a request or response.
+
+    @return `true` if the key was extracted, or `false` if the
+    Call-ID, the CSeq, or the branch parameter of the top Via is
+    missing or malformed.
+*/
+template<class Allocator, class Protocol>
+bool
+make_transaction_key(
+    transaction_key& key,
+    http::basic_fields<Allocator, Protocol> const& fields);
+
+//------------------------------------------------------------------------------
+
+/// The timers of the SIP transaction state machines in rfc3261
+enum class transaction_timer
+{
+    /// INVITE request retransmit interval, for UDP only
+    a,
+
+    /// INVITE transaction timeout timer
+    b,
+
+    /// Proxy INVITE transaction timeout
+    c,
+
+    /// Wait time for response retransmits
+    d,
+
+    /// Non-INVITE request retransmit interval, UDP only
+    e,
+
+    /// Non-INVITE transaction timeout timer
+    f,
+
+    /// INVITE response retransmit interval
+    g,
+
+    /// Wait time for ACK receipt
+    h,
+
+    /// Wait time for ACK retransmits
+    i,
+
+    /// Wait time for non-INVITE request retransmits
+    j,
+
+    /// Wait time for response retransmits
+    k
+};
+
+/** The values of the SIP transaction timers.
+
+    The defaults of the base values are those of rfc3261
+    section 17.1.1.1 and table 4. A program may change them,
+    for example to use a larger T1 when the round-trip time
+    is known to be high.
+*/
+struct transaction_timers
+{
+    /// The type of duration
+    using duration = std::chrono::milliseconds;
+
+    /// The round-trip time estimate
+    duration t1 = duration(500);
+
+    /// The maximum retransmit interval for non-INVITE requests and INVITE responses
+    duration t2 = duration(4000);
+
+    /// The maximum duration a message will remain in the network
+    duration t4 = duration(5000);
+
+    /** Returns the interval of a timer.
+
+        @param t The timer.
+
+        @param reliable `true` if the transport is reliable, such
+        as TCP. Timers which only apply to unreliable transports
+        have a zero interval on a reliable transport, meaning they
+        fire immediately or are not started.
+
+        @param retransmits The number of retransmissions already
+        made. The retransmit timers A, E and G double each time,
+        with E and G limited to T2.
+    */
+    duration
+    interval(
+        transaction_timer t,
+        bool reliable,
+        unsigned retransmits = 0) const;
+};
+
+//------------------------------------------------------------------------------
+
+/** A concurrent table of SIP transactions.
+
+    This container maps the @ref transaction_key of a message to
+    a transaction object, and runs the transaction timers. It is
+    divided into shards, each with its own mutex, hash table and
+    timer wheel, so that threads working on different transactions
+    rarely contend. Looking up a transaction does not allocate
+    memory: the key is hashed and compared in place.
+
+    Timers are kept in a hashed timing wheel with a fixed tick.
+    Starting or cancelling a timer takes constant time, and
+    a timer which is cancelled or whose transaction is removed
+    is discarded when its slot is next visited. Expired timers
+    are delivered by calling @ref expire periodically, typically
+    from a steady timer running at the tick interval.
+
+    @par Thread Safety
+    Distinct objects: Safe.@n
+    Shared objects: Safe. Function objects passed to member
+    functions are invoked while the shard holding the transaction
+    is locked, and must not call member functions of the table.
+
+    @tparam T The type of transaction object.
+
+    @tparam Clock The clock used for timers.
+*/
+template<class T, class Clock = std::chrono::steady_clock>
+class transaction_table
+{
+public:
+    /// The type of clock
+    using clock_type = Clock;
+
+    /// The type of time point
+    using time_point = typename Clock::time_point;
+
+    /// The type of duration
+    using duration = typename Clock::duration;
+
+private:
+    static std::size_t constexpr timer_count = 11;
+
+    struct node
+    {
+        std::string s;
+        transaction_key key;
+        std::uint64_t id;
+        std::uint32_t armed = 0;
+        std::uint32_t gen[timer_count] = {};
+        T value;
+
+        template<class... Args>
+        node(transaction_key const& k,
+            std::uint64_t id_, Args&&... args);
+    };
+
+    struct timer_entry
+    {
+        std::size_t hash;
+        std::uint64_t id;
+        std::uint64_t tick;
+        std::uint32_t gen;
+        transaction_timer t;
+    };
+
+    struct shard
+    {
+        std::mutex m;
+        std::unordered_multimap<
+            std::size_t, std::unique_ptr<node>> map;
+        std::vector<std::vector<timer_entry>> wheel;
+        std::uint64_t tick = 0;
+        std::uint64_t next_id = 0;
+    };
+
+    std::unique_ptr<shard[]> shards_;
+    std::size_t shard_count_;
+    duration tick_;
+    time_point start_;
+
+    static
+    std::size_t
+    hash(transaction_key const& key);
+
+    shard&
+    shard_for(std::size_t h) const
+    {
+        return shards_[h % shard_count_];
+    }
+
+    static
+    node*
+    find(shard& s, std::size_t h, transaction_key const& key);
+
+    std::uint64_t
+    to_tick(time_point when) const;
+
+public:
+    /** Constructor
+
+        @param shards The number of shards, which should be at
+        least the number of threads using the table.
+
+        @param tick The resolution of the timers.
+
+        @param slots The number of slots in the timer wheel of
+        each shard. Timers further than `tick * slots` in the
+        future are kept in a slot until their deadline.
+    */
+    explicit
+    transaction_table(
+        std::size_t shards = 16,
+        duration tick = std::chrono::milliseconds(10),
+        std::size_t slots = 512);
+
+    /// Returns the number of transactions in the table
+    std::size_t
+    size() const;
+
+    /** Add a transaction.
+
+        The transaction object is constructed in place from the
+        arguments. The strings of the key are copied.
+
+        @return `true` if the transaction was added, or `false`
+        if a transaction with the same key already exists.
+    */
+    template<class... Args>
+    bool
+    emplace(transaction_key const& key, Args&&... args);
+
+    /** Remove a transaction.
+
+        Timers which are running for the transaction are cancelled.
+
+        @return `true` if the transaction was removed.
+    */
+    bool
+    erase(transaction_key const& key);
+
+    /// Returns `true` if the table holds a transaction with the key
+    bool
+    contains(transaction_key const& key) const;
+
+    /** Invoke a function with a transaction.
+
+        The equivalent signature of the function must be:
+        @code
+        void f(T& value);
+        @endcode
+
+        @return `true` if the transaction was found.
+    */
+    template<class F>
+    bool
+    visit(transaction_key const& key, F&& f);
+
+    /** Start a timer for a transaction.
+
+        If the timer is already running for the transaction,
+        its deadline is replaced.
+
+        @param key The key of the transaction.
+
+        @param t The timer to start.
+
+        @param expiry The time at which the timer expires.
+
+        @return `true` if the transaction was found.
+    */
+    bool
+    start_timer(
+        transaction_key const& key,
+        transaction_timer t,
+        time_point expiry);
+
+    /** Cancel a timer for a transaction.
+
+        @return `true` if the timer was running.
+    */
+    bool
+    cancel_timer(
+        transaction_key const& key,
+        transaction_timer t);
+
+    /** Deliver the timers which have expired.
+
+        Every timer whose deadline is at or before `now` is
+        stopped and the function is invoked for it. The
+        equivalent signature of the function must be:
+        @code
+        bool f(
+            transaction_key const& key, // the key of the transaction
+            T& value,                   // the transaction
+            transaction_timer t         // the timer which expired
+        );
+        @endcode
+        When the function returns `true` the transaction is
+        removed from the table.
+
+        @return The number of timers delivered.
+    */
+    template<class F>
+    std::size_t
+    expire(time_point now, F&& f);
+};
+
+} // sip
+} // beast
+} // boost
+
+#include <boost/beast/sip/impl/transaction.ipp>
+
+#endif
@@ -15,7 +15,7 @@
 #include <boost/throw_exception.hpp>
 #include <atomic>
 #include <cstdlib>
-#include <mutex>
+#include <cstdint>
 #include <new>
 #include <random>
 #include <stdexcept>
@@ -57,11 +57,40 @@ prng_seed(std::seed_seq* ss)
 
 //------------------------------------------------------------------------------
 
+// A lock-free cache of idle generators. Each slot holds
+// at most one, taken and returned with a single atomic
+// operation on the slot, so there is no ABA problem.
 template<class T>
 class prng_pool
 {
-    std::mutex m_;
-    T* head_ = nullptr;
+    static std::size_t constexpr slots = 64;
+
+    struct alignas(64) slot
+    {
+        std::atomic<T*> p{nullptr};
+    };
+
+    slot v_[slots];
+
+    // The stacks of different threads are far apart,
+    // which spreads them over the slots without the
+    // cost of hashing the thread id.
+    static
+    std::size_t
+    first() noexcept
+    {
+        char c;
+        return (reinterpret_cast<std::uintptr_t>(
+            &c) >> 20) % slots;
+    }
+
+    static
+    void
+    destroy(T* p) noexcept
+    {
+        p->~T();
+        boost::alignment::aligned_free(p);
+    }
 
 public:
     static
@@ -74,27 +103,22 @@ public:
 
     ~prng_pool()
     {
-        for(auto p = head_; p;)
-        {
-            auto next = p->next;
-            p->~T();
-            boost::alignment::aligned_free(p);
-            p = next;
-        }
+        for(auto& s : v_)
+            if(auto p = s.p.load())
+                destroy(p);
     }
 
     prng::ref
     acquire()
     {
+        auto const i0 = first();
+        for(std::size_t n = 0; n < slots; ++n)
         {
-            std::lock_guard<
-                std::mutex> g(m_);
-            if(head_)
-            {
-                auto p = head_;
-                head_ = head_->next;
-                return prng::ref(*p);
-            }
+            auto& s = v_[(i0 + n) % slots];
+            if(s.p.load(std::memory_order_relaxed))
+                if(auto p = s.p.exchange(
+                        nullptr, std::memory_order_acquire))
+                    return prng::ref(*p);
         }
         auto p = boost::alignment::aligned_alloc(
             16, sizeof(T));
@@ -104,12 +128,21 @@ public:
     }
 
     void
-    release(T& t)
+    release(T& t) noexcept
     {
-        std::lock_guard<
-            std::mutex> g(m_);
-        t.next = head_;
-        head_ = &t;
+        auto const i0 = first();
+        for(std::size_t n = 0; n < slots; ++n)
+        {
+            auto& s = v_[(i0 + n) % slots];
+            T* expected = nullptr;
+            if(s.p.compare_exchange_strong(expected, &t,
+                    std::memory_order_release,
+                    std::memory_order_relaxed))
+                return;
+        }
+        // Every slot is taken, more generators
+        // were in use at once than we cache
+        destroy(&t);
     }
 };
 
@@ -122,8 +155,6 @@ make_prng_no_tls(bool secure)
         std::minstd_rand r_;
 
     public:
-        fast_prng* next;
-
         fast_prng()
             : r_([]
                 {
@@ -166,8 +197,6 @@ make_prng_no_tls(bool secure)
         beast::detail::chacha<20> r_;
 
     public:
-        secure_prng* next;
-
         secure_prng()
             : r_(prng_seed(), []
                 {
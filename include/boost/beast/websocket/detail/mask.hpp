@@ -12,13 +12,20 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/detail/cpu_info.hpp>
 #include <boost/asio/buffer.hpp>
+#include <algorithm>
 #include <array>
 #include <climits>
 #include <cstdint>
+#include <cstring>
 #include <random>
 #include <type_traits>
 
+#if ! BOOST_BEAST_NO_INTRINSICS
+#include <immintrin.h>
+#endif
+
 namespace boost {
 namespace beast {
 namespace websocket {
@@ -45,28 +52,214 @@ rol(std::array<unsigned char, N>& v, std::size_t n)
         v[i] = v0[(i + n) % v.size()];
 }
 
+/*  Masking kernels
+
+    Each kernel XORs whole vectors of the `n` octets at `src`
+    with the 32-bit key `k` repeated and stores them at `dst`,
+    stopping when less than a vector remains, and returns the
+    number of octets masked. As this is a multiple of four, the
+    key needs no rotation afterwards. The octets of `k` are in
+    memory order. The ranges are either the same or disjoint.
+*/
+using mask_kernel = std::size_t(*)(
+    unsigned char* dst,
+    unsigned char const* src,
+    std::size_t n,
+    std::uint32_t k);
+
+inline
+std::size_t
+mask_words(
+    unsigned char* dst,
+    unsigned char const* src,
+    std::size_t n,
+    std::uint32_t k)
+{
+    std::uint64_t const k2 = (std::uint64_t(k) << 32) | k;
+    auto const n0 = n;
+    while(n >= 8)
+    {
+        std::uint64_t v;
+        std::memcpy(&v, src, 8);
+        v ^= k2;
+        std::memcpy(dst, &v, 8);
+        src += 8;
+        dst += 8;
+        n -= 8;
+    }
+    return n0 - n;
+}
+
+#if ! BOOST_BEAST_NO_INTRINSICS
+
+inline
+std::size_t
+mask_sse2(
+    unsigned char* dst,
+    unsigned char const* src,
+    std::size_t n,
+    std::uint32_t k)
+{
+    auto const k4 = _mm_set1_epi32(static_cast<int>(k));
+    auto const n0 = n;
+    while(n >= 16)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+            _mm_xor_si128(_mm_loadu_si128(
+                reinterpret_cast<__m128i const*>(src)), k4));
+        src += 16;
+        dst += 16;
+        n -= 16;
+    }
+    return n0 - n;
+}
+
+BOOST_BEAST_TARGET("avx2")
+inline
+std::size_t
+mask_avx2(
+    unsigned char* dst,
+    unsigned char const* src,
+    std::size_t n,
+    std::uint32_t k)
+{
+    auto const k8 = _mm256_set1_epi32(static_cast<int>(k));
+    auto const n0 = n;
+    while(n >= 32)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+            _mm256_xor_si256(_mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(src)), k8));
+        src += 32;
+        dst += 32;
+        n -= 32;
+    }
+    return n0 - n;
+}
+
+BOOST_BEAST_TARGET("avx512f")
+inline
+std::size_t
+mask_avx512(
+    unsigned char* dst,
+    unsigned char const* src,
+    std::size_t n,
+    std::uint32_t k)
+{
+    auto const k16 = _mm512_set1_epi32(static_cast<int>(k));
+    auto const n0 = n;
+    while(n >= 64)
+    {
+        _mm512_storeu_si512(dst,
+            _mm512_xor_si512(_mm512_loadu_si512(src), k16));
+        src += 64;
+        dst += 64;
+        n -= 64;
+    }
+    return n0 - n;
+}
+
+#endif
+
+// Returns the fastest kernel this processor supports
+template<class = void>
+mask_kernel
+get_mask_kernel()
+{
+#if ! BOOST_BEAST_NO_INTRINSICS
+    static mask_kernel const f =
+        beast::detail::get_cpu_info().avx512 ? &mask_avx512 :
+        beast::detail::get_cpu_info().avx2 ? &mask_avx2 :
+        &mask_sse2;
+    return f;
+#else
+    return &mask_words;
+#endif
+}
+
+// Mask octets one at a time
+inline
+void
+mask_bytes(
+    unsigned char* dst,
+    unsigned char const* src,
+    std::size_t n,
+    prepared_key& key)
+{
+    if(n == 0)
+        return;
+    for(std::size_t i = 0; i < n; ++i)
+        dst[i] = src[i] ^ key[i % 4];
+    rol(key, n % 4);
+}
+
+// Mask `n` octets from `src` to `dst`
+inline
+void
+mask_copy(
+    unsigned char* dst,
+    unsigned char const* src,
+    std::size_t n,
+    prepared_key& key)
+{
+    // Below this size, calling the kernel
+    // costs more than masking whole words.
+    std::size_t constexpr min_vector = 64;
+
+    std::uint32_t k;
+    std::memcpy(&k, key.data(), 4);
+    if(n >= min_vector)
+    {
+        // The kernels load and store unaligned vectors,
+        // so octets before an alignment boundary need
+        // no separate pass.
+        auto const m = get_mask_kernel()(dst, src, n, k);
+        src += m;
+        dst += m;
+        n -= m;
+    }
+    auto const m = mask_words(dst, src, n, k);
+    mask_bytes(dst + m, src + m, n - m, key);
+}
+
 // Apply mask in place
 //
 inline
 void
 mask_inplace(net::mutable_buffer& b, prepared_key& key)
 {
-    auto n = b.size();
-    auto mask = key; // avoid aliasing
-    auto p = static_cast<unsigned char*>(b.data());
-    while(n >= 4)
-    {
-        for(int i = 0; i < 4; ++i)
-            p[i] ^= mask[i];
-        p += 4;
-        n -= 4;
-    }
-    if(n > 0)
+    auto const p = static_cast<unsigned char*>(b.data());
+    mask_copy(p, p, b.size(), key);
+}
+
+/*  Copy and mask in one pass
+
+    Octets are copied from the buffer sequence to `dst` as if
+    by `net::buffer_copy`, masking each one, and the number of
+    octets copied is returned.
+*/
+template<class ConstBufferSequence>
+std::size_t
+mask_copy(
+    net::mutable_buffer dst,
+    ConstBufferSequence const& src,
+    prepared_key& key)
+{
+    auto p = static_cast<unsigned char*>(dst.data());
+    auto n = dst.size();
+    auto const n0 = n;
+    for(net::const_buffer b :
+            beast::buffers_range_ref(src))
     {
-        for(std::size_t i = 0; i < n; ++i)
-            p[i] ^= mask[i];
-        rol(key, n);
+        if(n == 0)
+            break;
+        auto const m = (std::min)(n, b.size());
+        mask_copy(p, static_cast<
+            unsigned char const*>(b.data()), m, key);
+        p += m;
+        n -= m;
     }
+    return n0 - n;
 }
 
 // Apply mask in place
@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_DETAIL_PAYLOAD_HPP
+#define BOOST_BEAST_WEBSOCKET_DETAIL_PAYLOAD_HPP
+
+#include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/detail/cpu_info.hpp>
+#include <boost/beast/websocket/detail/mask.hpp>
+#include <boost/beast/websocket/detail/utf8_checker.hpp>
+#include <boost/asio/buffer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if ! BOOST_BEAST_NO_INTRINSICS && ! defined(BOOST_MSVC)
+#include <x86intrin.h> // __rdtsc
+#endif
+
+/*  Set to nonzero to count the cycles spent in each stage of
+    reading message payload. This is the default in debug builds.
+*/
+#ifndef BOOST_BEAST_WEBSOCKET_READ_COUNTERS
+# ifdef NDEBUG
+#  define BOOST_BEAST_WEBSOCKET_READ_COUNTERS 0
+# else
+#  define BOOST_BEAST_WEBSOCKET_READ_COUNTERS 1
+# endif
+#endif
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+/*  The work done reading message payload on this thread.
+
+    The counters only advance when BOOST_BEAST_WEBSOCKET_READ_COUNTERS
+    is nonzero. Cycles are read from the time stamp counter, or are
+    nanoseconds when intrinsics are disabled.
+*/
+struct read_counters
+{
+    std::uint64_t bytes = 0;    // octets of payload
+    std::uint64_t copy = 0;     // cycles copying and unmasking
+    std::uint64_t utf8 = 0;     // cycles validating text
+};
+
+template<class = void>
+read_counters&
+get_read_counters()
+{
+    static thread_local read_counters c;
+    return c;
+}
+
+inline
+std::uint64_t
+read_cycles()
+{
+#if ! BOOST_BEAST_NO_INTRINSICS
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// The octets copied, unmasked and validated at once.
+// Each block stays in the first level cache between
+// the stages, so the payload is read from memory once.
+static std::size_t constexpr payload_block = 4096;
+
+/*  Copy payload, removing the mask and validating text.
+
+    The ranges are either the same or disjoint. `key` is null
+    if the payload is not masked, and `utf8` is null if the
+    payload is not text.
+
+    @return `false` if the text is not valid UTF-8.
+*/
+inline
+bool
+process_payload(
+    unsigned char* dst,
+    unsigned char const* src,
+    std::size_t n,
+    prepared_key* key,
+    utf8_checker* utf8)
+{
+    while(n > 0)
+    {
+        auto const m = (std::min)(n, payload_block);
+    #if BOOST_BEAST_WEBSOCKET_READ_COUNTERS
+        auto& rc = get_read_counters();
+        auto const t0 = read_cycles();
+    #endif
+        if(key)
+            mask_copy(dst, src, m, *key);
+        else if(dst != src)
+            std::memcpy(dst, src, m);
+    #if BOOST_BEAST_WEBSOCKET_READ_COUNTERS
+        auto const t1 = read_cycles();
+        rc.copy += t1 - t0;
+    #endif
+        if(utf8 && ! utf8->write(dst, m))
+            return false;
+    #if BOOST_BEAST_WEBSOCKET_READ_COUNTERS
+        rc.utf8 += read_cycles() - t1;
+        rc.bytes += m;
+    #endif
+        dst += m;
+        src += m;
+        n -= m;
+    }
+    return true;
+}
+
+/*  Copy payload from the read buffer into the caller's buffers.
+
+    @param n Set to the number of octets copied.
+
+    @return `false` if the text is not valid UTF-8.
+*/
+template<
+    class MutableBufferSequence,
+    class ConstBufferSequence>
+bool
+copy_payload(
+    std::size_t& n,
+    MutableBufferSequence const& buffers,
+    ConstBufferSequence const& src,
+    prepared_key* key,
+    utf8_checker* utf8)
+{
+    n = 0;
+    auto it = net::buffer_sequence_begin(src);
+    auto const end = net::buffer_sequence_end(src);
+    net::const_buffer cb;
+    for(net::mutable_buffer b : beast::buffers_range_ref(buffers))
+    {
+        while(b.size() > 0)
+        {
+            while(cb.size() == 0)
+            {
+                if(it == end)
+                    return true;
+                cb = *it++;
+            }
+            auto const m = (std::min)(b.size(), cb.size());
+            if(! process_payload(
+                static_cast<unsigned char*>(b.data()),
+                static_cast<unsigned char const*>(cb.data()),
+                m, key, utf8))
+                return false;
+            b += m;
+            cb += m;
+            n += m;
+        }
+    }
+    return true;
+}
+
+/*  Unmask and validate payload read into the caller's buffers.
+
+    @return `false` if the text is not valid UTF-8.
+*/
+template<class MutableBufferSequence>
+bool
+unmask_payload(
+    MutableBufferSequence const& buffers,
+    prepared_key* key,
+    utf8_checker* utf8)
+{
+    for(auto b : beast::buffers_range_ref(buffers))
+    {
+        auto const p = static_cast<unsigned char*>(b.data());
+        if(! process_payload(p, p, b.size(), key, utf8))
+            return false;
+    }
+    return true;
+}
+
+} // detail
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -165,6 +165,23 @@ struct impl_base<true>
         }
     }
 
+    // Prepare to send a message compressed separately,
+    // with `window_bits`, or zero if it has no compressed
+    // form. Returns `false` to send it uncompressed.
+    bool
+    begin_prepared(int window_bits)
+    {
+        if( ! pmd_ || window_bits == 0 ||
+            window_bits > pmd_config_.server_max_window_bits)
+            return false;
+        // The message refers to no earlier data, but it is
+        // added to the window of the peer and not to ours.
+        // Start over, or the distances in the next message
+        // would point at the wrong data.
+        pmd_->zo.reset();
+        return true;
+    }
+
     void
     inflate(
         zlib::z_params& zs,
@@ -383,6 +400,12 @@ struct impl_base<false>
     {
     }
 
+    bool
+    begin_prepared(int)
+    {
+        return false;
+    }
+
     void
     inflate(
         zlib::z_params&,
@@ -11,16 +11,335 @@
 #define BOOST_BEAST_WEBSOCKET_DETAIL_UTF8_CHECKER_HPP
 
 #include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/detail/cpu_info.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/assert.hpp>
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+
+#if ! BOOST_BEAST_NO_INTRINSICS
+#include <immintrin.h>
+#endif
 
 namespace boost {
 namespace beast {
 namespace websocket {
 namespace detail {
 
+#if ! BOOST_BEAST_NO_INTRINSICS
+
+/*  Vectorized UTF-8 validation
+
+    This is the lookup algorithm of Keiser and Lemire, "Validating
+    UTF-8 In Less Than One Instruction Per Byte" (2020). Each octet
+    is classified with three table lookups, on the high nibble of
+    the previous octet, the low nibble of the previous octet and
+    the high nibble of the octet itself. The tables are arranged
+    so that the AND of the three results is nonzero exactly where
+    a pair of octets is invalid, except that the third and fourth
+    octets of a sequence are checked separately against the lead
+    octet two and three positions back.
+
+    Each kernel validates a range holding only whole code points.
+    The last block is padded with zeros, which ends any sequence
+    left incomplete as an error.
+*/
+
+// The error bits set by each pair of octets
+enum : std::uint8_t
+{
+    utf8_too_short   = 1 << 0, // 11______ 0_______ or 11______ 11______
+    utf8_too_long    = 1 << 1, // 0_______ 10______
+    utf8_overlong_3  = 1 << 2, // 11100000 100_____
+    utf8_too_large   = 1 << 3, // 11110100 1001____ and larger
+    utf8_surrogate   = 1 << 4, // 11101101 101_____
+    utf8_overlong_2  = 1 << 5, // 1100000_ 10______
+    utf8_too_large_1000 = 1 << 6, // 11110101 1000____ and larger
+    utf8_overlong_4  = 1 << 6, // 11110000 1000____
+    utf8_two_conts   = 1 << 7, // 10______ 10______
+    utf8_carry = utf8_too_short | utf8_too_long | utf8_two_conts
+};
+
+#define BOOST_BEAST_UTF8_BYTE_1_HIGH \
+    utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long, \
+    utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long, \
+    utf8_two_conts, utf8_two_conts, utf8_two_conts, utf8_two_conts, \
+    utf8_too_short | utf8_overlong_2, \
+    utf8_too_short, \
+    utf8_too_short | utf8_overlong_3 | utf8_surrogate, \
+    utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4
+
+#define BOOST_BEAST_UTF8_BYTE_1_LOW \
+    utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4, \
+    utf8_carry | utf8_overlong_2, \
+    utf8_carry, \
+    utf8_carry, \
+    utf8_carry | utf8_too_large, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000, \
+    utf8_carry | utf8_too_large | utf8_too_large_1000
+
+#define BOOST_BEAST_UTF8_BYTE_2_HIGH \
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short, \
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short, \
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | \
+        utf8_overlong_3 | utf8_too_large_1000 | utf8_overlong_4, \
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | \
+        utf8_overlong_3 | utf8_too_large, \
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | \
+        utf8_surrogate | utf8_too_large, \
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | \
+        utf8_surrogate | utf8_too_large, \
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short
+
+template<class = void>
+struct utf8_tables
+{
+    static std::uint8_t const byte_1_high[16];
+    static std::uint8_t const byte_1_low[16];
+    static std::uint8_t const byte_2_high[16];
+};
+
+template<class _>
+std::uint8_t const utf8_tables<_>::byte_1_high[16] = {
+    BOOST_BEAST_UTF8_BYTE_1_HIGH };
+
+template<class _>
+std::uint8_t const utf8_tables<_>::byte_1_low[16] = {
+    BOOST_BEAST_UTF8_BYTE_1_LOW };
+
+template<class _>
+std::uint8_t const utf8_tables<_>::byte_2_high[16] = {
+    BOOST_BEAST_UTF8_BYTE_2_HIGH };
+
+#undef BOOST_BEAST_UTF8_BYTE_1_HIGH
+#undef BOOST_BEAST_UTF8_BYTE_1_LOW
+#undef BOOST_BEAST_UTF8_BYTE_2_HIGH
+
+// The largest octets which may end a block without
+// leaving a sequence incomplete, in the last three places
+template<class = void>
+struct utf8_incomplete
+{
+    static std::uint8_t const max[32];
+};
+
+template<class _>
+std::uint8_t const utf8_incomplete<_>::max[32] = {
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255,
+    0xf0 - 1, 0xe0 - 1, 0xc0 - 1 };
+
+// The state of the validation, between blocks
+struct utf8_state_sse42
+{
+    __m128i error;      // the error bits found
+    __m128i prev;       // the previous block
+    __m128i incomplete; // nonzero if the previous block is cut short
+};
+
+struct utf8_state_avx2
+{
+    __m256i error;
+    __m256i prev;
+    __m256i incomplete;
+};
+
+// Look up each octet of `index` in a table of 16 octets
+BOOST_BEAST_TARGET("sse4.2")
+inline
+__m128i
+utf8_lookup(std::uint8_t const* table, __m128i index)
+{
+    return _mm_shuffle_epi8(_mm_loadu_si128(
+        reinterpret_cast<__m128i const*>(table)), index);
+}
+
+BOOST_BEAST_TARGET("avx2")
+inline
+__m256i
+utf8_lookup(std::uint8_t const* table, __m256i index)
+{
+    return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<
+            __m128i const*>(table))), index);
+}
+
+BOOST_BEAST_TARGET("sse4.2")
+inline
+void
+utf8_check_sse42(
+    utf8_state_sse42& st,
+    std::uint8_t const* p)
+{
+    using tables = utf8_tables<void>;
+    auto const input = _mm_loadu_si128(
+        reinterpret_cast<__m128i const*>(p));
+    if(_mm_movemask_epi8(input) == 0)
+    {
+        // ASCII, which must not follow
+        // a code point cut short
+        st.error = _mm_or_si128(st.error, st.incomplete);
+        st.incomplete = _mm_setzero_si128();
+        st.prev = input;
+        return;
+    }
+    auto const lo = _mm_set1_epi8(0x0f);
+    auto const prev1 = _mm_alignr_epi8(input, st.prev, 16 - 1);
+    auto const prev2 = _mm_alignr_epi8(input, st.prev, 16 - 2);
+    auto const prev3 = _mm_alignr_epi8(input, st.prev, 16 - 3);
+    auto const sc = _mm_and_si128(_mm_and_si128(
+        utf8_lookup(tables::byte_1_high,
+            _mm_and_si128(_mm_srli_epi16(prev1, 4), lo)),
+        utf8_lookup(tables::byte_1_low, _mm_and_si128(prev1, lo))),
+        utf8_lookup(tables::byte_2_high,
+            _mm_and_si128(_mm_srli_epi16(input, 4), lo)));
+    auto const must23 = _mm_or_si128(
+        _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xe0 - 0x80))),
+        _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xf0 - 0x80))));
+    st.error = _mm_or_si128(st.error, _mm_xor_si128(
+        _mm_and_si128(must23, _mm_set1_epi8(char(0x80))), sc));
+    st.incomplete = _mm_subs_epu8(input, _mm_loadu_si128(
+        reinterpret_cast<__m128i const*>(
+            utf8_incomplete<void>::max + 16)));
+    st.prev = input;
+}
+
+BOOST_BEAST_TARGET("sse4.2")
+inline
+bool
+utf8_validate_sse42(std::uint8_t const* p, std::size_t n)
+{
+    utf8_state_sse42 st;
+    st.error = _mm_setzero_si128();
+    st.prev = st.error;
+    st.incomplete = st.error;
+    auto const last = p + (n - n % 16);
+    for(; p != last; p += 16)
+        utf8_check_sse42(st, p);
+
+    // The zeros padding the last block
+    // reveal a code point cut short.
+    std::uint8_t tmp[16] = {};
+    if(n % 16)
+        std::memcpy(tmp, p, n % 16);
+    utf8_check_sse42(st, tmp);
+    return _mm_testz_si128(st.error, st.error) != 0;
+}
+
+BOOST_BEAST_TARGET("avx2")
+inline
+void
+utf8_check_avx2(
+    utf8_state_avx2& st,
+    std::uint8_t const* p)
+{
+    using tables = utf8_tables<void>;
+    auto const input = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(p));
+    if(_mm256_movemask_epi8(input) == 0)
+    {
+        st.error = _mm256_or_si256(st.error, st.incomplete);
+        st.incomplete = _mm256_setzero_si256();
+        st.prev = input;
+        return;
+    }
+    auto const lo = _mm256_set1_epi8(0x0f);
+    // The alignment works within each lane, so the high
+    // lane of the previous block precedes the low lane.
+    auto const cross = _mm256_permute2x128_si256(
+        st.prev, input, 0x21);
+    auto const prev1 = _mm256_alignr_epi8(input, cross, 16 - 1);
+    auto const prev2 = _mm256_alignr_epi8(input, cross, 16 - 2);
+    auto const prev3 = _mm256_alignr_epi8(input, cross, 16 - 3);
+    auto const sc = _mm256_and_si256(_mm256_and_si256(
+        utf8_lookup(tables::byte_1_high,
+            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lo)),
+        utf8_lookup(tables::byte_1_low, _mm256_and_si256(prev1, lo))),
+        utf8_lookup(tables::byte_2_high,
+            _mm256_and_si256(_mm256_srli_epi16(input, 4), lo)));
+    auto const must23 = _mm256_or_si256(
+        _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xe0 - 0x80))),
+        _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xf0 - 0x80))));
+    st.error = _mm256_or_si256(st.error, _mm256_xor_si256(
+        _mm256_and_si256(must23, _mm256_set1_epi8(char(0x80))), sc));
+    st.incomplete = _mm256_subs_epu8(input, _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(utf8_incomplete<void>::max)));
+    st.prev = input;
+}
+
+BOOST_BEAST_TARGET("avx2")
+inline
+bool
+utf8_validate_avx2(std::uint8_t const* p, std::size_t n)
+{
+    utf8_state_avx2 st;
+    st.error = _mm256_setzero_si256();
+    st.prev = st.error;
+    st.incomplete = st.error;
+    auto const last = p + (n - n % 32);
+    for(; p != last; p += 32)
+        utf8_check_avx2(st, p);
+    std::uint8_t tmp[32] = {};
+    if(n % 32)
+        std::memcpy(tmp, p, n % 32);
+    utf8_check_avx2(st, tmp);
+    return _mm256_testz_si256(st.error, st.error) != 0;
+}
+
+/*  Returns `true` if [p, p + n) is valid UTF-8, and does not end
+    in the middle of a code point.
+*/
+using utf8_kernel = bool(*)(std::uint8_t const* p, std::size_t n);
+
+// Returns the fastest validator this processor supports, or null
+template<class = void>
+utf8_kernel
+get_utf8_kernel()
+{
+    static utf8_kernel const f =
+        beast::detail::get_cpu_info().avx2 ? &utf8_validate_avx2 :
+        beast::detail::get_cpu_info().sse42 ? &utf8_validate_sse42 :
+        nullptr;
+    return f;
+}
+
+#endif
+
+/*  Returns the number of octets at the end of [first, last)
+    which begin a code point without completing it.
+*/
+inline
+std::size_t
+utf8_partial_suffix(
+    std::uint8_t const* first,
+    std::uint8_t const* last)
+{
+    auto const n = (std::min)(
+        static_cast<std::size_t>(last - first), std::size_t{3});
+    for(std::size_t i = 1; i <= n; ++i)
+    {
+        auto const c = last[-static_cast<std::ptrdiff_t>(i)];
+        if((c & 0xc0) == 0x80)
+            continue;
+        std::size_t const need =
+            c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 1;
+        return need > i ? i : 0;
+    }
+    return 0;
+}
+
 /** A UTF8 validator.
 
     This validator can be used to check if a buffer containing UTF8 text is
@@ -267,6 +586,22 @@ write(std::uint8_t const* in, std::size_t size)
         p_ = cp_;
     }
 
+#if ! BOOST_BEAST_NO_INTRINSICS
+    // Validate the whole code points with the vector
+    // kernel, leaving any partial one to the tail.
+    if(size >= 64)
+    {
+        if(auto const f = get_utf8_kernel())
+        {
+            auto const last = end - utf8_partial_suffix(in, end);
+            if(! f(in, last - in))
+                return false;
+            in = last;
+            goto tail;
+        }
+    }
+#endif
+
     if(size <= sizeof(std::size_t))
         goto slow;
 
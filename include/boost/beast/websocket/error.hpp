@@ -51,6 +51,10 @@ enum class error
     */
     message_too_big,
 
+    /** The WebSocket send queue dropped a message under the disconnect policy
+    */
+    send_queue_overflow,
+
     //
     // Handshake failure errors
     //
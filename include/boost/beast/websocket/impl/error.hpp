@@ -35,6 +35,7 @@ message(int ev) const
     case error::buffer_overflow:        return "The WebSocket operation caused a dynamic buffer overflow";
     case error::partial_deflate_block:  return "The WebSocket stream produced an incomplete deflate block";
     case error::message_too_big:        return "The WebSocket message exceeded the locally configured limit";
+    case error::send_queue_overflow:    return "The WebSocket send queue dropped a message under the disconnect policy";
 
     case error::bad_http_version:       return "The WebSocket handshake was not HTTP/1.1";
     case error::bad_method:             return "The WebSocket handshake method was not GET";
@@ -79,6 +80,7 @@ default_error_condition(int ev) const noexcept
     case error::buffer_overflow:
     case error::partial_deflate_block:
     case error::message_too_big:
+    case error::send_queue_overflow:
         return {ev, *this};
 
     case error::bad_http_version:
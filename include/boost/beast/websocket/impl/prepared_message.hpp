@@ -0,0 +1,152 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_HPP
+#define BOOST_BEAST_WEBSOCKET_IMPL_PREPARED_MESSAGE_HPP
+
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_static_buffer.hpp>
+#include <boost/beast/websocket/detail/frame.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+template<class ConstBufferSequence>
+prepared_message::
+prepared_message(
+    bool text,
+    ConstBufferSequence const& buffers)
+    : impl_(make(text, buffers))
+{
+}
+
+template<class ConstBufferSequence>
+prepared_message::
+prepared_message(
+    bool text,
+    ConstBufferSequence const& buffers,
+    permessage_deflate const& opts)
+{
+    auto impl = make(text, buffers);
+    deflate(*impl, opts);
+    impl_ = std::move(impl);
+}
+
+template<class ConstBufferSequence>
+auto
+prepared_message::
+make(bool text, ConstBufferSequence const& buffers) ->
+    std::shared_ptr<impl_type>
+{
+    static_assert(net::is_const_buffer_sequence<
+        ConstBufferSequence>::value,
+            "ConstBufferSequence requirements not met");
+    auto impl = std::make_shared<impl_type>();
+    impl->text = text;
+    impl->size = net::buffer_size(buffers);
+    frame(impl->frame, text, false, impl->size);
+    auto const n = impl->frame.size();
+    impl->frame.resize(n + impl->size);
+    net::buffer_copy(net::buffer(
+        &impl->frame[n], impl->size), buffers);
+    return impl;
+}
+
+inline
+void
+prepared_message::
+deflate(impl_type& impl, permessage_deflate const& opts)
+{
+    if( opts.server_max_window_bits > 15 ||
+        opts.server_max_window_bits < 9)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "invalid server_max_window_bits"});
+    if( opts.compLevel < 0 ||
+        opts.compLevel > 9)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "invalid compLevel"});
+    if( opts.memLevel < 1 ||
+        opts.memLevel > 9)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "invalid memLevel"});
+
+    // A fresh compressor, so the message refers to
+    // no earlier data and any receiver can inflate it.
+    zlib::deflate_stream zo;
+    zo.reset(
+        opts.compLevel,
+        opts.server_max_window_bits,
+        opts.memLevel,
+        zlib::Strategy::normal);
+    std::string out;
+    out.resize(zo.upper_bound(impl.size) + 16);
+    zlib::z_params zs;
+    zs.next_in = impl.frame.data() +
+        (impl.frame.size() - impl.size);
+    zs.avail_in = impl.size;
+    zs.next_out = &out[0];
+    zs.avail_out = out.size();
+    for(;;)
+    {
+        error_code ec;
+        zo.write(zs, zlib::Flush::sync, ec);
+        if(ec && ec != zlib::error::need_buffers)
+            BOOST_THROW_EXCEPTION(system_error{ec});
+        if(zs.avail_out > 0)
+            break;
+        out.resize(2 * out.size());
+        zs.next_out = &out[zs.total_out];
+        zs.avail_out = out.size() - zs.total_out;
+    }
+    BOOST_ASSERT(zs.avail_in == 0);
+
+    // remove flush marker
+    BOOST_ASSERT(zs.total_out >= 4);
+    auto const n = zs.total_out - 4;
+    frame(impl.deflated, impl.text, true, n);
+    impl.deflated.append(out.data(), n);
+    impl.window_bits = opts.server_max_window_bits;
+}
+
+inline
+void
+prepared_message::
+frame(
+    std::string& s,
+    bool text,
+    bool deflated,
+    std::uint64_t len)
+{
+    detail::frame_header fh;
+    fh.op = text ?
+        detail::opcode::text :
+        detail::opcode::binary;
+    fh.fin = true;
+    fh.mask = false;
+    fh.rsv1 = deflated;
+    fh.rsv2 = false;
+    fh.rsv3 = false;
+    fh.len = len;
+    detail::fh_buffer b;
+    detail::write<flat_static_buffer_base>(b, fh);
+    s.reserve(b.size() + static_cast<std::size_t>(len));
+    s.assign(static_cast<char const*>(
+        b.data().data()), b.size());
+}
+
+} // websocket
+} // beast
+} // boost
+
+#endif
@@ -12,6 +12,7 @@
 
 #include <boost/beast/websocket/teardown.hpp>
 #include <boost/beast/websocket/detail/mask.hpp>
+#include <boost/beast/websocket/detail/payload.hpp>
 #include <boost/beast/core/async_op_base.hpp>
 #include <boost/beast/core/bind_handler.hpp>
 #include <boost/beast/core/buffers_prefix.hpp>
@@ -174,8 +175,12 @@ public:
                     impl.rd_block.lock(this);
                 }
                 // Immediately apply the mask to the portion
-                // of the buffer holding payload data.
-                if(impl.rd_fh.len > 0 && impl.rd_fh.mask)
+                // of the buffer holding payload data. The payload
+                // of an uncompressed message is unmasked later,
+                // as it is copied to the caller's buffers.
+                if(impl.rd_fh.len > 0 && impl.rd_fh.mask && (
+                    detail::is_control(impl.rd_fh.op) ||
+                        impl.rd_deflated()))
                     detail::mask_inplace(buffers_prefix(
                         clamp(impl.rd_fh.len),
                             impl.rd_buf.data()),
@@ -349,12 +354,15 @@ public:
             {
                 if(impl.rd_remain > 0)
                 {
-                    if(impl.rd_buf.size() == 0 && impl.rd_buf.max_size() >
+                    if(impl.rd_buf.size() == 0 && (std::min)(
+                        impl.rd_buf.max_size(), +tcp_frame_size) >
                         (std::min)(clamp(impl.rd_remain),
                             buffer_size(cb_)))
                     {
                         // Fill the read buffer first, otherwise we
                         // get fewer bytes at the cost of one I/O.
+                        // Larger reads go straight to the caller's
+                        // buffer whatever the size of the read buffer.
                         BOOST_ASIO_CORO_YIELD
                         impl.stream.async_read_some(
                             impl.rd_buf.prepare(read_size(
@@ -363,23 +371,22 @@ public:
                         if(! impl.check_ok(ec))
                             goto upcall;
                         impl.rd_buf.commit(bytes_transferred);
-                        if(impl.rd_fh.mask)
-                            detail::mask_inplace(buffers_prefix(clamp(
-                                impl.rd_remain), impl.rd_buf.data()),
-                                    impl.rd_key);
                     }
                     if(impl.rd_buf.size() > 0)
                     {
-                        // Copy from the read buffer.
-                        // The mask was already applied.
-                        bytes_transferred = net::buffer_copy(cb_,
-                            impl.rd_buf.data(), clamp(impl.rd_remain));
-                        auto const mb = buffers_prefix(
-                            bytes_transferred, cb_);
+                        // Copy from the read buffer, applying
+                        // the mask and validating in one pass.
+                        auto const text =
+                            impl.rd_op == detail::opcode::text;
+                        auto const valid = detail::copy_payload(
+                            bytes_transferred, cb_, buffers_prefix(
+                                clamp(impl.rd_remain), impl.rd_buf.data()),
+                            impl.rd_fh.mask ? &impl.rd_key : nullptr,
+                            text ? &impl.rd_utf8 : nullptr);
                         impl.rd_remain -= bytes_transferred;
-                        if(impl.rd_op == detail::opcode::text)
+                        if(text)
                         {
-                            if(! impl.rd_utf8.write(mb) ||
+                            if(! valid ||
                                 (impl.rd_remain == 0 && impl.rd_fh.fin &&
                                     ! impl.rd_utf8.finish()))
                             {
@@ -406,14 +413,16 @@ public:
                         if(! impl.check_ok(ec))
                             goto upcall;
                         BOOST_ASSERT(bytes_transferred > 0);
-                        auto const mb = buffers_prefix(
-                            bytes_transferred, cb_);
+                        auto const text =
+                            impl.rd_op == detail::opcode::text;
+                        auto const valid = detail::unmask_payload(
+                            buffers_prefix(bytes_transferred, cb_),
+                            impl.rd_fh.mask ? &impl.rd_key : nullptr,
+                            text ? &impl.rd_utf8 : nullptr);
                         impl.rd_remain -= bytes_transferred;
-                        if(impl.rd_fh.mask)
-                            detail::mask_inplace(mb, impl.rd_key);
-                        if(impl.rd_op == detail::opcode::text)
+                        if(text)
                         {
-                            if(! impl.rd_utf8.write(mb) ||
+                            if(! valid ||
                                 (impl.rd_remain == 0 && impl.rd_fh.fin &&
                                     ! impl.rd_utf8.finish()))
                             {
@@ -921,8 +930,12 @@ loop:
             impl_->rd_buf.commit(bytes_transferred);
         }
         // Immediately apply the mask to the portion
-        // of the buffer holding payload data.
-        if(impl_->rd_fh.len > 0 && impl_->rd_fh.mask)
+        // of the buffer holding payload data. The payload
+        // of an uncompressed message is unmasked later,
+        // as it is copied to the caller's buffers.
+        if(impl_->rd_fh.len > 0 && impl_->rd_fh.mask && (
+            detail::is_control(impl_->rd_fh.op) ||
+                impl_->rd_deflated()))
             detail::mask_inplace(buffers_prefix(
                 clamp(impl_->rd_fh.len), impl_->rd_buf.data()),
                     impl_->rd_key);
@@ -1012,35 +1025,37 @@ loop:
     {
         if(impl_->rd_remain > 0)
         {
-            if(impl_->rd_buf.size() == 0 && impl_->rd_buf.max_size() >
+            if(impl_->rd_buf.size() == 0 && (std::min)(
+                impl_->rd_buf.max_size(), +tcp_frame_size) >
                 (std::min)(clamp(impl_->rd_remain),
                     buffer_size(buffers)))
             {
                 // Fill the read buffer first, otherwise we
                 // get fewer bytes at the cost of one I/O.
+                // Larger reads go straight to the caller's
+                // buffer whatever the size of the read buffer.
                 impl_->rd_buf.commit(impl_->stream.read_some(
                     impl_->rd_buf.prepare(read_size(impl_->rd_buf,
                         impl_->rd_buf.max_size())), ec));
                 if(! impl_->check_ok(ec))
                     return bytes_written;
-                if(impl_->rd_fh.mask)
-                    detail::mask_inplace(
-                        buffers_prefix(clamp(impl_->rd_remain),
-                            impl_->rd_buf.data()), impl_->rd_key);
             }
             if(impl_->rd_buf.size() > 0)
             {
-                // Copy from the read buffer.
-                // The mask was already applied.
-                auto const bytes_transferred = net::buffer_copy(
-                    buffers, impl_->rd_buf.data(),
-                        clamp(impl_->rd_remain));
-                auto const mb = buffers_prefix(
-                    bytes_transferred, buffers);
+                // Copy from the read buffer, applying
+                // the mask and validating in one pass.
+                auto const text =
+                    impl_->rd_op == detail::opcode::text;
+                std::size_t bytes_transferred;
+                auto const valid = detail::copy_payload(
+                    bytes_transferred, buffers, buffers_prefix(
+                        clamp(impl_->rd_remain), impl_->rd_buf.data()),
+                    impl_->rd_fh.mask ? &impl_->rd_key : nullptr,
+                    text ? &impl_->rd_utf8 : nullptr);
                 impl_->rd_remain -= bytes_transferred;
-                if(impl_->rd_op == detail::opcode::text)
+                if(text)
                 {
-                    if(! impl_->rd_utf8.write(mb) ||
+                    if(! valid ||
                         (impl_->rd_remain == 0 && impl_->rd_fh.fin &&
                             ! impl_->rd_utf8.finish()))
                     {
@@ -1067,14 +1082,16 @@ loop:
                 if(! impl_->check_ok(ec))
                     return bytes_written;
                 BOOST_ASSERT(bytes_transferred > 0);
-                auto const mb = buffers_prefix(
-                    bytes_transferred, buffers);
+                auto const text =
+                    impl_->rd_op == detail::opcode::text;
+                auto const valid = detail::unmask_payload(
+                    buffers_prefix(bytes_transferred, buffers),
+                    impl_->rd_fh.mask ? &impl_->rd_key : nullptr,
+                    text ? &impl_->rd_utf8 : nullptr);
                 impl_->rd_remain -= bytes_transferred;
-                if(impl_->rd_fh.mask)
-                    detail::mask_inplace(mb, impl_->rd_key);
-                if(impl_->rd_op == detail::opcode::text)
+                if(text)
                 {
-                    if(! impl_->rd_utf8.write(mb) ||
+                    if(! valid ||
                         (impl_->rd_remain == 0 && impl_->rd_fh.fin &&
                             ! impl_->rd_utf8.finish()))
                     {
@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_IMPL_SEND_QUEUE_HPP
+#define BOOST_BEAST_WEBSOCKET_IMPL_SEND_QUEUE_HPP
+
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
+#include <stdexcept>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+inline
+send_queue::
+send_queue(
+    std::size_t max_messages,
+    std::size_t max_bytes,
+    policy p)
+    : max_bytes_(max_bytes)
+    , policy_(p)
+{
+    if(max_messages == 0)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "invalid max_messages"});
+    ring_.resize(max_messages);
+    bufs_.reserve((std::min)(max_messages,
+        static_cast<std::size_t>(max_batch)));
+}
+
+inline
+bool
+send_queue::
+push(prepared_message const& msg)
+{
+    auto const n = msg.size();
+    if(overflowed_)
+    {
+        ++dropped_;
+        return false;
+    }
+    if(! fits(n))
+    {
+        switch(policy_)
+        {
+        case policy::drop_oldest:
+            while(size_ > in_flight_ && ! fits(n))
+                drop_waiting();
+            if(fits(n))
+                break;
+            ++dropped_;
+            return false;
+
+        case policy::drop_newest:
+            ++dropped_;
+            return false;
+
+        case policy::disconnect:
+            overflowed_ = true;
+            ++dropped_;
+            return false;
+        }
+    }
+    ring_[index(size_)].emplace(msg);
+    ++size_;
+    bytes_ += n;
+    if(high_water_ < size_)
+        high_water_ = size_;
+    return true;
+}
+
+// Remove the oldest message which is not being sent
+inline
+void
+send_queue::
+drop_waiting()
+{
+    BOOST_ASSERT(size_ > in_flight_);
+    bytes_ -= ring_[index(in_flight_)]->size();
+
+    // Messages being sent move up one slot. Their
+    // buffers refer to shared storage, not the slots.
+    for(auto i = in_flight_; i > 0; --i)
+        ring_[index(i)] = std::move(ring_[index(i - 1)]);
+    ring_[head_].reset();
+    head_ = index(1);
+    --size_;
+    ++dropped_;
+}
+
+// Choose the messages for the next write and return their
+// payload size. `select` returns the buffer for one message.
+template<class Select>
+std::size_t
+send_queue::
+prepare(Select const& select)
+{
+    BOOST_ASSERT(busy_);
+    BOOST_ASSERT(in_flight_ == 0);
+    bufs_.clear();
+    std::size_t n = 0;
+    std::size_t wire = 0;
+    auto const last = (std::min)(size_,
+        static_cast<std::size_t>(max_batch));
+    for(std::size_t i = 0; i < last; ++i)
+    {
+        auto const& msg = *ring_[index(i)];
+        net::const_buffer const b = select(msg);
+        if(i > 0 && b.size() > coalesce_limit_ - wire)
+            break;
+        bufs_.push_back(b);
+        wire += b.size();
+        n += msg.size();
+        ++in_flight_;
+        if(wire > coalesce_limit_)
+            break;
+    }
+    return n;
+}
+
+inline
+void
+send_queue::
+begin_write() noexcept
+{
+    BOOST_ASSERT(! busy_);
+    busy_ = true;
+}
+
+inline
+void
+send_queue::
+end_write(bool sent)
+{
+    BOOST_ASSERT(busy_);
+    busy_ = false;
+    if(in_flight_ == 0)
+        return;
+    if(sent)
+    {
+        sent_ += in_flight_;
+        ++writes_;
+        for(; in_flight_ > 0; --in_flight_)
+        {
+            bytes_ -= ring_[head_]->size();
+            ring_[head_].reset();
+            head_ = index(1);
+            --size_;
+        }
+    }
+    in_flight_ = 0;
+    bufs_.clear();
+}
+
+} // websocket
+} // beast
+} // boost
+
+#endif
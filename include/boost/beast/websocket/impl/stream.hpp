@@ -232,6 +232,29 @@ secure_prng(bool value)
     this->secure_prng_ = value;
 }
 
+template<class NextLayer, bool deflateSupported>
+void
+stream<NextLayer, deflateSupported>::
+read_buffer_size(std::size_t amount)
+{
+    if(amount < max_control_frame_size)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{
+            "read buffer size underflow"});
+    BOOST_ASSERT(impl_->rd_buf.size() <= amount);
+    impl_->rd_buf.max_size(amount);
+    if(impl_->rd_buf.capacity() > amount)
+        impl_->rd_buf.shrink_to_fit();
+    impl_->rd_buf.reserve(amount);
+}
+
+template<class NextLayer, bool deflateSupported>
+std::size_t
+stream<NextLayer, deflateSupported>::
+read_buffer_size() const
+{
+    return impl_->rd_buf.max_size();
+}
+
 template<class NextLayer, bool deflateSupported>
 void
 stream<NextLayer, deflateSupported>::
@@ -10,7 +10,7 @@
 #ifndef BOOST_BEAST_WEBSOCKET_IMPL_STREAM_IMPL_HPP
 #define BOOST_BEAST_WEBSOCKET_IMPL_STREAM_IMPL_HPP
 
-#include <boost/beast/core/static_buffer.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/saved_handler.hpp>
 #include <boost/beast/websocket/detail/frame.hpp>
 #include <boost/beast/websocket/detail/pmd_extension.hpp>
@@ -47,8 +47,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
     detail::prepared_key    rd_key;         // current stateful mask key
     detail::frame_buffer    rd_fb;          // to write control frames (during reads)
     detail::utf8_checker    rd_utf8;        // to validate utf8
-    static_buffer<
-        +tcp_frame_size>    rd_buf;         // buffer for reads
+    flat_buffer             rd_buf          /* buffer for reads */ {+tcp_frame_size};
     detail::opcode          rd_op           /* current message binary or text */ = detail::opcode::text;
     bool                    rd_cont         /* `true` if the next frame is a continuation */ = false;
     bool                    rd_done         /* set when a message is done */ = true;
@@ -62,7 +61,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
     bool                    wr_close        /* did we write a close frame? */ = false;
     bool                    wr_cont         /* next write is a continuation */ = false;
     bool                    wr_frag         /* autofrag the current message */ = false;
-    bool                    wr_frag_opt     /* autofrag option setting */ = true;
+    bool                    wr_frag_opt     /* autofrag option setting */ = false;
     bool                    wr_compress     /* compress current message */ = false;
     detail::opcode          wr_opcode       /* message type */ = detail::opcode::text;
     std::unique_ptr<
@@ -82,6 +81,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
     impl_type(Args&&... args)
         : stream(std::forward<Args>(args)...)
     {
+        rd_buf.reserve(tcp_frame_size);
     }
 
     void
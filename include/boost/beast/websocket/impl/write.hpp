@@ -19,6 +19,7 @@
 #include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/core/type_traits.hpp>
+#include <boost/beast/core/detail/buffers_ref.hpp>
 #include <boost/beast/core/detail/clamp.hpp>
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/detail/get_executor_type.hpp>
@@ -26,6 +27,7 @@
 #include <boost/asio/coroutine.hpp>
 #include <boost/assert.hpp>
 #include <boost/config.hpp>
+#include <boost/core/ignore_unused.hpp>
 #include <boost/throw_exception.hpp>
 #include <algorithm>
 #include <memory>
@@ -89,7 +91,6 @@ operator()(
 {
     using beast::detail::clamp;
     using net::buffer;
-    using net::buffer_copy;
     using net::buffer_size;
     using net::mutable_buffer;
     enum
@@ -266,10 +267,8 @@ operator()(
             detail::write<flat_static_buffer_base>(
                 ws_.impl_->wr_fb, fh_);
             n = clamp(remain_, ws_.impl_->wr_buf_size);
-            buffer_copy(buffer(
-                ws_.impl_->wr_buf.get(), n), cb_);
-            detail::mask_inplace(buffer(
-                ws_.impl_->wr_buf.get(), n), key_);
+            detail::mask_copy(buffer(
+                ws_.impl_->wr_buf.get(), n), cb_, key_);
             remain_ -= n;
             ws_.impl_->wr_cont = ! fin_;
             // Send frame header and partial payload
@@ -286,10 +285,8 @@ operator()(
             {
                 cb_.consume(ws_.impl_->wr_buf_size);
                 n = clamp(remain_, ws_.impl_->wr_buf_size);
-                buffer_copy(buffer(
-                    ws_.impl_->wr_buf.get(), n), cb_);
-                detail::mask_inplace(buffer(
-                    ws_.impl_->wr_buf.get(), n), key_);
+                detail::mask_copy(buffer(
+                    ws_.impl_->wr_buf.get(), n), cb_, key_);
                 remain_ -= n;
                 // Send partial payload
                 BOOST_ASIO_CORO_YIELD
@@ -315,10 +312,8 @@ operator()(
                 fh_.key = ws_.create_mask();
                 fh_.fin = fin_ ? remain_ == 0 : false;
                 detail::prepare_key(key_, fh_.key);
-                buffer_copy(buffer(
-                    ws_.impl_->wr_buf.get(), n), cb_);
-                detail::mask_inplace(buffer(
-                    ws_.impl_->wr_buf.get(), n), key_);
+                detail::mask_copy(buffer(
+                    ws_.impl_->wr_buf.get(), n), cb_, key_);
                 ws_.impl_->wr_fb.clear();
                 detail::write<flat_static_buffer_base>(
                     ws_.impl_->wr_fb, fh_);
@@ -474,7 +469,6 @@ write_some(bool fin,
             "ConstBufferSequence requirements not met");
     using beast::detail::clamp;
     using net::buffer;
-    using net::buffer_copy;
     using net::buffer_size;
     std::size_t bytes_transferred = 0;
     ec = {};
@@ -607,10 +601,9 @@ write_some(bool fin,
         {
             auto const n = clamp(remain, impl_->wr_buf_size);
             auto const b = buffer(impl_->wr_buf.get(), n);
-            buffer_copy(b, cb);
+            detail::mask_copy(b, cb, key);
             cb.consume(n);
             remain -= n;
-            detail::mask_inplace(b, key);
             impl_->wr_cont = ! fin;
             net::write(impl_->stream,
                 buffers_cat(fh_buf.data(), b), ec);
@@ -622,10 +615,9 @@ write_some(bool fin,
         {
             auto const n = clamp(remain, impl_->wr_buf_size);
             auto const b = buffer(impl_->wr_buf.get(), n);
-            buffer_copy(b, cb);
+            detail::mask_copy(b, cb, key);
             cb.consume(n);
             remain -= n;
-            detail::mask_inplace(b, key);
             net::write(impl_->stream, b, ec);
             if(! impl_->check_ok(ec))
                 return bytes_transferred;
@@ -645,8 +637,7 @@ write_some(bool fin,
             detail::prepare_key(key, fh.key);
             auto const n = clamp(remain, impl_->wr_buf_size);
             auto const b = buffer(impl_->wr_buf.get(), n);
-            buffer_copy(b, cb);
-            detail::mask_inplace(b, key);
+            detail::mask_copy(b, cb, key);
             fh.len = n;
             remain -= n;
             fh.fin = fin ? remain == 0 : false;
@@ -746,6 +737,351 @@ async_write(
     return init.result.get();
 }
 
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported>
+template<class Handler>
+class stream<NextLayer, deflateSupported>::write_prepared_op
+    : public beast::async_op_base<
+        Handler, beast::detail::get_executor_type<stream>>
+    , public net::coroutine
+{
+    stream& ws_;
+    prepared_message msg_;
+    bool cont_ = false;
+
+public:
+    static constexpr int id = 5; // for soft_mutex
+
+    template<class Handler_>
+    write_prepared_op(
+        Handler_&& h,
+        stream<NextLayer, deflateSupported>& ws,
+        prepared_message const& msg)
+        : beast::async_op_base<Handler,
+            beast::detail::get_executor_type<stream>>(
+                std::forward<Handler_>(h), ws.get_executor())
+        , ws_(ws)
+        , msg_(msg)
+    {
+    }
+
+    void
+    operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0,
+        bool cont = true)
+    {
+        boost::ignore_unused(bytes_transferred);
+        cont_ = cont;
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            // Maybe suspend
+            if(ws_.impl_->wr_block.try_lock(this))
+            {
+                // Make sure the stream is open
+                if(! ws_.impl_->check_open(ec))
+                    goto upcall;
+            }
+            else
+            {
+                // Suspend
+                BOOST_ASIO_CORO_YIELD
+                ws_.impl_->paused_wr.emplace(std::move(*this));
+
+                // Acquire the write block
+                ws_.impl_->wr_block.lock(this);
+
+                // Resume
+                BOOST_ASIO_CORO_YIELD
+                net::post(
+                    ws_.get_executor(), std::move(*this));
+                BOOST_ASSERT(ws_.impl_->wr_block.is_locked(this));
+
+                // Make sure the stream is open
+                if(! ws_.impl_->check_open(ec))
+                    goto upcall;
+            }
+            if(ws_.impl_->role != role_type::server)
+            {
+                ec = net::error::operation_not_supported;
+                goto upcall;
+            }
+            BOOST_ASSERT(! ws_.impl_->wr_cont);
+
+            // Send frame
+            BOOST_ASIO_CORO_YIELD
+            net::async_write(ws_.impl_->stream,
+                msg_.data(ws_.impl_->begin_prepared(
+                    msg_.window_bits())), std::move(*this));
+            ws_.impl_->check_ok(ec);
+
+        upcall:
+            ws_.impl_->wr_block.unlock(this);
+            ws_.impl_->paused_close.maybe_invoke() ||
+                ws_.impl_->paused_rd.maybe_invoke() ||
+                ws_.impl_->paused_ping.maybe_invoke();
+            if(! cont_)
+            {
+                BOOST_ASIO_CORO_YIELD
+                net::post(
+                    ws_.get_executor(),
+                    beast::bind_front_handler(
+                        std::move(*this), ec, 0));
+            }
+            this->invoke(ec, ec ? 0 : msg_.size());
+        }
+    }
+};
+
+template<class NextLayer, bool deflateSupported>
+std::size_t
+stream<NextLayer, deflateSupported>::
+write_prepared(prepared_message const& msg)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream requirements not met");
+    error_code ec;
+    auto const bytes_transferred =
+        write_prepared(msg, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return bytes_transferred;
+}
+
+template<class NextLayer, bool deflateSupported>
+std::size_t
+stream<NextLayer, deflateSupported>::
+write_prepared(prepared_message const& msg, error_code& ec)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream requirements not met");
+    ec = {};
+    // Make sure the stream is open
+    if(! impl_->check_open(ec))
+        return 0;
+    if(impl_->role != role_type::server)
+    {
+        ec = net::error::operation_not_supported;
+        return 0;
+    }
+    BOOST_ASSERT(! impl_->wr_cont);
+    net::write(impl_->stream, msg.data(
+        impl_->begin_prepared(msg.window_bits())), ec);
+    if(! impl_->check_ok(ec))
+        return 0;
+    return msg.size();
+}
+
+template<class NextLayer, bool deflateSupported>
+template<class WriteHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    WriteHandler, void(error_code, std::size_t))
+stream<NextLayer, deflateSupported>::
+async_write_prepared(
+    prepared_message const& msg, WriteHandler&& handler)
+{
+    static_assert(is_async_stream<next_layer_type>::value,
+        "AsyncStream requirements not met");
+    BOOST_BEAST_HANDLER_INIT(
+        WriteHandler, void(error_code, std::size_t));
+    write_prepared_op<BOOST_ASIO_HANDLER_TYPE(
+        WriteHandler, void(error_code, std::size_t))>{
+            std::move(init.completion_handler), *this, msg}(
+                {}, 0, false);
+    return init.result.get();
+}
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer, bool deflateSupported>
+template<class Handler>
+class stream<NextLayer, deflateSupported>::write_queue_op
+    : public beast::async_op_base<
+        Handler, beast::detail::get_executor_type<stream>>
+    , public net::coroutine
+{
+    stream& ws_;
+    send_queue& q_;
+    std::size_t n_ = 0;
+    bool cont_ = false;
+
+public:
+    static constexpr int id = 6; // for soft_mutex
+
+    template<class Handler_>
+    write_queue_op(
+        Handler_&& h,
+        stream<NextLayer, deflateSupported>& ws,
+        send_queue& q)
+        : beast::async_op_base<Handler,
+            beast::detail::get_executor_type<stream>>(
+                std::forward<Handler_>(h), ws.get_executor())
+        , ws_(ws)
+        , q_(q)
+    {
+    }
+
+    void
+    operator()(
+        error_code ec = {},
+        std::size_t bytes_transferred = 0,
+        bool cont = true)
+    {
+        boost::ignore_unused(bytes_transferred);
+        cont_ = cont;
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            // Maybe suspend
+            if(ws_.impl_->wr_block.try_lock(this))
+            {
+                // Make sure the stream is open
+                if(! ws_.impl_->check_open(ec))
+                    goto upcall;
+            }
+            else
+            {
+                // Suspend
+                BOOST_ASIO_CORO_YIELD
+                ws_.impl_->paused_wr.emplace(std::move(*this));
+
+                // Acquire the write block
+                ws_.impl_->wr_block.lock(this);
+
+                // Resume
+                BOOST_ASIO_CORO_YIELD
+                net::post(
+                    ws_.get_executor(), std::move(*this));
+                BOOST_ASSERT(ws_.impl_->wr_block.is_locked(this));
+
+                // Make sure the stream is open
+                if(! ws_.impl_->check_open(ec))
+                    goto upcall;
+            }
+            if(ws_.impl_->role != role_type::server)
+            {
+                ec = net::error::operation_not_supported;
+                goto upcall;
+            }
+            if(q_.overflowed())
+            {
+                ec = error::send_queue_overflow;
+                goto upcall;
+            }
+            BOOST_ASSERT(! ws_.impl_->wr_cont);
+
+            // Choose the messages now, to include
+            // those pushed while we were suspended.
+            n_ = q_.prepare(
+                [this](prepared_message const& msg)
+                {
+                    return msg.data(ws_.impl_->begin_prepared(
+                        msg.window_bits()));
+                });
+            if(q_.in_flight_ == 0)
+                goto upcall;
+
+            // Send frames
+            BOOST_ASIO_CORO_YIELD
+            net::async_write(ws_.impl_->stream,
+                beast::detail::make_buffers_ref(q_.bufs_),
+                    std::move(*this));
+            ws_.impl_->check_ok(ec);
+
+        upcall:
+            q_.end_write(! ec);
+            ws_.impl_->wr_block.unlock(this);
+            ws_.impl_->paused_close.maybe_invoke() ||
+                ws_.impl_->paused_rd.maybe_invoke() ||
+                ws_.impl_->paused_ping.maybe_invoke();
+            if(! cont_)
+            {
+                BOOST_ASIO_CORO_YIELD
+                net::post(
+                    ws_.get_executor(),
+                    beast::bind_front_handler(
+                        std::move(*this), ec, 0));
+            }
+            this->invoke(ec, ec ? 0 : n_);
+        }
+    }
+};
+
+template<class NextLayer, bool deflateSupported>
+std::size_t
+stream<NextLayer, deflateSupported>::
+write_prepared(send_queue& queue)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream requirements not met");
+    error_code ec;
+    auto const bytes_transferred =
+        write_prepared(queue, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return bytes_transferred;
+}
+
+template<class NextLayer, bool deflateSupported>
+std::size_t
+stream<NextLayer, deflateSupported>::
+write_prepared(send_queue& queue, error_code& ec)
+{
+    static_assert(is_sync_stream<next_layer_type>::value,
+        "SyncStream requirements not met");
+    ec = {};
+    // Make sure the stream is open
+    if(! impl_->check_open(ec))
+        return 0;
+    if(impl_->role != role_type::server)
+    {
+        ec = net::error::operation_not_supported;
+        return 0;
+    }
+    if(queue.overflowed())
+    {
+        ec = error::send_queue_overflow;
+        return 0;
+    }
+    BOOST_ASSERT(! impl_->wr_cont);
+    queue.begin_write();
+    auto const n = queue.prepare(
+        [this](prepared_message const& msg)
+        {
+            return msg.data(impl_->begin_prepared(
+                msg.window_bits()));
+        });
+    if(queue.in_flight_ > 0)
+    {
+        net::write(impl_->stream, queue.bufs_, ec);
+        impl_->check_ok(ec);
+    }
+    queue.end_write(! ec);
+    if(ec)
+        return 0;
+    return n;
+}
+
+template<class NextLayer, bool deflateSupported>
+template<class WriteHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    WriteHandler, void(error_code, std::size_t))
+stream<NextLayer, deflateSupported>::
+async_write_prepared(
+    send_queue& queue, WriteHandler&& handler)
+{
+    static_assert(is_async_stream<next_layer_type>::value,
+        "AsyncStream requirements not met");
+    BOOST_BEAST_HANDLER_INIT(
+        WriteHandler, void(error_code, std::size_t));
+    queue.begin_write();
+    write_queue_op<BOOST_ASIO_HANDLER_TYPE(
+        WriteHandler, void(error_code, std::size_t))>{
+            std::move(init.completion_handler), *this, queue}(
+                {}, 0, false);
+    return init.result.get();
+}
+
 } // websocket
 } // beast
 } // boost
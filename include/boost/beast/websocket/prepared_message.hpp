@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_PREPARED_MESSAGE_HPP
+#define BOOST_BEAST_WEBSOCKET_PREPARED_MESSAGE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/websocket/option.hpp>
+#include <boost/beast/websocket/stream_fwd.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+/** A message which is framed once and sent on many streams.
+
+    Objects of this type hold a complete, unmasked WebSocket
+    message including the frame header. When constructed with
+    @ref permessage_deflate options, they also hold the message
+    compressed without reference to earlier messages, so it may
+    be sent on any stream which negotiated the permessage-deflate
+    extension with a window at least as large.
+
+    Messages are sent with @ref stream::write_prepared or
+    @ref stream::async_write_prepared. Copies of the object share
+    the same immutable storage, so a message may be sent to many
+    sessions without copying or compressing it again.
+
+    Because frames sent in the client role must be masked with a
+    different key each time, prepared messages may only be sent
+    by streams in the server role.
+
+    @par Example
+    Sending the same message to several sessions.
+    @code
+        permessage_deflate pmd;
+        pmd.server_enable = true;
+        prepared_message msg(true, net::buffer(text), pmd);
+        for(auto& ws : sessions)
+            ws.async_write_prepared(msg, handler);
+    @endcode
+*/
+class prepared_message
+{
+    struct impl_type
+    {
+        std::string frame;          // header and payload
+        std::string deflated;       // header and compressed payload
+        std::size_t size = 0;       // payload size
+        int window_bits = 0;        // for `deflated`, or zero
+        bool text = false;
+    };
+
+    std::shared_ptr<impl_type const> impl_;
+
+    template<class NextLayer, bool deflateSupported>
+    friend class stream;
+
+    template<class ConstBufferSequence>
+    static
+    std::shared_ptr<impl_type>
+    make(bool text, ConstBufferSequence const& buffers);
+
+    static
+    void
+    deflate(impl_type& impl, permessage_deflate const& opts);
+
+    static
+    void
+    frame(
+        std::string& s,
+        bool text,
+        bool deflated,
+        std::uint64_t len);
+
+    net::const_buffer
+    data(bool deflated) const
+    {
+        auto const& s = deflated ?
+            impl_->deflated : impl_->frame;
+        return {s.data(), s.size()};
+    }
+
+    int
+    window_bits() const
+    {
+        return impl_->window_bits;
+    }
+
+public:
+    /** Constructor
+
+        The payload is framed as a single uncompressed message.
+
+        @param text `true` if the message is text, or
+        `false` if it is binary.
+
+        @param buffers The message payload, which is copied.
+    */
+    template<class ConstBufferSequence>
+    prepared_message(
+        bool text,
+        ConstBufferSequence const& buffers);
+
+    /** Constructor
+
+        The payload is framed as a single uncompressed message, and
+        also compressed as a single message using the server window
+        bits, compression level and memory level of `opts`. The
+        compressed form is sent on streams which negotiated the
+        permessage-deflate extension with a server window at least
+        as large.
+
+        @param text `true` if the message is text, or
+        `false` if it is binary.
+
+        @param buffers The message payload, which is copied.
+
+        @param opts The compression settings to use.
+
+        @throws std::invalid_argument if the settings are invalid.
+    */
+    template<class ConstBufferSequence>
+    prepared_message(
+        bool text,
+        ConstBufferSequence const& buffers,
+        permessage_deflate const& opts);
+
+    /// Returns `true` if the message is text
+    bool
+    text() const
+    {
+        return impl_->text;
+    }
+
+    /// Returns the size of the message payload, before compression
+    std::size_t
+    size() const
+    {
+        return impl_->size;
+    }
+
+    /// Returns `true` if the message has a compressed form
+    bool
+    deflated() const
+    {
+        return impl_->window_bits != 0;
+    }
+};
+
+} // websocket
+} // beast
+} // boost
+
+#include <boost/beast/websocket/impl/prepared_message.hpp>
+
+#endif
@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_WEBSOCKET_SEND_QUEUE_HPP
+#define BOOST_BEAST_WEBSOCKET_SEND_QUEUE_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/websocket/prepared_message.hpp>
+#include <boost/beast/websocket/stream_fwd.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+/** A bounded queue of outgoing messages for one stream.
+
+    This container holds @ref prepared_message objects waiting to
+    be sent on a stream in the server role. The queue is a ring
+    buffer whose storage is allocated once, limited both in the
+    number of messages and in the total size of their payloads.
+    When a message does not fit, the @ref policy chosen at
+    construction decides what happens to it.
+
+    Messages are sent with @ref stream::write_prepared or
+    @ref stream::async_write_prepared. Each call sends the messages
+    at the front of the queue with a single gather write of their
+    consecutive frames, as long as they fit in the
+    @ref coalesce_limit, and removes them from the queue once sent.
+    Messages which are being sent are never dropped.
+
+    The queue also keeps counters which describe its depth and the
+    messages dropped, for monitoring slow peers.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe. The application must also ensure
+    that the queue is used from the same implicit or explicit strand
+    as the stream it is sent on.
+
+    @par Example
+    Queueing a message and sending the queue on a session's stream.
+    @code
+        void send(prepared_message const& msg)
+        {
+            if(! queue_.push(msg) && queue_.overflowed())
+                return ws_.next_layer().close();
+            if(! queue_.busy())
+                do_write();
+        }
+
+        void do_write()
+        {
+            ws_.async_write_prepared(queue_,
+                [this](error_code ec, std::size_t)
+                {
+                    if(! ec && ! queue_.empty())
+                        do_write();
+                });
+        }
+    @endcode
+*/
+class send_queue
+{
+public:
+    /// What to do with a message which does not fit in the queue
+    enum class policy
+    {
+        /** Drop the oldest messages which are not being sent.
+
+            If the message still does not fit, it is dropped.
+        */
+        drop_oldest,
+
+        /// Drop the message being pushed
+        drop_newest,
+
+        /** Drop the message and fail the stream.
+
+            The queue is marked as overflowed, later pushes are
+            dropped, and sending the queue fails with
+            @ref error::send_queue_overflow.
+        */
+        disconnect
+    };
+
+    /** Constructor
+
+        @param max_messages The largest number of messages held,
+        including those being sent. This must be greater than zero.
+
+        @param max_bytes The largest total payload size of the messages
+        held, including those being sent. A message is always accepted
+        by an empty queue, even if it is larger.
+
+        @param p The policy for messages which do not fit.
+    */
+    explicit
+    send_queue(
+        std::size_t max_messages = 1024,
+        std::size_t max_bytes = 16 * 1024 * 1024,
+        policy p = policy::drop_oldest);
+
+    send_queue(send_queue const&) = delete;
+    send_queue& operator=(send_queue const&) = delete;
+
+    /** Append a message to the queue.
+
+        If the message does not fit, the queue's @ref policy is
+        applied.
+
+        @return `true` if the message was added to the queue.
+    */
+    bool
+    push(prepared_message const& msg);
+
+    /// Returns `true` if no messages are held
+    bool
+    empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    /// Returns the number of messages held, including those being sent
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    /// Returns the total payload size of the messages held
+    std::size_t
+    bytes() const noexcept
+    {
+        return bytes_;
+    }
+
+    /// Returns `true` if the queue is being sent on a stream
+    bool
+    busy() const noexcept
+    {
+        return busy_;
+    }
+
+    /// Returns `true` if a message was dropped under policy::disconnect
+    bool
+    overflowed() const noexcept
+    {
+        return overflowed_;
+    }
+
+    /// Returns the largest number of messages held at once
+    std::size_t
+    high_water() const noexcept
+    {
+        return high_water_;
+    }
+
+    /// Returns the number of messages dropped
+    std::size_t
+    dropped() const noexcept
+    {
+        return dropped_;
+    }
+
+    /// Returns the number of messages sent
+    std::size_t
+    sent() const noexcept
+    {
+        return sent_;
+    }
+
+    /// Returns the number of writes used to send them
+    std::size_t
+    writes() const noexcept
+    {
+        return writes_;
+    }
+
+    /** Set the largest number of bytes sent by one write.
+
+        Consecutive messages are sent together while their frames
+        fit in this many bytes. The first message of a write is
+        always sent, regardless of its size. A limit of zero sends
+        one message per write.
+
+        The default is 16384.
+    */
+    void
+    coalesce_limit(std::size_t bytes) noexcept
+    {
+        coalesce_limit_ = bytes;
+    }
+
+    /// Returns the largest number of bytes sent by one write
+    std::size_t
+    coalesce_limit() const noexcept
+    {
+        return coalesce_limit_;
+    }
+
+private:
+    template<class NextLayer, bool deflateSupported>
+    friend class stream;
+
+    // The most messages sent by one write
+    static std::size_t constexpr max_batch = 64;
+
+    std::vector<boost::optional<prepared_message>> ring_;
+    std::vector<net::const_buffer> bufs_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    std::size_t bytes_ = 0;
+    std::size_t in_flight_ = 0;
+    std::size_t const max_bytes_;
+    std::size_t coalesce_limit_ = 16384;
+    std::size_t high_water_ = 0;
+    std::size_t dropped_ = 0;
+    std::size_t sent_ = 0;
+    std::size_t writes_ = 0;
+    policy const policy_;
+    bool busy_ = false;
+    bool overflowed_ = false;
+
+    std::size_t
+    index(std::size_t i) const noexcept
+    {
+        return (head_ + i) % ring_.size();
+    }
+
+    bool
+    fits(std::size_t n) const noexcept
+    {
+        return size_ == 0 || (
+            size_ < ring_.size() &&
+            n <= max_bytes_ - (std::min)(bytes_, max_bytes_));
+    }
+
+    void
+    drop_waiting();
+
+    template<class Select>
+    std::size_t
+    prepare(Select const& select);
+
+    void
+    begin_write() noexcept;
+
+    void
+    end_write(bool sent);
+};
+
+} // websocket
+} // beast
+} // boost
+
+#include <boost/beast/websocket/impl/send_queue.hpp>
+
+#endif
@@ -13,8 +13,10 @@
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/websocket/error.hpp>
 #include <boost/beast/websocket/option.hpp>
+#include <boost/beast/websocket/prepared_message.hpp>
 #include <boost/beast/websocket/role.hpp>
 #include <boost/beast/websocket/rfc6455.hpp>
+#include <boost/beast/websocket/send_queue.hpp>
 #include <boost/beast/websocket/stream_fwd.hpp>
 #include <boost/beast/websocket/detail/pmd_extension.hpp>
 #include <boost/beast/websocket/detail/stream_base.hpp>
@@ -359,9 +361,13 @@ public:
 
         When the automatic fragmentation size is turned on, outgoing
         message payloads are broken up into multiple frames no larger
-        than the write buffer size.
+        than the write buffer size. This allows control frames to be
+        sent in between the frames of a large message.
 
-        The default setting is to fragment messages.
+        The default setting is to not fragment messages. Each message
+        written by a stream in the server role without compression is
+        then sent as a single frame, by writing the frame header and
+        the caller's buffers together.
 
         @param value A `bool` indicating if auto fragmentation should be on.
 
@@ -510,12 +516,50 @@ public:
     void
     secure_prng(bool value);
 
+    /** Set the read buffer size option.
+
+        Sets the size of the buffer used by the implementation to
+        receive frames. Frame headers, control frames, compressed
+        message data, and payload too small to be read into the
+        caller's buffers directly are received into this buffer.
+
+        Increasing the size of the buffer can reduce the number of
+        calls made to the next layer to read many small messages,
+        while lowering the size of the buffer can decrease the memory
+        requirements for each connection. Payload of at least 1536
+        bytes is read directly into the caller's buffers regardless
+        of this setting.
+
+        The default setting is 1536. The minimum value is 139, the
+        size of the largest control frame.
+
+        Undefined behavior results if the option is modified while a
+        read operation is pending, or if the new size is smaller than
+        the number of bytes received but not yet read.
+
+        @par Example
+        Setting the read buffer size.
+        @code
+            ws.read_buffer_size(65536);
+        @endcode
+
+        @param amount The size of the read buffer in bytes.
+    */
+    void
+    read_buffer_size(std::size_t amount);
+
+    /// Returns the size of the read buffer.
+    std::size_t
+    read_buffer_size() const;
+
     /** Set the write buffer size option.
 
         Sets the size of the write buffer used by the implementation to
         send frames. The write buffer is needed when masking payload data
         in the client role, compressing frames, or auto-fragmenting message
-        data.
+        data. Streams in the server role which neither compress nor
+        auto-fragment send the caller's buffers directly, and do not use
+        the write buffer.
 
         Lowering the size of the buffer can decrease the memory requirements
         for each connection, while increasing the size of the buffer can reduce
@@ -3190,6 +3234,264 @@ public:
     async_write_some(bool fin,
         ConstBufferSequence const& buffers, WriteHandler&& handler);
 
+    /** Write a prepared message to the stream.
+
+        This function is used to write a message which was framed
+        ahead of time, typically to send the same message on many
+        streams. The call blocks until one of the following
+        conditions is true:
+
+        @li The entire message is sent.
+
+        @li An error occurs.
+
+        This operation is implemented in terms of one or more calls
+        to the next layer's `write_some` function.
+
+        The message is sent as a single frame with the opcode it was
+        prepared with. The settings of the @ref binary and
+        @ref auto_fragment options have no effect. If the
+        permessage-deflate extension was negotiated and the message
+        holds a compressed form the peer can inflate, the compressed
+        form is sent. Nothing is copied, masked or compressed.
+
+        The stream must be in the server role, and must not be in
+        the middle of sending a message with @ref write_some.
+
+        @param msg The message to send.
+
+        @return The size of the message payload.
+
+        @throws system_error Thrown on failure.
+    */
+    std::size_t
+    write_prepared(prepared_message const& msg);
+
+    /** Write a prepared message to the stream.
+
+        This function is used to write a message which was framed
+        ahead of time, typically to send the same message on many
+        streams. The call blocks until one of the following
+        conditions is true:
+
+        @li The entire message is sent.
+
+        @li An error occurs.
+
+        This operation is implemented in terms of one or more calls
+        to the next layer's `write_some` function.
+
+        The message is sent as a single frame with the opcode it was
+        prepared with. The settings of the @ref binary and
+        @ref auto_fragment options have no effect. If the
+        permessage-deflate extension was negotiated and the message
+        holds a compressed form the peer can inflate, the compressed
+        form is sent. Nothing is copied, masked or compressed.
+
+        The stream must be in the server role, otherwise the error
+        `net::error::operation_not_supported` is set. It must not be
+        in the middle of sending a message with @ref write_some.
+
+        @param msg The message to send.
+
+        @param ec Set to indicate what error occurred, if any.
+
+        @return The size of the message payload, or zero if an
+        error occurred.
+    */
+    std::size_t
+    write_prepared(prepared_message const& msg, error_code& ec);
+
+    /** Start an asynchronous operation to write a prepared message to the stream.
+
+        This function is used to asynchronously write a message which
+        was framed ahead of time, typically to send the same message
+        on many streams. The function call always returns immediately.
+        The asynchronous operation will continue until one of the
+        following conditions is true:
+
+        @li The entire message is sent.
+
+        @li An error occurs.
+
+        This operation is implemented in terms of one or more calls
+        to the next layer's `async_write_some` functions, and is known
+        as a <em>composed operation</em>. The program must ensure that
+        the stream performs no other write operations (such as
+        @ref async_write, @ref async_write_some, or
+        @ref async_close).
+
+        The message is sent as a single frame with the opcode it was
+        prepared with. The settings of the @ref binary and
+        @ref auto_fragment options have no effect. If the
+        permessage-deflate extension was negotiated and the message
+        holds a compressed form the peer can inflate, the compressed
+        form is sent. Nothing is copied, masked or compressed.
+
+        The stream must be in the server role, otherwise the operation
+        completes with `net::error::operation_not_supported`. It must
+        not be in the middle of sending a message with
+        @ref async_write_some.
+
+        @param msg The message to send. The operation holds a copy
+        of this object, which shares ownership of the message, until
+        the handler is called.
+
+        @param handler Invoked when the operation completes.
+        The handler may be moved or copied as needed.
+        The function signature of the handler must be:
+        @code
+        void handler(
+            error_code const& ec,           // Result of operation
+            std::size_t bytes_transferred   // The size of the message
+                                            // payload, or zero if an
+                                            // error occurred.
+        );
+        @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::io_context::post`.
+    */
+    template<class WriteHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(
+        WriteHandler, void(error_code, std::size_t))
+    async_write_prepared(
+        prepared_message const& msg,
+        WriteHandler&& handler);
+
+    /** Write queued messages to the stream.
+
+        This function is used to write the prepared messages at the
+        front of a @ref send_queue. The call blocks until one of the
+        following conditions is true:
+
+        @li The messages are sent.
+
+        @li An error occurs.
+
+        This operation is implemented in terms of one or more calls
+        to the next layer's `write_some` function.
+
+        Consecutive messages are sent with a single gather write of
+        their frames, as long as the frames fit in the queue's
+        @ref send_queue::coalesce_limit. Each message is sent as
+        described for @ref write_prepared. Messages which were sent
+        are removed from the queue. If the queue is empty, nothing
+        is sent.
+
+        The stream must be in the server role, and must not be in
+        the middle of sending a message with @ref write_some.
+
+        @param queue The queue to send from.
+
+        @return The total payload size of the messages sent.
+
+        @throws system_error Thrown on failure. If the queue
+        overflowed under @ref send_queue::policy::disconnect, the
+        error is @ref error::send_queue_overflow.
+    */
+    std::size_t
+    write_prepared(send_queue& queue);
+
+    /** Write queued messages to the stream.
+
+        This function is used to write the prepared messages at the
+        front of a @ref send_queue. The call blocks until one of the
+        following conditions is true:
+
+        @li The messages are sent.
+
+        @li An error occurs.
+
+        This operation is implemented in terms of one or more calls
+        to the next layer's `write_some` function.
+
+        Consecutive messages are sent with a single gather write of
+        their frames, as long as the frames fit in the queue's
+        @ref send_queue::coalesce_limit. Each message is sent as
+        described for @ref write_prepared. Messages which were sent
+        are removed from the queue. If the queue is empty, nothing
+        is sent.
+
+        The stream must be in the server role, otherwise the error
+        `net::error::operation_not_supported` is set. It must not be
+        in the middle of sending a message with @ref write_some.
+
+        @param queue The queue to send from.
+
+        @param ec Set to indicate what error occurred, if any. If the
+        queue overflowed under @ref send_queue::policy::disconnect,
+        the error is @ref error::send_queue_overflow.
+
+        @return The total payload size of the messages sent, or zero
+        if an error occurred.
+    */
+    std::size_t
+    write_prepared(send_queue& queue, error_code& ec);
+
+    /** Start an asynchronous operation to write queued messages to the stream.
+
+        This function is used to asynchronously write the prepared
+        messages at the front of a @ref send_queue. The function call
+        always returns immediately. The asynchronous operation will
+        continue until one of the following conditions is true:
+
+        @li The messages are sent.
+
+        @li An error occurs.
+
+        This operation is implemented in terms of one or more calls
+        to the next layer's `async_write_some` functions, and is known
+        as a <em>composed operation</em>. The program must ensure that
+        the stream performs no other write operations (such as
+        @ref async_write, @ref async_write_some, or
+        @ref async_close).
+
+        Consecutive messages are sent with a single gather write of
+        their frames, as long as the frames fit in the queue's
+        @ref send_queue::coalesce_limit. Messages pushed before the
+        operation starts writing are included. Each message is sent
+        as described for @ref async_write_prepared. Messages which
+        were sent are removed from the queue. If the queue is empty,
+        the operation completes without sending anything.
+
+        The stream must be in the server role, otherwise the operation
+        completes with `net::error::operation_not_supported`. It must
+        not be in the middle of sending a message with
+        @ref async_write_some.
+
+        @param queue The queue to send from. The queue is marked
+        busy until the handler is called, and the application must
+        ensure that it remains valid until then. Messages may still
+        be pushed to the queue while the operation is pending.
+
+        @param handler Invoked when the operation completes.
+        The handler may be moved or copied as needed.
+        The function signature of the handler must be:
+        @code
+        void handler(
+            error_code const& ec,           // Result of operation
+            std::size_t bytes_transferred   // The total payload size
+                                            // of the messages sent, or
+                                            // zero if an error occurred.
+        );
+        @endcode
+        If the queue overflowed under
+        @ref send_queue::policy::disconnect, the error is
+        @ref error::send_queue_overflow.
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::io_context::post`.
+    */
+    template<class WriteHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(
+        WriteHandler, void(error_code, std::size_t))
+    async_write_prepared(
+        send_queue& queue,
+        WriteHandler&& handler);
+
 private:
     template<class, class>  class accept_op;
     template<class>         class close_op;
@@ -3200,6 +3502,8 @@ private:
     template<class>         class response_op;
     template<class, class>  class write_some_op;
     template<class, class>  class write_op;
+    template<class>         class write_prepared_op;
+    template<class>         class write_queue_op;
 
     static void default_decorate_req(request_type&) {}
     static void default_decorate_res(response_type&) {}
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_DETAIL_CHECKSUM_HPP
+#define BOOST_BEAST_ZLIB_DETAIL_CHECKSUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+namespace detail {
+
+// CRC-32 as used by the gzip format, RFC 1952 section 8
+
+struct crc32_table
+{
+    std::uint32_t v[256];
+
+    crc32_table()
+    {
+        for(std::uint32_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t c = i;
+            for(int k = 0; k < 8; ++k)
+                c = (c & 1) ? (0xedb88320 ^ (c >> 1)) : (c >> 1);
+            v[i] = c;
+        }
+    }
+};
+
+inline
+std::uint32_t const*
+get_crc32_table()
+{
+    static crc32_table const tab;
+    return tab.v;
+}
+
+/*  Update a running CRC-32 with the bytes in [p, p+n).
+
+    The initial value for a new checksum is zero.
+*/
+inline
+std::uint32_t
+crc32(std::uint32_t crc, void const* p, std::size_t n)
+{
+    auto const tab = get_crc32_table();
+    auto in = static_cast<unsigned char const*>(p);
+    crc = crc ^ 0xffffffff;
+    while(n--)
+        crc = tab[(crc ^ *in++) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffff;
+}
+
+/*  Update a running Adler-32 with the bytes in [p, p+n).
+
+    Used by the zlib format, RFC 1950 section 9.
+    The initial value for a new checksum is one.
+*/
+inline
+std::uint32_t
+adler32(std::uint32_t adler, void const* p, std::size_t n)
+{
+    // largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1
+    std::size_t constexpr nmax = 5552;
+    std::uint32_t constexpr base = 65521;
+    auto in = static_cast<unsigned char const*>(p);
+    std::uint32_t a = adler & 0xffff;
+    std::uint32_t b = adler >> 16;
+    while(n > 0)
+    {
+        auto k = n < nmax ? n : nmax;
+        n -= k;
+        while(k--)
+        {
+            a += *in++;
+            b += a;
+        }
+        a %= base;
+        b %= base;
+    }
+    return (b << 16) | a;
+}
+
+} // detail
+} // zlib
+} // beast
+} // boost
+
+#endif
@@ -331,6 +331,10 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
             if(last_)
             {
                 bi_.flush_byte();
+                // Return whole bytes read past the end of the
+                // stream so the caller sees them as unused input.
+                r.in.next -= clamp(bi_.size() / 8, r.in.used());
+                bi_.flush();
                 mode_ = CHECK;
                 break;
             }
@@ -557,11 +561,17 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
                     back_ = -1;
                 break;
             }
-            if(! bi_.fill(lenbits_, r.in.next, r.in.last))
+            if(! bi_.fill(lenbits_, r.in.next, r.in.last) &&
+                lencode_[bi_.peek_fast() & ((1U << lenbits_) - 1)
+                    ].bits > bi_.size())
+            {
+                // The code can be shorter than lenbits_, such as
+                // the end-of-block code at the end of the stream.
                 return done();
-            std::uint16_t v;
+            }
+            auto v = static_cast<std::uint16_t>(
+                bi_.peek_fast() & ((1U << lenbits_) - 1));
             back_ = 0;
-            bi_.peek(v, lenbits_);
             auto cp = &lencode_[v];
             if(cp->op && (cp->op & 0xf0) == 0)
             {
@@ -613,10 +623,12 @@ doWrite(z_params& zs, Flush flush, error_code& ec)
 
         case DIST:
         {
-            if(! bi_.fill(distbits_, r.in.next, r.in.last))
+            if(! bi_.fill(distbits_, r.in.next, r.in.last) &&
+                distcode_[bi_.peek_fast() & ((1U << distbits_) - 1)
+                    ].bits > bi_.size())
                 return done();
-            std::uint16_t v;
-            bi_.peek(v, distbits_);
+            auto v = static_cast<std::uint16_t>(
+                bi_.peek_fast() & ((1U << distbits_) - 1));
             auto cp = &distcode_[v];
             if((cp->op & 0xf0) == 0)
             {
@@ -16,6 +16,9 @@
 
 #include <boost/beast/core/type_traits.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace boost {
 namespace beast {
@@ -26,10 +29,59 @@ class file_posix_test
     : public beast::unit_test::suite
 {
 public:
+    void
+    testWriteBuffers()
+    {
+        auto const path = boost::filesystem::unique_path();
+        auto const s = path.string<std::string>();
+
+        // more buffers than one gather write takes
+        std::string data;
+        std::vector<net::const_buffer> v;
+        for(int i = 0; i < 40; ++i)
+            data.append(std::string(i, static_cast<char>('a' + i % 26)));
+        for(std::size_t i = 0, n = 0; i < data.size(); i += n++)
+            v.emplace_back(data.data() + i,
+                (std::min)(n, data.size() - i));
+
+        error_code ec;
+        {
+            file_posix f;
+            f.write(v, ec);
+            BEAST_EXPECTS(ec == errc::bad_file_descriptor, ec.message());
+            f.preallocate(data.size(), ec);
+            BEAST_EXPECTS(ec == errc::bad_file_descriptor, ec.message());
+
+            f.open(s.c_str(), file_mode::write, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            f.preallocate(data.size(), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(f.size(ec) == 0);
+            auto const n = f.write(v, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == data.size());
+            BEAST_EXPECT(f.pos(ec) == data.size());
+            BEAST_EXPECT(f.write(std::vector<net::const_buffer>{}, ec) == 0);
+            BEAST_EXPECTS(! ec, ec.message());
+        }
+        {
+            file_posix f;
+            f.open(s.c_str(), file_mode::read, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(f.size(ec) == data.size());
+            std::string result(data.size(), 0);
+            f.read(&result[0], result.size(), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(result == data);
+        }
+        boost::filesystem::remove(path, ec);
+    }
+
     void
     run()
     {
         test_file<file_posix>();
+        testWriteBuffers();
     }
 };
 
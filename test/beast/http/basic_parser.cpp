@@ -1057,6 +1057,90 @@ public:
     //--------------------------------------------------------------------------
 
     // https://github.com/boostorg/beast/issues/430
+    void
+    testBodyBuffers()
+    {
+        // Body octets in a buffer sequence
+        // are presented without flattening.
+        auto const put_body =
+            [&](test_parser<false>& p, error_code& ec)
+            {
+                string_view const s1 = "abc";
+                string_view const s2 = "defg";
+                string_view const s3 = "hiHTTP/1.1";
+                return p.put(buffers_cat(
+                    net::const_buffer(s1.data(), s1.size()),
+                    net::const_buffer(s2.data(), s2.size()),
+                    net::const_buffer(s3.data(), s3.size())), ec);
+            };
+        {
+            test_parser<false> p;
+            error_code ec;
+            string_view const s =
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 9\r\n"
+                "\r\n";
+            p.put(net::buffer(s.data(), s.size()), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.is_header_done());
+            auto const n = put_body(p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 9);
+            BEAST_EXPECT(p.is_done());
+            BEAST_EXPECT(p.body == "abcdefghi");
+            BEAST_EXPECT(p.got_on_body == 1);
+            BEAST_EXPECT(p.got_on_complete == 1);
+        }
+        {
+            test_parser<false> p;
+            error_code ec;
+            string_view const s =
+                "HTTP/1.1 200 OK\r\n"
+                "\r\n";
+            p.put(net::buffer(s.data(), s.size()), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            auto const n = put_body(p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 17);
+            BEAST_EXPECT(! p.is_done());
+            p.put_eof(ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.is_done());
+            BEAST_EXPECT(p.body == "abcdefghiHTTP/1.1");
+        }
+        {
+            test_parser<false> p;
+            error_code ec;
+            p.body_limit(16);
+            string_view const s =
+                "HTTP/1.1 200 OK\r\n"
+                "\r\n";
+            p.put(net::buffer(s.data(), s.size()), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            put_body(p, ec);
+            BEAST_EXPECTS(ec == error::body_limit, ec.message());
+        }
+        {
+            response_parser<string_body> p;
+            error_code ec;
+            string_view const s =
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 5\r\n"
+                "\r\n";
+            p.put(net::buffer(s.data(), s.size()), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            string_view const s1 = "ab";
+            string_view const s2 = "cde";
+            auto const n = p.put(buffers_cat(
+                net::const_buffer(s1.data(), s1.size()),
+                net::const_buffer(s2.data(), s2.size())), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == 5);
+            BEAST_EXPECT(p.is_done());
+            BEAST_EXPECT(p.get().body() == "abcde");
+        }
+    }
+
     void
     testIssue430()
     {
@@ -1301,6 +1385,7 @@ public:
         testPartial();
         testLimits();
         testBody();
+        testBodyBuffers();
         testIssue430();
         testIssue452();
         testIssue496();
@@ -0,0 +1,295 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/deflate_body.hpp>
+
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/http/buffer_body.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <random>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+BOOST_STATIC_ASSERT(is_body<gzip_body<string_body>>::value);
+BOOST_STATIC_ASSERT(is_body_writer<gzip_body<string_body>>::value);
+BOOST_STATIC_ASSERT(is_body_reader<gzip_body<string_body>>::value);
+BOOST_STATIC_ASSERT(is_body_writer<deflate_body<buffer_body>>::value);
+
+class deflate_body_test : public beast::unit_test::suite
+{
+public:
+    struct visitor
+    {
+        std::string& s;
+        std::size_t size;
+
+        template<class ConstBufferSequence>
+        void
+        operator()(error_code&,
+            ConstBufferSequence const& buffers)
+        {
+            size = net::buffer_size(buffers);
+            s.append(buffers_to_string(buffers));
+        }
+    };
+
+    static
+    std::string
+    make_corpus(std::size_t n)
+    {
+        std::string s;
+        std::mt19937 g;
+        std::uniform_int_distribution<int> d{'a', 'h'};
+        while(s.size() < n)
+            s.append(std::size_t(d(g)) - 'a' + 1,
+                static_cast<char>(d(g)));
+        s.resize(n);
+        return s;
+    }
+
+    // Serialize a message and return the body octets
+    template<class Body>
+    std::string
+    serialize(std::string const& body)
+    {
+        response<Body> res;
+        res.body() = body;
+        res.chunked(false);
+        serializer<false, Body> sr{res};
+        std::string s;
+        visitor v{s, 0};
+        error_code ec;
+        while(! sr.is_done())
+        {
+            sr.next(ec, v);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return {};
+            sr.consume(v.size);
+        }
+        return s.substr(s.find("\r\n\r\n") + 4);
+    }
+
+    // Parse coded body octets, delivered in pieces
+    template<class Body>
+    std::string
+    parse(std::string const& coded,
+        std::size_t piece, error_code& ec)
+    {
+        response_parser<Body> p;
+        p.eager(true);
+        std::string const h =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: " + std::to_string(coded.size()) +
+            "\r\n\r\n";
+        p.put(net::buffer(h), ec);
+        if(ec)
+            return {};
+        std::size_t i = 0;
+        while(i < coded.size())
+        {
+            auto const n = (std::min)(piece, coded.size() - i);
+            auto const used = p.put(
+                net::buffer(coded.data() + i, n), ec);
+            if(ec)
+                return {};
+            BEAST_EXPECT(used == n);
+            i += n;
+        }
+        BEAST_EXPECT(p.is_done());
+        return p.get().body();
+    }
+
+    template<class Body>
+    void
+    doRoundTrip(std::string const& body)
+    {
+        auto const coded = serialize<Body>(body);
+        for(std::size_t piece : {std::size_t{1}, std::size_t{7},
+            std::size_t{4096}, coded.size() + 1})
+        {
+            error_code ec;
+            auto const s = parse<Body>(coded, piece, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(s == body);
+        }
+    }
+
+    void
+    testRoundTrip()
+    {
+        for(std::size_t n : {0, 1, 100, 4096, 100000})
+        {
+            auto const body = make_corpus(n);
+            doRoundTrip<gzip_body<string_body>>(body);
+            doRoundTrip<deflate_body<string_body>>(body);
+        }
+        // compression actually happens
+        auto const body = make_corpus(100000);
+        BEAST_EXPECT(serialize<gzip_body<
+            string_body>>(body).size() < body.size() / 2);
+    }
+
+    void
+    testFormat()
+    {
+        // gzip member header
+        {
+            auto const s = serialize<gzip_body<string_body>>("*");
+            BEAST_EXPECT(s.size() >= 18);
+            BEAST_EXPECT(static_cast<unsigned char>(s[0]) == 0x1f);
+            BEAST_EXPECT(static_cast<unsigned char>(s[1]) == 0x8b);
+            BEAST_EXPECT(s[2] == 8);
+            // ISIZE
+            BEAST_EXPECT(s[s.size() - 4] == 1);
+        }
+        // zlib header
+        {
+            auto const s = serialize<deflate_body<string_body>>("*");
+            BEAST_EXPECT(static_cast<unsigned char>(s[0]) == 0x78);
+            BEAST_EXPECT(static_cast<unsigned char>(s[1]) == 0x9c);
+        }
+        // gzip header with optional fields, as produced by gzip(1)
+        {
+            auto coded = serialize<gzip_body<string_body>>("Hello");
+            std::string const extra =
+                std::string("\x04\x00" "abcd", 6) +    // FEXTRA
+                std::string("name\0", 5) +             // FNAME
+                std::string("comment\0", 8) +          // FCOMMENT
+                std::string("\x00\x00", 2);            // FHCRC
+            coded[3] = 0x04 | 0x08 | 0x10 | 0x02;
+            coded.insert(10, extra);
+            error_code ec;
+            auto const s = parse<gzip_body<string_body>>(coded, 3, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(s == "Hello");
+        }
+    }
+
+    void
+    testErrors()
+    {
+        // bad magic
+        {
+            auto coded = serialize<gzip_body<string_body>>("Hello");
+            coded[1] = 'x';
+            error_code ec;
+            parse<gzip_body<string_body>>(coded, 100, ec);
+            BEAST_EXPECTS(ec == error::bad_content_coding, ec.message());
+        }
+        {
+            auto coded = serialize<deflate_body<string_body>>("Hello");
+            coded[1] = 'x';
+            error_code ec;
+            parse<deflate_body<string_body>>(coded, 100, ec);
+            BEAST_EXPECTS(ec == error::bad_content_coding, ec.message());
+        }
+        // bad checksum
+        {
+            auto coded = serialize<gzip_body<string_body>>("Hello");
+            coded[coded.size() - 8] ^= 1;
+            error_code ec;
+            parse<gzip_body<string_body>>(coded, 100, ec);
+            BEAST_EXPECTS(ec == error::bad_content_coding, ec.message());
+        }
+        {
+            auto coded = serialize<deflate_body<string_body>>("Hello");
+            coded[coded.size() - 1] ^= 1;
+            error_code ec;
+            parse<deflate_body<string_body>>(coded, 100, ec);
+            BEAST_EXPECTS(ec == error::bad_content_coding, ec.message());
+        }
+        // truncated
+        {
+            auto const coded = serialize<gzip_body<string_body>>("Hello");
+            gzip_body<string_body>::value_type body;
+            response<string_body> res;
+            gzip_body<string_body>::reader r{res, body};
+            error_code ec;
+            r.init(boost::none, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            r.put(net::buffer(coded.data(), coded.size() - 1), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            r.finish(ec);
+            BEAST_EXPECTS(ec == error::partial_message, ec.message());
+        }
+    }
+
+    void
+    testBufferBody()
+    {
+        // streaming input which pauses for more buffers
+        std::string const body = make_corpus(20000);
+        response<gzip_body<buffer_body>> res;
+        res.chunked(true);
+        serializer<false, gzip_body<buffer_body>> sr{res};
+        std::string s;
+        visitor v{s, 0};
+        std::size_t i = 0;
+        for(;;)
+        {
+            if(i < body.size())
+            {
+                auto const n = (std::min)(
+                    std::size_t{1000}, body.size() - i);
+                res.body().data = const_cast<char*>(body.data() + i);
+                res.body().size = n;
+                res.body().more = true;
+                i += n;
+            }
+            else
+            {
+                res.body().data = nullptr;
+                res.body().more = false;
+            }
+            error_code ec;
+            while(! sr.is_done())
+            {
+                sr.next(ec, v);
+                if(ec)
+                    break;
+                sr.consume(v.size);
+            }
+            if(ec == error::need_buffer)
+                continue;
+            BEAST_EXPECTS(! ec, ec.message());
+            break;
+        }
+        BEAST_EXPECT(sr.is_done());
+
+        response_parser<gzip_body<string_body>> p;
+        p.eager(true);
+        error_code ec;
+        auto const used = p.put(net::buffer(s), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(used == s.size());
+        BEAST_EXPECT(p.is_done());
+        BEAST_EXPECT(p.get().body() == body);
+    }
+
+    void
+    run() override
+    {
+        testRoundTrip();
+        testFormat();
+        testErrors();
+        testBufferBody();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,deflate_body);
+
+} // http
+} // beast
+} // boost
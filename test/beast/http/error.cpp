@@ -64,6 +64,8 @@ public:
         check("beast.http", error::bad_chunk);
         check("beast.http", error::bad_chunk_extension);
         check("beast.http", error::bad_obs_fold);
+        check("beast.http", error::bad_content_coding);
+        check("beast.http", error::bad_multipart);
     }
 };
 
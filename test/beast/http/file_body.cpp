@@ -17,6 +17,9 @@
 #include <boost/beast/http/serializer.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/filesystem.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 namespace boost {
 namespace beast {
@@ -97,15 +100,69 @@ public:
         boost::filesystem::remove(temp, ec);
         BEAST_EXPECTS(! ec, ec.message());
     }
+
+    // The body arrives in a sequence of many buffers,
+    // as when read into a multi_buffer.
+    template<class File>
+    void
+    doTestUpload()
+    {
+        std::string body;
+        for(int i = 0; i < 5000; ++i)
+            body.push_back(static_cast<char>('a' + i % 23));
+        std::string const header =
+            "PUT /upload HTTP/1.1\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "\r\n";
+        std::vector<net::const_buffer> v;
+        for(std::size_t i = 0; i < body.size(); i += 100)
+            v.emplace_back(body.data() + i,
+                (std::min<std::size_t>)(100, body.size() - i));
+        // bytes of the next message follow the body
+        v.emplace_back("GET", 3);
+
+        error_code ec;
+        auto const temp = boost::filesystem::unique_path();
+        {
+            request_parser<basic_file_body<File>> p;
+            p.get().body().preallocate(true);
+            p.get().body().open(
+                temp.string<std::string>().c_str(), file_mode::write, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            p.put(net::buffer(header), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.is_header_done());
+            auto const n = p.put(v, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(n == body.size());
+            BEAST_EXPECT(p.is_done());
+        }
+        {
+            File f;
+            f.open(temp.string<std::string>().c_str(), file_mode::read, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(f.size(ec) == body.size());
+            std::string s1(body.size(), 0);
+            f.read(&s1[0], s1.size(), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(s1 == body);
+        }
+        boost::filesystem::remove(temp, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+    }
+
     void
     run() override
     {
         doTestFileBody<file_stdio>();
+        doTestUpload<file_stdio>();
     #if BOOST_BEAST_USE_WIN32_FILE
         doTestFileBody<file_win32>();
+        doTestUpload<file_win32>();
     #endif
     #if BOOST_BEAST_USE_POSIX_FILE
         doTestFileBody<file_posix>();
+        doTestUpload<file_posix>();
     #endif
     }
 };
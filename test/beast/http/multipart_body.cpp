@@ -0,0 +1,386 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/multipart_body.hpp>
+
+#include <boost/beast/core/file_stdio.hpp>
+#include <boost/beast/http/detail/multipart.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/filesystem.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+BOOST_STATIC_ASSERT(is_body<multipart_body>::value);
+BOOST_STATIC_ASSERT(is_body_reader<multipart_body>::value);
+
+class multipart_body_test : public beast::unit_test::suite
+{
+public:
+    // Records the parts delivered to the callbacks
+    struct collector
+    {
+        struct part
+        {
+            std::string fields;
+            std::string data;
+            bool done = false;
+        };
+
+        std::vector<part> parts;
+
+        void
+        operator()(fields& f, error_code&)
+        {
+            parts.emplace_back();
+            for(auto const& e : f)
+            {
+                parts.back().fields.append(
+                    e.name_string().data(), e.name_string().size());
+                parts.back().fields.push_back('=');
+                parts.back().fields.append(
+                    e.value().data(), e.value().size());
+                parts.back().fields.push_back(';');
+            }
+        }
+
+        void
+        operator()(string_view s, error_code&)
+        {
+            parts.back().data.append(s.data(), s.size());
+        }
+
+        void
+        operator()(error_code&)
+        {
+            parts.back().done = true;
+        }
+    };
+
+    // Deliver a payload to a reader in pieces of the given size
+    std::size_t
+    put(
+        string_view content_type,
+        string_view payload,
+        std::size_t piece,
+        collector& c,
+        error_code& ec,
+        std::size_t header_limit = 8192)
+    {
+        request<multipart_body> req;
+        req.set(field::content_type, content_type);
+        req.body().on_part_header(c);
+        req.body().on_part_body(c);
+        req.body().on_part_end(c);
+        req.body().header_limit(header_limit);
+        multipart_body::reader r{req, req.body()};
+        r.init(boost::none, ec);
+        if(ec)
+            return 0;
+        std::size_t i = 0;
+        while(i < payload.size())
+        {
+            auto const n = (std::min)(piece, payload.size() - i);
+            auto const used = r.put(
+                net::const_buffer(payload.data() + i, n), ec);
+            if(ec)
+                return req.body().parts();
+            BEAST_EXPECT(used == n);
+            i += n;
+        }
+        r.finish(ec);
+        return req.body().parts();
+    }
+
+    void
+    check(
+        string_view content_type,
+        string_view payload,
+        std::vector<std::pair<std::string, std::string>> const& expected)
+    {
+        for(std::size_t piece = 1; piece <= payload.size(); ++piece)
+        {
+            collector c;
+            error_code ec;
+            auto const n = put(content_type, payload, piece, c, ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            BEAST_EXPECT(n == expected.size());
+            if(! BEAST_EXPECT(c.parts.size() == expected.size()))
+                return;
+            for(std::size_t i = 0; i < expected.size(); ++i)
+            {
+                BEAST_EXPECTS(c.parts[i].fields == expected[i].first,
+                    c.parts[i].fields);
+                BEAST_EXPECTS(c.parts[i].data == expected[i].second,
+                    c.parts[i].data);
+                BEAST_EXPECT(c.parts[i].done);
+            }
+        }
+    }
+
+    void
+    testParts()
+    {
+        string_view const ct =
+            "multipart/form-data; boundary=xyz";
+
+        check(ct,
+            "--xyz\r\n"
+            "Content-Disposition: form-data; name=\"a\"\r\n"
+            "\r\n"
+            "hello\r\n"
+            "--xyz\r\n"
+            "Content-Disposition: form-data; name=\"b\"; filename=\"b.txt\"\r\n"
+            "Content-Type: text/plain\r\n"
+            "\r\n"
+            "line1\r\nline2\r\n"
+            "--xyz--\r\n",
+            {
+                {"Content-Disposition=form-data; name=\"a\";", "hello"},
+                {"Content-Disposition=form-data; name=\"b\"; filename=\"b.txt\";"
+                    "Content-Type=text/plain;", "line1\r\nline2"},
+            });
+
+        // preamble, epilogue, transport padding, no fields, empty data
+        check(ct,
+            "preamble\r\n--xy\r\n"
+            "--xyz \t\r\n"
+            "\r\n"
+            "\r\n"
+            "--xyz\r\n"
+            "\r\n"
+            "\r\n--x\r\n--xy\r\n--xy"
+            "\r\n--xyz--epilogue\r\n--xyz\r\n",
+            {
+                {"", ""},
+                {"", "\r\n--x\r\n--xy\r\n--xy"},
+            });
+
+        // data resembling delimiters
+        check(ct,
+            "--xyz\r\n"
+            "\r\n"
+            "\r\r\n\r\n-\r\n--\r\n--x--\r\r\n--xy\r\n"
+            "\r\n--xyz--",
+            {
+                {"", "\r\r\n\r\n-\r\n--\r\n--x--\r\r\n--xy\r\n"},
+            });
+
+        // obs-fold in part fields
+        check(ct,
+            "--xyz\r\n"
+            "X-Long: a\r\n"
+            " b\r\n"
+            "\r\n"
+            "*\r\n"
+            "--xyz--",
+            {
+                {"X-Long=a b;", "*"},
+            });
+
+        // quoted boundary containing characters outside token
+        check("multipart/mixed; charset=utf-8; boundary=\"a:b=c?\"",
+            "--a:b=c?\r\n\r\nz\r\n--a:b=c?--",
+            {
+                {"", "z"},
+            });
+    }
+
+    void
+    testLarge()
+    {
+        // A payload much larger than any internal buffer,
+        // with binary data which contains many CR octets.
+        std::string data;
+        std::mt19937 g;
+        std::uniform_int_distribution<int> d{0, 15};
+        for(std::size_t i = 0; i < 200000; ++i)
+        {
+            auto const v = d(g);
+            data.push_back(v < 4 ? '\r' : v < 6 ? '\n' :
+                v < 8 ? '-' : static_cast<char>('a' + v));
+        }
+        std::string const payload =
+            "--0123456789abcdef\r\n\r\n" + data +
+            "\r\n--0123456789abcdef--\r\n";
+        for(std::size_t piece : {
+            std::size_t{1}, std::size_t{17}, std::size_t{4096},
+            payload.size()})
+        {
+            collector c;
+            error_code ec;
+            put("multipart/form-data; boundary=0123456789abcdef",
+                payload, piece, c, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            if(BEAST_EXPECT(c.parts.size() == 1))
+                BEAST_EXPECT(c.parts[0].data == data);
+        }
+    }
+
+    void
+    testErrors()
+    {
+        auto const bad =
+            [&](string_view ct, string_view payload,
+                error_code const& expected, std::size_t header_limit)
+            {
+                collector c;
+                error_code ec;
+                put(ct, payload, payload.size(), c, ec, header_limit);
+                BEAST_EXPECTS(ec == expected, ec.message());
+            };
+
+        string_view const ct =
+            "multipart/form-data; boundary=xyz";
+
+        // no boundary
+        bad("multipart/form-data", "", error::bad_multipart, 8192);
+        bad("text/plain; boundary=xyz", "", error::bad_multipart, 8192);
+        bad("multipart/form-data; charset=x", "", error::bad_multipart, 8192);
+        bad("multipart/form-data; boundary=" + std::string(71, 'x'),
+            "", error::bad_multipart, 8192);
+
+        // bad delimiter line
+        bad(ct, "--xyz!\r\n\r\n--xyz--", error::bad_multipart, 8192);
+        bad(ct, "--xyz\r!\r\n--xyz--", error::bad_multipart, 8192);
+        bad(ct, "--xyz-!", error::bad_multipart, 8192);
+
+        // bad part fields
+        bad(ct, "--xyz\r\nno colon\r\n\r\n--xyz--", error::bad_field, 8192);
+
+        // part fields too large
+        bad(ct, "--xyz\r\nX: " + std::string(100, 'x') +
+            "\r\n\r\n--xyz--", error::header_limit, 64);
+
+        // truncated
+        bad(ct, "", error::partial_message, 8192);
+        bad(ct, "--xyz\r\n\r\ndata", error::partial_message, 8192);
+        bad(ct, "--xyz\r\n\r\ndata\r\n--xyz", error::partial_message, 8192);
+
+        // error from a callback
+        {
+            request<multipart_body> req;
+            req.set(field::content_type, ct);
+            auto cb = [](string_view, error_code& ec)
+                {
+                    ec = error::body_limit;
+                };
+            req.body().on_part_body(cb);
+            multipart_body::reader r{req, req.body()};
+            error_code ec;
+            r.init(boost::none, ec);
+            string_view const s = "--xyz\r\n\r\ndata";
+            r.put(net::const_buffer(s.data(), s.size()), ec);
+            BEAST_EXPECTS(ec == error::body_limit, ec.message());
+        }
+    }
+
+    void
+    testParser()
+    {
+        // Parts are split across chunks, and the
+        // data of a part is streamed to a file.
+        auto const path = boost::filesystem::unique_path();
+        std::string const s =
+            "POST /upload HTTP/1.1\r\n"
+            "Content-Type: multipart/form-data; boundary=b\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n"
+            "7\r\n--b\r\n\r\n\r\n"
+            "3\r\nabc\r\n"
+            "2\r\n\r\n\r\n"
+            "3\r\n--b\r\n"
+            "2\r\n--\r\n"
+            "0\r\n\r\n";
+        file_stdio f;
+        error_code ec;
+        auto on_header =
+            [&](fields&, error_code& ec)
+            {
+                f.open(path.string<std::string>().c_str(),
+                    file_mode::write, ec);
+            };
+        auto on_body =
+            [&](string_view data, error_code& ec)
+            {
+                f.write(data.data(), data.size(), ec);
+            };
+        auto on_end =
+            [&](error_code& ec)
+            {
+                f.close(ec);
+            };
+        request_parser<multipart_body> p;
+        p.get().body().on_part_header(on_header);
+        p.get().body().on_part_body(on_body);
+        p.get().body().on_part_end(on_end);
+        p.eager(true);
+        auto const used = p.put(net::buffer(s), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(used == s.size());
+        BEAST_EXPECT(p.is_done());
+        BEAST_EXPECT(p.get().body().parts() == 1);
+
+        f.open(path.string<std::string>().c_str(), file_mode::read, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        char buf[16];
+        auto const n = f.read(buf, sizeof(buf), ec);
+        BEAST_EXPECT(string_view(buf, n) == "abc");
+        f.close(ec);
+        boost::filesystem::remove(path, ec);
+    }
+
+    void
+    testFind()
+    {
+        std::string s(100, 'x');
+        auto const find =
+            [&](std::size_t first)
+            {
+                return static_cast<std::size_t>(
+                    detail::find_multipart_delimiter(
+                        s.data() + first, s.data() + s.size()) - s.data());
+            };
+        BEAST_EXPECT(find(0) == 100);
+        s[40] = '\r';
+        BEAST_EXPECT(find(0) == 100);
+        s[43] = '-';
+        BEAST_EXPECT(find(0) == 40);
+        BEAST_EXPECT(find(41) == 100);
+        s[98] = '\r';
+        BEAST_EXPECT(find(41) == 98);
+        s[20] = '\r';
+        s[23] = '-';
+        BEAST_EXPECT(find(0) == 20);
+        BEAST_EXPECT(find(21) == 40);
+    }
+
+    void
+    run() override
+    {
+        testParts();
+        testLarge();
+        testErrors();
+        testParser();
+        testFind();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,multipart_body);
+
+} // http
+} // beast
+} // boost
@@ -0,0 +1,335 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/precompressed_store.hpp>
+
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/file_stdio.hpp>
+#include <boost/beast/http/deflate_body.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/filesystem.hpp>
+#include <random>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+BOOST_STATIC_ASSERT(is_body<precompressed_body>::value);
+BOOST_STATIC_ASSERT(is_body_writer<precompressed_body>::value);
+BOOST_STATIC_ASSERT(detail::is_body_sized<precompressed_body>::value);
+
+class precompressed_store_test : public beast::unit_test::suite
+{
+public:
+    using store_type = basic_precompressed_store<file_stdio>;
+    using body_type = store_type::body_type;
+
+    struct visitor
+    {
+        std::string& s;
+        std::size_t size;
+
+        template<class ConstBufferSequence>
+        void
+        operator()(error_code&,
+            ConstBufferSequence const& buffers)
+        {
+            size = net::buffer_size(buffers);
+            s.append(buffers_to_string(buffers));
+        }
+    };
+
+    class temp_file
+    {
+        boost::filesystem::path path_;
+
+    public:
+        explicit
+        temp_file(std::string const& s)
+            : path_(boost::filesystem::unique_path())
+        {
+            file_stdio f;
+            error_code ec;
+            f.open(path_.string<std::string>().c_str(),
+                file_mode::write, ec);
+            if(! s.empty())
+                f.write(s.data(), s.size(), ec);
+        }
+
+        ~temp_file()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(path_, ec);
+        }
+
+        std::string
+        path() const
+        {
+            return path_.string<std::string>();
+        }
+    };
+
+    static
+    std::string
+    corpus1(std::size_t n)
+    {
+        std::string s;
+        std::mt19937 g;
+        std::uniform_int_distribution<int> d{'a', 'h'};
+        while(s.size() < n)
+            s.append(std::size_t(d(g)) - 'a' + 1,
+                static_cast<char>(d(g)));
+        s.resize(n);
+        return s;
+    }
+
+    static
+    std::string
+    corpus2(std::size_t n)
+    {
+        std::string s;
+        std::mt19937 g;
+        std::uniform_int_distribution<int> d{0, 255};
+        while(n--)
+            s.push_back(static_cast<char>(d(g)));
+        return s;
+    }
+
+    // Serialize the body and return the octets following the header
+    std::string
+    serialize(body_type::value_type&& body)
+    {
+        response<body_type> res{status::ok, 11};
+        res.body() = std::move(body);
+        res.prepare_payload();
+        serializer<false, body_type> sr{res};
+        std::string s;
+        visitor v{s, 0};
+        error_code ec;
+        while(! sr.is_done())
+        {
+            sr.next(ec, v);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return {};
+            sr.consume(v.size);
+        }
+        return s.substr(s.find("\r\n\r\n") + 4);
+    }
+
+    template<bool isGzip>
+    std::string
+    decode(std::string const& coded)
+    {
+        string_body::value_type body;
+        response<string_body> res;
+        typename basic_deflate_body<
+            string_body, isGzip>::reader r{res, body};
+        error_code ec;
+        r.init(boost::none, ec);
+        r.put(net::buffer(coded), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        r.finish(ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        return body;
+    }
+
+    void
+    testNegotiate()
+    {
+        auto const check =
+            [&](string_view s, content_coding c)
+            {
+                BEAST_EXPECTS(negotiate_content_coding(s) == c, s);
+            };
+        check("", content_coding::identity);
+        check("identity", content_coding::identity);
+        check("br", content_coding::identity);
+        check("gzip", content_coding::gzip);
+        check("x-gzip", content_coding::gzip);
+        check("GZIP", content_coding::gzip);
+        check("deflate", content_coding::deflate);
+        check("gzip, deflate", content_coding::gzip);
+        check("deflate, gzip", content_coding::gzip);
+        check("*", content_coding::gzip);
+        check("gzip;q=0.5, deflate", content_coding::deflate);
+        check("gzip;q=0, deflate;q=0", content_coding::identity);
+        check("gzip;q=0, *", content_coding::deflate);
+        check("*;q=0, identity", content_coding::identity);
+        check("gzip;q=0.5, identity;q=0.8", content_coding::identity);
+        check("gzip;q=1.000", content_coding::gzip);
+        check("gzip;q=2", content_coding::identity);
+        check("gzip;q=0.0001", content_coding::identity);
+        check("gzip;q=x, deflate", content_coding::deflate);
+        check(" , gzip ;q=0.9 , br", content_coding::gzip);
+
+        BEAST_EXPECT(to_string(content_coding::identity) == "identity");
+        BEAST_EXPECT(to_string(content_coding::deflate) == "deflate");
+        BEAST_EXPECT(to_string(content_coding::gzip) == "gzip");
+    }
+
+    void
+    testOpen()
+    {
+        auto const s = corpus1(50000);
+        temp_file f{s};
+        store_type st{1024 * 1024};
+        BEAST_EXPECT(st.capacity() == 1024 * 1024);
+        std::size_t gzip_size = 0;
+        {
+            body_type::value_type body;
+            error_code ec;
+            auto const c = st.open(f.path(), "gzip, deflate", body, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(c == content_coding::gzip);
+            BEAST_EXPECT(body.is_open());
+            BEAST_EXPECT(body.is_precompressed());
+            BEAST_EXPECT(body.size() < s.size() / 2);
+            gzip_size = static_cast<std::size_t>(body.size());
+            BEAST_EXPECT(decode<true>(serialize(std::move(body))) == s);
+        }
+        {
+            auto const stats = st.stats();
+            BEAST_EXPECT(stats.misses == 1);
+            BEAST_EXPECT(stats.hits == 0);
+            BEAST_EXPECT(stats.entries == 1);
+            BEAST_EXPECT(stats.size == gzip_size);
+            BEAST_EXPECT(stats.bytes_saved == s.size() - gzip_size);
+        }
+        {
+            body_type::value_type body;
+            error_code ec;
+            auto const c = st.open(f.path(), "gzip", body, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(c == content_coding::gzip);
+            BEAST_EXPECT(decode<true>(serialize(std::move(body))) == s);
+            auto const stats = st.stats();
+            BEAST_EXPECT(stats.misses == 1);
+            BEAST_EXPECT(stats.hits == 1);
+            BEAST_EXPECT(stats.bytes_saved == 2 * (s.size() - gzip_size));
+        }
+        {
+            body_type::value_type body;
+            error_code ec;
+            auto const c = st.open(f.path(), "deflate", body, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(c == content_coding::deflate);
+            BEAST_EXPECT(decode<false>(serialize(std::move(body))) == s);
+            BEAST_EXPECT(st.stats().entries == 2);
+        }
+        {
+            body_type::value_type body;
+            error_code ec;
+            auto const c = st.open(f.path(), "", body, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(c == content_coding::identity);
+            BEAST_EXPECT(body.is_open());
+            BEAST_EXPECT(! body.is_precompressed());
+            BEAST_EXPECT(body.size() == s.size());
+            BEAST_EXPECT(serialize(std::move(body)) == s);
+        }
+        {
+            body_type::value_type body;
+            error_code ec;
+            st.open(f.path() + ".missing", "gzip", body, ec);
+            BEAST_EXPECT(ec);
+            BEAST_EXPECT(! body.is_open());
+        }
+
+        st.erase(f.path());
+        BEAST_EXPECT(st.stats().entries == 0);
+        BEAST_EXPECT(st.stats().size == 0);
+    }
+
+    void
+    testIncompressible()
+    {
+        auto const s = corpus2(4096);
+        temp_file f{s};
+        store_type st{1024 * 1024};
+        for(int i = 0; i < 2; ++i)
+        {
+            body_type::value_type body;
+            error_code ec;
+            auto const c = st.open(f.path(), "gzip", body, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(c == content_coding::identity);
+            BEAST_EXPECT(! body.is_precompressed());
+            BEAST_EXPECT(serialize(std::move(body)) == s);
+        }
+        auto const stats = st.stats();
+        BEAST_EXPECT(stats.misses == 1);
+        BEAST_EXPECT(stats.hits == 1);
+        BEAST_EXPECT(stats.size == 0);
+        BEAST_EXPECT(stats.bytes_saved == 0);
+    }
+
+    void
+    testCapacity()
+    {
+        temp_file f1{corpus1(20000)};
+        temp_file f2{corpus1(30000)};
+        error_code ec;
+        std::size_t size1;
+        {
+            store_type st{1024 * 1024};
+            st.load(f1.path(), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            size1 = st.stats().size;
+            BEAST_EXPECT(st.stats().entries == 2);
+            BEAST_EXPECT(st.stats().misses == 0);
+        }
+
+        // room for the variants of only one file
+        store_type st{size1 + 100};
+        st.load(f1.path(), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(st.stats().entries == 2);
+        st.load(f2.path(), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        auto const stats = st.stats();
+        BEAST_EXPECT(stats.evictions >= 2);
+        BEAST_EXPECT(stats.size <= stats.capacity);
+
+        // load of a missing file
+        st.load(f2.path() + ".missing", ec);
+        BEAST_EXPECT(ec);
+
+        // variants larger than the capacity are served uncached
+        store_type st0{0};
+        body_type::value_type body;
+        auto const c = st0.open(f1.path(), "deflate", body, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(c == content_coding::deflate);
+        BEAST_EXPECT(body.is_precompressed());
+        BEAST_EXPECT(st0.stats().entries == 0);
+
+        st.clear();
+        BEAST_EXPECT(st.stats().entries == 0);
+        BEAST_EXPECT(st.stats().size == 0);
+    }
+
+    void
+    run() override
+    {
+        testNegotiate();
+        testOpen();
+        testIncompressible();
+        testCapacity();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,precompressed_store);
+
+} // http
+} // beast
+} // boost
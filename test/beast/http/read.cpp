@@ -15,9 +15,15 @@
 #include <boost/beast/core/ostream.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/http/fields.hpp>
+#include <boost/beast/http/buffer_body.hpp>
 #include <boost/beast/http/dynamic_body.hpp>
+#include <boost/beast/http/empty_body.hpp>
 #include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/span_body.hpp>
 #include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/vector_body.hpp>
+#include <boost/beast/sip/message.hpp>
+#include <boost/beast/sip/parser.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/beast/test/yield_to.hpp>
@@ -30,6 +36,22 @@ namespace boost {
 namespace beast {
 namespace http {
 
+namespace {
+
+// A body whose parser uses a custom read size policy
+struct small_read_body : string_body
+{
+};
+
+std::size_t
+read_size_hint(
+    parser<true, small_read_body> const&, std::size_t)
+{
+    return 16;
+}
+
+} // (anon)
+
 class read_test
     : public beast::unit_test::suite
     , public test::enable_yield_to
@@ -426,6 +448,340 @@ public:
         BEAST_EXPECTS(! ec, ec.message());
     }
 
+    void
+    testProtocol()
+    {
+        // SIP over a stream transport, using the same algorithms
+        std::string const s =
+            "INVITE sip:bob@example.com SIP/2.0\r\n"
+            "i: abc\r\n"
+            "l: 5\r\n"
+            "\r\n"
+            "v=0\r\n";
+        {
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) << s << s;
+            ts.read_size(3);
+            flat_buffer b;
+            sip::tcp_parser<true, string_body> p;
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().method_string() == "INVITE");
+            BEAST_EXPECT(p.get().version() == 20);
+            BEAST_EXPECT(p.get()[field::call_id] == "abc");
+            BEAST_EXPECT(p.get().body() == "v=0\r\n");
+            sip::tcp_request<string_body> m;
+            read(ts, b, m, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(m.body() == "v=0\r\n");
+        }
+        {
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) << s;
+            flat_buffer b;
+            sip::tcp_parser<true, empty_body> p0;
+            error_code ec;
+            read_header(ts, b, p0, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            sip::tcp_parser<true, vector_body<char>> p{std::move(p0)};
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body().size() == 5);
+        }
+        {
+            // HTTP version is rejected
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) <<
+                "GET / HTTP/1.1\r\n"
+                "Content-Length: 0\r\n"
+                "\r\n";
+            flat_buffer b;
+            sip::tcp_parser<true, string_body> p;
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECT(ec);
+        }
+        {
+            net::io_context ioc;
+            test::stream ts{ioc};
+            ostream(ts.buffer()) << s;
+            flat_buffer b;
+            sip::tcp_request<string_body> m;
+            error_code result = test::error::test_failure;
+            async_read(ts, b, m,
+                [&](error_code ec, std::size_t)
+                {
+                    result = ec;
+                });
+            ioc.run();
+            BEAST_EXPECTS(! result, result.message());
+            BEAST_EXPECT(m[field::call_id] == "abc");
+            BEAST_EXPECT(m.body() == "v=0\r\n");
+        }
+    }
+
+    void
+    testReadSizeHint()
+    {
+        {
+            test_parser<true> p;
+            BEAST_EXPECT(read_size_hint(p, 0) == 1024);
+            BEAST_EXPECT(read_size_hint(p, 1024) == 2048);
+            BEAST_EXPECT(read_size_hint(p, 65536) == 65536);
+        }
+        auto const header =
+            [&](test_parser<true>& p, string_view s)
+            {
+                error_code ec;
+                p.eager(false);
+                p.body_limit(10000000);
+                p.put(net::buffer(s.data(), s.size()), ec);
+                BEAST_EXPECTS(! ec, ec.message());
+                BEAST_EXPECT(p.is_header_done());
+            };
+        {
+            test_parser<true> p;
+            header(p,
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: 100000\r\n"
+                "\r\n");
+            BEAST_EXPECT(read_size_hint(p, 1024) == 100000);
+            BEAST_EXPECT(*p.content_length_remaining() == 100000);
+        }
+        {
+            test_parser<true> p;
+            header(p,
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: 5000000\r\n"
+                "\r\n");
+            BEAST_EXPECT(read_size_hint(p, 1024) == 1024 * 1024);
+        }
+        {
+            test_parser<true> p;
+            header(p,
+                "POST / HTTP/1.1\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n");
+            BEAST_EXPECT(! p.content_length_remaining());
+            BEAST_EXPECT(read_size_hint(p, 1024) == 4096);
+            BEAST_EXPECT(read_size_hint(p, 4096) == 8192);
+            BEAST_EXPECT(read_size_hint(p, 1024 * 1024) == 1024 * 1024);
+        }
+
+        // A large body is read in few operations
+        {
+            std::string const body(300000, '*');
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) <<
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: " << body.size() << "\r\n"
+                "\r\n" << body;
+            flat_buffer b;
+            request_parser<string_body> p;
+            p.body_limit(body.size());
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body() == body);
+            BEAST_EXPECTS(ts.nread() <= 3, std::to_string(ts.nread()));
+        }
+
+        // A small message does not over-allocate
+        {
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) <<
+                "GET / HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "\r\n";
+            flat_buffer b;
+            request_parser<string_body> p;
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(b.capacity() <= 1024);
+        }
+
+        // The policy is a customization point
+        {
+            std::string const body(100, '*');
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) <<
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: " << body.size() << "\r\n"
+                "\r\n" << body;
+            flat_buffer b;
+            request_parser<small_read_body> p;
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body() == body);
+            BEAST_EXPECT(ts.nread() > body.size() / 16);
+        }
+    }
+
+    template<class Body, class Pred>
+    void
+    doReadDirect(
+        typename Body::value_type body,
+        std::string const& expected,
+        Pred&& pred)
+    {
+        // The body is read into its storage without
+        // passing through the dynamic buffer.
+        std::string const s =
+            "POST / HTTP/1.1\r\n"
+            "Content-Length: " + std::to_string(expected.size()) + "\r\n"
+            "\r\n" + expected;
+        for(std::size_t n : {
+            std::size_t{1}, std::size_t{7}, std::size_t{4096}, s.size()})
+        {
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) << s << "GET / HTTP/1.1\r\n\r\n";
+            ts.read_size(n);
+            flat_buffer b;
+            request_parser<Body> p;
+            p.get().body() = body;
+            p.body_limit(expected.size());
+            error_code ec;
+            auto const bytes_transferred = read(ts, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.is_done());
+            BEAST_EXPECT(b.capacity() < expected.size());
+            BEAST_EXPECT(bytes_transferred ==
+                b.size() + s.size());
+            pred(p.get().body());
+        }
+    }
+
+    void
+    testReadDirect()
+    {
+        std::string const body(300000, '*');
+        {
+            // also check that pipelined octets stay in the buffer
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) <<
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: " << body.size() << "\r\n"
+                "\r\n" << body << "GET / HTTP/1.1\r\n\r\n";
+            flat_buffer b;
+            request_parser<string_body> p;
+            p.body_limit(body.size());
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body() == body);
+            BEAST_EXPECT(b.capacity() <= 1024);
+            BEAST_EXPECTS(ts.nread() <= 3, std::to_string(ts.nread()));
+            request_parser<string_body> p2;
+            read(ts, b, p2, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p2.get().target() == "/");
+        }
+        doReadDirect<string_body>({}, body,
+            [&](std::string const& v)
+            {
+                BEAST_EXPECT(v == body);
+            });
+        doReadDirect<vector_body<char>>({}, body,
+            [&](std::vector<char> const& v)
+            {
+                BEAST_EXPECT(std::string(v.begin(), v.end()) == body);
+            });
+        {
+            std::string v(body.size(), '.');
+            doReadDirect<span_body<char>>({&v[0], v.size()}, body,
+                [&](span<char> const& rest)
+                {
+                    BEAST_EXPECT(rest.empty());
+                    BEAST_EXPECT(v == body);
+                });
+            std::string w(body.size() - 1, '.');
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) <<
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: " << body.size() << "\r\n"
+                "\r\n" << body;
+            flat_buffer b;
+            request_parser<span_body<char>> p;
+            p.get().body() = {&w[0], w.size()};
+            p.body_limit(body.size());
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(ec == error::buffer_overflow, ec.message());
+        }
+        {
+            // buffer_body reads into the caller's buffer
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) <<
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: " << body.size() << "\r\n"
+                "\r\n" << body;
+            flat_buffer b;
+            request_parser<buffer_body> p;
+            p.body_limit(body.size());
+            std::string result;
+            char buf[65536];
+            error_code ec;
+            while(! p.is_done())
+            {
+                p.get().body().data = buf;
+                p.get().body().size = sizeof(buf);
+                read(ts, b, p, ec);
+                if(ec == error::need_buffer)
+                    ec = {};
+                if(! BEAST_EXPECTS(! ec, ec.message()))
+                    break;
+                result.append(buf, sizeof(buf) - p.get().body().size);
+            }
+            BEAST_EXPECT(result == body);
+            BEAST_EXPECT(b.capacity() <= 1024);
+        }
+        {
+            // truncated body
+            test::stream ts{ioc_};
+            ostream(ts.buffer()) <<
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: " << body.size() << "\r\n"
+                "\r\n" << body.substr(0, 5000);
+            ts.close_remote();
+            flat_buffer b;
+            request_parser<string_body> p;
+            p.body_limit(body.size());
+            error_code ec;
+            read(ts, b, p, ec);
+            BEAST_EXPECTS(ec == error::partial_message, ec.message());
+        }
+        {
+            // asynchronous
+            net::io_context ioc;
+            test::stream ts{ioc};
+            ostream(ts.buffer()) <<
+                "POST / HTTP/1.1\r\n"
+                "Content-Length: " << body.size() << "\r\n"
+                "\r\n" << body;
+            flat_buffer b;
+            request_parser<vector_body<char>> p;
+            p.body_limit(body.size());
+            error_code result = test::error::test_failure;
+            std::size_t n = 0;
+            async_read(ts, b, p,
+                [&](error_code ec, std::size_t bytes_transferred)
+                {
+                    result = ec;
+                    n = bytes_transferred;
+                });
+            ioc.run();
+            BEAST_EXPECTS(! result, result.message());
+            BEAST_EXPECT(p.is_done());
+            BEAST_EXPECT(std::string(p.get().body().begin(),
+                p.get().body().end()) == body);
+            BEAST_EXPECT(b.capacity() <= 1024);
+            BEAST_EXPECT(n > body.size());
+        }
+    }
+
     //--------------------------------------------------------------------------
 
     template<class Parser, class Pred>
@@ -553,6 +909,9 @@ public:
 
         testIoService();
         testRegression430();
+        testProtocol();
+        testReadSizeHint();
+        testReadDirect();
         testReadGrind();
         testAsioHandlerInvoke();
     }
@@ -10,7 +10,9 @@
 // Test that header file is self-contained.
 #include <boost/beast/http/serializer.hpp>
 
+#include <boost/beast/http/buffer_body.hpp>
 #include <boost/beast/http/string_body.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 
 namespace boost {
@@ -115,10 +117,139 @@ public:
         }
     }
 
+    struct append_lambda
+    {
+        std::string& s;
+        std::size_t size;
+
+        template<class ConstBufferSequence>
+        void
+        operator()(error_code&,
+            ConstBufferSequence const& buffers)
+        {
+            size = net::buffer_size(buffers);
+            s.append(buffers_to_string(buffers));
+        }
+    };
+
+    // Serialize until the body needs another buffer
+    template<class Serializer>
+    void
+    drain(Serializer& sr, std::string& s)
+    {
+        error_code ec;
+        append_lambda visit{s, 0};
+        while(! sr.is_done())
+        {
+            sr.next(ec, visit);
+            if(ec == error::need_buffer)
+                return;
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            sr.consume(visit.size);
+        }
+    }
+
+    void
+    testCoalesce()
+    {
+        // small pieces are accumulated into larger chunks
+        {
+            std::string s;
+            char buf[] = "0123456789";
+            response<buffer_body> res;
+            res.chunked(true);
+            serializer<false, buffer_body> sr{res};
+            sr.coalesce(25);
+            for(int i = 0; i < 10; ++i)
+            {
+                res.body().data = buf;
+                res.body().size = 10;
+                res.body().more = true;
+                drain(sr, s);
+            }
+            res.body().data = nullptr;
+            res.body().more = false;
+            drain(sr, s);
+            BEAST_EXPECT(sr.is_done());
+            auto const pos = s.find("\r\n\r\n");
+            BEAST_EXPECT(pos != std::string::npos);
+            BEAST_EXPECT(s.substr(pos + 4) ==
+                "1e\r\n" + std::string(
+                    "012345678901234567890123456789") + "\r\n"
+                "1e\r\n" + std::string(
+                    "012345678901234567890123456789") + "\r\n"
+                "1e\r\n" + std::string(
+                    "012345678901234567890123456789") + "\r\n"
+                "a\r\n" "0123456789" "\r\n"
+                "0\r\n\r\n");
+        }
+
+        // flush emits retained octets immediately
+        {
+            std::string s;
+            char buf[] = "data";
+            response<buffer_body> res;
+            res.chunked(true);
+            serializer<false, buffer_body> sr{res};
+            sr.coalesce(1000);
+            for(int i = 0; i < 3; ++i)
+            {
+                res.body().data = buf;
+                res.body().size = 4;
+                res.body().more = true;
+                sr.flush();
+                drain(sr, s);
+            }
+            auto const pos = s.find("\r\n\r\n");
+            BEAST_EXPECT(pos != std::string::npos);
+            BEAST_EXPECT(s.substr(pos + 4) ==
+                "4\r\ndata\r\n"
+                "4\r\ndata\r\n"
+                "4\r\ndata\r\n");
+            res.body().data = nullptr;
+            res.body().more = false;
+            drain(sr, s);
+            BEAST_EXPECT(sr.is_done());
+            BEAST_EXPECT(s.substr(s.size() - 5) == "0\r\n\r\n");
+        }
+
+        // the final chunk and the last-chunk are combined
+        {
+            std::string s;
+            response<string_body> res;
+            res.body() = "Hello, world!";
+            res.chunked(true);
+            serializer<false, string_body> sr{res};
+            sr.coalesce(4096);
+            drain(sr, s);
+            BEAST_EXPECT(sr.is_done());
+            auto const pos = s.find("\r\n\r\n");
+            BEAST_EXPECT(pos != std::string::npos);
+            BEAST_EXPECT(s.substr(pos + 4) ==
+                "d\r\nHello, world!\r\n0\r\n\r\n");
+        }
+
+        // empty body
+        {
+            std::string s;
+            response<string_body> res;
+            res.chunked(true);
+            serializer<false, string_body> sr{res};
+            sr.coalesce(4096);
+            drain(sr, s);
+            BEAST_EXPECT(sr.is_done());
+            auto const pos = s.find("\r\n\r\n");
+            BEAST_EXPECT(pos != std::string::npos);
+            BEAST_EXPECT(s.substr(pos + 4) == "0\r\n\r\n");
+        }
+    }
+
     void
     run() override
     {
         testWriteLimit();
+        testCoalesce();
     }
 };
 
@@ -151,6 +151,29 @@ struct not_fields {};
 
 BOOST_STATIC_ASSERT(! is_fields<not_fields>::value);
 
+// Protocol
+
+namespace {
+
+// a framing decision which is not a constant expression
+struct runtime_protocol : protocol
+{
+    static bool accept_chunked()
+    {
+        return true;
+    }
+};
+
+} // (anonymous)
+
+BOOST_STATIC_ASSERT(is_protocol<protocol>::value);
+
+BOOST_STATIC_ASSERT(! is_protocol<int>::value);
+
+BOOST_STATIC_ASSERT(! is_protocol<not_fields>::value);
+
+BOOST_STATIC_ASSERT(! is_protocol<runtime_protocol>::value);
+
 } // http
 } // beast
 } // boost
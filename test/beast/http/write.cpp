@@ -16,6 +16,7 @@
 #include <boost/beast/http/message.hpp>
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/string_body.hpp>
+#include <boost/beast/sip/message.hpp>
 #include <boost/beast/core/buffers_to_string.hpp>
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
@@ -500,6 +501,36 @@ public:
         BEAST_EXPECT(n < limit);
     }
 
+    void
+    testProtocol()
+    {
+        // SIP over a stream transport
+        sip::tcp_response<string_body> m;
+        m.result(status::ok);
+        m.version(20);
+        m.set(field::call_id, "abc");
+        m.body() = "v=0\r\n";
+        m.prepare_payload();
+        BEAST_EXPECT(str(m) ==
+            "SIP/2.0 200 OK\r\n"
+            "Call-ID: abc\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "v=0\r\n");
+
+        test::stream ts{ioc_}, tr{ioc_};
+        ts.connect(tr);
+        serializer<false, string_body, sip::tcp_fields> sr{m};
+        error_code ec;
+        write_header(ts, sr, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(sr.is_header_done());
+        write(ts, sr, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(sr.is_done());
+        BEAST_EXPECT(tr.str() == str(m));
+    }
+
     void
     testOutput()
     {
@@ -1009,6 +1040,7 @@ public:
                 testFailures(yield);
             });
         testOutput();
+        testProtocol();
         test_std_ostream();
         testIoService();
         yield_to(
@@ -0,0 +1,211 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/sip/batch.hpp>
+
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/sip/message.hpp>
+#include <boost/beast/sip/parser.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/optional.hpp>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+class batch_test : public beast::unit_test::suite
+{
+public:
+    using udp = net::ip::udp;
+
+    using socket_type = net::basic_datagram_socket<
+        udp, net::io_context::executor_type>;
+
+    using parser_type =
+        udp_parser<true, http::string_body>;
+
+    static
+    udp_request<http::string_body>
+    make_request(std::string const& call_id)
+    {
+        udp_request<http::string_body> req;
+        req.method_string("OPTIONS");
+        req.target("sip:bob@example.com");
+        req.version(20);
+        req.set(http::field::call_id, call_id);
+        req.body() = "*";
+        req.prepare_payload();
+        return req;
+    }
+
+    void
+    add(datagram_batch& b,
+        udp_request<http::string_body> const& req,
+        udp::endpoint const& ep)
+    {
+        error_code ec;
+        serialize_datagram(b, req, ep, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+    }
+
+    void
+    testBatch()
+    {
+        udp::endpoint const ep{
+            net::ip::address_v4::loopback(), 5060};
+        datagram_batch b{2, 128};
+        BEAST_EXPECT(b.capacity() == 2);
+        BEAST_EXPECT(b.buffer_size() == 128);
+        BEAST_EXPECT(b.empty());
+
+        error_code ec;
+        serialize_datagram(b, make_request("1"), ep, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(b.size() == 1);
+        BEAST_EXPECT(b.endpoint(0) == ep);
+        BEAST_EXPECT(! b.truncated(0));
+
+        parser_type p;
+        parse_datagram(p, b.data(0), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(p.get()[http::field::call_id] == "1");
+
+        // too large for the buffer of one datagram
+        auto req = make_request("2");
+        req.body() = std::string(128, '*');
+        req.prepare_payload();
+        serialize_datagram(b, req, ep, ec);
+        BEAST_EXPECTS(ec == http::error::buffer_overflow, ec.message());
+        BEAST_EXPECT(b.size() == 1);
+
+        serialize_datagram(b, make_request("2"), ep, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(b.full());
+
+        b.clear();
+        BEAST_EXPECT(b.empty());
+    }
+
+    // Receive `count` datagrams, which may take more than one batch
+    std::vector<std::string>
+    receive_all(socket_type& s, datagram_batch& b, std::size_t count)
+    {
+        std::vector<std::string> v;
+        boost::optional<parser_type> p;
+        while(v.size() < count)
+        {
+            auto const n = receive_batch(s, b);
+            BEAST_EXPECT(n > 0 && n == b.size());
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                error_code ec;
+                p.emplace();
+                parse_datagram(*p, b.data(i), ec);
+                BEAST_EXPECTS(! ec, ec.message());
+                v.emplace_back(p->get()[http::field::call_id]);
+            }
+        }
+        return v;
+    }
+
+    void
+    testSocket()
+    {
+        net::io_context ioc;
+        socket_type s0{ioc, udp::endpoint{
+            net::ip::address_v4::loopback(), 0}};
+        socket_type s1{ioc, udp::endpoint{
+            net::ip::address_v4::loopback(), 0}};
+
+        // synchronous, more datagrams than fit in one batch
+        {
+            datagram_batch b0{100};
+            for(int i = 0; i < 100; ++i)
+                add(b0, make_request(
+                    std::to_string(i)), s1.local_endpoint());
+            BEAST_EXPECT(send_batch(s0, b0) == 100);
+
+            datagram_batch b1{16};
+            auto const v = receive_all(s1, b1, 100);
+            BEAST_EXPECT(v.size() == 100);
+            for(std::size_t i = 0; i < v.size(); ++i)
+                BEAST_EXPECT(v[i] == std::to_string(i));
+            BEAST_EXPECT(b1.endpoint(0) == s0.local_endpoint());
+        }
+
+        // truncated datagram
+        {
+            datagram_batch b0{1};
+            auto req = make_request("1");
+            req.body() = std::string(200, '*');
+            req.prepare_payload();
+            add(b0, req, s1.local_endpoint());
+            send_batch(s0, b0);
+
+            datagram_batch b1{4, 64};
+            BEAST_EXPECT(receive_batch(s1, b1) == 1);
+        #if BOOST_BEAST_SIP_USE_MMSG
+            BEAST_EXPECT(b1.truncated(0));
+        #endif
+            BEAST_EXPECT(b1.data(0).size() <= 64);
+        }
+
+        // asynchronous
+        {
+            datagram_batch b0{8};
+            for(int i = 0; i < 8; ++i)
+                add(b0, make_request(
+                    std::to_string(i)), s1.local_endpoint());
+            datagram_batch b1{8};
+            error_code ec0 = http::error::need_more;
+            error_code ec1 = http::error::need_more;
+            std::size_t n0 = 0;
+            std::size_t n1 = 0;
+            async_receive_batch(s1, b1,
+                [&](error_code ec, std::size_t n)
+                {
+                    ec1 = ec;
+                    n1 = n;
+                });
+            async_send_batch(s0, b0,
+                [&](error_code ec, std::size_t n)
+                {
+                    ec0 = ec;
+                    n0 = n;
+                });
+            ioc.run();
+            BEAST_EXPECTS(! ec0, ec0.message());
+            BEAST_EXPECTS(! ec1, ec1.message());
+            BEAST_EXPECT(n0 == 8);
+            BEAST_EXPECT(n1 > 0 && n1 == b1.size());
+
+            // the descriptor is now non-blocking
+            auto const v = receive_all(s1, b1, 8 - n1);
+            BEAST_EXPECT(n1 + v.size() == 8);
+        }
+    }
+
+    void
+    run() override
+    {
+        testBatch();
+        testSocket();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,sip,batch);
+
+} // sip
+} // beast
+} // boost
@@ -0,0 +1,298 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/sip/connection.hpp>
+
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/sip/message.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <functional>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+class connection_test : public beast::unit_test::suite
+{
+public:
+    using connection_type =
+        basic_connection<test::stream>;
+
+    static
+    tcp_request<http::string_body>
+    make_request(string_view call_id)
+    {
+        tcp_request<http::string_body> req;
+        req.method_string("OPTIONS");
+        req.target("sip:bob@biloxi.com");
+        req.version(20);
+        req.set(http::field::call_id, call_id);
+        req.set(http::field::cseq, "1 OPTIONS");
+        req.body() = "*";
+        req.prepare_payload();
+        return req;
+    }
+
+    void
+    testHistogram()
+    {
+        using duration = latency_histogram::duration;
+        latency_histogram h;
+        BEAST_EXPECT(h.count() == 0);
+        BEAST_EXPECT(h.percentile(50) == duration(0));
+
+        h.record(duration(0));
+        h.record(duration(1));
+        h.record(duration(3));
+        h.record(duration(4));
+        h.record(duration(1000));
+        BEAST_EXPECT(h.count() == 5);
+        BEAST_EXPECT(h.bucket(0) == 1);
+        BEAST_EXPECT(h.bucket(1) == 1);
+        BEAST_EXPECT(h.bucket(2) == 1);
+        BEAST_EXPECT(h.bucket(3) == 1);
+        BEAST_EXPECT(h.bucket(10) == 1);
+        BEAST_EXPECT(h.upper_bound(0) == duration(1));
+        BEAST_EXPECT(h.upper_bound(10) == duration(1024));
+        BEAST_EXPECT(h.percentile(0) == duration(1));
+        BEAST_EXPECT(h.percentile(50) == duration(4));
+        BEAST_EXPECT(h.percentile(80) == duration(8));
+        BEAST_EXPECT(h.percentile(100) == duration(1024));
+
+        // longer latencies are in the last bucket
+        h.record(duration(-1));
+        h.record(std::chrono::hours(24));
+        BEAST_EXPECT(h.bucket(0) == 2);
+        BEAST_EXPECT(h.bucket(latency_histogram::bucket_count - 1) == 1);
+
+        h.clear();
+        BEAST_EXPECT(h.count() == 0);
+        BEAST_EXPECT(h.bucket(0) == 0);
+    }
+
+    void
+    testRead()
+    {
+        net::io_context ioc;
+        auto c = std::make_shared<connection_type>(ioc);
+
+        // several messages and keep-alives in one segment
+        c->next_layer().append(
+            "\r\n\r\n"
+            "OPTIONS sip:bob@biloxi.com SIP/2.0\r\n"
+            "Call-ID: 1\r\n"
+            "Content-Length: 1\r\n"
+            "\r\n"
+            "*"
+            "\r\n"
+            "SIP/2.0 200 OK\r\n"
+            "i: 2\r\n"
+            "l: 0\r\n"
+            "\r\n"
+            "BYE sip:bob@biloxi.com SIP/2.0\r\n"
+            "Call-ID: 3\r\n"
+            "Content-Length: 0\r\n"
+            "\r\n"
+            "\r\n");
+        c->next_layer().close_remote();
+
+        std::string log;
+        std::function<void(error_code, std::size_t)> on_read;
+        on_read =
+            [&](error_code ec, std::size_t)
+            {
+                if(ec)
+                {
+                    BEAST_EXPECTS(ec == http::error::end_of_stream,
+                        ec.message());
+                    return;
+                }
+                if(c->is_request())
+                    log += c->request().method_string().to_string() +
+                        " " + c->request()[http::field::call_id].to_string() +
+                        " " + c->request().body() + ";";
+                else
+                    log += std::to_string(c->response().result_int()) +
+                        " " + c->response()[http::field::call_id].to_string() + ";";
+                c->async_read(on_read);
+            };
+        c->async_read(on_read);
+        ioc.run();
+        BEAST_EXPECTS(log == "OPTIONS 1 *;200 2;BYE 3 ;", log);
+        BEAST_EXPECT(! c->is_open());
+        BEAST_EXPECT(c->error() == http::error::end_of_stream);
+
+        // a message cut short
+        {
+            auto c1 = std::make_shared<connection_type>(ioc);
+            c1->next_layer().append("SIP/2.0 200 OK\r\n");
+            c1->next_layer().close_remote();
+            error_code ec1;
+            c1->async_read(
+                [&](error_code ec, std::size_t)
+                {
+                    ec1 = ec;
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECTS(ec1 == http::error::partial_message,
+                ec1.message());
+            BEAST_EXPECT(! c1->is_open());
+        }
+        {
+            auto c1 = std::make_shared<connection_type>(ioc);
+            c1->next_layer().append("SIP");
+            c1->next_layer().close_remote();
+            error_code ec1;
+            c1->async_read(
+                [&](error_code ec, std::size_t)
+                {
+                    ec1 = ec;
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECTS(ec1 == http::error::partial_message,
+                ec1.message());
+        }
+    }
+
+    void
+    testSend()
+    {
+        net::io_context ioc;
+        auto c = std::make_shared<connection_type>(ioc);
+        test::stream remote{ioc};
+        c->next_layer().connect(remote);
+
+        // a burst of messages is written at once
+        for(int i = 0; i < 10; ++i)
+            c->send(make_request(std::to_string(i)));
+        BEAST_EXPECT(c->queue_depth() == 10);
+        BEAST_EXPECT(c->queue_size() > 0);
+        ioc.run();
+        BEAST_EXPECT(c->queue_depth() == 0);
+        BEAST_EXPECT(c->queue_size() == 0);
+        BEAST_EXPECT(c->latency().count() == 10);
+        BEAST_EXPECT(c->next_layer().nwrite() == 1);
+
+        // the messages read back in order
+        std::string expected;
+        for(int i = 0; i < 10; ++i)
+            expected +=
+                "OPTIONS sip:bob@biloxi.com SIP/2.0\r\n"
+                "Call-ID: " + std::to_string(i) + "\r\n"
+                "CSeq: 1 OPTIONS\r\n"
+                "Content-Length: 1\r\n"
+                "\r\n"
+                "*";
+        BEAST_EXPECT(remote.str() == expected);
+
+        // messages sent during a write are written next
+        remote.clear();
+        c->send(make_request("a"));
+        net::post(ioc,
+            [&]
+            {
+                c->send(make_request("b"));
+                c->send(make_request("c"));
+            });
+        ioc.restart();
+        ioc.run();
+        BEAST_EXPECT(c->queue_depth() == 0);
+        BEAST_EXPECT(c->latency().count() == 13);
+        BEAST_EXPECT(remote.str().find("Call-ID: a") <
+            remote.str().find("Call-ID: c"));
+        c->clear_latency();
+        BEAST_EXPECT(c->latency().count() == 0);
+
+        // a failed write fails the connection
+        auto c1 = std::make_shared<connection_type>(ioc);
+        c1->send(make_request("d"));
+        ioc.restart();
+        ioc.run();
+        BEAST_EXPECT(! c1->is_open());
+        BEAST_EXPECT(c1->error() == net::error::connection_reset);
+        BEAST_EXPECT(c1->queue_depth() == 0);
+        BEAST_EXPECT(c1->latency().count() == 0);
+        error_code ec;
+        c1->send(make_request("e"), ec);
+        BEAST_EXPECT(ec == net::error::connection_reset);
+        BEAST_EXPECT(c1->queue_depth() == 0);
+        try
+        {
+            c1->send(make_request("f"));
+            fail("", __FILE__, __LINE__);
+        }
+        catch(system_error const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testPool()
+    {
+        net::io_context ioc;
+        connection_pool<connection_type, std::string> pool;
+        BEAST_EXPECT(pool.size() == 0);
+        BEAST_EXPECT(! pool.find("a"));
+
+        auto a = pool.emplace("a", ioc);
+        auto b = pool.emplace("b", ioc);
+        BEAST_EXPECT(pool.size() == 2);
+        BEAST_EXPECT(pool.find("a") == a);
+        BEAST_EXPECT(pool.find("b") == b);
+
+        // a new connection replaces the old
+        auto a1 = pool.emplace("a", ioc);
+        BEAST_EXPECT(pool.size() == 2);
+        BEAST_EXPECT(pool.find("a") == a1);
+
+        std::size_t depth = 0;
+        pool.for_each(
+            [&](std::string const&,
+                std::shared_ptr<connection_type> const& c)
+            {
+                depth += c->queue_depth();
+            });
+        BEAST_EXPECT(depth == 0);
+
+        // a failed connection is removed
+        b->next_layer().close_remote();
+        b->async_read([](error_code, std::size_t){});
+        ioc.run();
+        BEAST_EXPECT(! b->is_open());
+        BEAST_EXPECT(! pool.find("b"));
+        BEAST_EXPECT(pool.size() == 1);
+
+        BEAST_EXPECT(pool.erase("a"));
+        BEAST_EXPECT(! pool.erase("a"));
+        BEAST_EXPECT(pool.size() == 0);
+    }
+
+    void
+    run() override
+    {
+        testHistogram();
+        testRead();
+        testSend();
+        testPool();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,sip,connection);
+
+} // sip
+} // beast
+} // boost
@@ -0,0 +1,242 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/sip/datagram.hpp>
+
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/sip/message.hpp>
+#include <boost/beast/sip/parser.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+class datagram_test : public beast::unit_test::suite
+{
+public:
+    using parser_type =
+        udp_parser<true, http::string_body>;
+
+    static
+    std::string
+    to_string(net::const_buffer b)
+    {
+        return std::string(
+            static_cast<char const*>(b.data()), b.size());
+    }
+
+    void
+    parse(string_view s, parser_type& p, error_code& ec)
+    {
+        parse_datagram(p, net::const_buffer(
+            s.data(), s.size()), ec);
+    }
+
+    void
+    testParse()
+    {
+        // body ends at the end of the datagram
+        {
+            parser_type p;
+            error_code ec;
+            parse(
+                "MESSAGE sip:bob@example.com SIP/2.0\r\n"
+                "i: abc\r\n"
+                "\r\n"
+                "hello", p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.is_done());
+            BEAST_EXPECT(p.get()[http::field::call_id] == "abc");
+            BEAST_EXPECT(p.get().body() == "hello");
+        }
+        // octets beyond the Content-Length are discarded
+        {
+            parser_type p;
+            error_code ec;
+            parse(
+                "MESSAGE sip:bob@example.com SIP/2.0\r\n"
+                "l: 3\r\n"
+                "\r\n"
+                "hello", p, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body() == "hel");
+        }
+        // datagram ends before the body
+        {
+            parser_type p;
+            error_code ec;
+            parse(
+                "MESSAGE sip:bob@example.com SIP/2.0\r\n"
+                "l: 10\r\n"
+                "\r\n"
+                "hello", p, ec);
+            BEAST_EXPECTS(ec == http::error::partial_message, ec.message());
+        }
+        // datagram ends in the header
+        {
+            parser_type p;
+            error_code ec;
+            parse(
+                "MESSAGE sip:bob@example.com SIP/2.0\r\n"
+                "i: abc\r\n", p, ec);
+            BEAST_EXPECTS(ec == http::error::partial_message, ec.message());
+        }
+        // empty datagram
+        {
+            parser_type p;
+            error_code ec;
+            parse("", p, ec);
+            BEAST_EXPECTS(ec == http::error::partial_message, ec.message());
+        }
+        // body limit of the datagram protocol
+        {
+            std::string const s =
+                "MESSAGE sip:bob@example.com SIP/2.0\r\n"
+                "\r\n" + std::string(65535 - 200 + 1, '*');
+            parser_type p;
+            error_code ec;
+            parse(s, p, ec);
+            BEAST_EXPECTS(ec == http::error::body_limit, ec.message());
+        }
+    }
+
+    void
+    testSerialize()
+    {
+        udp_request<http::string_body> req;
+        req.method_string("MESSAGE");
+        req.target("sip:bob@example.com");
+        req.version(20);
+        req.set(http::field::call_id, "abc");
+        req.set(http::field::via, "SIP/2.0/UDP host");
+        req.body() = "hello";
+        req.prepare_payload();
+        datagram_buffer b;
+        error_code ec;
+        serialize_datagram(b, req, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECTS(to_string(b.data()) ==
+            "MESSAGE sip:bob@example.com SIP/2.0\r\n"
+            "i: abc\r\n"
+            "v: SIP/2.0/UDP host\r\n"
+            "l: 5\r\n"
+            "\r\n"
+            "hello", to_string(b.data()));
+
+        // round trip
+        parser_type p;
+        parse_datagram(p, b.data(), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(p.get()[http::field::via] == "SIP/2.0/UDP host");
+        BEAST_EXPECT(p.get().body() == "hello");
+
+        // too large for a datagram
+        req.body() = std::string(datagram_buffer::max_size, '*');
+        req.prepare_payload();
+        serialize_datagram(b, req, ec);
+        BEAST_EXPECTS(ec == http::error::buffer_overflow, ec.message());
+    }
+
+    void
+    testSocket()
+    {
+        net::io_context ioc;
+        using udp = net::ip::udp;
+        using socket_type = net::basic_datagram_socket<
+            udp, net::io_context::executor_type>;
+        socket_type s0{ioc, udp::endpoint{
+            net::ip::address_v4::loopback(), 0}};
+        socket_type s1{ioc, udp::endpoint{
+            net::ip::address_v4::loopback(), 0}};
+
+        udp_request<http::string_body> req;
+        req.method_string("OPTIONS");
+        req.target("sip:bob@example.com");
+        req.version(20);
+        req.set(http::field::call_id, "1");
+        req.body() = "*";
+        req.prepare_payload();
+
+        datagram_buffer b0;
+        datagram_buffer b1;
+        udp::endpoint sender;
+
+        // synchronous
+        {
+            auto const n = send_message(
+                s0, b0, req, s1.local_endpoint());
+            parser_type p;
+            BEAST_EXPECT(receive_message(
+                s1, b1, p, sender) == n);
+            BEAST_EXPECT(sender == s0.local_endpoint());
+            BEAST_EXPECT(p.get()[http::field::call_id] == "1");
+            BEAST_EXPECT(p.get().body() == "*");
+        }
+
+        // asynchronous
+        {
+            parser_type p;
+            error_code ec0 = http::error::need_more;
+            error_code ec1 = http::error::need_more;
+            async_receive_message(s1, b1, p, sender,
+                [&](error_code ec, std::size_t)
+                {
+                    ec1 = ec;
+                });
+            req.set(http::field::call_id, "2");
+            async_send_message(s0, b0, req, s1.local_endpoint(),
+                [&](error_code ec, std::size_t)
+                {
+                    ec0 = ec;
+                });
+            ioc.run();
+            BEAST_EXPECTS(! ec0, ec0.message());
+            BEAST_EXPECTS(! ec1, ec1.message());
+            BEAST_EXPECT(p.get()[http::field::call_id] == "2");
+        }
+
+        // serialization failure is reported to the handler
+        {
+            req.body() = std::string(datagram_buffer::max_size, '*');
+            req.prepare_payload();
+            error_code ec0;
+            bool invoked = false;
+            async_send_message(s0, b0, req, s1.local_endpoint(),
+                [&](error_code ec, std::size_t)
+                {
+                    invoked = true;
+                    ec0 = ec;
+                });
+            BEAST_EXPECT(! invoked);
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECTS(ec0 == http::error::buffer_overflow, ec0.message());
+        }
+    }
+
+    void
+    run() override
+    {
+        testParse();
+        testSerialize();
+        testSocket();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,sip,datagram);
+
+} // sip
+} // beast
+} // boost
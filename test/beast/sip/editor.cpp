@@ -0,0 +1,289 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/sip/editor.hpp>
+
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/sip/datagram.hpp>
+#include <boost/beast/sip/parser.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+class editor_test : public beast::unit_test::suite
+{
+public:
+    static
+    std::string
+    str(message_editor const& e)
+    {
+        return buffers_to_string(e.buffers());
+    }
+
+    static
+    net::const_buffer
+    buf(string_view s)
+    {
+        return {s.data(), s.size()};
+    }
+
+    // Returns `true` if the edited message parses
+    bool
+    parses(message_editor const& e)
+    {
+        auto const s = str(e);
+        udp_parser<true, http::string_body> p;
+        error_code ec;
+        parse_datagram(p, buf(s), ec);
+        return BEAST_EXPECTS(! ec, ec.message()) &&
+            BEAST_EXPECT(p.is_done());
+    }
+
+    void
+    testReset()
+    {
+        message_editor e;
+        error_code ec;
+
+        e.reset(buf(
+            "INVITE sip:bob@biloxi.com SIP/2.0\r\n"
+            "\r\n"), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(e.is_request());
+        BEAST_EXPECT(e.target() == "sip:bob@biloxi.com");
+        BEAST_EXPECT(! e.pop_via());
+
+        e.reset(buf(
+            "SIP/2.0 200 OK\r\n"
+            "\r\n"), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(! e.is_request());
+        BEAST_EXPECT(e.target().empty());
+
+        e.reset(buf("INVITE sip:bob@biloxi.com SIP/2.0\r\n"), ec);
+        BEAST_EXPECT(ec == http::error::partial_message);
+        e.reset(buf("INVITE sip:bob@biloxi.com SIP/2.0\r\nVia: x\r\n"), ec);
+        BEAST_EXPECT(ec == http::error::partial_message);
+        e.reset(buf("INVITE SIP/2.0\r\n\r\n"), ec);
+        BEAST_EXPECT(ec == http::error::bad_target);
+        e.reset(buf("INVITE sip:a@b.com SIP/2.0\r\n x\r\n\r\n"), ec);
+        BEAST_EXPECT(ec == http::error::bad_field);
+        e.reset(buf("INVITE sip:a@b.com SIP/2.0\r\nVia x\r\n\r\n"), ec);
+        BEAST_EXPECT(ec == http::error::bad_field);
+    }
+
+    void
+    testRequest()
+    {
+        string_view const m =
+            "INVITE sip:bob@biloxi.com SIP/2.0\r\n"
+            "Via: SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+            "Max-Forwards: 70\r\n"
+            "To: Bob <sip:bob@biloxi.com>\r\n"
+            "From: Alice <sip:alice@atlanta.com>;tag=1928301774\r\n"
+            "Call-ID: a84b4c76e66710@pc33.atlanta.com\r\n"
+            "CSeq: 314159 INVITE\r\n"
+            "Content-Length: 4\r\n"
+            "\r\n"
+            "v=0\n";
+        message_editor e;
+        error_code ec;
+        e.reset(buf(m), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+
+        // no edits
+        BEAST_EXPECT(str(e) == m);
+        BEAST_EXPECT(e.size() == m.size());
+
+        BEAST_EXPECT(e.decrement_max_forwards());
+        e.push_via("SIP/2.0/UDP bigbox3.site3.atlanta.com;branch=z9hG4bK77ef4c2312983.1");
+        e.set_target("sip:bob@192.0.2.4");
+        auto const s = str(e);
+        BEAST_EXPECT(s ==
+            "INVITE sip:bob@192.0.2.4 SIP/2.0\r\n"
+            "Via: SIP/2.0/UDP bigbox3.site3.atlanta.com;branch=z9hG4bK77ef4c2312983.1\r\n"
+            "Via: SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+            "Max-Forwards: 69\r\n"
+            "To: Bob <sip:bob@biloxi.com>\r\n"
+            "From: Alice <sip:alice@atlanta.com>;tag=1928301774\r\n"
+            "Call-ID: a84b4c76e66710@pc33.atlanta.com\r\n"
+            "CSeq: 314159 INVITE\r\n"
+            "Content-Length: 4\r\n"
+            "\r\n"
+            "v=0\n");
+        BEAST_EXPECT(e.size() == s.size());
+        BEAST_EXPECT(parses(e));
+
+        // repeating an edit replaces it
+        e.set_target("sip:bob@biloxi.com");
+        BEAST_EXPECT(str(e).substr(0, 35) ==
+            "INVITE sip:bob@biloxi.com SIP/2.0\r\n");
+
+        // a new message discards the edits
+        e.reset(buf(m), ec);
+        BEAST_EXPECT(str(e) == m);
+    }
+
+    void
+    testMaxForwards()
+    {
+        message_editor e;
+        error_code ec;
+        auto const check =
+            [&](string_view value, string_view result)
+            {
+                std::string m =
+                    "OPTIONS sip:a@b.com SIP/2.0\r\n"
+                    "Max-Forwards:";
+                m.append(value.data(), value.size());
+                m += "\r\nContent-Length: 0\r\n\r\n";
+                e.reset(buf(m), ec);
+                if(! BEAST_EXPECTS(! ec, ec.message()))
+                    return;
+                if(result.empty())
+                {
+                    BEAST_EXPECT(! e.decrement_max_forwards());
+                    BEAST_EXPECT(str(e) == m);
+                    return;
+                }
+                BEAST_EXPECT(e.decrement_max_forwards());
+                std::string r =
+                    "OPTIONS sip:a@b.com SIP/2.0\r\n"
+                    "Max-Forwards:";
+                r.append(result.data(), result.size());
+                r += "\r\nContent-Length: 0\r\n\r\n";
+                BEAST_EXPECTS(str(e) == r, str(e));
+            };
+        check(" 70", " 69");
+        check(" 10", " 9");
+        check("1 ", "0 ");
+        check(" \t 255\t", " \t 254\t");
+        check(" 0", "");
+        check(" 00", "");
+        check(" x", "");
+        check(" -1", "");
+        check(" 1 2", "");
+        check("", "");
+        check(" 1234567890", "");
+
+        // absent
+        string_view const m =
+            "OPTIONS sip:a@b.com SIP/2.0\r\n"
+            "Content-Length: 0\r\n"
+            "\r\n";
+        e.reset(buf(m), ec);
+        BEAST_EXPECT(e.decrement_max_forwards());
+        BEAST_EXPECT(str(e) ==
+            "OPTIONS sip:a@b.com SIP/2.0\r\n"
+            "Content-Length: 0\r\n"
+            "Max-Forwards: 70\r\n"
+            "\r\n");
+        BEAST_EXPECT(parses(e));
+    }
+
+    void
+    testPopVia()
+    {
+        message_editor e;
+        error_code ec;
+        via_parm v;
+
+        // the only via-parm of the first field
+        e.reset(buf(
+            "SIP/2.0 200 OK\r\n"
+            "v: SIP/2.0/UDP proxy.example.com;branch=z9hG4bK4b43c2ff8.1\r\n"
+            "Via: SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+            "l: 0\r\n"
+            "\r\n"), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(e.pop_via(v));
+        BEAST_EXPECT(v.host == "proxy.example.com");
+        BEAST_EXPECT(v.branch == "z9hG4bK4b43c2ff8.1");
+        BEAST_EXPECT(str(e) ==
+            "SIP/2.0 200 OK\r\n"
+            "Via: SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+            "l: 0\r\n"
+            "\r\n");
+
+        // the first of several via-parms
+        e.reset(buf(
+            "SIP/2.0 200 OK\r\n"
+            "Call-ID: a84b4c76e66710\r\n"
+            "Via: SIP/2.0/UDP proxy.example.com;branch=z9hG4bK4b43c2ff8.1 ,\r\n"
+            "  SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+            "\r\n"), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(e.pop_via(v));
+        BEAST_EXPECT(v.host == "proxy.example.com");
+        BEAST_EXPECT(str(e) ==
+            "SIP/2.0 200 OK\r\n"
+            "Call-ID: a84b4c76e66710\r\n"
+            "Via: \r\n"
+            "  SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+            "\r\n");
+        e.reset(buf(
+            "SIP/2.0 200 OK\r\n"
+            "Call-ID: a84b4c76e66710\r\n"
+            "Via: SIP/2.0/UDP proxy.example.com;branch=z9hG4bK4b43c2ff8.1 , "
+                "SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+            "\r\n"), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(e.pop_via(v));
+        BEAST_EXPECT(v.branch == "z9hG4bK4b43c2ff8.1");
+        BEAST_EXPECT(str(e) ==
+            "SIP/2.0 200 OK\r\n"
+            "Call-ID: a84b4c76e66710\r\n"
+            "Via: SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+            "\r\n");
+
+        // malformed
+        e.reset(buf(
+            "SIP/2.0 200 OK\r\n"
+            "Via: SIP/2.0/UDP\r\n"
+            "\r\n"), ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(! e.pop_via(v));
+
+        // pop and push together
+        string_view const m =
+            "SIP/2.0 200 OK\r\n"
+            "Via: SIP/2.0/UDP a.example.com;branch=z9hG4bK1\r\n"
+            "\r\n";
+        e.reset(buf(m), ec);
+        e.push_via("SIP/2.0/UDP b.example.com;branch=z9hG4bK2");
+        BEAST_EXPECT(e.pop_via(v));
+        BEAST_EXPECT(e.decrement_max_forwards());
+        BEAST_EXPECT(str(e) ==
+            "SIP/2.0 200 OK\r\n"
+            "Via: SIP/2.0/UDP b.example.com;branch=z9hG4bK2\r\n"
+            "Max-Forwards: 70\r\n"
+            "\r\n");
+        BEAST_EXPECT(e.size() == str(e).size());
+    }
+
+    void
+    run() override
+    {
+        testReset();
+        testRequest();
+        testMaxForwards();
+        testPopVia();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,sip,editor);
+
+} // sip
+} // beast
+} // boost
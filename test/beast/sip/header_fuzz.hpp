@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_SIP_TEST_HEADER_FUZZ_HPP
+#define BOOST_BEAST_SIP_TEST_HEADER_FUZZ_HPP
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+// Produces random SIP field values, remembering the
+// parts of the last value so that a parser can be checked.
+//
+template<class = void>
+class header_fuzz_t
+{
+    std::mt19937 rng_;
+
+public:
+    struct via_info
+    {
+        std::string transport;
+        std::string host;
+        std::uint16_t port = 0;
+        std::string branch;
+    };
+
+    struct name_addr_info
+    {
+        std::string display_name;
+        std::string uri;
+        std::string tag;
+    };
+
+    template<class UInt = std::size_t>
+    UInt
+    rand(std::size_t n)
+    {
+        return static_cast<UInt>(
+            std::uniform_int_distribution<
+                std::size_t>{0, n-1}(rng_));
+    }
+
+    std::string
+    lws()
+    {
+        std::string s;
+        while(! rand(4))
+            s += " \t"[rand(2)];
+        return s;
+    }
+
+    std::string
+    token()
+    {
+        static char constexpr tchar[] =
+            "!#$%&'*+-.^_`|~"
+            "0123456789"
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+            "abcdefghijklmnopqrstuvwxyz";
+        std::string s;
+        auto const n = 1 + rand(12);
+        for(std::size_t i = 0; i < n; ++i)
+            s += tchar[rand(sizeof(tchar) - 1)];
+        return s;
+    }
+
+    std::string
+    quoted()
+    {
+        static char constexpr qdchar[] =
+            " !#$%&'()*+,-./:;<=>?@[]^_`{|}~"
+            "0123456789"
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+            "abcdefghijklmnopqrstuvwxyz";
+        std::string s = "\"";
+        while(rand(8))
+        {
+            if(rand(10))
+                s += qdchar[rand(sizeof(qdchar) - 1)];
+            else
+                s += "\\\"";
+        }
+        s += '"';
+        return s;
+    }
+
+    std::string
+    host()
+    {
+        switch(rand(3))
+        {
+        case 0:
+            return "[2001:db8::" + std::to_string(1 + rand(9999)) + "]";
+        case 1:
+            return
+                std::to_string(rand(256)) + "." +
+                std::to_string(rand(256)) + "." +
+                std::to_string(rand(256)) + "." +
+                std::to_string(rand(256));
+        default:
+            break;
+        }
+        static char constexpr alnum[] =
+            "0123456789"
+            "abcdefghijklmnopqrstuvwxyz";
+        std::string s;
+        auto const labels = 1 + rand(3);
+        for(std::size_t i = 0; i < labels; ++i)
+        {
+            if(i > 0)
+                s += '.';
+            auto const n = 1 + rand(8);
+            for(std::size_t j = 0; j < n; ++j)
+                s += alnum[rand(sizeof(alnum) - 1)];
+        }
+        return s;
+    }
+
+    std::string
+    param()
+    {
+        std::string s = lws() + ";" + lws() + token();
+        if(rand(4))
+        {
+            s += lws() + "=" + lws();
+            s += rand(4) ? token() : quoted();
+        }
+        return s;
+    }
+
+    std::string
+    via(via_info& v)
+    {
+        static char const* const transports[] = {
+            "UDP", "TCP", "TLS", "SCTP", "WS", "WSS" };
+        v = {};
+        v.transport = transports[rand(6)];
+        v.host = host();
+        std::string s =
+            "SIP" + lws() + "/" + lws() +
+            "2.0" + lws() + "/" + lws() +
+            v.transport + " " + lws() + v.host;
+        if(rand(2))
+        {
+            v.port = static_cast<std::uint16_t>(1 + rand(65535));
+            s += lws() + ":" + lws() + std::to_string(v.port);
+        }
+        while(! rand(3))
+            s += param();
+        v.branch = "z9hG4bK" + token();
+        s += ";branch=" + v.branch;
+        while(! rand(3))
+            s += param();
+        return s;
+    }
+
+    std::string
+    uri()
+    {
+        std::string s = rand(4) ? "sip:" : "sips:";
+        if(rand(2))
+            s += token() + "@";
+        s += host();
+        if(rand(3))
+            s += ":" + std::to_string(1 + rand(65535));
+        return s;
+    }
+
+    std::string
+    name_addr(name_addr_info& v)
+    {
+        v = {};
+        v.uri = uri();
+        std::string s;
+        switch(rand(3))
+        {
+        case 0:
+            v.display_name = quoted();
+            s = v.display_name + lws();
+            break;
+        case 1:
+            v.display_name = token();
+            s = v.display_name + " " + lws();
+            break;
+        default:
+            break;
+        }
+        if(v.display_name.empty() && rand(2))
+        {
+            // an addr-spec, so the URI cannot contain
+            // a semicolon, comma or whitespace
+            s += v.uri;
+        }
+        else
+        {
+            while(! rand(3))
+                v.uri += ";" + token();
+            s += "<" + v.uri + ">";
+        }
+        while(! rand(3))
+            s += param();
+        if(rand(2))
+        {
+            v.tag = token();
+            s += ";tag=" + v.tag;
+        }
+        return s;
+    }
+
+    std::string
+    cseq(std::uint32_t& number, std::string& method)
+    {
+        static char const* const methods[] = {
+            "INVITE", "ACK", "BYE", "CANCEL", "OPTIONS", "REGISTER",
+            "PRACK", "SUBSCRIBE", "NOTIFY", "PUBLISH", "INFO", "REFER",
+            "MESSAGE", "UPDATE" };
+        number = static_cast<std::uint32_t>(rng_());
+        method = methods[rand(14)];
+        return lws() + std::to_string(number) + " " + lws() + method + lws();
+    }
+};
+
+using header_fuzz = header_fuzz_t<>;
+
+} // sip
+} // beast
+} // boost
+
+#endif
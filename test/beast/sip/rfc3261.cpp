@@ -0,0 +1,403 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/sip/rfc3261.hpp>
+
+#include "header_fuzz.hpp"
+
+#include <boost/beast/http/rfc7230.hpp>
+#include <boost/beast/sip/fields.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+class rfc3261_test : public beast::unit_test::suite
+{
+public:
+    static
+    bool
+    contains(string_view outer, string_view inner)
+    {
+        return inner.empty() || (
+            inner.data() >= outer.data() &&
+            inner.data() + inner.size() <=
+                outer.data() + outer.size());
+    }
+
+    static
+    std::string
+    str(param_list const& list)
+    {
+        std::string s;
+        for(auto const& p : list)
+        {
+            s.push_back(';');
+            s.append(p.first.data(), p.first.size());
+            if(! p.second.empty())
+            {
+                s.push_back('=');
+                s.append(p.second.data(), p.second.size());
+            }
+        }
+        return s;
+    }
+
+    void
+    testParamList()
+    {
+        auto const ce =
+            [&](string_view s, string_view answer)
+            {
+                param_list const list{s};
+                BEAST_EXPECT(http::validate_list(list));
+                BEAST_EXPECTS(str(list) == answer, str(list));
+            };
+        auto const cq =
+            [&](string_view s)
+            {
+                BEAST_EXPECTS(! http::validate_list(param_list{s}), s);
+            };
+
+        ce("", "");
+        ce(" ", "");
+        ce(";a", ";a");
+        ce(";a=1", ";a=1");
+        ce(" ; a = 1 ", ";a=1");
+        ce(";branch=z9hG4bK776;rport", ";branch=z9hG4bK776;rport");
+        ce(";received=[2001:db8::1]", ";received=[2001:db8::1]");
+        ce(";maddr=239.255.255.1;ttl=16", ";maddr=239.255.255.1;ttl=16");
+        ce(";a=\"x;y,z\";b", ";a=\"x;y,z\";b");
+        ce(";a=\"\\\"\"", ";a=\"\\\"\"");
+
+        cq(";");
+        cq(";=");
+        cq(";a=");
+        cq(";a=;b");
+        cq(";a=\"x");
+        cq("a");
+        cq(";a b");
+        cq(";a=1,");
+
+        string_view v;
+        param_list const list{";Branch=z9hG4bK1;lr;ttl=16"};
+        BEAST_EXPECT(find_param(list, "branch", v) && v == "z9hG4bK1");
+        BEAST_EXPECT(find_param(list, "LR", v) && v.empty());
+        BEAST_EXPECT(find_param(list, "ttl", v) && v == "16");
+        BEAST_EXPECT(! find_param(list, "maddr", v));
+    }
+
+    void
+    testViaList()
+    {
+        {
+            via_list const list{
+                "SIP/2.0/UDP pc33.atlanta.com:5066;branch=z9hG4bK776asdhds;rport"};
+            BEAST_EXPECT(http::validate_list(list));
+            auto it = list.begin();
+            BEAST_EXPECT(it != list.end());
+            BEAST_EXPECT((*it).protocol_name == "SIP");
+            BEAST_EXPECT((*it).protocol_version == "2.0");
+            BEAST_EXPECT((*it).transport == "UDP");
+            BEAST_EXPECT((*it).host == "pc33.atlanta.com");
+            BEAST_EXPECT((*it).port == 5066);
+            BEAST_EXPECT((*it).branch == "z9hG4bK776asdhds");
+            BEAST_EXPECT((*it).has_rport);
+            BEAST_EXPECT((*it).rport.empty());
+            BEAST_EXPECT(str((*it).params) == ";branch=z9hG4bK776asdhds;rport");
+            BEAST_EXPECT(++it == list.end());
+        }
+        {
+            via_list const list{
+                "SIP / 2.0 / TCP [2001:db8::9] : 5060 ; received=192.0.2.4 ;"
+                "branch=z9hG4bKnashds8 ; rport=5061 , "
+                "SIP/2.0/UDP bigbox3.site3.atlanta.com;branch=z9hG4bK77ef4c2312983.1"};
+            BEAST_EXPECT(http::validate_list(list));
+            auto it = list.begin();
+            BEAST_EXPECT((*it).transport == "TCP");
+            BEAST_EXPECT((*it).host == "[2001:db8::9]");
+            BEAST_EXPECT((*it).port == 5060);
+            BEAST_EXPECT((*it).received == "192.0.2.4");
+            BEAST_EXPECT((*it).branch == "z9hG4bKnashds8");
+            BEAST_EXPECT((*it).rport == "5061");
+            ++it;
+            BEAST_EXPECT((*it).host == "bigbox3.site3.atlanta.com");
+            BEAST_EXPECT((*it).port == 0);
+            BEAST_EXPECT((*it).branch == "z9hG4bK77ef4c2312983.1");
+            BEAST_EXPECT(! (*it).has_rport);
+            BEAST_EXPECT(++it == list.end());
+        }
+        {
+            via_list const list{",, SIP/2.0/UDP a.com ,, SIP/2.0/UDP b.com ,"};
+            BEAST_EXPECT(http::validate_list(list));
+            BEAST_EXPECT(std::distance(list.begin(), list.end()) == 2);
+        }
+
+        auto const cq =
+            [&](string_view s)
+            {
+                BEAST_EXPECTS(! http::validate_list(via_list{s}), s);
+            };
+        cq("SIP/2.0/UDP");
+        cq("SIP/2.0/UDPa.com");
+        cq("SIP/2.0 a.com");
+        cq("SIP//UDP a.com");
+        cq("SIP/2.0/UDP a.com:");
+        cq("SIP/2.0/UDP a.com:65536");
+        cq("SIP/2.0/UDP a.com:x");
+        cq("SIP/2.0/UDP [2001:db8::1");
+        cq("SIP/2.0/UDP []");
+        cq("SIP/2.0/UDP a.com;");
+        cq("SIP/2.0/UDP a.com;branch=");
+        cq("SIP/2.0/UDP a.com b.com");
+        cq("SIP/2.0/UDP a_b.com");
+    }
+
+    void
+    testNameAddr()
+    {
+        name_addr v;
+        BEAST_EXPECT(parse_name_addr(
+            "Bob <sip:bob@biloxi.com>;tag=a6c85cf", v));
+        BEAST_EXPECT(v.display_name == "Bob");
+        BEAST_EXPECT(v.uri == "sip:bob@biloxi.com");
+        BEAST_EXPECT(v.tag == "a6c85cf");
+
+        BEAST_EXPECT(parse_name_addr(
+            "\"Alice \\\"A\\\" Liddell\" <sip:alice@atlanta.com;transport=tcp> ; tag = 1928301774 ; x", v));
+        BEAST_EXPECT(v.display_name == "\"Alice \\\"A\\\" Liddell\"");
+        BEAST_EXPECT(v.uri == "sip:alice@atlanta.com;transport=tcp");
+        BEAST_EXPECT(v.tag == "1928301774");
+        BEAST_EXPECT(str(v.params) == ";tag=1928301774;x");
+
+        BEAST_EXPECT(parse_name_addr("The Operator <sip:operator@cs.columbia.edu>", v));
+        BEAST_EXPECT(v.display_name == "The Operator");
+        BEAST_EXPECT(v.tag.empty());
+
+        BEAST_EXPECT(parse_name_addr("<sip:carol@chicago.com>", v));
+        BEAST_EXPECT(v.display_name.empty());
+        BEAST_EXPECT(v.uri == "sip:carol@chicago.com");
+
+        // parameters after an addr-spec belong to the header
+        BEAST_EXPECT(parse_name_addr(" sip:+12125551212@server.phone2net.com;tag=887s ", v));
+        BEAST_EXPECT(v.display_name.empty());
+        BEAST_EXPECT(v.uri == "sip:+12125551212@server.phone2net.com");
+        BEAST_EXPECT(v.tag == "887s");
+
+        BEAST_EXPECT(parse_name_addr("sip:[2001:db8::1]:5060", v));
+        BEAST_EXPECT(v.uri == "sip:[2001:db8::1]:5060");
+
+        BEAST_EXPECT(! parse_name_addr("", v));
+        BEAST_EXPECT(! parse_name_addr("<>", v));
+        BEAST_EXPECT(! parse_name_addr("<sip:a@b.com", v));
+        BEAST_EXPECT(! parse_name_addr("\"Bob <sip:a@b.com>", v));
+        BEAST_EXPECT(! parse_name_addr("\"Bob\" sip:a@b.com", v));
+        BEAST_EXPECT(! parse_name_addr("<sip:a@b.com> x", v));
+        BEAST_EXPECT(! parse_name_addr("<sip:a@b.com>;", v));
+        BEAST_EXPECT(! parse_name_addr("<sip:a@b.com>, <sip:c@d.com>", v));
+        BEAST_EXPECT(! parse_name_addr("sip:a@b.com sip:c@d.com", v));
+    }
+
+    void
+    testContactList()
+    {
+        {
+            contact_list const list{
+                "\"Mr. Watson\" <sip:watson@worcester.bell-telephone.com>;q=0.7; expires=3600, "
+                "\"Mr. Watson\" <mailto:watson@bell-telephone.com> ;q=0.1"};
+            BEAST_EXPECT(http::validate_list(list));
+            auto it = list.begin();
+            BEAST_EXPECT((*it).uri == "sip:watson@worcester.bell-telephone.com");
+            BEAST_EXPECT(str((*it).params) == ";q=0.7;expires=3600");
+            ++it;
+            BEAST_EXPECT((*it).uri == "mailto:watson@bell-telephone.com");
+            BEAST_EXPECT(++it == list.end());
+        }
+        {
+            contact_list const list{"*"};
+            BEAST_EXPECT(http::validate_list(list));
+            BEAST_EXPECT((*list.begin()).uri == "*");
+        }
+        {
+            contact_list const list{"sip:a@b.com;expires=0,sip:c@d.com"};
+            BEAST_EXPECT(http::validate_list(list));
+            BEAST_EXPECT(std::distance(list.begin(), list.end()) == 2);
+        }
+        BEAST_EXPECT(! http::validate_list(contact_list{"<sip:a@b.com> <sip:c@d.com>"}));
+        BEAST_EXPECT(! http::validate_list(contact_list{"<sip:a@b.com"}));
+    }
+
+    void
+    testCSeq()
+    {
+        std::uint32_t n;
+        string_view m;
+        BEAST_EXPECT(parse_cseq("314159 INVITE", n, m));
+        BEAST_EXPECT(n == 314159 && m == "INVITE");
+        BEAST_EXPECT(parse_cseq(" 0 \t ACK ", n, m));
+        BEAST_EXPECT(n == 0 && m == "ACK");
+        BEAST_EXPECT(parse_cseq("4294967295 BYE", n, m));
+        BEAST_EXPECT(n == 4294967295u);
+
+        BEAST_EXPECT(! parse_cseq("", n, m));
+        BEAST_EXPECT(! parse_cseq("1", n, m));
+        BEAST_EXPECT(! parse_cseq("1 ", n, m));
+        BEAST_EXPECT(! parse_cseq("INVITE", n, m));
+        BEAST_EXPECT(! parse_cseq("1INVITE", n, m));
+        BEAST_EXPECT(! parse_cseq("-1 INVITE", n, m));
+        BEAST_EXPECT(! parse_cseq("4294967296 BYE", n, m));
+        BEAST_EXPECT(! parse_cseq("1 INVITE BYE", n, m));
+        BEAST_EXPECT(! parse_cseq("1 INV/ITE", n, m));
+    }
+
+    void
+    testParsedHeader()
+    {
+        udp_fields f;
+        f.insert(http::field::via,
+            "SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds, "
+            "SIP/2.0/UDP bigbox3.site3.atlanta.com;branch=z9hG4bK77ef4c2312983.1");
+        f.insert(http::field::from, "Alice <sip:alice@atlanta.com>;tag=1928301774");
+        f.insert(http::field::to, "Bob <sip:bob@biloxi.com>");
+        f.insert(http::field::call_id, " a84b4c76e66710@pc33.atlanta.com ");
+        f.insert(http::field::cseq, "314159 INVITE");
+
+        parsed_header h;
+        BEAST_EXPECT(h.parse(f));
+        BEAST_EXPECT(h.via.host == "pc33.atlanta.com");
+        BEAST_EXPECT(h.via.branch == "z9hG4bK776asdhds");
+        BEAST_EXPECT(h.from.tag == "1928301774");
+        BEAST_EXPECT(h.to.uri == "sip:bob@biloxi.com");
+        BEAST_EXPECT(h.to.tag.empty());
+        BEAST_EXPECT(h.call_id == "a84b4c76e66710@pc33.atlanta.com");
+        BEAST_EXPECT(h.cseq == 314159);
+        BEAST_EXPECT(h.method == "INVITE");
+
+        f.erase(http::field::to);
+        BEAST_EXPECT(! h.parse(f));
+        f.insert(http::field::to, "<sip:bob@biloxi.com");
+        BEAST_EXPECT(! h.parse(f));
+    }
+
+    void
+    testFuzz()
+    {
+        header_fuzz fuzz;
+        for(int i = 0; i < 2000; ++i)
+        {
+            header_fuzz::via_info vi[3];
+            std::string s;
+            auto const n = 1 + fuzz.rand(3);
+            for(std::size_t j = 0; j < n; ++j)
+            {
+                if(j > 0)
+                    s += fuzz.lws() + "," + fuzz.lws();
+                s += fuzz.via(vi[j]);
+            }
+            via_list const list{s};
+            if(! BEAST_EXPECTS(http::validate_list(list), s))
+                continue;
+            std::size_t j = 0;
+            for(auto const& v : list)
+            {
+                BEAST_EXPECTS(v.transport == vi[j].transport, s);
+                BEAST_EXPECTS(v.host == vi[j].host, s);
+                BEAST_EXPECTS(v.port == vi[j].port, s);
+                BEAST_EXPECTS(v.branch == vi[j].branch, s);
+                BEAST_EXPECT(contains(s, v.branch));
+                ++j;
+            }
+            BEAST_EXPECT(j == n);
+        }
+        for(int i = 0; i < 2000; ++i)
+        {
+            header_fuzz::name_addr_info ni;
+            auto const s = fuzz.name_addr(ni);
+            name_addr v;
+            if(! BEAST_EXPECTS(parse_name_addr(s, v), s))
+                continue;
+            BEAST_EXPECTS(v.display_name == ni.display_name, s);
+            BEAST_EXPECTS(v.uri == ni.uri, s);
+            BEAST_EXPECTS(v.tag == ni.tag, s);
+        }
+        for(int i = 0; i < 2000; ++i)
+        {
+            std::uint32_t n0;
+            std::string m0;
+            auto const s = fuzz.cseq(n0, m0);
+            std::uint32_t n;
+            string_view m;
+            BEAST_EXPECTS(parse_cseq(s, n, m), s);
+            BEAST_EXPECT(n == n0 && m == m0);
+        }
+    }
+
+    // Truncated and corrupted values must be rejected or parsed
+    // without reading outside the input.
+    void
+    testMutate()
+    {
+        header_fuzz fuzz;
+        static char constexpr junk[] = "\"\\<>;,:=[] \t\r\n\x80";
+        for(int i = 0; i < 2000; ++i)
+        {
+            header_fuzz::via_info vi;
+            header_fuzz::name_addr_info ni;
+            auto s = fuzz.rand(2) ?
+                fuzz.via(vi) : fuzz.name_addr(ni);
+            if(fuzz.rand(2))
+                s.resize(fuzz.rand(s.size() + 1));
+            else
+                s[fuzz.rand(s.size())] =
+                    junk[fuzz.rand(sizeof(junk) - 1)];
+            // copy to the heap so that sanitizers catch overreads
+            std::vector<char> buf(s.begin(), s.end());
+            string_view const sv(buf.data(), buf.size());
+            for(auto const& v : via_list{sv})
+            {
+                BEAST_EXPECT(contains(sv, v.host));
+                BEAST_EXPECT(contains(sv, v.branch));
+                for(auto const& p : v.params)
+                    BEAST_EXPECT(contains(sv, p.second));
+            }
+            for(auto const& v : contact_list{sv})
+            {
+                BEAST_EXPECT(contains(sv, v.display_name));
+                BEAST_EXPECT(contains(sv, v.uri));
+                BEAST_EXPECT(contains(sv, v.tag));
+            }
+            name_addr v;
+            if(parse_name_addr(sv, v))
+                BEAST_EXPECT(contains(sv, v.uri));
+        }
+    }
+
+    void
+    run() override
+    {
+        testParamList();
+        testViaList();
+        testNameAddr();
+        testContactList();
+        testCSeq();
+        testParsedHeader();
+        testFuzz();
+        testMutate();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,sip,rfc3261);
+
+} // sip
+} // beast
+} // boost
@@ -0,0 +1,324 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/sip/transaction.hpp>
+
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/sip/datagram.hpp>
+#include <boost/beast/sip/message.hpp>
+#include <boost/beast/sip/parser.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+class transaction_test : public beast::unit_test::suite
+{
+public:
+    using parser_type =
+        udp_parser<true, http::string_body>;
+
+    using table_type =
+        transaction_table<std::string>;
+
+    static
+    std::chrono::milliseconds
+    ms(int n)
+    {
+        return std::chrono::milliseconds(n);
+    }
+
+    bool
+    key_of(udp_fields const& f, transaction_key& key)
+    {
+        return make_transaction_key(key, f);
+    }
+
+    static
+    udp_fields
+    make_fields(
+        string_view via,
+        string_view call_id,
+        string_view cseq)
+    {
+        udp_fields f;
+        if(! via.empty())
+            f.insert(http::field::via, via);
+        if(! call_id.empty())
+            f.insert(http::field::call_id, call_id);
+        if(! cseq.empty())
+            f.insert(http::field::cseq, cseq);
+        return f;
+    }
+
+    static
+    transaction_key
+    make_key(string_view branch, std::uint32_t cseq = 1)
+    {
+        transaction_key key;
+        key.branch = branch;
+        key.call_id = "a84b4c76e66710";
+        key.cseq = cseq;
+        key.method = "INVITE";
+        return key;
+    }
+
+    void
+    testKey()
+    {
+        transaction_key key;
+
+        // compact names in a received datagram
+        {
+            string_view const s =
+                "INVITE sip:bob@biloxi.com SIP/2.0\r\n"
+                "v: SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+                "i: a84b4c76e66710@pc33.atlanta.com\r\n"
+                "CSeq: 314159 INVITE\r\n"
+                "l: 0\r\n"
+                "\r\n";
+            parser_type p;
+            error_code ec;
+            parse_datagram(p, net::const_buffer(s.data(), s.size()), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(make_transaction_key(key, p.get().base()));
+            BEAST_EXPECT(key.branch == "z9hG4bK776asdhds");
+            BEAST_EXPECT(key.call_id == "a84b4c76e66710@pc33.atlanta.com");
+            BEAST_EXPECT(key.cseq == 314159);
+            BEAST_EXPECT(key.method == "INVITE");
+        }
+
+        // ACK matches the INVITE transaction, CANCEL does not
+        {
+            auto const invite = make_fields(
+                "SIP/2.0/UDP h;branch=z9hG4bK1", "c", "1 INVITE");
+            auto const ack = make_fields(
+                "SIP/2.0/UDP h;branch=z9hG4bK1", "c", "1 ACK");
+            auto const cancel = make_fields(
+                "SIP/2.0/UDP h;branch=z9hG4bK1", "c", "1 CANCEL");
+            transaction_key k0, k1, k2;
+            BEAST_EXPECT(key_of(invite, k0));
+            BEAST_EXPECT(key_of(ack, k1));
+            BEAST_EXPECT(key_of(cancel, k2));
+            BEAST_EXPECT(k0 == k1);
+            BEAST_EXPECT(k0 != k2);
+        }
+
+        // top Via of a combined field value
+        BEAST_EXPECT(key_of(make_fields(
+            "SIP/2.0/UDP a;received=\"x,y\";branch=z9hG4bK1 , "
+            "SIP/2.0/UDP b;branch=z9hG4bK2", "c", "1 INVITE"), key));
+        BEAST_EXPECT(key.branch == "z9hG4bK1");
+
+        // top Via of separate fields
+        {
+            auto f = make_fields(
+                "SIP/2.0/UDP a;rport;branch=z9hG4bK1", "c", "1 INVITE");
+            f.insert(http::field::via, "SIP/2.0/UDP b;branch=z9hG4bK2");
+            BEAST_EXPECT(key_of(f, key));
+            BEAST_EXPECT(key.branch == "z9hG4bK1");
+        }
+
+        // missing or malformed fields
+        BEAST_EXPECT(! key_of(make_fields(
+            "", "c", "1 INVITE"), key));
+        BEAST_EXPECT(! key_of(make_fields(
+            "SIP/2.0/UDP a", "c", "1 INVITE"), key));
+        BEAST_EXPECT(! key_of(make_fields(
+            "SIP/2.0/UDP a;branch=z9hG4bK1", "", "1 INVITE"), key));
+        BEAST_EXPECT(! key_of(make_fields(
+            "SIP/2.0/UDP a;branch=z9hG4bK1", "c", ""), key));
+        BEAST_EXPECT(! key_of(make_fields(
+            "SIP/2.0/UDP a;branch=z9hG4bK1", "c", "INVITE"), key));
+        BEAST_EXPECT(! key_of(make_fields(
+            "SIP/2.0/UDP a;branch=z9hG4bK1", "c", "1"), key));
+        BEAST_EXPECT(! key_of(make_fields(
+            "SIP/2.0/UDP a;branch=z9hG4bK1", "c", "1 INVITE x"), key));
+        BEAST_EXPECT(! key_of(make_fields(
+            "SIP/2.0/UDP a;branch=z9hG4bK1", "c", "4294967296 INVITE"), key));
+        BEAST_EXPECT(key_of(make_fields(
+            "SIP/2.0/UDP a;branch=z9hG4bK1", "c", "4294967295 INVITE"), key));
+    }
+
+    void
+    testTimers()
+    {
+        transaction_timers const tt;
+        using t = transaction_timer;
+        BEAST_EXPECT(tt.interval(t::a, false) == ms(500));
+        BEAST_EXPECT(tt.interval(t::a, false, 3) == ms(4000));
+        BEAST_EXPECT(tt.interval(t::a, true) == ms(0));
+        BEAST_EXPECT(tt.interval(t::b, true) == ms(32000));
+        BEAST_EXPECT(tt.interval(t::c, true) > ms(180000));
+        BEAST_EXPECT(tt.interval(t::d, false) >= ms(32000));
+        BEAST_EXPECT(tt.interval(t::d, true) == ms(0));
+        BEAST_EXPECT(tt.interval(t::e, false, 2) == ms(2000));
+        BEAST_EXPECT(tt.interval(t::e, false, 5) == ms(4000));
+        BEAST_EXPECT(tt.interval(t::f, false) == ms(32000));
+        BEAST_EXPECT(tt.interval(t::g, false, 9) == ms(4000));
+        BEAST_EXPECT(tt.interval(t::h, false) == ms(32000));
+        BEAST_EXPECT(tt.interval(t::i, false) == ms(5000));
+        BEAST_EXPECT(tt.interval(t::j, false) == ms(32000));
+        BEAST_EXPECT(tt.interval(t::j, true) == ms(0));
+        BEAST_EXPECT(tt.interval(t::k, false) == ms(5000));
+        BEAST_EXPECT(tt.interval(t::k, true) == ms(0));
+    }
+
+    void
+    testTable()
+    {
+        table_type tt{4};
+        auto const k1 = make_key("z9hG4bK1");
+        auto const k2 = make_key("z9hG4bK2");
+        BEAST_EXPECT(tt.emplace(k1, "one"));
+        BEAST_EXPECT(! tt.emplace(k1, "again"));
+        BEAST_EXPECT(tt.emplace(k2, 3, '*'));
+        BEAST_EXPECT(tt.size() == 2);
+        BEAST_EXPECT(tt.contains(k1));
+        BEAST_EXPECT(! tt.contains(make_key("z9hG4bK1", 2)));
+
+        // the table owns the strings of the key
+        {
+            std::string branch = "z9hG4bK3";
+            BEAST_EXPECT(tt.emplace(make_key(branch), "three"));
+            branch = "z9hG4bK4";
+        }
+        BEAST_EXPECT(tt.contains(make_key("z9hG4bK3")));
+
+        std::string s;
+        BEAST_EXPECT(tt.visit(k2,
+            [&](std::string& v)
+            {
+                s = v;
+                v = "two";
+            }));
+        BEAST_EXPECT(s == "***");
+        tt.visit(k2, [&](std::string& v) { s = v; });
+        BEAST_EXPECT(s == "two");
+
+        BEAST_EXPECT(tt.erase(k2));
+        BEAST_EXPECT(! tt.erase(k2));
+        BEAST_EXPECT(! tt.visit(k2, [&](std::string&) {}));
+        BEAST_EXPECT(tt.size() == 2);
+    }
+
+    void
+    testExpire()
+    {
+        using t = transaction_timer;
+        table_type tt{2, ms(10), 8};
+        auto const t0 = table_type::clock_type::now();
+        auto const k1 = make_key("z9hG4bK1");
+        auto const k2 = make_key("z9hG4bK2");
+        auto const k3 = make_key("z9hG4bK3");
+        tt.emplace(k1, "one");
+        tt.emplace(k2, "two");
+        tt.emplace(k3, "three");
+        BEAST_EXPECT(! tt.start_timer(make_key("x"), t::a, t0));
+
+        std::vector<std::pair<std::string, t>> v;
+        auto const record =
+            [&](transaction_key const& key, std::string& value, t id)
+            {
+                v.emplace_back(value, id);
+                return id == t::b && key == k1;
+            };
+
+        BEAST_EXPECT(tt.start_timer(k1, t::a, t0 + ms(500)));
+        BEAST_EXPECT(tt.start_timer(k1, t::b, t0 + ms(32000)));
+        BEAST_EXPECT(tt.start_timer(k2, t::e, t0 + ms(500)));
+        BEAST_EXPECT(tt.start_timer(k3, t::f, t0 + ms(500)));
+
+        BEAST_EXPECT(tt.expire(t0 + ms(499), record) == 0);
+
+        // a restarted timer uses the new deadline
+        BEAST_EXPECT(tt.start_timer(k2, t::e, t0 + ms(1000)));
+
+        // a cancelled timer is not delivered
+        BEAST_EXPECT(tt.cancel_timer(k3, t::f));
+        BEAST_EXPECT(! tt.cancel_timer(k3, t::f));
+
+        BEAST_EXPECT(tt.expire(t0 + ms(520), record) == 1);
+        BEAST_EXPECT(v.size() == 1 && v[0].first == "one" && v[0].second == t::a);
+
+        BEAST_EXPECT(tt.expire(t0 + ms(1010), record) == 1);
+        BEAST_EXPECT(v.size() == 2 && v[1].first == "two" && v[1].second == t::e);
+
+        // a removed transaction's timers are discarded
+        BEAST_EXPECT(tt.start_timer(k2, t::j, t0 + ms(2000)));
+        tt.erase(k2);
+
+        // beyond the span of the wheel; returning true removes
+        BEAST_EXPECT(tt.expire(t0 + ms(31000), record) == 0);
+        BEAST_EXPECT(tt.contains(k1));
+        BEAST_EXPECT(tt.expire(t0 + ms(32010), record) == 1);
+        BEAST_EXPECT(v.size() == 3 && v[2].second == t::b);
+        BEAST_EXPECT(! tt.contains(k1));
+
+        // a deadline in the past expires on the next call
+        BEAST_EXPECT(tt.start_timer(k3, t::k, t0));
+        BEAST_EXPECT(tt.expire(t0 + ms(32010), record) == 0);
+        BEAST_EXPECT(tt.expire(t0 + ms(32020), record) == 1);
+        BEAST_EXPECT(tt.size() == 1);
+    }
+
+    void
+    testThreads()
+    {
+        table_type tt;
+        std::vector<std::thread> threads;
+        for(int i = 0; i < 4; ++i)
+            threads.emplace_back(
+                [&tt, i]
+                {
+                    for(int j = 0; j < 1000; ++j)
+                    {
+                        auto const branch =
+                            std::to_string(i) + "-" + std::to_string(j);
+                        tt.emplace(make_key(branch), branch);
+                        tt.start_timer(make_key(branch),
+                            transaction_timer::f,
+                            table_type::clock_type::now());
+                    }
+                });
+        for(auto& t : threads)
+            t.join();
+        BEAST_EXPECT(tt.size() == 4000);
+        std::size_t n = 0;
+        while(n < 4000)
+            n += tt.expire(table_type::clock_type::now() + ms(20),
+                [](transaction_key const&, std::string&, transaction_timer)
+                {
+                    return true;
+                });
+        BEAST_EXPECT(n == 4000);
+        BEAST_EXPECT(tt.size() == 0);
+    }
+
+    void
+    run() override
+    {
+        testKey();
+        testTimers();
+        testTable();
+        testExpire();
+        testThreads();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,sip,transaction);
+
+} // sip
+} // beast
+} // boost
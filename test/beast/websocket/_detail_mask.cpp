@@ -0,0 +1,213 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/websocket/detail/mask.hpp>
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+class mask_test
+    : public beast::unit_test::suite
+{
+public:
+    static
+    std::vector<unsigned char>
+    make_data(std::size_t n)
+    {
+        std::vector<unsigned char> v(n);
+        for(std::size_t i = 0; i < n; ++i)
+            v[i] = static_cast<unsigned char>(i * 7 + 3);
+        return v;
+    }
+
+    // The result of masking, one octet at a time
+    static
+    std::vector<unsigned char>
+    reference(
+        unsigned char const* p,
+        std::size_t n,
+        std::uint32_t key,
+        std::size_t phase)
+    {
+        prepared_key k;
+        prepare_key(k, key);
+        std::vector<unsigned char> v(p, p + n);
+        for(std::size_t i = 0; i < n; ++i)
+            v[i] ^= k[(i + phase) % 4];
+        return v;
+    }
+
+    void
+    testMask()
+    {
+        std::uint32_t const key = 0xa1b2c3d4;
+        auto const data = make_data(1200);
+        std::vector<unsigned char> buf(data.size() + 64);
+
+        // every size and alignment near the vector widths,
+        // starting at each octet of the key
+        for(std::size_t offset = 0; offset < 64; offset += 7)
+        for(std::size_t n : {0, 1, 3, 4, 5, 15, 16, 17, 63, 64, 65,
+            127, 128, 129, 130, 131, 255, 256, 257, 1000, 1100})
+        for(std::size_t phase = 0; phase < 4; ++phase)
+        {
+            auto const p = buf.data() + offset;
+            std::memcpy(p, data.data(), n);
+            prepared_key k;
+            prepare_key(k, key);
+            rol(k, phase);
+            net::mutable_buffer b(p, n);
+            mask_inplace(b, k);
+            auto const r = reference(data.data(), n, key, phase);
+            BEAST_EXPECTS(std::equal(r.begin(), r.end(), p),
+                std::to_string(offset) + ", " + std::to_string(n));
+
+            // the key is rotated by the octets masked
+            prepared_key k1;
+            prepare_key(k1, key);
+            rol(k1, (phase + n) % 4);
+            BEAST_EXPECT(k == k1);
+        }
+    }
+
+    void
+    testSequence()
+    {
+        // masking in pieces equals masking at once
+        std::uint32_t const key = 0x01020304;
+        auto const data = make_data(4096);
+        auto const r = reference(data.data(), data.size(), key, 0);
+        for(std::size_t piece : {1, 3, 13, 129, 1000, 4095})
+        {
+            auto v = data;
+            std::vector<net::mutable_buffer> bs;
+            for(std::size_t i = 0; i < v.size(); i += piece)
+                bs.emplace_back(v.data() + i,
+                    (std::min)(piece, v.size() - i));
+            prepared_key k;
+            prepare_key(k, key);
+            mask_inplace(bs, k);
+            BEAST_EXPECTS(v == r, std::to_string(piece));
+        }
+    }
+
+    void
+    testCopy()
+    {
+        std::uint32_t const key = 0x0badf00d;
+        auto const data = make_data(3000);
+        auto const r = reference(data.data(), data.size(), key, 0);
+
+        // from a sequence of pieces of each size
+        for(std::size_t piece : {1, 7, 64, 100, 1500, 3000})
+        {
+            std::vector<net::const_buffer> bs;
+            for(std::size_t i = 0; i < data.size(); i += piece)
+                bs.emplace_back(data.data() + i,
+                    (std::min)(piece, data.size() - i));
+            std::vector<unsigned char> v(data.size());
+            prepared_key k;
+            prepare_key(k, key);
+            BEAST_EXPECT(mask_copy(net::buffer(v), bs, k) == v.size());
+            BEAST_EXPECTS(v == r, std::to_string(piece));
+        }
+
+        // into a smaller buffer, continuing with the same key
+        {
+            std::vector<unsigned char> v(data.size());
+            prepared_key k;
+            prepare_key(k, key);
+            auto const src = net::buffer(data);
+            auto n = mask_copy(net::buffer(v.data(), 1001), src, k);
+            BEAST_EXPECT(n == 1001);
+            n += mask_copy(net::buffer(v.data() + n, v.size() - n),
+                src + n, k);
+            BEAST_EXPECT(n == v.size());
+            BEAST_EXPECT(v == r);
+        }
+
+        // the source is not changed
+        {
+            auto const copy = data;
+            std::vector<unsigned char> v(10);
+            prepared_key k;
+            prepare_key(k, key);
+            BEAST_EXPECT(mask_copy(net::buffer(v),
+                net::buffer(data), k) == 10);
+            BEAST_EXPECT(data == copy);
+        }
+    }
+
+    void
+    testKernels()
+    {
+        std::uint32_t k;
+        prepared_key pk;
+        prepare_key(pk, 0x55aa33cc);
+        std::memcpy(&k, pk.data(), 4);
+        auto const data = make_data(1024 + 64);
+        auto const check =
+            [&](mask_kernel f, std::size_t width)
+            {
+                for(std::size_t n : {0, 1, 63, 64, 100, 1024 + 63})
+                {
+                    auto v = data;
+                    auto const m = f(v.data() + 1, v.data() + 1, n, k);
+                    BEAST_EXPECT(width == 1 || m == n - n % width);
+                    auto const r = reference(
+                        data.data() + 1, m, 0x55aa33cc, 0);
+                    BEAST_EXPECT(std::equal(
+                        r.begin(), r.end(), v.data() + 1));
+                    BEAST_EXPECT(std::equal(v.data() + 1 + m,
+                        v.data() + 1 + n, data.data() + 1 + m));
+                }
+            };
+        check(&mask_words, 8);
+        check([](unsigned char* dst, unsigned char const* src,
+                std::size_t n, std::uint32_t k)
+            {
+                // into a disjoint range
+                std::vector<unsigned char> v(src, src + n);
+                auto const m = get_mask_kernel()(v.data(), src, n, k);
+                std::copy(v.begin(), v.begin() + m, dst);
+                return m;
+            }, 1);
+    #if ! BOOST_BEAST_NO_INTRINSICS
+        check(&mask_sse2, 16);
+        if(beast::detail::get_cpu_info().avx2)
+            check(&mask_avx2, 32);
+        if(beast::detail::get_cpu_info().avx512)
+            check(&mask_avx512, 64);
+    #endif
+    }
+
+    void
+    run() override
+    {
+        testMask();
+        testSequence();
+        testCopy();
+        testKernels();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,websocket,mask);
+
+} // detail
+} // websocket
+} // beast
+} // boost
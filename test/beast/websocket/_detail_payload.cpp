@@ -0,0 +1,182 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/websocket/detail/payload.hpp>
+
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace websocket {
+namespace detail {
+
+class payload_test
+    : public beast::unit_test::suite
+{
+public:
+    // Valid text of `n` octets, spanning several blocks
+    static
+    std::string
+    make_text(std::size_t n)
+    {
+        string_view const words =
+            "abc \xce\xba\xe1\xbd\xb9\xcf\x83\xce\xbc\xce\xb5 "
+            "\xe4\xb8\xad\xe6\x96\x87 \xf0\x9f\x98\x80 ";
+        std::string s;
+        while(s.size() + words.size() <= n)
+            s.append(words.data(), words.size());
+        s.resize(n, ' ');
+        return s;
+    }
+
+    static
+    std::string
+    masked(std::string s, std::uint32_t key)
+    {
+        prepared_key k;
+        prepare_key(k, key);
+        net::mutable_buffer b(&s[0], s.size());
+        mask_inplace(b, k);
+        return s;
+    }
+
+    void
+    testCopy()
+    {
+        std::uint32_t const key = 0x12345678;
+        auto const text = make_text(3 * payload_block + 100);
+        auto const src = masked(text, key);
+
+        // into pieces of every size, which split code points
+        for(std::size_t piece : {1, 7, 100, 4096, 5000, 20000})
+        {
+            std::string out(text.size(), 0);
+            std::vector<net::mutable_buffer> bs;
+            for(std::size_t i = 0; i < out.size(); i += piece)
+                bs.emplace_back(&out[i],
+                    (std::min)(piece, out.size() - i));
+            prepared_key k;
+            prepare_key(k, key);
+            utf8_checker u;
+            std::size_t n;
+            BEAST_EXPECT(copy_payload(n, bs,
+                net::buffer(src), &k, &u));
+            BEAST_EXPECT(n == text.size());
+            BEAST_EXPECTS(out == text, std::to_string(piece));
+        }
+
+        // into a smaller buffer, continuing with the same state
+        {
+            std::string out(text.size(), 0);
+            prepared_key k;
+            prepare_key(k, key);
+            utf8_checker u;
+            std::size_t n;
+            BEAST_EXPECT(copy_payload(n,
+                net::buffer(&out[0], 5001), net::buffer(src), &k, &u));
+            BEAST_EXPECT(n == 5001);
+            std::size_t n1;
+            BEAST_EXPECT(copy_payload(n1,
+                net::buffer(&out[n], out.size() - n),
+                net::buffer(src) + n, &k, &u));
+            BEAST_EXPECT(n + n1 == text.size());
+            BEAST_EXPECT(out == text);
+            BEAST_EXPECT(u.finish());
+        }
+
+        // not masked, and not text
+        {
+            std::string const bin(9000, '\xff');
+            std::string out(bin.size(), 0);
+            std::size_t n;
+            BEAST_EXPECT(copy_payload(n, net::buffer(&out[0], out.size()),
+                net::buffer(bin), nullptr, nullptr));
+            BEAST_EXPECT(n == bin.size());
+            BEAST_EXPECT(out == bin);
+        }
+    }
+
+    void
+    testInvalid()
+    {
+        std::uint32_t const key = 0xdeadbeef;
+
+        // an invalid octet in each block is found
+        for(std::size_t pos : {0, 1000, 4095, 4096, 9000})
+        {
+            auto text = make_text(10000);
+            text[pos] = '\xff';
+            auto const src = masked(text, key);
+            std::string out(text.size(), 0);
+            prepared_key k;
+            prepare_key(k, key);
+            utf8_checker u;
+            std::size_t n;
+            BEAST_EXPECTS(! copy_payload(n,
+                net::buffer(&out[0], out.size()),
+                net::buffer(src), &k, &u), std::to_string(pos));
+        }
+
+        // in place
+        {
+            auto text = make_text(10000);
+            text[7000] = '\x80';
+            auto buf = masked(text, key);
+            prepared_key k;
+            prepare_key(k, key);
+            utf8_checker u;
+            BEAST_EXPECT(! unmask_payload(
+                net::buffer(&buf[0], buf.size()), &k, &u));
+        }
+    }
+
+    void
+    testInPlace()
+    {
+        std::uint32_t const key = 0x0badf00d;
+        auto const text = make_text(10000);
+        auto buf = masked(text, key);
+        prepared_key k;
+        prepare_key(k, key);
+        utf8_checker u;
+        auto const before = get_read_counters();
+        BEAST_EXPECT(unmask_payload(
+            net::buffer(&buf[0], buf.size()), &k, &u));
+        BEAST_EXPECT(buf == text);
+        BEAST_EXPECT(u.finish());
+    #if BOOST_BEAST_WEBSOCKET_READ_COUNTERS
+        auto const& after = get_read_counters();
+        BEAST_EXPECT(after.bytes == before.bytes + text.size());
+        BEAST_EXPECT(after.copy >= before.copy);
+        BEAST_EXPECT(after.utf8 >= before.utf8);
+    #else
+        (void)before;
+    #endif
+    }
+
+    void
+    run() override
+    {
+        testCopy();
+        testInvalid();
+        testInPlace();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,websocket,payload);
+
+} // detail
+} // websocket
+} // beast
+} // boost
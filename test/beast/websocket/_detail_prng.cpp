@@ -11,6 +11,9 @@
 #include <boost/beast/websocket/detail/prng.hpp>
 
 #include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 namespace boost {
 namespace beast {
@@ -46,6 +49,56 @@ public:
         }
     }
 
+    void
+    testChacha()
+    {
+        std::uint32_t const key[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+        beast::detail::chacha<20> g(key, 1);
+        std::vector<std::uint32_t> v(16 * 16);
+        for(auto& x : v)
+            x = g();
+
+        // every block is different
+        for(std::size_t i = 16; i < v.size(); i += 16)
+            BEAST_EXPECT(! std::equal(
+                v.begin() + i - 16, v.begin() + i, v.begin() + i));
+
+        // a different stream gives different output
+        beast::detail::chacha<20> g2(key, 2);
+        BEAST_EXPECT(g2() != v[0]);
+    }
+
+    void
+    testPool()
+    {
+        // generators in use at the same time are distinct
+        {
+            auto g1 = make_prng_no_tls(true);
+            auto g2 = make_prng_no_tls(true);
+            auto g3 = g1;
+            BEAST_EXPECT(g1() != g2());
+            g3();
+        }
+
+        std::vector<std::thread> tv;
+        for(int i = 0; i < 4; ++i)
+            tv.emplace_back(
+                []
+                {
+                    for(int j = 0; j < 10000; ++j)
+                    {
+                        make_prng_no_tls(j % 2 == 0)();
+                        auto g = make_prng_no_tls(true);
+                        auto g2 = make_prng_no_tls(true);
+                        g();
+                        g2();
+                    }
+                });
+        for(auto& t : tv)
+            t.join();
+        pass();
+    }
+
     void
     run() override
     {
@@ -57,6 +110,8 @@ public:
         testPrng([]{ return make_prng_tls(true); });
         testPrng([]{ return make_prng_tls(false); });
     #endif
+        testChacha();
+        testPool();
     }
 };
 
@@ -43,6 +43,7 @@ public:
         check(error::buffer_overflow);
         check(error::partial_deflate_block);
         check(error::message_too_big);
+        check(error::send_queue_overflow);
 
         check(condition::protocol_violation, error::bad_opcode);
         check(condition::protocol_violation, error::bad_data_frame);
@@ -0,0 +1,274 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/websocket/prepared_message.hpp>
+
+#include <boost/beast/websocket/stream.hpp>
+
+#include "test.hpp"
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+class prepared_message_test : public websocket_test_suite
+{
+public:
+    // A connected server and client, both open
+    struct pair
+    {
+        stream<test::stream> server;
+        stream<test::stream> client;
+
+        pair(
+            net::io_context& ioc,
+            permessage_deflate const& server_pmd,
+            permessage_deflate const& client_pmd)
+            : server(ioc)
+            , client(ioc)
+        {
+            server.set_option(server_pmd);
+            client.set_option(client_pmd);
+            client.next_layer().connect(server.next_layer());
+            client.async_handshake("localhost", "/",
+                [](error_code ec)
+                {
+                    if(ec)
+                        BOOST_THROW_EXCEPTION(system_error{ec});
+                });
+            server.async_accept(
+                [](error_code ec)
+                {
+                    if(ec)
+                        BOOST_THROW_EXCEPTION(system_error{ec});
+                });
+            ioc.run();
+            ioc.restart();
+        }
+    };
+
+    // Send `msg` with `async_write_prepared`, then a regular message
+    void
+    doSend(
+        pair& p,
+        net::io_context& ioc,
+        prepared_message const& msg,
+        std::string const& s)
+    {
+        std::size_t n = 0;
+        p.server.async_write_prepared(msg,
+            [&](error_code ec, std::size_t bytes_transferred)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+                n = bytes_transferred;
+            });
+        flat_buffer b;
+        p.client.async_read(b,
+            [&](error_code ec, std::size_t)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        ioc.run();
+        ioc.restart();
+        BEAST_EXPECT(n == s.size());
+        BEAST_EXPECT(p.client.got_text() == msg.text());
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+
+        // a message compressed by the stream afterwards
+        b.consume(b.size());
+        p.server.binary(true);
+        p.server.async_write(net::buffer(s),
+            [&](error_code ec, std::size_t)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        p.client.async_read(b,
+            [&](error_code ec, std::size_t)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        ioc.run();
+        ioc.restart();
+        BEAST_EXPECT(buffers_to_string(b.data()) == s);
+    }
+
+    void
+    testConstruct()
+    {
+        std::string const s = "Hello, world!";
+        {
+            prepared_message msg(true, net::buffer(s));
+            BEAST_EXPECT(msg.text());
+            BEAST_EXPECT(msg.size() == s.size());
+            BEAST_EXPECT(! msg.deflated());
+        }
+        {
+            permessage_deflate pmd;
+            prepared_message msg(false, net::buffer(s), pmd);
+            BEAST_EXPECT(! msg.text());
+            BEAST_EXPECT(msg.size() == s.size());
+            BEAST_EXPECT(msg.deflated());
+        }
+        {
+            prepared_message msg(false, net::const_buffer{});
+            BEAST_EXPECT(msg.size() == 0);
+        }
+
+        auto const bad =
+        [&](permessage_deflate const& pmd)
+        {
+            try
+            {
+                prepared_message msg(true, net::buffer(s), pmd);
+                fail("", __FILE__, __LINE__);
+            }
+            catch(std::invalid_argument const&)
+            {
+                pass();
+            }
+        };
+        {
+            permessage_deflate pmd;
+            pmd.server_max_window_bits = 8;
+            bad(pmd);
+        }
+        {
+            permessage_deflate pmd;
+            pmd.compLevel = 10;
+            bad(pmd);
+        }
+        {
+            permessage_deflate pmd;
+            pmd.memLevel = 0;
+            bad(pmd);
+        }
+    }
+
+    void
+    testWrite()
+    {
+        // one frame, written as prepared
+        {
+            stream<test::stream> ws{ioc_,
+                "GET / HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "Upgrade: websocket\r\n"
+                "Connection: upgrade\r\n"
+                "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                "Sec-WebSocket-Version: 13\r\n"
+                "\r\n"};
+            auto tr = connect(ws.next_layer());
+            ws.accept();
+            tr.clear();
+            std::string const s(300, '*');
+            prepared_message msg(false, net::buffer(s));
+            BEAST_EXPECT(ws.write_prepared(msg) == s.size());
+            BEAST_EXPECT(tr.str() ==
+                std::string("\x82\x7e\x01\x2c", 4) + s);
+        }
+
+        // one frame, written as prepared and compressed
+        {
+            stream<test::stream> ws{ioc_,
+                "GET / HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "Upgrade: websocket\r\n"
+                "Connection: upgrade\r\n"
+                "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                "Sec-WebSocket-Version: 13\r\n"
+                "Sec-WebSocket-Extensions: permessage-deflate\r\n"
+                "\r\n"};
+            permessage_deflate pmd;
+            pmd.server_enable = true;
+            ws.set_option(pmd);
+            auto tr = connect(ws.next_layer());
+            ws.accept();
+            tr.clear();
+            std::string const s(300, '*');
+            prepared_message msg(false, net::buffer(s), pmd);
+            BEAST_EXPECT(ws.write_prepared(msg) == s.size());
+            BEAST_EXPECT(tr.str().size() > 2);
+            BEAST_EXPECT(tr.str().size() < 20);
+            BEAST_EXPECT(tr.str()[0] == '\xc2');
+        }
+
+        // client role
+        {
+            echo_server es{log};
+            stream<test::stream> ws{ioc_};
+            ws.next_layer().connect(es.stream());
+            ws.handshake("localhost", "/");
+            error_code ec;
+            prepared_message msg(true, net::buffer("Hello", 5));
+            BEAST_EXPECT(ws.write_prepared(msg, ec) == 0);
+            BEAST_EXPECT(ec == net::error::operation_not_supported);
+            ws.next_layer().close();
+        }
+
+        auto const& s = random_string();
+        permessage_deflate off;
+        permessage_deflate on;
+        on.server_enable = true;
+        on.client_enable = true;
+
+        // uncompressed
+        {
+            net::io_context ioc;
+            pair p{ioc, off, off};
+            doSend(p, ioc, prepared_message(false,
+                net::buffer(s)), s);
+            doSend(p, ioc, prepared_message(true,
+                net::buffer("Hello", 5)), "Hello");
+        }
+
+        // compressed form, not negotiated
+        {
+            net::io_context ioc;
+            pair p{ioc, off, off};
+            doSend(p, ioc, prepared_message(false,
+                net::buffer(s), on), s);
+        }
+
+        // compressed, then compressed by the stream
+        {
+            net::io_context ioc;
+            pair p{ioc, on, on};
+            doSend(p, ioc, prepared_message(false,
+                net::buffer(s), on), s);
+            doSend(p, ioc, prepared_message(false,
+                net::buffer(s), on), s);
+            doSend(p, ioc, prepared_message(true,
+                net::const_buffer{}, on), "");
+        }
+
+        // compressed form with a larger window than negotiated
+        {
+            permessage_deflate small = on;
+            small.server_max_window_bits = 9;
+            net::io_context ioc;
+            pair p{ioc, small, on};
+            doSend(p, ioc, prepared_message(false,
+                net::buffer(s), on), s);
+        }
+    }
+
+    void
+    run() override
+    {
+        testConstruct();
+        testWrite();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,websocket,prepared_message);
+
+} // websocket
+} // beast
+} // boost
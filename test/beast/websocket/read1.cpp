@@ -599,6 +599,34 @@ public:
             BEAST_EXPECT(buffers_to_string(b.data()) == s);
         });
 
+        // small messages, large read buffer
+        doTest(pmd, [&](ws_type& ws)
+        {
+            ws.read_buffer_size(65536);
+            ws.text(true);
+            for(int i = 0; i < 50; ++i)
+                w.write(ws, buffer("Hello, world!", 13));
+            for(int i = 0; i < 50; ++i)
+            {
+                multi_buffer b;
+                w.read(ws, b);
+                BEAST_EXPECT(buffers_to_string(b.data()) ==
+                    "Hello, world!");
+            }
+        });
+
+        // big message, small read buffer
+        doTest(pmd, [&](ws_type& ws)
+        {
+            ws.read_buffer_size(256);
+            auto const& s = random_string();
+            ws.binary(true);
+            w.write(ws, buffer(s));
+            multi_buffer b;
+            w.read(ws, b);
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        });
+
         // message, bad utf8
         doTest(pmd, [&](ws_type& ws)
         {
@@ -0,0 +1,389 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/websocket/send_queue.hpp>
+
+#include <boost/beast/websocket/stream.hpp>
+
+#include "test.hpp"
+
+namespace boost {
+namespace beast {
+namespace websocket {
+
+class send_queue_test : public websocket_test_suite
+{
+public:
+    static
+    prepared_message
+    msg(std::string const& s)
+    {
+        return prepared_message(true, net::buffer(s));
+    }
+
+    // The wire format of an unmasked, short text message
+    static
+    std::string
+    frame(std::string const& s)
+    {
+        BOOST_ASSERT(s.size() < 126);
+        return std::string{'\x81', static_cast<char>(s.size())} + s;
+    }
+
+    // A server stream in the open state
+    struct server
+    {
+        stream<test::stream> ws;
+        test::stream tr;
+
+        explicit
+        server(net::io_context& ioc)
+            : ws(ioc,
+                "GET / HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "Upgrade: websocket\r\n"
+                "Connection: upgrade\r\n"
+                "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                "Sec-WebSocket-Version: 13\r\n"
+                "\r\n")
+            , tr(connect(ws.next_layer()))
+        {
+            ws.accept();
+            tr.clear();
+        }
+    };
+
+    void
+    testPush()
+    {
+        try
+        {
+            send_queue q(0);
+            fail("", __FILE__, __LINE__);
+        }
+        catch(std::invalid_argument const&)
+        {
+            pass();
+        }
+
+        // drop oldest
+        {
+            send_queue q(3);
+            BEAST_EXPECT(q.empty());
+            for(auto const s : {"1", "2", "3", "4", "5"})
+                BEAST_EXPECT(q.push(msg(s)));
+            BEAST_EXPECT(q.size() == 3);
+            BEAST_EXPECT(q.bytes() == 3);
+            BEAST_EXPECT(q.dropped() == 2);
+            BEAST_EXPECT(q.high_water() == 3);
+            BEAST_EXPECT(! q.overflowed());
+        }
+
+        // drop newest
+        {
+            send_queue q(3, 1000, send_queue::policy::drop_newest);
+            for(auto const s : {"1", "2", "3"})
+                BEAST_EXPECT(q.push(msg(s)));
+            BEAST_EXPECT(! q.push(msg("4")));
+            BEAST_EXPECT(q.size() == 3);
+            BEAST_EXPECT(q.dropped() == 1);
+            BEAST_EXPECT(! q.overflowed());
+        }
+
+        // disconnect
+        {
+            send_queue q(2, 1000, send_queue::policy::disconnect);
+            BEAST_EXPECT(q.push(msg("1")));
+            BEAST_EXPECT(q.push(msg("2")));
+            BEAST_EXPECT(! q.push(msg("3")));
+            BEAST_EXPECT(q.overflowed());
+            BEAST_EXPECT(q.size() == 2);
+            BEAST_EXPECT(q.dropped() == 1);
+        }
+
+        // byte limit
+        {
+            send_queue q(100, 10);
+            BEAST_EXPECT(q.push(msg("12345")));
+            BEAST_EXPECT(q.push(msg("12345")));
+            BEAST_EXPECT(q.push(msg("123")));
+            BEAST_EXPECT(q.size() == 2);
+            BEAST_EXPECT(q.bytes() == 8);
+            BEAST_EXPECT(q.dropped() == 1);
+
+            // a large message replaces everything waiting
+            BEAST_EXPECT(q.push(msg("1234567890")));
+            BEAST_EXPECT(q.size() == 1);
+            BEAST_EXPECT(q.bytes() == 10);
+
+            // and is accepted by an empty queue
+            send_queue q2(100, 10, send_queue::policy::drop_newest);
+            BEAST_EXPECT(q2.push(msg(std::string(20, '*'))));
+            BEAST_EXPECT(! q2.push(msg("1")));
+            BEAST_EXPECT(q2.size() == 1);
+        }
+    }
+
+    void
+    testWrite()
+    {
+        // coalesced
+        {
+            server s{ioc_};
+            send_queue q;
+            BEAST_EXPECT(s.ws.write_prepared(q) == 0);
+            BEAST_EXPECT(s.tr.str().empty());
+            q.push(msg("Hello"));
+            q.push(msg(", "));
+            q.push(msg("world!"));
+            BEAST_EXPECT(s.ws.write_prepared(q) == 13);
+            BEAST_EXPECT(s.tr.str() ==
+                frame("Hello") + frame(", ") + frame("world!"));
+            BEAST_EXPECT(q.empty());
+            BEAST_EXPECT(q.bytes() == 0);
+            BEAST_EXPECT(q.sent() == 3);
+            BEAST_EXPECT(q.writes() == 1);
+            BEAST_EXPECT(! q.busy());
+        }
+
+        // coalescing limited
+        {
+            server s{ioc_};
+            send_queue q;
+            q.coalesce_limit(14);
+            q.push(msg("Hello"));
+            q.push(msg(", "));
+            q.push(msg("world!"));
+            BEAST_EXPECT(s.ws.write_prepared(q) == 7);
+            BEAST_EXPECT(s.tr.str() == frame("Hello") + frame(", "));
+            BEAST_EXPECT(q.size() == 1);
+            s.tr.clear();
+            q.coalesce_limit(0);
+            q.push(msg("1"));
+            BEAST_EXPECT(s.ws.write_prepared(q) == 6);
+            BEAST_EXPECT(s.ws.write_prepared(q) == 1);
+            BEAST_EXPECT(s.tr.str() == frame("world!") + frame("1"));
+            BEAST_EXPECT(q.empty());
+            BEAST_EXPECT(q.writes() == 3);
+        }
+
+        // wraps around the ring
+        {
+            server s{ioc_};
+            send_queue q(3);
+            std::string expect;
+            for(int i = 0; i < 10; ++i)
+            {
+                auto const m = std::to_string(i);
+                q.push(msg(m));
+                expect += frame(m);
+                if(i % 2 == 1)
+                    s.ws.write_prepared(q);
+            }
+            BEAST_EXPECT(s.tr.str() == expect);
+            BEAST_EXPECT(q.sent() == 10);
+            BEAST_EXPECT(q.dropped() == 0);
+        }
+
+        // overflowed
+        {
+            server s{ioc_};
+            send_queue q(1, 1000, send_queue::policy::disconnect);
+            q.push(msg("1"));
+            q.push(msg("2"));
+            try
+            {
+                s.ws.write_prepared(q);
+                fail("", __FILE__, __LINE__);
+            }
+            catch(system_error const& se)
+            {
+                BEAST_EXPECTS(se.code() == error::send_queue_overflow,
+                    se.code().message());
+            }
+            BEAST_EXPECT(s.tr.str().empty());
+        }
+
+        // client role
+        {
+            echo_server es{log};
+            stream<test::stream> ws{ioc_};
+            ws.next_layer().connect(es.stream());
+            ws.handshake("localhost", "/");
+            send_queue q;
+            q.push(msg("Hello"));
+            error_code ec;
+            BEAST_EXPECT(ws.write_prepared(q, ec) == 0);
+            BEAST_EXPECT(ec == net::error::operation_not_supported);
+            BEAST_EXPECT(q.size() == 1);
+            BEAST_EXPECT(! q.busy());
+            ws.next_layer().close();
+        }
+    }
+
+    void
+    testAsyncWrite()
+    {
+        // messages being sent are not dropped
+        {
+            net::io_context ioc;
+            server s{ioc};
+            send_queue q(2);
+            q.push(msg("1"));
+            q.push(msg("2"));
+            std::size_t n = 0;
+            s.ws.async_write_prepared(q,
+                [&](error_code ec, std::size_t bytes_transferred)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    n = bytes_transferred;
+                });
+            BEAST_EXPECT(q.busy());
+            BEAST_EXPECT(! q.push(msg("3")));
+            BEAST_EXPECT(q.dropped() == 1);
+            ioc.run();
+            BEAST_EXPECT(n == 2);
+            BEAST_EXPECT(! q.busy());
+            BEAST_EXPECT(q.empty());
+            BEAST_EXPECT(s.tr.str() == frame("1") + frame("2"));
+        }
+
+        // drain the queue while pushing
+        {
+            net::io_context ioc;
+            server s{ioc};
+            send_queue q(4);
+            std::string expect;
+            int next = 0;
+            std::function<void()> do_write;
+            auto const push =
+                [&]
+                {
+                    auto const m = std::to_string(next++);
+                    BEAST_EXPECT(q.push(msg(m)));
+                    expect += frame(m);
+                };
+            do_write =
+                [&]
+                {
+                    s.ws.async_write_prepared(q,
+                        [&](error_code ec, std::size_t)
+                        {
+                            BEAST_EXPECTS(! ec, ec.message());
+                            if(next < 20)
+                            {
+                                push();
+                                push();
+                            }
+                            if(! q.empty())
+                                do_write();
+                        });
+                };
+            push();
+            do_write();
+            ioc.run();
+            BEAST_EXPECT(q.empty());
+            BEAST_EXPECT(q.sent() == 21);
+            BEAST_EXPECT(q.writes() == 11);
+            BEAST_EXPECT(q.high_water() <= 4);
+            BEAST_EXPECT(s.tr.str() == expect);
+        }
+
+        // overflowed
+        {
+            net::io_context ioc;
+            server s{ioc};
+            send_queue q(1, 1000, send_queue::policy::disconnect);
+            q.push(msg("1"));
+            q.push(msg("2"));
+            s.ws.async_write_prepared(q,
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(ec == error::send_queue_overflow,
+                        ec.message());
+                    BEAST_EXPECT(n == 0);
+                });
+            ioc.run();
+            BEAST_EXPECT(! q.busy());
+            BEAST_EXPECT(s.tr.str().empty());
+        }
+
+        // read by a client, with compression
+        {
+            net::io_context ioc;
+            stream<test::stream> server(ioc);
+            stream<test::stream> client(ioc);
+            permessage_deflate pmd;
+            pmd.server_enable = true;
+            pmd.client_enable = true;
+            server.set_option(pmd);
+            client.set_option(pmd);
+            client.next_layer().connect(server.next_layer());
+            client.async_handshake("localhost", "/",
+                [](error_code ec)
+                {
+                    if(ec)
+                        BOOST_THROW_EXCEPTION(system_error{ec});
+                });
+            server.async_accept(
+                [](error_code ec)
+                {
+                    if(ec)
+                        BOOST_THROW_EXCEPTION(system_error{ec});
+                });
+            ioc.run();
+            ioc.restart();
+
+            auto const& s = random_string();
+            send_queue q;
+            q.coalesce_limit(64 * 1024);
+            q.push(prepared_message(false, net::buffer(s), pmd));
+            q.push(prepared_message(true, net::buffer("Hello", 5), pmd));
+            server.async_write_prepared(q,
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == s.size() + 5);
+                });
+            flat_buffer b1;
+            flat_buffer b2;
+            client.async_read(b1,
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(! client.got_text());
+                    client.async_read(b2,
+                        [&](error_code ec, std::size_t)
+                        {
+                            BEAST_EXPECTS(! ec, ec.message());
+                            BEAST_EXPECT(client.got_text());
+                        });
+                });
+            ioc.run();
+            BEAST_EXPECT(buffers_to_string(b1.data()) == s);
+            BEAST_EXPECT(buffers_to_string(b2.data()) == "Hello");
+            BEAST_EXPECT(q.writes() == 1);
+        }
+    }
+
+    void
+    run() override
+    {
+        testPush();
+        testWrite();
+        testAsyncWrite();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,websocket,send_queue);
+
+} // websocket
+} // beast
+} // boost
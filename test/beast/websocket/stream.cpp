@@ -42,6 +42,20 @@ public:
             pass();
         }
 
+        ws.read_buffer_size(65536);
+        BEAST_EXPECT(ws.read_buffer_size() == 65536);
+        ws.read_buffer_size(512);
+        BEAST_EXPECT(ws.read_buffer_size() == 512);
+        try
+        {
+            ws.read_buffer_size(138);
+            fail();
+        }
+        catch(std::exception const&)
+        {
+            pass();
+        }
+
         ws.secure_prng(true);
         ws.secure_prng(false);
 
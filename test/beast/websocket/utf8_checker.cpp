@@ -14,6 +14,8 @@
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <array>
+#include <random>
+#include <vector>
 
 namespace boost {
 namespace beast {
@@ -566,6 +568,172 @@ public:
         }
     }
 
+    // Returns `true` if the octets are valid UTF-8,
+    // checking one code point at a time.
+    static
+    bool
+    reference(std::vector<std::uint8_t> const& v)
+    {
+        std::size_t i = 0;
+        while(i < v.size())
+        {
+            auto const c = v[i];
+            std::size_t n;
+            std::uint32_t cp;
+            if(c < 0x80)
+            {
+                ++i;
+                continue;
+            }
+            else if(c >= 0xc2 && c <= 0xdf)
+            {
+                n = 1;
+                cp = c & 0x1f;
+            }
+            else if(c >= 0xe0 && c <= 0xef)
+            {
+                n = 2;
+                cp = c & 0x0f;
+            }
+            else if(c >= 0xf0 && c <= 0xf4)
+            {
+                n = 3;
+                cp = c & 0x07;
+            }
+            else
+            {
+                return false;
+            }
+            if(v.size() - i - 1 < n)
+                return false;
+            for(std::size_t j = 1; j <= n; ++j)
+            {
+                if((v[i + j] & 0xc0) != 0x80)
+                    return false;
+                cp = (cp << 6) | (v[i + j] & 0x3f);
+            }
+            if( (n == 2 && cp < 0x800) ||
+                (n == 3 && cp < 0x10000) ||
+                cp > 0x10ffff ||
+                (cp >= 0xd800 && cp <= 0xdfff))
+                return false;
+            i += n + 1;
+        }
+        return true;
+    }
+
+    // Random text, mostly valid, of every code point length
+    static
+    std::vector<std::uint8_t>
+    make_text(std::mt19937& g, std::size_t n)
+    {
+        static std::uint32_t const cps[] = {
+            0x41, 0x7f, 0xe9, 0x3b1, 0x7ff, 0x800, 0x4e2d, 0xd7ff,
+            0xe000, 0xfffd, 0x10000, 0x1f600, 0x10ffff };
+        std::vector<std::uint8_t> v;
+        while(v.size() < n)
+        {
+            auto const cp = cps[g() % (sizeof(cps) / sizeof(cps[0]))];
+            if(cp < 0x80)
+            {
+                // runs of ASCII take the fast path
+                auto k = g() % 80;
+                while(k--)
+                    v.push_back(static_cast<std::uint8_t>(
+                        0x20 + g() % 95));
+            }
+            else if(cp < 0x800)
+            {
+                v.push_back(static_cast<std::uint8_t>(0xc0 | (cp >> 6)));
+                v.push_back(static_cast<std::uint8_t>(0x80 | (cp & 0x3f)));
+            }
+            else if(cp < 0x10000)
+            {
+                v.push_back(static_cast<std::uint8_t>(0xe0 | (cp >> 12)));
+                v.push_back(static_cast<std::uint8_t>(0x80 | ((cp >> 6) & 0x3f)));
+                v.push_back(static_cast<std::uint8_t>(0x80 | (cp & 0x3f)));
+            }
+            else
+            {
+                v.push_back(static_cast<std::uint8_t>(0xf0 | (cp >> 18)));
+                v.push_back(static_cast<std::uint8_t>(0x80 | ((cp >> 12) & 0x3f)));
+                v.push_back(static_cast<std::uint8_t>(0x80 | ((cp >> 6) & 0x3f)));
+                v.push_back(static_cast<std::uint8_t>(0x80 | (cp & 0x3f)));
+            }
+        }
+        v.resize(n);
+        return v;
+    }
+
+    void
+    testRandom()
+    {
+        // The checker agrees with a simple validator on text
+        // long enough for the vector kernels, with octets
+        // changed at random and written in random pieces.
+        static std::uint8_t const bad[] = {
+            0x80, 0xbf, 0xc0, 0xc1, 0xe0, 0xed, 0xf0, 0xf4, 0xf5, 0xff, 0x00 };
+        std::mt19937 g;
+        std::size_t valid = 0;
+        for(int i = 0; i < 3000; ++i)
+        {
+            auto v = make_text(g, 1 + g() % 700);
+            for(auto k = g() % 3; k--;)
+                v[g() % v.size()] = bad[g() % sizeof(bad)];
+            auto const expected = reference(v);
+            valid += expected;
+
+            utf8_checker u;
+            bool result = true;
+            for(std::size_t pos = 0; result && pos < v.size();)
+            {
+                auto const n = (std::min<std::size_t>)(
+                    v.size() - pos, i % 2 ? v.size() : 1 + g() % 200);
+                result = u.write(v.data() + pos, n);
+                pos += n;
+            }
+            result = result && u.finish();
+            BEAST_EXPECTS(result == expected, std::to_string(i));
+        }
+        // both outcomes were tested
+        BEAST_EXPECT(valid > 300 && valid < 2700);
+    }
+
+    void
+    testKernels()
+    {
+    #if ! BOOST_BEAST_NO_INTRINSICS
+        auto const check =
+            [&](utf8_kernel f)
+            {
+                std::mt19937 g;
+                for(int i = 0; i < 2000; ++i)
+                {
+                    auto v = make_text(g, g() % 300);
+                    if(! v.empty() && i % 2)
+                        v[g() % v.size()] = static_cast<std::uint8_t>(g());
+                    BEAST_EXPECT(f(v.data(), v.size()) == reference(v));
+                }
+
+                // a code point cut short at the end of a block
+                std::vector<std::uint8_t> v(64, 'a');
+                for(std::size_t n : {31, 32, 33, 63, 64})
+                {
+                    v.resize(n);
+                    v.back() = 0xe4;
+                    BEAST_EXPECT(! f(v.data(), v.size()));
+                    v.back() = 'a';
+                    BEAST_EXPECT(f(v.data(), v.size()));
+                }
+            };
+        if(beast::detail::get_cpu_info().sse42)
+            check(&utf8_validate_sse42);
+        if(beast::detail::get_cpu_info().avx2)
+            check(&utf8_validate_avx2);
+    #endif
+        pass();
+    }
+
     void
     run() override
     {
@@ -576,6 +744,8 @@ public:
         testWithStreamBuffer();
         testBranches();
         AutodeskTests();
+        testRandom();
+        testKernels();
         // 6.4.2
         AutobahnTest(std::vector<std::vector<std::uint8_t>>{
             { 0xCE, 0xBA, 0xE1, 0xBD, 0xB9, 0xCF, 0x83, 0xCE, 0xBC, 0xCE, 0xB5, 0xF4 },
@@ -172,6 +172,27 @@ public:
             ts.close();
         });
 
+        // nomask, one frame by default
+        {
+            stream<test::stream, deflateSupported> ws{ioc_,
+                "GET / HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "Upgrade: websocket\r\n"
+                "Connection: upgrade\r\n"
+                "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                "Sec-WebSocket-Version: 13\r\n"
+                "\r\n"};
+            auto tr = connect(ws.next_layer());
+            ws.write_buffer_size(16);
+            w.accept(ws);
+            tr.clear();
+            std::string const s(16384, '*');
+            ws.binary(true);
+            w.write(ws, buffer(s));
+            BEAST_EXPECT(tr.str() ==
+                std::string("\x82\x7e\x40\x00", 4) + s);
+        }
+
         // nomask, autofrag
         doStreamLoop([&](test::stream& ts)
         {
@@ -362,6 +362,50 @@ public:
 #endif
     }
 
+    void
+    testEndOfStream()
+    {
+        // The final end-of-block code may be shorter than the
+        // root table bits with no more input following it, and
+        // octets after the end of the stream are left unused.
+        for(std::size_t n : {1, 100, 5000})
+        {
+            auto const check = corpus1(n);
+            z_stream zs;
+            memset(&zs, 0, sizeof(zs));
+            deflateInit2(&zs, 6, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+            std::string in;
+            in.resize(deflateBound(&zs,
+                static_cast<uLong>(check.size())));
+            zs.next_in = (Bytef*)check.data();
+            zs.avail_in = static_cast<uInt>(check.size());
+            zs.next_out = (Bytef*)&in[0];
+            zs.avail_out = static_cast<uInt>(in.size());
+            BEAST_EXPECT(deflate(&zs, Z_FINISH) == Z_STREAM_END);
+            in.resize(zs.total_out);
+            deflateEnd(&zs);
+
+            for(std::size_t extra : {0, 4})
+            {
+                auto const s = in + std::string(extra, '*');
+                inflate_stream is;
+                std::string out;
+                out.resize(check.size() + 1);
+                z_params zp;
+                zp.next_in = s.data();
+                zp.avail_in = s.size();
+                zp.next_out = &out[0];
+                zp.avail_out = out.size();
+                error_code ec;
+                is.write(zp, Flush::none, ec);
+                BEAST_EXPECTS(ec == error::end_of_stream, ec.message());
+                BEAST_EXPECT(zp.avail_in == extra);
+                out.resize(zp.total_out);
+                BEAST_EXPECT(out == check);
+            }
+        }
+    }
+
     void
     run() override
     {
@@ -369,6 +413,7 @@ public:
             "sizeof(inflate_stream) == " <<
             sizeof(inflate_stream) << std::endl;
         testInflate();
+        testEndOfStream();
     }
 };
 
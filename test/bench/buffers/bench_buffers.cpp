@@ -10,9 +10,15 @@
 #include <boost/beast/core/buffers_range.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/ostream.hpp>
 #include <boost/beast/core/read_size.hpp>
 #include <boost/beast/core/string.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/streambuf.hpp>
 #include <algorithm>
 #include <chrono>
@@ -24,6 +30,23 @@
 namespace boost {
 namespace beast {
 
+namespace {
+
+// A body whose parser reads with a fixed size,
+// as http::read did before read_size_hint.
+struct fixed_read_body : http::string_body
+{
+};
+
+std::size_t
+read_size_hint(
+    http::parser<true, fixed_read_body> const&, std::size_t)
+{
+    return 65536;
+}
+
+} // (anon)
+
 class buffers_test : public beast::unit_test::suite
 {
 public:
@@ -145,6 +168,86 @@ public:
         return throughput(t.elapsed(), total);
     }
 
+    struct read_stats
+    {
+        size_type throughput = 0;
+        std::size_t reads = 0;
+        std::size_t capacity = 0;
+    };
+
+    // Read `count` copies of a message with `body_size`
+    // octets of body, one after another from one stream.
+    template<class Body>
+    read_stats
+    do_http_reads(std::size_t count, std::size_t body_size)
+    {
+        net::io_context ioc;
+        test::stream ts{ioc};
+        std::string const body(body_size, '*');
+        for(auto i = count; i--;)
+            ostream(ts.buffer()) <<
+                "POST /upload HTTP/1.1\r\n"
+                "Host: localhost\r\n"
+                "User-Agent: bench\r\n"
+                "Content-Length: " << body.size() << "\r\n"
+                "\r\n" << body;
+        auto const total = ts.buffer().size();
+        read_stats stats;
+        flat_buffer b;
+        timer t;
+        for(auto i = count; i--;)
+        {
+            http::request_parser<Body> p;
+            p.body_limit(body_size);
+            error_code ec;
+            http::read(ts, b, p, ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return stats;
+            stats.capacity = (std::max)(stats.capacity, b.capacity());
+        }
+        stats.throughput = throughput(t.elapsed(), total);
+        stats.reads = ts.nread();
+        return stats;
+    }
+
+    void
+    do_http_read_trials()
+    {
+        static size_type constexpr den = 1024 * 1024;
+        std::vector<std::pair<std::size_t, std::size_t>> params;
+        params.emplace_back(100000, 0);
+        params.emplace_back(20000, 500);
+        params.emplace_back(200, 256 * 1024);
+        params.emplace_back(20, 4 * 1024 * 1024);
+        log << std::left << std::setw(30) << "http::read" <<
+            std::right << std::setw(12) << "MB/s" <<
+            std::right << std::setw(14) << "reads/msg" <<
+            std::right << std::setw(14) << "capacity" <<
+            std::endl;
+        for(auto const& param : params)
+        {
+            auto const count = param.first;
+            auto const size = param.second;
+            auto const print =
+                [&](string_view name, read_stats const& stats)
+                {
+                    log << std::left << std::setw(30) << (
+                        std::string("body=") + std::to_string(size) +
+                            ", " + std::string(name)) <<
+                        std::right << std::setw(12) <<
+                            ((stats.throughput + den / 2) / den) <<
+                        std::right << std::setw(14) << std::fixed <<
+                            std::setprecision(2) <<
+                            (double(stats.reads) / count) <<
+                        std::right << std::setw(14) << stats.capacity <<
+                        std::endl;
+                };
+            print("fixed", do_http_reads<fixed_read_body>(count, size));
+            print("adaptive", do_http_reads<http::string_body>(count, size));
+        }
+        log << std::endl;
+    }
+
     static
     inline
     void
@@ -231,6 +334,7 @@ public:
             );
             log << std::endl;
         }
+        do_http_read_trials();
         pass();
     }
 };
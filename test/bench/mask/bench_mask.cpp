@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/websocket/detail/mask.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+class mask_test : public beast::unit_test::suite
+{
+public:
+    using size_type = std::uint64_t;
+
+    using prepared_key =
+        websocket::detail::prepared_key;
+
+    class timer
+    {
+    public:
+        using clock_type =
+            std::chrono::system_clock;
+
+    private:
+        clock_type::time_point when_;
+
+    public:
+        using duration =
+            clock_type::duration;
+
+        timer()
+            : when_(clock_type::now())
+        {
+        }
+
+        duration
+        elapsed() const
+        {
+            return clock_type::now() - when_;
+        }
+    };
+
+    static
+    inline
+    size_type
+    throughput(std::chrono::duration<
+        double> const& elapsed, size_type items)
+    {
+        using namespace std::chrono;
+        return static_cast<size_type>(
+            1 / (elapsed/items).count());
+    }
+
+    // The previous implementation, four octets at a time
+    static
+    void
+    mask_scalar(net::mutable_buffer& b, prepared_key& key)
+    {
+        auto n = b.size();
+        auto mask = key;
+        auto p = static_cast<unsigned char*>(b.data());
+        while(n >= 4)
+        {
+            for(int i = 0; i < 4; ++i)
+                p[i] ^= mask[i];
+            p += 4;
+            n -= 4;
+        }
+        if(n > 0)
+        {
+            for(std::size_t i = 0; i < n; ++i)
+                p[i] ^= mask[i];
+            websocket::detail::rol(key, n);
+        }
+    }
+
+    // Mask every octet with one kernel
+    template<class Kernel>
+    static
+    void
+    mask_with(Kernel f, net::mutable_buffer& b, prepared_key& key)
+    {
+        auto const p = static_cast<unsigned char*>(b.data());
+        std::uint32_t k;
+        std::memcpy(&k, key.data(), 4);
+        auto const m = f(p, p, b.size(), k);
+        websocket::detail::mask_bytes(p + m, p + m, b.size() - m, key);
+    }
+
+    // Octets masked per second, the best of three trials
+    template<class F>
+    size_type
+    measure(std::vector<unsigned char>& v, std::size_t size, F const& f)
+    {
+        // mask about 256MB in each trial
+        auto const n = (std::max<std::size_t>)(
+            1, (std::size_t(256) << 20) / size);
+        size_type result = 0;
+        for(int trial = 0; trial < 3; ++trial)
+        {
+            prepared_key key;
+            websocket::detail::prepare_key(key, 0x12345678);
+            timer t;
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                net::mutable_buffer b(v.data(), size);
+                f(b, key);
+            }
+            result = (std::max)(result,
+                throughput(t.elapsed(), size * n));
+        }
+        return result;
+    }
+
+    static
+    std::string
+    to_size(std::size_t n)
+    {
+        if(n >= 1024 * 1024)
+            return std::to_string(n >> 20) + "MB";
+        if(n >= 1024)
+            return std::to_string(n >> 10) + "KB";
+        return std::to_string(n) + "B";
+    }
+
+    void
+    run() override
+    {
+        using namespace websocket::detail;
+        std::vector<unsigned char> v(16 * 1024 * 1024);
+        for(std::size_t i = 0; i < v.size(); ++i)
+            v[i] = static_cast<unsigned char>(i);
+        std::vector<std::pair<std::string,
+            std::function<void(net::mutable_buffer&, prepared_key&)>>> fs;
+        fs.emplace_back("scalar", &mask_scalar);
+        fs.emplace_back("words",
+            [](net::mutable_buffer& b, prepared_key& key)
+            {
+                mask_with(&mask_words, b, key);
+            });
+    #if ! BOOST_BEAST_NO_INTRINSICS
+        fs.emplace_back("sse2",
+            [](net::mutable_buffer& b, prepared_key& key)
+            {
+                mask_with(&mask_sse2, b, key);
+            });
+        if(beast::detail::get_cpu_info().avx2)
+            fs.emplace_back("avx2",
+                [](net::mutable_buffer& b, prepared_key& key)
+                {
+                    mask_with(&mask_avx2, b, key);
+                });
+        if(beast::detail::get_cpu_info().avx512)
+            fs.emplace_back("avx512",
+                [](net::mutable_buffer& b, prepared_key& key)
+                {
+                    mask_with(&mask_avx512, b, key);
+                });
+    #endif
+        fs.emplace_back("dispatch",
+            [](net::mutable_buffer& b, prepared_key& key)
+            {
+                mask_inplace(b, key);
+            });
+
+        log << std::endl;
+        log << std::left << std::setw(24) << "MB/s";
+        for(auto const& f : fs)
+            log << std::right << std::setw(10) << f.first;
+        log << std::endl;
+        for(std::size_t size = 16; size <= v.size(); size *= 4)
+        {
+            log << std::left << std::setw(24) << to_size(size);
+            for(auto const& f : fs)
+                log << std::right << std::setw(10) <<
+                    measure(v, size, f.second) / 1000000;
+            log << std::endl;
+        }
+        log << std::endl;
+
+        // copying the payload to the write buffer and masking it
+        std::vector<unsigned char> dst(v.size());
+        log << std::left << std::setw(24) << "MB/s" <<
+            std::right << std::setw(10) << "copy+mask" <<
+            std::right << std::setw(10) << "fused" <<
+            std::endl;
+        for(std::size_t size = 16; size <= v.size(); size *= 4)
+        {
+            log << std::left << std::setw(24) << to_size(size) <<
+                std::right << std::setw(10) << measure(v, size,
+                    [&](net::mutable_buffer& b, prepared_key& key)
+                    {
+                        net::mutable_buffer d(dst.data(), b.size());
+                        net::buffer_copy(d, b);
+                        mask_inplace(d, key);
+                    }) / 1000000 <<
+                std::right << std::setw(10) << measure(v, size,
+                    [&](net::mutable_buffer& b, prepared_key& key)
+                    {
+                        mask_copy(net::mutable_buffer(
+                            dst.data(), b.size()), b, key);
+                    }) / 1000000 <<
+                std::endl;
+        }
+        log << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,mask);
+
+} // beast
+} // boost
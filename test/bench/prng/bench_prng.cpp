@@ -0,0 +1,206 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/websocket/detail/prng.hpp>
+#include <boost/beast/websocket/stream.hpp>
+#include <boost/beast/_experimental/test/stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+class prng_test : public beast::unit_test::suite
+{
+public:
+    using size_type = std::uint64_t;
+
+    class timer
+    {
+    public:
+        using clock_type =
+            std::chrono::system_clock;
+
+    private:
+        clock_type::time_point when_;
+
+    public:
+        using duration =
+            clock_type::duration;
+
+        timer()
+            : when_(clock_type::now())
+        {
+        }
+
+        duration
+        elapsed() const
+        {
+            return clock_type::now() - when_;
+        }
+    };
+
+    static
+    inline
+    size_type
+    throughput(std::chrono::duration<
+        double> const& elapsed, size_type items)
+    {
+        using namespace std::chrono;
+        return static_cast<size_type>(
+            1 / (elapsed/items).count());
+    }
+
+    // Calls per second on `threads` threads, the best of three trials.
+    // The calls are always made on new threads, because the standard
+    // library may skip locking until a process starts its first thread.
+    template<class F>
+    size_type
+    measure(std::size_t n, std::size_t threads, F const& f)
+    {
+        size_type result = 0;
+        for(int trial = 0; trial < 3; ++trial)
+        {
+            timer t;
+            std::vector<std::thread> tv;
+            for(std::size_t i = 0; i < threads; ++i)
+                tv.emplace_back([&]{ f(n); });
+            for(auto& th : tv)
+                th.join();
+            result = (std::max)(result,
+                throughput(t.elapsed(), n * threads));
+        }
+        return result;
+    }
+
+    // Acquire a generator for each key, as a stream does for each frame
+    template<class Make>
+    static
+    void
+    make_keys(std::size_t n, Make const& make)
+    {
+        std::uint32_t sum = 0;
+        for(std::size_t i = 0; i < n; ++i)
+            sum += make()();
+        volatile std::uint32_t sink = sum;
+        (void)sink;
+    }
+
+    // Write small messages on a client stream, each one masked
+    static
+    void
+    write_masked(std::size_t n, std::size_t size, bool secure)
+    {
+        net::io_context ioc;
+        websocket::stream<test::stream> ws{ioc};
+        websocket::stream<test::stream> server{ioc};
+        ws.next_layer().connect(server.next_layer());
+        ws.async_handshake("localhost", "/",
+            [](error_code ec)
+            {
+                if(ec)
+                    BOOST_THROW_EXCEPTION(system_error{ec});
+            });
+        server.async_accept(
+            [](error_code ec)
+            {
+                if(ec)
+                    BOOST_THROW_EXCEPTION(system_error{ec});
+            });
+        ioc.run();
+        ws.secure_prng(secure);
+        ws.binary(true);
+        std::string const s(size, '*');
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            ws.write(net::buffer(s));
+            if((i % 1024) == 0)
+                server.next_layer().clear();
+        }
+    }
+
+    void
+    run() override
+    {
+        using namespace websocket::detail;
+        std::size_t const n = 10000000;
+
+        std::vector<std::pair<std::string,
+            std::function<void(std::size_t)>>> fs;
+        fs.emplace_back("no-tls fast",
+            [](std::size_t n)
+            {
+                make_keys(n, []{ return make_prng_no_tls(false); });
+            });
+        fs.emplace_back("no-tls secure",
+            [](std::size_t n)
+            {
+                make_keys(n, []{ return make_prng_no_tls(true); });
+            });
+    #if ! BOOST_BEAST_NO_THREAD_LOCAL
+        fs.emplace_back("tls fast",
+            [](std::size_t n)
+            {
+                make_keys(n, []{ return make_prng_tls(false); });
+            });
+        fs.emplace_back("tls secure",
+            [](std::size_t n)
+            {
+                make_keys(n, []{ return make_prng_tls(true); });
+            });
+    #endif
+
+        log << std::endl;
+        log << std::left << std::setw(24) << "Mkeys/s" <<
+            std::right << std::setw(10) << "1 thread" <<
+            std::right << std::setw(10) << "4 threads" <<
+            std::endl;
+        for(auto const& f : fs)
+            log << std::left << std::setw(24) << f.first <<
+                std::right << std::setw(10) <<
+                    measure(n, 1, f.second) / 1000000. <<
+                std::right << std::setw(10) <<
+                    measure(n / 4, 4, f.second) / 1000000. <<
+                std::endl;
+        log << std::endl;
+
+        log << std::left << std::setw(24) << "Kmsgs/s" <<
+            std::right << std::setw(10) << "fast" <<
+            std::right << std::setw(10) << "secure" <<
+            std::endl;
+        for(std::size_t size : {0, 16, 64})
+            log << std::left << std::setw(24) <<
+                (std::to_string(size) + "B masked") <<
+                std::right << std::setw(10) << measure(n / 10, 1,
+                    [size](std::size_t n)
+                    {
+                        write_masked(n, size, false);
+                    }) / 1000 <<
+                std::right << std::setw(10) << measure(n / 10, 1,
+                    [size](std::size_t n)
+                    {
+                        write_masked(n, size, true);
+                    }) / 1000 <<
+                std::endl;
+        log << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,prng);
+
+} // beast
+} // boost
@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/sip/batch.hpp>
+#include <boost/beast/sip/datagram.hpp>
+#include <boost/beast/sip/message.hpp>
+#include <boost/beast/sip/parser.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <iomanip>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+class sip_batch_test : public beast::unit_test::suite
+{
+public:
+    using size_type = std::uint64_t;
+
+    using udp = net::ip::udp;
+
+    using socket_type = net::basic_datagram_socket<
+        udp, net::io_context::executor_type>;
+
+    using parser_type =
+        udp_parser<true, http::string_body>;
+
+    class timer
+    {
+        using clock_type =
+            std::chrono::system_clock;
+
+        clock_type::time_point when_;
+
+    public:
+        using duration =
+            clock_type::duration;
+
+        timer()
+            : when_(clock_type::now())
+        {
+        }
+
+        duration
+        elapsed() const
+        {
+            return clock_type::now() - when_;
+        }
+    };
+
+    static
+    size_type
+    throughput(std::chrono::duration<
+        double> const& elapsed, size_type items)
+    {
+        return static_cast<size_type>(
+            1 / (elapsed/items).count());
+    }
+
+    static
+    udp_request<http::string_body>
+    make_request()
+    {
+        udp_request<http::string_body> req;
+        req.method_string("OPTIONS");
+        req.target("sip:bob@example.com");
+        req.version(20);
+        req.set(http::field::via,
+            "SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds");
+        req.set(http::field::from,
+            "Alice <sip:alice@atlanta.com>;tag=1928301774");
+        req.set(http::field::to, "Bob <sip:bob@example.com>");
+        req.set(http::field::call_id, "a84b4c76e66710@pc33.atlanta.com");
+        req.set(http::field::cseq, "314159 OPTIONS");
+        req.set(http::field::max_forwards, "70");
+        req.prepare_payload();
+        return req;
+    }
+
+    struct sockets
+    {
+        net::io_context ioc;
+        socket_type s0{ioc, udp::endpoint{
+            net::ip::address_v4::loopback(), 0}};
+        socket_type s1{ioc, udp::endpoint{
+            net::ip::address_v4::loopback(), 0}};
+    };
+
+    // Each message sent with send_to and
+    // received with one call to receive_from.
+    size_type
+    do_single(std::size_t rounds, std::size_t burst)
+    {
+        sockets ss;
+        auto const req = make_request();
+        datagram_buffer b0;
+        datagram_buffer b1;
+        udp::endpoint sender;
+        auto const dest = ss.s1.local_endpoint();
+        std::size_t total = 0;
+        timer t;
+        for(auto i = rounds; i--;)
+        {
+            for(auto j = burst; j--;)
+                send_message(ss.s0, b0, req, dest);
+            for(auto j = burst; j--;)
+            {
+                parser_type p;
+                receive_message(ss.s1, b1, p, sender);
+                ++total;
+            }
+        }
+        return throughput(t.elapsed(), total);
+    }
+
+    // Messages sent with sendmmsg and received with
+    // recvmmsg, `burst` messages at a time.
+    size_type
+    do_batch(std::size_t rounds, std::size_t burst)
+    {
+        sockets ss;
+        auto const req = make_request();
+        datagram_batch b0{burst};
+        datagram_batch b1{burst};
+        boost::optional<parser_type> p;
+        auto const dest = ss.s1.local_endpoint();
+        std::size_t total = 0;
+        timer t;
+        for(auto i = rounds; i--;)
+        {
+            b0.clear();
+            error_code ec;
+            while(! b0.full())
+                serialize_datagram(b0, req, dest, ec);
+            send_batch(ss.s0, b0);
+            for(std::size_t n = 0; n < burst;)
+            {
+                auto const count = receive_batch(ss.s1, b1);
+                for(std::size_t j = 0; j < count; ++j)
+                {
+                    p.emplace();
+                    parse_datagram(*p, b1.data(j), ec);
+                }
+                n += count;
+                total += count;
+            }
+        }
+        return throughput(t.elapsed(), total);
+    }
+
+    void
+    run() override
+    {
+        static std::size_t constexpr messages = 200000;
+        log << std::endl;
+        log << std::left << std::setw(24) << "messages per second" <<
+            std::right << std::setw(15) << "receive_from" <<
+            std::right << std::setw(15) << "recvmmsg" <<
+            std::endl;
+        for(std::size_t burst : {1, 8, 32, 64})
+        {
+            auto const rounds = messages / burst;
+            log << std::left << std::setw(24) <<
+                ("burst=" + std::to_string(burst)) <<
+                std::right << std::setw(15) <<
+                    do_single(rounds, burst) <<
+                std::right << std::setw(15) <<
+                    do_batch(rounds, burst) <<
+                std::endl;
+        }
+        log << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,sip_batch);
+
+} // sip
+} // beast
+} // boost
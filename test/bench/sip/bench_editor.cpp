@@ -0,0 +1,173 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/sip/datagram.hpp>
+#include <boost/beast/sip/editor.hpp>
+#include <boost/beast/sip/message.hpp>
+#include <boost/beast/sip/parser.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <chrono>
+#include <iomanip>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+class sip_editor_test : public beast::unit_test::suite
+{
+public:
+    using size_type = std::uint64_t;
+
+    using parser_type =
+        udp_parser<true, http::string_body>;
+
+    class timer
+    {
+        using clock_type =
+            std::chrono::system_clock;
+
+        clock_type::time_point when_;
+
+    public:
+        using duration =
+            clock_type::duration;
+
+        timer()
+            : when_(clock_type::now())
+        {
+        }
+
+        duration
+        elapsed() const
+        {
+            return clock_type::now() - when_;
+        }
+    };
+
+    static
+    size_type
+    throughput(std::chrono::duration<
+        double> const& elapsed, size_type items)
+    {
+        return static_cast<size_type>(
+            1 / (elapsed/items).count());
+    }
+
+    static
+    string_view
+    via()
+    {
+        return "SIP/2.0/UDP proxy.example.com;branch=z9hG4bK4b43c2ff8.1";
+    }
+
+    // A serialized INVITE with `extra` additional fields
+    static
+    std::string
+    make_message(std::size_t extra)
+    {
+        udp_request<http::string_body> req;
+        req.method_string("INVITE");
+        req.target("sip:bob@example.com");
+        req.version(20);
+        req.set(http::field::via,
+            "SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds");
+        req.set(http::field::max_forwards, "70");
+        req.set(http::field::from,
+            "Alice <sip:alice@atlanta.com>;tag=1928301774");
+        req.set(http::field::to, "Bob <sip:bob@example.com>");
+        req.set(http::field::call_id, "a84b4c76e66710@pc33.atlanta.com");
+        req.set(http::field::cseq, "314159 INVITE");
+        for(std::size_t i = 0; i < extra; ++i)
+            req.insert("X-Field-" + std::to_string(i),
+                "0123456789abcdef0123456789abcdef");
+        req.body() =
+            "v=0\r\n"
+            "o=alice 2890844526 2890844526 IN IP4 pc33.atlanta.com\r\n"
+            "s=-\r\n"
+            "c=IN IP4 pc33.atlanta.com\r\n"
+            "t=0 0\r\n"
+            "m=audio 49172 RTP/AVP 0\r\n";
+        req.prepare_payload();
+        datagram_buffer b;
+        error_code ec;
+        serialize_datagram(b, req, ec);
+        return {static_cast<char const*>(b.data().data()), b.data().size()};
+    }
+
+    // Parse the message, modify the container and serialize it.
+    size_type
+    do_reserialize(string_view m, std::size_t n)
+    {
+        datagram_buffer b;
+        timer t;
+        for(auto i = n; i--;)
+        {
+            parser_type p;
+            error_code ec;
+            parse_datagram(p, {m.data(), m.size()}, ec);
+            auto& req = p.get();
+            req.target("sip:bob@192.0.2.4");
+            req.set(http::field::max_forwards, "69");
+            req.insert(http::field::via, via());
+            serialize_datagram(b, req, ec);
+        }
+        return throughput(t.elapsed(), n);
+    }
+
+    // Edit the octets and copy the result to the send buffer.
+    size_type
+    do_edit(string_view m, std::size_t n)
+    {
+        datagram_buffer b;
+        message_editor e;
+        timer t;
+        for(auto i = n; i--;)
+        {
+            error_code ec;
+            e.reset({m.data(), m.size()}, ec);
+            e.set_target("sip:bob@192.0.2.4");
+            e.decrement_max_forwards();
+            e.push_via(via());
+            b.commit(net::buffer_copy(b.prepare(), e.buffers()));
+        }
+        return throughput(t.elapsed(), n);
+    }
+
+    void
+    run() override
+    {
+        static std::size_t constexpr messages = 200000;
+        log << std::endl;
+        log << std::left << std::setw(24) << "messages per second" <<
+            std::right << std::setw(15) << "reserialize" <<
+            std::right << std::setw(15) << "edit" <<
+            std::endl;
+        for(std::size_t extra : {0, 8, 32})
+        {
+            auto const m = make_message(extra);
+            log << std::left << std::setw(24) <<
+                (std::to_string(m.size()) + " octets") <<
+                std::right << std::setw(15) <<
+                    do_reserialize(m, messages) <<
+                std::right << std::setw(15) <<
+                    do_edit(m, messages) <<
+                std::endl;
+        }
+        log << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,sip_editor);
+
+} // sip
+} // beast
+} // boost
@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/sip/parser.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace sip {
+
+class sip_parser_test : public beast::unit_test::suite
+{
+public:
+    using size_type = std::uint64_t;
+
+    class timer
+    {
+        using clock_type =
+            std::chrono::system_clock;
+
+        clock_type::time_point when_;
+
+    public:
+        using duration =
+            clock_type::duration;
+
+        timer()
+            : when_(clock_type::now())
+        {
+        }
+
+        duration
+        elapsed() const
+        {
+            return clock_type::now() - when_;
+        }
+    };
+
+    static
+    size_type
+    throughput(std::chrono::duration<
+        double> const& elapsed, size_type items)
+    {
+        return static_cast<size_type>(
+            1 / (elapsed/items).count());
+    }
+
+    // The same request in each protocol, with full field names
+    static
+    std::string
+    make_message(string_view version)
+    {
+        std::string s = "INVITE sip:bob@biloxi.com ";
+        s.append(version.data(), version.size());
+        s +=
+            "\r\n"
+            "Via: SIP/2.0/UDP pc33.atlanta.com;branch=z9hG4bK776asdhds\r\n"
+            "Max-Forwards: 70\r\n"
+            "To: Bob <sip:bob@biloxi.com>\r\n"
+            "From: Alice <sip:alice@atlanta.com>;tag=1928301774\r\n"
+            "Call-ID: a84b4c76e66710@pc33.atlanta.com\r\n"
+            "CSeq: 314159 INVITE\r\n"
+            "Contact: <sip:alice@pc33.atlanta.com>\r\n"
+            "Content-Type: application/sdp\r\n"
+            "User-Agent: bench\r\n"
+            "Content-Length: 4\r\n"
+            "\r\n"
+            "v=0\n";
+        return s;
+    }
+
+    // Parse each message and look up the fields a proxy
+    // examines by name, as when they arrive from the network.
+    template<class Parser>
+    size_type
+    do_parse(std::string const& m, std::size_t n)
+    {
+        static char const* const names[] = {
+            "Via", "To", "From", "Call-ID", "CSeq", "Max-Forwards" };
+        std::size_t found = 0;
+        std::size_t failed = 0;
+        timer t;
+        for(auto i = n; i--;)
+        {
+            Parser p;
+            p.eager(true);
+            error_code ec;
+            p.put(net::buffer(m), ec);
+            failed += ec || ! p.is_done();
+            auto const& f = p.get();
+            for(auto name : names)
+                found += f.find(name) != f.end();
+        }
+        auto const result = throughput(t.elapsed(), n);
+        BEAST_EXPECT(failed == 0);
+        BEAST_EXPECT(found == n * 6);
+        return result;
+    }
+
+    // The best of several trials
+    template<class Parser>
+    size_type
+    best(std::string const& m, std::size_t n)
+    {
+        size_type result = 0;
+        for(int i = 0; i < 5; ++i)
+            result = (std::max)(result, do_parse<Parser>(m, n));
+        return result;
+    }
+
+    void
+    run() override
+    {
+        static std::size_t constexpr messages = 200000;
+        auto const http = make_message("HTTP/1.1");
+        auto const sip = make_message("SIP/2.0");
+        log << std::endl;
+        log << std::left << std::setw(24) << "messages per second" <<
+            std::right << std::setw(15) << "HTTP" <<
+            std::right << std::setw(15) << "SIP/TCP" <<
+            std::right << std::setw(15) << "SIP/UDP" <<
+            std::endl;
+        log << std::left << std::setw(24) << "best of 5" <<
+            std::right << std::setw(15) <<
+                best<http::request_parser<
+                    http::string_body>>(http, messages) <<
+            std::right << std::setw(15) <<
+                best<tcp_parser<true,
+                    http::string_body>>(sip, messages) <<
+            std::right << std::setw(15) <<
+                best<udp_parser<true,
+                    http::string_body>>(sip, messages) <<
+            std::endl;
+        log << std::endl;
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,sip_parser);
+
+} // sip
+} // beast
+} // boost
@@ -10,7 +10,9 @@
 #include <boost/beast/websocket/detail/utf8_checker.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <chrono>
+#include <iomanip>
 #include <random>
+#include <string>
 
 #ifndef BEAST_USE_BOOST_LOCALE_BENCHMARK
 #define BEAST_USE_BOOST_LOCALE_BENCHMARK 0
@@ -75,22 +77,61 @@ public:
             1 / (elapsed/items).count());
     }
 
+    // Append the UTF-8 encoding of a code point
+    static
+    void
+    append(std::string& s, std::uint32_t cp)
+    {
+        if(cp < 0x80)
+        {
+            s.push_back(static_cast<char>(cp));
+        }
+        else if(cp < 0x800)
+        {
+            s.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+        else if(cp < 0x10000)
+        {
+            s.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+        else
+        {
+            s.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+            s.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+        }
+    }
+
+    // Text of about `n` octets, in words of code points
+    // drawn from each range and separated by spaces.
     std::string
-    corpus(std::size_t n)
+    corpus(std::size_t n,
+        std::initializer_list<std::pair<
+            std::uint32_t, std::uint32_t>> ranges)
     {
         std::string s;
-        s.reserve(n);
-        while(n--)
-            s.push_back(static_cast<char>(
-                ' ' + rand(95)));
+        s.reserve(n + 8);
+        while(s.size() < n)
+        {
+            auto const& r = *(ranges.begin() + rand(ranges.size()));
+            for(auto i = 1 + rand(8); i--;)
+                append(s, r.first +
+                    rand<std::uint32_t>(r.second - r.first));
+            s.push_back(' ');
+        }
         return s;
     }
 
     void
     checkBeast(std::string const& s)
     {
-        beast::websocket::detail::check_utf8(
-            s.data(), s.size());
+        if(! beast::websocket::detail::check_utf8(
+                s.data(), s.size()))
+            fail("invalid", __FILE__, __LINE__);
     }
 
 #if BEAST_USE_BOOST_LOCALE_BENCHMARK
@@ -118,34 +159,97 @@ public:
         return t.elapsed();
     }
 
-    void
-    run() override
+    // The best throughput of several trials, in octets per second
+    template<class F>
+    size_type
+    best(std::string const& s, F const& f)
     {
-        auto const s = corpus(32 * 1024 * 1024);
+        size_type result = 0;
         for(int i = 0; i < 5; ++ i)
         {
             auto const elapsed = test([&]{
-                checkBeast(s);
-                checkBeast(s);
-                checkBeast(s);
-                checkBeast(s);
-                checkBeast(s);
+                f(s);
+                f(s);
+                f(s);
+                f(s);
+                f(s);
             });
-            log << "beast:  " << throughput(elapsed, s.size()) << " char/s" << std::endl;
+            result = (std::max)(result,
+                throughput(elapsed, 5 * s.size()));
         }
+        return result;
+    }
+
+    void
+    run() override
+    {
+        std::size_t constexpr n = 8 * 1024 * 1024;
+        struct
+        {
+            char const* name;
+            std::string s;
+        } const corpora[] = {
+            { "ascii", corpus(n, {{0x21, 0x7f}}) },
+            { "latin", corpus(n, {{0x21, 0x7f}, {0xc0, 0x180}}) },
+            { "greek/cyrillic", corpus(n, {{0x391, 0x3ca}, {0x410, 0x450}}) },
+            { "cjk", corpus(n, {{0x4e00, 0x9fa6}, {0x3041, 0x3097}}) },
+            { "emoji", corpus(n, {{0x1f300, 0x1f650}}) },
+            { "mixed", corpus(n, {{0x21, 0x7f}, {0x410, 0x450},
+                {0x4e00, 0x9fa6}, {0x1f300, 0x1f650}}) },
+        };
+        log << std::endl;
+        log << std::left << std::setw(16) << "MB/s" <<
+            std::right << std::setw(10) << "checker";
+    #if ! BOOST_BEAST_NO_INTRINSICS
+        log << std::right << std::setw(10) << "sse4.2" <<
+            std::right << std::setw(10) << "avx2";
+    #endif
     #if BEAST_USE_BOOST_LOCALE_BENCHMARK
-        for(int i = 0; i < 5; ++ i)
+        log << std::right << std::setw(10) << "locale";
+    #endif
+        log << std::endl;
+        for(auto const& c : corpora)
         {
-            auto const elapsed = test([&]{
-                checkLocale(s);
-                checkLocale(s);
-                checkLocale(s);
-                checkLocale(s);
-                checkLocale(s);
-            });
-            log << "locale: " << throughput(elapsed, s.size()) << " char/s" << std::endl;
+            log << std::left << std::setw(16) << c.name <<
+                std::right << std::setw(10) << best(c.s,
+                    [&](std::string const& s)
+                    {
+                        checkBeast(s);
+                    }) / 1000000;
+        #if ! BOOST_BEAST_NO_INTRINSICS
+            using namespace websocket::detail;
+            auto const kernel =
+                [&](bool supported, utf8_kernel f)
+                {
+                    log << std::right << std::setw(10);
+                    if(! supported)
+                    {
+                        log << "-";
+                        return;
+                    }
+                    log << best(c.s,
+                        [&](std::string const& s)
+                        {
+                            if(! f(reinterpret_cast<std::uint8_t const*>(
+                                    s.data()), s.size()))
+                                fail("invalid", __FILE__, __LINE__);
+                        }) / 1000000;
+                };
+            kernel(beast::detail::get_cpu_info().sse42,
+                &utf8_validate_sse42);
+            kernel(beast::detail::get_cpu_info().avx2,
+                &utf8_validate_avx2);
+        #endif
+        #if BEAST_USE_BOOST_LOCALE_BENCHMARK
+            log << std::right << std::setw(10) << best(c.s,
+                [&](std::string const& s)
+                {
+                    checkLocale(s);
+                }) / 1000000;
+        #endif
+            log << std::endl;
         }
-    #endif
+        log << std::endl;
         pass();
     }
 };
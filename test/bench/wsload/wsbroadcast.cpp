@@ -0,0 +1,404 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+//------------------------------------------------------------------------------
+//
+// wsbroadcast
+//
+//  Measure the broadcast performance of a WebSocket chat server
+//
+//  Many subscribers connect to the server, then one publisher sends
+//  text messages, each of which the server delivers to every client.
+//  The publisher sends the next message when its own copy arrives,
+//  so the server is never asked to drop messages for a slow client.
+//
+//------------------------------------------------------------------------------
+
+#include <example/common/session_alloc.hpp>
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/_experimental/unit_test/dstream.hpp>
+#include <boost/asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace beast = boost::beast;         // from <boost/beast.hpp>
+namespace http = beast::http;           // from <boost/beast/http.hpp>
+namespace websocket = beast::websocket; // from <boost/beast/websocket.hpp>
+namespace net = boost::asio;            // from <boost/asio.hpp>
+using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
+
+class report
+{
+    std::mutex m_;
+    std::size_t bytes_ = 0;
+    std::size_t messages_ = 0;
+
+public:
+    void
+    insert(std::size_t messages, std::size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        bytes_ += bytes;
+        messages_ += messages;
+    }
+
+    std::size_t
+    bytes() const
+    {
+        return bytes_;
+    }
+
+    std::size_t
+    messages() const
+    {
+        return messages_;
+    }
+};
+
+void
+fail(beast::error_code ec, char const* what)
+{
+    std::cerr << what << ": " << ec.message() << "\n";
+}
+
+// Starts the publisher once every connection is open
+class start_gate
+{
+    std::atomic<std::size_t> pending_;
+    std::function<void()> start_;
+
+public:
+    explicit
+    start_gate(std::size_t n)
+        : pending_(n)
+    {
+    }
+
+    void
+    on_start(std::function<void()> f)
+    {
+        start_ = std::move(f);
+    }
+
+    void
+    arrive()
+    {
+        if(--pending_ == 0)
+            start_();
+    }
+};
+
+class connection
+    : public std::enable_shared_from_this<connection>
+{
+    websocket::stream<tcp::socket> ws_;
+    tcp::endpoint ep_;
+    std::size_t messages_;
+    std::string const& msg_;
+    std::string const& last_;
+    report& rep_;
+    start_gate& gate_;
+    net::strand<
+        net::io_context::executor_type> strand_;
+    net::steady_timer timer_;
+    beast::flat_buffer buffer_;
+    std::size_t count_ = 0;
+    std::size_t bytes_ = 0;
+    bool publisher_ = false;
+    session_alloc<char> alloc_;
+
+public:
+    connection(
+        net::io_context& ioc,
+        tcp::endpoint const& ep,
+        std::size_t messages,
+        std::string const& msg,
+        std::string const& last,
+        report& rep,
+        start_gate& gate)
+        : ws_(ioc)
+        , ep_(ep)
+        , messages_(messages)
+        , msg_(msg)
+        , last_(last)
+        , rep_(rep)
+        , gate_(gate)
+        , strand_(ioc.get_executor())
+        , timer_(ioc)
+    {
+        ws_.text(true);
+    }
+
+    ~connection()
+    {
+        rep_.insert(count_, bytes_);
+    }
+
+    void
+    run()
+    {
+        ws_.next_layer().async_connect(ep_,
+            net::bind_executor(strand_, alloc_.wrap(std::bind(
+                &connection::on_connect,
+                shared_from_this(),
+                std::placeholders::_1))));
+    }
+
+    // Called once, to make this connection send the messages
+    void
+    publish()
+    {
+        net::post(strand_,
+            std::bind(
+                &connection::on_publish,
+                shared_from_this()));
+    }
+
+private:
+    void
+    on_publish()
+    {
+        publisher_ = true;
+
+        // Give the server a moment to finish joining the
+        // sessions whose handshake response was just sent.
+        timer_.expires_after(std::chrono::milliseconds(100));
+        timer_.async_wait(
+            net::bind_executor(strand_,
+                std::bind(
+                    &connection::on_timer,
+                    shared_from_this(),
+                    std::placeholders::_1)));
+    }
+
+    void
+    on_connect(beast::error_code ec)
+    {
+        if(ec)
+            return fail(ec, "on_connect");
+
+        ws_.async_handshake(
+            ep_.address().to_string() + ":" + std::to_string(ep_.port()),
+            "/",
+            net::bind_executor(strand_, alloc_.wrap(std::bind(
+                &connection::on_handshake,
+                shared_from_this(),
+                std::placeholders::_1))));
+    }
+
+    void
+    on_handshake(beast::error_code ec)
+    {
+        if(ec)
+            return fail(ec, "handshake");
+
+        do_read();
+        gate_.arrive();
+    }
+
+    void
+    on_timer(beast::error_code ec)
+    {
+        if(ec)
+            return fail(ec, "timer");
+
+        do_write();
+    }
+
+    void
+    do_write()
+    {
+        ws_.async_write(
+            net::buffer(messages_ > 0 ? msg_ : last_),
+            net::bind_executor(strand_, alloc_.wrap(std::bind(
+                &connection::on_write,
+                shared_from_this(),
+                std::placeholders::_1))));
+    }
+
+    void
+    on_write(beast::error_code ec)
+    {
+        if(ec)
+            return fail(ec, "write");
+    }
+
+    void
+    do_read()
+    {
+        ws_.async_read(buffer_,
+            net::bind_executor(strand_, alloc_.wrap(std::bind(
+                &connection::on_read,
+                shared_from_this(),
+                std::placeholders::_1))));
+    }
+
+    void
+    on_read(beast::error_code ec)
+    {
+        if(ec)
+            return fail(ec, "read");
+
+        ++count_;
+        bytes_ += buffer_.size();
+        bool const last =
+            buffer_.size() == last_.size() &&
+            beast::buffers_to_string(buffer_.data()) == last_;
+        buffer_.consume(buffer_.size());
+
+        if(last)
+            return ws_.async_close({},
+                net::bind_executor(strand_, alloc_.wrap(std::bind(
+                    &connection::on_close,
+                    shared_from_this(),
+                    std::placeholders::_1))));
+
+        if(publisher_ && messages_-- > 0)
+            do_write();
+
+        do_read();
+    }
+
+    void
+    on_close(beast::error_code ec)
+    {
+        if(ec)
+            return fail(ec, "close");
+    }
+};
+
+class timer
+{
+    using clock_type =
+        std::chrono::system_clock;
+
+    clock_type::time_point when_;
+
+public:
+    using duration =
+        clock_type::duration;
+
+    timer()
+        : when_(clock_type::now())
+    {
+    }
+
+    duration
+    elapsed() const
+    {
+        return clock_type::now() - when_;
+    }
+};
+
+inline
+std::uint64_t
+throughput(
+    std::chrono::duration<double> const& elapsed,
+    std::uint64_t items)
+{
+    using namespace std::chrono;
+    return static_cast<std::uint64_t>(
+        1 / (elapsed/items).count());
+}
+
+int
+main(int argc, char** argv)
+{
+    boost::beast::unit_test::dstream dout(std::cerr);
+
+    try
+    {
+        // Check command line arguments.
+        if(argc != 8)
+        {
+            std::cerr <<
+                "Usage: bench-wsbroadcast <address> <port> <trials> <messages> <subscribers> <threads> <size>";
+            return EXIT_FAILURE;
+        }
+
+        auto const address = net::ip::make_address(argv[1]);
+        auto const port    = static_cast<unsigned short>(std::atoi(argv[2]));
+        auto const trials  = static_cast<std::size_t>(std::atoi(argv[3]));
+        auto const messages= static_cast<std::size_t>(std::atoi(argv[4]));
+        auto const clients = static_cast<std::size_t>(std::atoi(argv[5]));
+        auto const threads = static_cast<std::size_t>(std::atoi(argv[6]));
+        auto const size    = static_cast<std::size_t>(std::atoi(argv[7]));
+        if(clients == 0 || size == 0)
+        {
+            std::cerr << "Error: subscribers and size must be positive\n";
+            return EXIT_FAILURE;
+        }
+        std::string const msg(size, '*');
+        std::string const last(size, '#');
+        for(auto i = trials; i != 0; --i)
+        {
+            report rep;
+            start_gate gate{clients};
+            net::io_context ioc;
+            std::shared_ptr<connection> publisher;
+            for(auto j = clients; j; --j)
+            {
+                auto sp =
+                std::make_shared<connection>(
+                    ioc,
+                    tcp::endpoint{address, port},
+                    messages,
+                    msg,
+                    last,
+                    rep,
+                    gate);
+                if(! publisher)
+                    publisher = sp;
+                sp->run();
+            }
+            timer clock;
+            gate.on_start(
+                [&publisher]
+                {
+                    publisher->publish();
+                    publisher.reset();
+                });
+            std::vector<std::thread> tv;
+            if(threads > 1)
+            {
+                tv.reserve(threads - 1);
+                for(auto n = threads - 1; n; --n)
+                    tv.emplace_back([&ioc]{ ioc.run(); });
+            }
+            ioc.run();
+            for(auto& t : tv)
+                t.join();
+            auto const elapsed = clock.elapsed();
+            dout <<
+                throughput(elapsed, rep.messages()) << " deliveries/s, " <<
+                throughput(elapsed, rep.bytes()) << " bytes/s in " <<
+                (std::chrono::duration_cast<
+                    std::chrono::milliseconds>(
+                    elapsed).count() / 1000.) << "ms and " <<
+                rep.messages() << " deliveries" << std::endl;
+        }
+    }
+    catch(std::exception const& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -127,6 +127,8 @@ public:
         tcp::endpoint const& ep,
         std::size_t messages,
         bool deflate,
+        bool autofrag,
+        std::size_t read_buffer_size,
         report& rep,
         test_buffer const& tb)
         : ws_(ioc)
@@ -140,8 +142,9 @@ public:
         pmd.client_enable = deflate;
         ws_.set_option(pmd);
         ws_.binary(true);
-        ws_.auto_fragment(false);
+        ws_.auto_fragment(autofrag);
         ws_.write_buffer_size(64 * 1024);
+        ws_.read_buffer_size(read_buffer_size);
     }
 
     ~connection()
@@ -285,10 +288,10 @@ main(int argc, char** argv)
     try
     {
         // Check command line arguments.
-        if(argc != 8)
+        if(argc < 8 || argc > 10)
         {
             std::cerr <<
-                "Usage: bench-wsload <address> <port> <trials> <messages> <workers> <threads> <compression:0|1>";
+                "Usage: bench-wsload <address> <port> <trials> <messages> <workers> <threads> <compression:0|1> [<read-buffer-size> [<autofrag:0|1>]]";
             return EXIT_FAILURE;
         }
 
@@ -299,6 +302,9 @@ main(int argc, char** argv)
         auto const workers = static_cast<std::size_t>(std::atoi(argv[5]));
         auto const threads = static_cast<std::size_t>(std::atoi(argv[6]));
         auto const deflate = std::atoi(argv[7]) != 0;
+        auto const rdsize  = argc > 8 ?
+            static_cast<std::size_t>(std::atoi(argv[8])) : 1536;
+        auto const autofrag= argc > 9 && std::atoi(argv[9]) != 0;
         auto const work = (messages + workers - 1) / workers;
         test_buffer tb;
         for(auto i = trials; i != 0; --i)
@@ -313,6 +319,8 @@ main(int argc, char** argv)
                     tcp::endpoint{address, port},
                     work,
                     deflate,
+                    autofrag,
+                    rdsize,
                     rep,
                     tb);
                 sp->run();
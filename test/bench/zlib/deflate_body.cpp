@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2016-2017 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/http/deflate_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/test/throughput.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <iomanip>
+#include <random>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+class deflate_body_test : public beast::unit_test::suite
+{
+public:
+    struct visitor
+    {
+        std::size_t& n;
+
+        template<class ConstBufferSequence>
+        void
+        operator()(error_code&,
+            ConstBufferSequence const& buffers)
+        {
+            n = net::buffer_size(buffers);
+        }
+    };
+
+    // Lots of repeats, limited char range
+    static
+    std::string
+    corpus1(std::size_t n)
+    {
+        static std::string const alphabet{
+            "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+        };
+        std::string s;
+        s.reserve(n + 5);
+        std::mt19937 g;
+        std::uniform_int_distribution<std::size_t> d0{
+            0, alphabet.size() - 1};
+        std::uniform_int_distribution<std::size_t> d1{
+            1, 5};
+        while(s.size() < n)
+        {
+            auto const rep = d1(g);
+            auto const ch = alphabet[d0(g)];
+            s.insert(s.end(), rep, ch);
+        }
+        s.resize(n);
+        return s;
+    }
+
+    // Serialize a response, returning the number of octets produced
+    template<class Body>
+    std::size_t
+    doSerialize(std::string const& body)
+    {
+        response<Body> res{status::ok, 11};
+        res.body() = body;
+        res.prepare_payload();
+        serializer<false, Body> sr{res};
+        std::size_t total = 0;
+        error_code ec;
+        while(! sr.is_done())
+        {
+            std::size_t n = 0;
+            sr.next(ec, visitor{n});
+            if(ec)
+                break;
+            sr.consume(n);
+            total += n;
+        }
+        BEAST_EXPECTS(! ec, ec.message());
+        return total;
+    }
+
+    template<class Body>
+    void
+    doTrial(
+        string_view name,
+        std::string const& body,
+        std::size_t repeat)
+    {
+        test::timer t;
+        std::size_t n = 0;
+        for(std::size_t i = 0; i < repeat; ++i)
+            n = doSerialize<Body>(body);
+        auto const elapsed = t.elapsed();
+        log <<
+            std::left << std::setw(10) << name <<
+            std::right << std::setw(12) <<
+                test::throughput(elapsed, body.size() * repeat) <<
+                " B/s " <<
+            std::right << std::setw(12) << n << " B on wire" <<
+            std::endl;
+    }
+
+    void
+    doCorpus(
+        std::size_t size,
+        std::size_t repeat)
+    {
+        std::size_t constexpr trials = 3;
+        auto const c1 = corpus1(size);
+        log << (std::to_string(size) + "B") << std::endl;
+        for(std::size_t i = 0; i < trials; ++i)
+        {
+            doTrial<string_body>("string", c1, repeat);
+            doTrial<gzip_body<string_body>>("gzip", c1, repeat);
+            doTrial<deflate_body<string_body>>("deflate", c1, repeat);
+        }
+        log << std::endl;
+    }
+
+    void
+    doBench()
+    {
+        doCorpus(      16 * 1024, 512);
+        doCorpus(    1024 * 1024,   8);
+        doCorpus(8 * 1024 * 1024,   1);
+    }
+
+    void
+    run() override
+    {
+        doBench();
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,deflate_body);
+
+} // http
+} // beast
+} // boost